@@ -40,6 +40,7 @@ USE_LITE_OP(fusion_elementwise_add_activation)
 USE_LITE_OP(fusion_elementwise_mul_activation)
 USE_LITE_OP(fusion_elementwise_max_activation)
 USE_LITE_OP(fusion_elementwise_div_activation)
+USE_LITE_OP(fusion_elementwise_chain)
 USE_LITE_OP(square)
 USE_LITE_OP(softmax)
 USE_LITE_OP(dropout)
@@ -83,6 +84,7 @@ USE_LITE_OP(flatten2)
 USE_LITE_OP(split)
 USE_LITE_OP(fake_quantize_moving_average_abs_max);
 USE_LITE_OP(fake_dequantize_max_abs);
+USE_LITE_OP(fake_channel_wise_dequantize_max_abs);
 USE_LITE_OP(fake_quantize_range_abs_max);
 USE_LITE_OP(calib);
 USE_LITE_OP(calib_once);
@@ -110,6 +112,7 @@ USE_LITE_OP(multiclass_nms)
 USE_LITE_OP(graph_op)
 USE_LITE_OP(sequence_expand)
 USE_LITE_OP(sequence_pool)
+USE_LITE_OP(fused_embedding_seq_pool)
 USE_LITE_OP(reduce_max)
 USE_LITE_OP(is_empty)
 USE_LITE_OP(shape)
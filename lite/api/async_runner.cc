@@ -0,0 +1,108 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/async_runner.h"
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+AsyncRunner::AsyncRunner(const std::function<lite::Tensor*(size_t)>& input,
+                         const std::function<void()>& run,
+                         int max_pending)
+    : input_(input), run_(run), max_pending_(max_pending) {
+  CHECK_GT(max_pending_, 0);
+  worker_ = std::thread(&AsyncRunner::WorkLoop, this);
+}
+
+AsyncRunner::~AsyncRunner() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  worker_.join();
+}
+
+lite::Tensor* AsyncRunner::GetInput(size_t i) {
+  if (i >= staged_.size()) {
+    staged_.resize(i + 1);
+  }
+  return &staged_[i];
+}
+
+void AsyncRunner::Run(const std::function<void()>& callback) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return pending_ < max_pending_; });
+  Job job;
+  job.inputs.swap(staged_);
+  job.callback = callback;
+  queue_.push_back(std::move(job));
+  pending_++;
+  unfinished_++;
+  // Stage the next inputs in a used slot, the tensors keep their dims, so the
+  // inputs of the same shapes reuse the buffers.
+  if (!free_slots_.empty()) {
+    staged_.swap(free_slots_.back());
+    free_slots_.pop_back();
+  }
+  lock.unlock();
+  cond_.notify_all();
+}
+
+void AsyncRunner::Wait() {
+  // The worker would wait for itself.
+  CHECK(std::this_thread::get_id() != worker_.get_id())
+      << "Wait is called in a callback";
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return unfinished_ == 0; });
+}
+
+void AsyncRunner::WorkLoop() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      // The queued runs are completed before stopping.
+      if (queue_.empty()) return;
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    for (size_t i = 0; i < job.inputs.size(); i++) {
+      std::swap(*input_(i), job.inputs[i]);
+    }
+    run_();
+    for (size_t i = 0; i < job.inputs.size(); i++) {
+      std::swap(*input_(i), job.inputs[i]);
+    }
+    // The slot and the pending run are released before the callback, so it
+    // can issue the next run. The next run starts after the callback returns.
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_slots_.push_back(std::move(job.inputs));
+      pending_--;
+    }
+    cond_.notify_all();
+    if (job.callback) job.callback();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      unfinished_--;
+    }
+    cond_.notify_all();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,97 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * Runs a predictor in a worker thread, with double-buffered inputs, so the
+ * caller stages the inputs of the next run while the current one executes.
+ *
+ * The caller fills the staged inputs by GetInput and issues the run by Run,
+ * which takes the staged tensors and returns at once, and GetInput gives the
+ * tensors of a free slot for the next run. Before running a job, the worker
+ * swaps its tensors with the feed tensors of the predictor, and swaps them
+ * back after, so the predictor is untouched by the caller while it runs. The
+ * used slots are recycled, so the buffers of the inputs are not reallocated
+ * as long as their sizes do not grow. The tensors of a recycled slot keep the
+ * dims and the data of the run they were last used in, until they are set.
+ *
+ * The fetch tensors of the predictor share the buffers of the vars of the
+ * program, so they are not buffered, which would take a copy. The outputs are
+ * read in the callback of the run, which is called in the worker thread right
+ * after the run and before the next one, or after Wait.
+ *
+ * GetInput, Run and Wait are called by one thread. The callbacks may issue
+ * the next runs by GetInput and Run in place of it, but not Wait, which is
+ * fatal in the worker thread.
+ */
+class LITE_API AsyncRunner {
+ public:
+  // `input` gives the i-th feed tensor of the predictor, and `run` runs it,
+  // they are only called in the worker thread. At most `max_pending` runs are
+  // issued and not completed, Run blocks if there are more.
+  AsyncRunner(const std::function<lite::Tensor*(size_t)>& input,
+              const std::function<void()>& run,
+              int max_pending = 2);
+  ~AsyncRunner();
+
+  // The i-th staged input of the next run.
+  lite::Tensor* GetInput(size_t i);
+
+  // Issue a run with the staged inputs, `callback` can be empty.
+  void Run(const std::function<void()>& callback);
+
+  // Block until the issued runs and their callbacks have completed.
+  void Wait();
+
+ private:
+  struct Job {
+    std::vector<lite::Tensor> inputs;
+    std::function<void()> callback;
+  };
+
+  void WorkLoop();
+
+  std::function<lite::Tensor*(size_t)> input_;
+  std::function<void()> run_;
+  int max_pending_;
+
+  // Only touched by the caller thread.
+  std::vector<lite::Tensor> staged_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Job> queue_;
+  // The input slots of the completed runs, to reuse.
+  std::vector<std::vector<lite::Tensor>> free_slots_;
+  // The issued runs not completed, including the running one, and the ones
+  // whose callbacks have not returned either.
+  int pending_{0};
+  int unfinished_{0};
+  bool stop_{false};
+  std::thread worker_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,119 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/async_runner.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(AsyncRunner, double_buffer) {
+  // A fake predictor, doubling its input.
+  std::vector<lite::Tensor> feed(1);
+  lite::Tensor fetch;
+  std::atomic<bool> running{false};
+  auto input = [&](size_t i) { return &feed[i]; };
+  auto run = [&] {
+    running = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    fetch.Resize(feed[0].dims());
+    auto* out = fetch.mutable_data<float>();
+    for (int64_t i = 0; i < feed[0].numel(); i++) {
+      out[i] = feed[0].data<float>()[i] * 2;
+    }
+    running = false;
+  };
+
+  const int kRuns = 8;
+  std::vector<float> results;
+  std::vector<const void*> buffers;
+  {
+    AsyncRunner runner(input, run);
+    for (int r = 0; r < kRuns; r++) {
+      auto* x = runner.GetInput(0);
+      x->Resize({4});
+      auto* data = x->mutable_data<float>();
+      buffers.push_back(data);
+      for (int i = 0; i < 4; i++) data[i] = r;
+      runner.Run([&] {
+        EXPECT_FALSE(running);
+        results.push_back(fetch.data<float>()[3]);
+      });
+    }
+    runner.Wait();
+    ASSERT_EQ(results.size(), static_cast<size_t>(kRuns));
+
+    // The sync run after the async ones.
+    runner.GetInput(0)->mutable_data<float>()[3] = 10;
+    runner.Run(nullptr);
+    runner.Wait();
+    EXPECT_EQ(fetch.data<float>()[3], 20);
+  }
+  for (int r = 0; r < kRuns; r++) {
+    EXPECT_EQ(results[r], r * 2);
+  }
+  // The input buffers are reused by the slots.
+  for (int r = 3; r < kRuns; r++) {
+    EXPECT_TRUE(buffers[r] == buffers[r - 2] || buffers[r] == buffers[r - 3]);
+  }
+}
+
+TEST(AsyncRunner, recycled_slot) {
+  std::vector<lite::Tensor> feed(1);
+  auto input = [&](size_t i) { return &feed[i]; };
+  AsyncRunner runner(input, [] {});
+  auto* x = runner.GetInput(0);
+  x->Resize({4});
+  x->mutable_data<float>()[3] = 1;
+  runner.Run(nullptr);
+  runner.Wait();
+  runner.GetInput(0)->Resize({2});
+  runner.GetInput(0)->mutable_data<float>()[1] = 2;
+  runner.Run(nullptr);
+  // The slot of the first run, with its dims and data.
+  x = runner.GetInput(0);
+  ASSERT_EQ(x->dims(), DDim(std::vector<int64_t>({4})));
+  EXPECT_EQ(x->data<float>()[3], 1);
+  runner.Wait();
+}
+
+TEST(AsyncRunner, run_in_callback) {
+  // Each callback issues the next run, with one run in flight at most.
+  std::vector<lite::Tensor> feed(1);
+  std::vector<float> results;
+  auto input = [&](size_t i) { return &feed[i]; };
+  auto run = [&] { results.push_back(feed[0].data<float>()[0]); };
+  const int kRuns = 5;
+  AsyncRunner runner(input, run, 1);
+  std::function<void()> next = [&] {
+    if (results.size() == static_cast<size_t>(kRuns)) return;
+    runner.GetInput(0)->Resize({1});
+    runner.GetInput(0)->mutable_data<float>()[0] = results.size();
+    runner.Run(next);
+  };
+  next();
+  // Wait returns after the runs issued by the callbacks.
+  runner.Wait();
+  ASSERT_EQ(results.size(), static_cast<size_t>(kRuns));
+  for (int r = 0; r < kRuns; r++) {
+    EXPECT_EQ(results[r], r);
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,259 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/batching_predictor.h"
+#include <cstring>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The element size of an input, by its precision, as its memory may be
+// larger than the data, e.g. bound by ShareExternalMemory.
+size_t ElementSize(const lite::Tensor& x) {
+  CHECK(x.precision() != PRECISION(kUnk) && x.precision() != PRECISION(kAny))
+      << "the precision of the input is not set";
+  return PrecisionTypeLength(x.precision());
+}
+
+// The element size of an output. The precisions of the outputs are mostly
+// not set, but their memory is sized to the data by the kernels writing them.
+size_t OutputElementSize(const lite::Tensor& x) {
+  if (x.precision() != PRECISION(kUnk) && x.precision() != PRECISION(kAny)) {
+    return PrecisionTypeLength(x.precision());
+  }
+  if (x.numel() == 0) return 0;
+  CHECK_EQ(x.memory_size() % x.numel(), 0UL);
+  return x.memory_size() / x.numel();
+}
+
+// Copy the rows [begin, end) of the output `x` to `out`, with the LoD `lod`.
+void CopyRows(const lite::Tensor& x,
+              int64_t begin,
+              int64_t end,
+              const LoD& lod,
+              lite::Tensor* out) {
+  size_t row_size = OutputElementSize(x) * x.dims().count(1, x.dims().size());
+  auto dims = x.dims();
+  dims[0] = end - begin;
+  out->Resize(dims);
+  auto* dst = out->mutable_data(x.target(), row_size * (end - begin));
+  std::memcpy(dst,
+              static_cast<const char*>(x.raw_data()) + row_size * begin,
+              row_size * (end - begin));
+  out->set_lod(lod);
+  out->set_precision(x.precision());
+}
+
+}  // namespace
+
+BatchingPredictor::BatchingPredictor(std::unique_ptr<Predictor>&& predictor,
+                                     int max_batch_size,
+                                     int timeout_us)
+    : predictor_(std::move(predictor)),
+      max_batch_size_(max_batch_size),
+      timeout_(timeout_us) {
+  CHECK(predictor_);
+  CHECK_GT(max_batch_size_, 0);
+  worker_ = std::thread(&BatchingPredictor::WorkLoop, this);
+}
+
+BatchingPredictor::~BatchingPredictor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  worker_.join();
+}
+
+void BatchingPredictor::Run(const std::vector<lite::Tensor>& inputs,
+                            std::vector<lite::Tensor>* outputs) {
+  CHECK(!inputs.empty()) << "no inputs";
+  CHECK(outputs);
+  std::unique_ptr<Request> request(new Request);
+  request->inputs = &inputs;
+  request->outputs = outputs;
+  request->batch_size = BatchSize(inputs);
+  request->enqueue_time = std::chrono::steady_clock::now();
+  auto done = request->done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(!stop_) << "the predictor is stopped";
+    queued_batch_size_ += request->batch_size;
+    queue_.push_back(std::move(request));
+  }
+  cond_.notify_all();
+  done.get();
+}
+
+int BatchingPredictor::BatchSize(const std::vector<lite::Tensor>& inputs) {
+  auto& x = inputs.front();
+  int batch_size = x.lod().empty() ? x.dims()[0] : x.lod()[0].size() - 1;
+  CHECK_GT(batch_size, 0) << "empty request";
+  return batch_size;
+}
+
+bool BatchingPredictor::Compatible(const Request& a, const Request& b) {
+  auto& x = *a.inputs;
+  auto& y = *b.inputs;
+  if (x.size() != y.size()) return false;
+  for (size_t i = 0; i < x.size(); i++) {
+    auto& x_dims = x[i].dims();
+    auto& y_dims = y[i].dims();
+    if (x_dims.size() != y_dims.size() || x_dims.size() == 0) return false;
+    for (size_t k = 1; k < x_dims.size(); k++) {
+      if (x_dims[k] != y_dims[k]) return false;
+    }
+    if (x[i].lod().size() != y[i].lod().size() ||
+        x[i].target() != y[i].target() ||
+        ElementSize(x[i]) != ElementSize(y[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BatchingPredictor::ConcatTensors(
+    const std::vector<const lite::Tensor*>& tensors, lite::Tensor* out) {
+  CHECK(!tensors.empty());
+  auto& first = *tensors.front();
+  size_t element_size = ElementSize(first);
+  auto dims = first.dims();
+  dims[0] = 0;
+  for (auto* x : tensors) {
+    dims[0] += x->dims()[0];
+  }
+  out->Resize(dims);
+  auto* dst = static_cast<char*>(
+      out->mutable_data(first.target(), dims.production() * element_size));
+  // The offsets of the LoD of a tensor are shifted by the lengths of the
+  // tensors before it.
+  LoD lod(first.lod().size(), std::vector<uint64_t>({0}));
+  for (auto* x : tensors) {
+    size_t size = x->numel() * element_size;
+    std::memcpy(dst, x->raw_data(), size);
+    dst += size;
+    CHECK_EQ(x->lod().size(), lod.size());
+    for (size_t level = 0; level < lod.size(); level++) {
+      auto base = lod[level].back();
+      auto& offsets = x->lod()[level];
+      for (size_t k = 1; k < offsets.size(); k++) {
+        lod[level].push_back(base + offsets[k]);
+      }
+    }
+  }
+  out->set_lod(lod);
+  out->set_precision(first.precision());
+}
+
+void BatchingPredictor::SliceBatch(const lite::Tensor& x,
+                                   int batch_size,
+                                   int begin,
+                                   int end,
+                                   lite::Tensor* out) {
+  auto& x_lod = x.lod();
+  if (!x_lod.empty() && x_lod[0].size() == batch_size + 1UL) {
+    // Split by the sequences, from the top level down to the rows.
+    LoD lod(x_lod.size());
+    uint64_t seq_begin = begin;
+    uint64_t seq_end = end;
+    for (size_t level = 0; level < x_lod.size(); level++) {
+      auto& offsets = x_lod[level];
+      for (uint64_t k = seq_begin; k <= seq_end; k++) {
+        lod[level].push_back(offsets[k] - offsets[seq_begin]);
+      }
+      seq_end = offsets[seq_end];
+      seq_begin = offsets[seq_begin];
+    }
+    CopyRows(x, seq_begin, seq_end, lod, out);
+  } else if (x.dims().size() > 0 && x.dims()[0] > 0 &&
+             x.dims()[0] % batch_size == 0) {
+    int64_t rows = x.dims()[0] / batch_size;
+    CopyRows(x, begin * rows, end * rows, LoD(), out);
+  } else if (x.dims().size() > 0 && x.dims()[0] > 0) {
+    CopyRows(x, 0, x.dims()[0], x_lod, out);
+  } else {
+    out->CopyDataFrom(x);
+  }
+}
+
+void BatchingPredictor::WorkLoop() {
+  while (true) {
+    auto batch = NextBatch();
+    if (batch.empty()) break;
+    RunBatch(batch);
+  }
+}
+
+std::vector<std::unique_ptr<BatchingPredictor::Request>>
+BatchingPredictor::NextBatch() {
+  std::vector<std::unique_ptr<Request>> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+  // The queued requests are still run when it is stopped.
+  if (queue_.empty()) return batch;
+  auto deadline = queue_.front()->enqueue_time + timeout_;
+  cond_.wait_until(lock, deadline, [this] {
+    return stop_ || queued_batch_size_ >= max_batch_size_;
+  });
+
+  int batch_size = queue_.front()->batch_size;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+  while (!queue_.empty() &&
+         batch_size + queue_.front()->batch_size <= max_batch_size_ &&
+         Compatible(*batch.front(), *queue_.front())) {
+    batch_size += queue_.front()->batch_size;
+    batch.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+  queued_batch_size_ -= batch_size;
+  return batch;
+}
+
+void BatchingPredictor::RunBatch(
+    const std::vector<std::unique_ptr<Request>>& batch) {
+  int batch_size = 0;
+  for (auto& request : batch) {
+    batch_size += request->batch_size;
+  }
+  size_t num_inputs = batch.front()->inputs->size();
+  for (size_t i = 0; i < num_inputs; i++) {
+    std::vector<const lite::Tensor*> tensors;
+    for (auto& request : batch) {
+      tensors.push_back(&request->inputs->at(i));
+    }
+    ConcatTensors(tensors, predictor_->GetInput(i));
+  }
+
+  predictor_->Run();
+
+  auto& outputs = *predictor_->GetOutputs();
+  int begin = 0;
+  for (auto& request : batch) {
+    int end = begin + request->batch_size;
+    request->outputs->resize(outputs.size());
+    for (size_t i = 0; i < outputs.size(); i++) {
+      SliceBatch(outputs[i], batch_size, begin, end, &request->outputs->at(i));
+    }
+    begin = end;
+    request->done.set_value();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,106 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * Serves the requests of many threads with one predictor by running them in
+ * batches. The requests are queued, and a worker thread concatenates the
+ * inputs of the queued requests along the batch dimension, until the batch
+ * reaches `max_batch_size` or the first request has waited for `timeout_us`,
+ * runs the predictor once, and scatters the outputs back to the requests.
+ *
+ * The batch size of a request is the number of sequences of its first input
+ * if it has LoD, or the first dimension of it. The inputs of the requests in
+ * a batch must have the same number, element sizes, LoD levels and dims
+ * except the first one, the incompatible requests are run in another batch.
+ * The element sizes are given by the precisions, which must be set to the
+ * inputs, so the inputs may be bound to larger memory than their data.
+ * An output is split by the sequences if its level-0 LoD has a sequence for
+ * every item in the batch, or by the rows if its first dimension is a
+ * multiple of the batch size. The other outputs, e.g. the scalars, are copied
+ * to every request.
+ *
+ * Only the inputs and outputs in the host memory are supported, e.g. on X86
+ * and ARM.
+ */
+class LITE_API BatchingPredictor {
+ public:
+  BatchingPredictor(std::unique_ptr<Predictor>&& predictor,
+                    int max_batch_size = 16,
+                    int timeout_us = 1000);
+  ~BatchingPredictor();
+
+  // Run a request, it blocks until the outputs are ready. Thread safe.
+  void Run(const std::vector<lite::Tensor>& inputs,
+           std::vector<lite::Tensor>* outputs);
+
+  // Concatenate the tensors along the first dimension, the LoDs are merged.
+  static void ConcatTensors(const std::vector<const lite::Tensor*>& tensors,
+                            lite::Tensor* out);
+  // Split the items [begin, end) of a batch of `batch_size` items from `x`,
+  // see the class comment for how the output is split.
+  static void SliceBatch(const lite::Tensor& x,
+                         int batch_size,
+                         int begin,
+                         int end,
+                         lite::Tensor* out);
+
+ private:
+  struct Request {
+    const std::vector<lite::Tensor>* inputs;
+    std::vector<lite::Tensor>* outputs;
+    int batch_size;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<void> done;
+  };
+
+  static int BatchSize(const std::vector<lite::Tensor>& inputs);
+  // Whether the two requests can be run in a batch.
+  static bool Compatible(const Request& a, const Request& b);
+
+  void WorkLoop();
+  // Pop the requests of the next batch, wait for more requests until the
+  // batch is full or timed out. Return an empty batch if it is stopped.
+  std::vector<std::unique_ptr<Request>> NextBatch();
+  void RunBatch(const std::vector<std::unique_ptr<Request>>& batch);
+
+  std::unique_ptr<Predictor> predictor_;
+  int max_batch_size_;
+  std::chrono::microseconds timeout_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  // The sum of the batch sizes of the queued requests.
+  int queued_batch_size_{0};
+  bool stop_{false};
+  std::thread worker_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,144 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/batching_predictor.h"
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/lite_api_test_helper.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+
+namespace paddle {
+namespace lite {
+
+TEST(BatchingPredictor, concat_and_slice) {
+  // Two requests of 2 and 1 sequences, with 3 and 2 rows.
+  lite::Tensor x0, x1;
+  x0.Resize({3, 2});
+  x1.Resize({2, 2});
+  auto* x0_data = x0.mutable_data<float>();
+  auto* x1_data = x1.mutable_data<float>();
+  for (int i = 0; i < 6; i++) x0_data[i] = i;
+  for (int i = 0; i < 4; i++) x1_data[i] = 6 + i;
+  x0.set_lod({{0, 1, 3}});
+  x1.set_lod({{0, 2}});
+  x0.set_precision(PRECISION(kFloat));
+  x1.set_precision(PRECISION(kFloat));
+
+  lite::Tensor batch;
+  BatchingPredictor::ConcatTensors({&x0, &x1}, &batch);
+  ASSERT_EQ(batch.dims(), DDim(std::vector<int64_t>({5, 2})));
+  ASSERT_EQ(batch.lod(), LoD({{0, 1, 3, 5}}));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(batch.data<float>()[i], i);
+  }
+
+  lite::Tensor y1;
+  BatchingPredictor::SliceBatch(batch, 3, 2, 3, &y1);
+  ASSERT_EQ(y1.dims(), x1.dims());
+  ASSERT_EQ(y1.lod(), x1.lod());
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(y1.data<float>()[i], x1_data[i]);
+  }
+
+  // An output of a row per sequence.
+  lite::Tensor out;
+  out.Resize({3, 4});
+  auto* out_data = out.mutable_data<float>();
+  for (int i = 0; i < 12; i++) out_data[i] = i;
+  lite::Tensor y0;
+  BatchingPredictor::SliceBatch(out, 3, 0, 2, &y0);
+  ASSERT_EQ(y0.dims(), DDim(std::vector<int64_t>({2, 4})));
+  for (int i = 0; i < 8; i++) {
+    ASSERT_EQ(y0.data<float>()[i], i);
+  }
+}
+
+TEST(BatchingPredictor, concat_larger_memory) {
+  // The inputs bound to the memory larger than their data, and an empty one.
+  std::vector<float> memory0(16), memory1(16);
+  lite::Tensor x0, x1, x2;
+  x0.Resize({2, 2});
+  x1.Resize({1, 2});
+  x2.Resize({0, 2});
+  x0.ShareExternalMemory(memory0.data(), 16 * sizeof(float), TARGET(kHost));
+  x1.ShareExternalMemory(memory1.data(), 16 * sizeof(float), TARGET(kHost));
+  for (auto* x : {&x0, &x1, &x2}) x->set_precision(PRECISION(kFloat));
+  for (int i = 0; i < 4; i++) memory0[i] = i;
+  for (int i = 0; i < 2; i++) memory1[i] = 4 + i;
+
+  lite::Tensor batch;
+  BatchingPredictor::ConcatTensors({&x0, &x2, &x1}, &batch);
+  ASSERT_EQ(batch.dims(), DDim(std::vector<int64_t>({3, 2})));
+  ASSERT_EQ(batch.memory_size(), 6 * sizeof(float));
+  for (int i = 0; i < 6; i++) {
+    ASSERT_EQ(batch.data<float>()[i], i);
+  }
+}
+
+#ifndef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
+TEST(BatchingPredictor, run) {
+  std::vector<Place> valid_places({Place{TARGET(kHost), PRECISION(kFloat)},
+                                   Place{TARGET(kX86), PRECISION(kFloat)}});
+  std::unique_ptr<Predictor> predictor(new Predictor);
+  predictor->Build(FLAGS_model_dir,
+                   "",
+                   "",
+                   Place{TARGET(kX86), PRECISION(kFloat)},
+                   valid_places);
+  auto reference = predictor->Clone();
+
+  const int num_requests = 8;
+  std::vector<std::vector<lite::Tensor>> inputs(num_requests);
+  for (int i = 0; i < num_requests; i++) {
+    inputs[i].resize(1);
+    inputs[i][0].Resize({i + 1, 100});
+    inputs[i][0].set_precision(PRECISION(kFloat));
+    auto* data = inputs[i][0].mutable_data<float>();
+    for (int k = 0; k < (i + 1) * 100; k++) {
+      data[k] = k % 100 + i;
+    }
+  }
+
+  std::vector<std::vector<lite::Tensor>> outputs(num_requests);
+  {
+    BatchingPredictor batching(std::move(predictor), 16, 10000);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_requests; i++) {
+      threads.emplace_back([&, i] { batching.Run(inputs[i], &outputs[i]); });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  for (int i = 0; i < num_requests; i++) {
+    auto* x = reference->GetInput(0);
+    x->Resize(inputs[i][0].dims());
+    x->CopyDataFrom(inputs[i][0]);
+    reference->Run();
+    auto* out = reference->GetOutput(0);
+    ASSERT_EQ(outputs[i][0].dims(), out->dims());
+    for (int k = 0; k < out->numel(); k++) {
+      EXPECT_NEAR(outputs[i][0].data<float>()[k], out->data<float>()[k], 1e-5);
+    }
+  }
+}
+#endif  // LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
+
+}  // namespace lite
+}  // namespace paddle
@@ -13,9 +13,15 @@
 // limitations under the License.
 
 #include <gflags/gflags.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
 #include <cstdio>
 #include <fstream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 #include "lite/api/paddle_api.h"
 #include "lite/api/test_helper.h"
@@ -30,6 +36,17 @@ DEFINE_string(result_filename, "", "save test result");
 DEFINE_bool(run_model_optimize,
             false,
             "apply model_optimize_tool to model, use optimized model to test");
+DEFINE_string(threads_list,
+              "",
+              "the thread numbers to sweep, separated by comma, e.g. 1,2,4, "
+              "--threads is used if empty");
+DEFINE_int32(instances,
+             1,
+             "run this many predictors sharing the weights in as many "
+             "threads, each runs --repeats times, to measure the throughput");
+DEFINE_string(result_json,
+              "",
+              "append the results of every thread number as a JSON line");
 
 namespace paddle {
 namespace lite_api {
@@ -59,23 +76,30 @@ void OutputOptModel(const std::string& load_model_dir,
 }
 
 #ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
-void Run(const std::vector<std::vector<int64_t>>& input_shapes,
-         const std::string& model_dir,
-         const int repeat,
-         const int thread_num,
-         const int warmup_times,
-         const std::string model_name) {
-  lite_api::MobileConfig config;
-  config.set_threads(thread_num);
-  if (thread_num == 1) {
-    config.set_power_mode(LITE_POWER_NO_BIND);
-  } else {
-    config.set_power_mode(LITE_POWER_NO_BIND);
+// The field of /proc/self/status in kB, e.g. VmRSS and VmHWM, -1 if it is not
+// available.
+int64_t ReadProcStatusKB(const std::string& field) {
+  std::ifstream file("/proc/self/status");
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::stoll(line.substr(field.size() + 1));
+    }
   }
-  config.set_model_dir(model_dir);
+  return -1;
+}
 
-  auto predictor = lite_api::CreatePaddlePredictor(config);
+// Reset VmHWM to the current RSS, so it is the peak of the next run. It needs
+// Linux 4.0 or later, returns false otherwise.
+bool ResetPeakRSS() {
+  std::ofstream file("/proc/self/clear_refs");
+  if (!file.is_open()) return false;
+  file << "5";
+  return static_cast<bool>(file.flush());
+}
 
+void FillInputs(PaddlePredictor* predictor,
+                const std::vector<std::vector<int64_t>>& input_shapes) {
   for (int j = 0; j < input_shapes.size(); ++j) {
     auto input_tensor = predictor->GetInput(j);
     input_tensor->Resize(input_shapes[j]);
@@ -88,16 +112,110 @@ void Run(const std::vector<std::vector<int64_t>>& input_shapes,
       input_data[i] = 1.f;
     }
   }
+}
+
+struct BenchmarkResult {
+  int threads{1};
+  int instances{1};
+  // The latencies of all the runs of all the instances, in ms.
+  std::vector<double> latencies;
+  double wall_ms{0};
+  // The RSS after the predictors are created and warmed up.
+  int64_t rss_kb{-1};
+  // The max and the average of the RSS peaks of the runs, only measured with
+  // a single instance.
+  int64_t peak_rss_kb{-1};
+  double avg_peak_rss_kb{-1};
+};
+
+// The nearest-rank percentile of the sorted values.
+double Percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+BenchmarkResult Run(const std::vector<std::vector<int64_t>>& input_shapes,
+                    const std::string& model_dir,
+                    const int repeat,
+                    const int thread_num,
+                    const int warmup_times,
+                    const int instances) {
+  using clock_t = std::chrono::steady_clock;
+  lite_api::MobileConfig config;
+  config.set_threads(thread_num);
+  config.set_power_mode(LITE_POWER_NO_BIND);
+  config.set_model_dir(model_dir);
 
-  for (int i = 0; i < warmup_times; ++i) {
-    predictor->Run();
+  // The clones share the weights of the first predictor.
+  std::vector<std::shared_ptr<PaddlePredictor>> predictors;
+  predictors.push_back(lite_api::CreatePaddlePredictor(config));
+  for (int i = 1; i < instances; ++i) {
+    predictors.push_back(predictors.front()->Clone());
   }
+  for (auto& predictor : predictors) {
+    FillInputs(predictor.get(), input_shapes);
+    for (int i = 0; i < warmup_times; ++i) {
+      predictor->Run();
+    }
+  }
+
+  BenchmarkResult result;
+  result.threads = thread_num;
+  result.instances = instances;
+  result.rss_kb = ReadProcStatusKB("VmRSS");
+  std::vector<std::vector<double>> latencies(instances);
+  auto run = [&](int id, bool track_memory) {
+    for (int i = 0; i < repeat; ++i) {
+      bool peak_reset = track_memory && ResetPeakRSS();
+      auto start = clock_t::now();
+      predictors[id]->Run();
+      auto end = clock_t::now();
+      latencies[id].push_back(
+          std::chrono::duration<double, std::milli>(end - start).count());
+      int64_t peak = peak_reset ? ReadProcStatusKB("VmHWM") : -1;
+      if (peak >= 0) {
+        result.peak_rss_kb = std::max(result.peak_rss_kb, peak);
+        result.avg_peak_rss_kb =
+            (result.avg_peak_rss_kb < 0 ? 0 : result.avg_peak_rss_kb) +
+            static_cast<double>(peak) / repeat;
+      }
+    }
+  };
 
-  auto start = lite::GetCurrentUS();
-  for (int i = 0; i < repeat; ++i) {
-    predictor->Run();
+  auto start = clock_t::now();
+  if (instances == 1) {
+    run(0, true);
+  } else {
+    // The RSS peak of a run is not separable from the other instances, so
+    // only the latencies and the throughput are measured.
+    std::vector<std::thread> threads;
+    for (int i = 0; i < instances; ++i) {
+      threads.emplace_back(run, i, false);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  result.wall_ms =
+      std::chrono::duration<double, std::milli>(clock_t::now() - start).count();
+  for (auto& x : latencies) {
+    result.latencies.insert(result.latencies.end(), x.begin(), x.end());
   }
-  auto end = lite::GetCurrentUS();
+  std::sort(result.latencies.begin(), result.latencies.end());
+  return result;
+}
+
+void SaveResult(const BenchmarkResult& result,
+                const std::string& model_name,
+                const int repeat,
+                const int warmup_times) {
+  auto& latencies = result.latencies;
+  double sum = 0;
+  for (double x : latencies) sum += x;
+  double avg = latencies.empty() ? 0 : sum / latencies.size();
+  double max = latencies.empty() ? 0 : latencies.back();
+  double qps = result.wall_ms > 0 ? latencies.size() * 1e3 / result.wall_ms : 0;
 
   std::FILE* pf = std::fopen(FLAGS_result_filename.c_str(), "a");
   if (nullptr == pf) {
@@ -105,10 +223,38 @@ void Run(const std::vector<std::vector<int64_t>>& input_shapes,
     exit(0);
   }
   fprintf(pf,
-          "-- %-18s    avg = %5.4f ms\n",
+          "-- %-18s    avg = %5.4f ms, p50 = %5.4f ms, p90 = %5.4f ms, "
+          "p99 = %5.4f ms, max = %5.4f ms, threads = %d, instances = %d, "
+          "qps = %.2f, peak rss = %lld kB\n",
           model_name.c_str(),
-          (end - start) / repeat / 1000.0);
+          avg,
+          Percentile(latencies, 0.5),
+          Percentile(latencies, 0.9),
+          Percentile(latencies, 0.99),
+          max,
+          result.threads,
+          result.instances,
+          qps,
+          static_cast<long long>(result.peak_rss_kb));  // NOLINT
   std::fclose(pf);
+
+  if (FLAGS_result_json.empty()) return;
+  std::stringstream ss;
+  ss << "{\"model\": \"" << model_name << "\", \"threads\": " << result.threads
+     << ", \"instances\": " << result.instances
+     << ", \"warmup\": " << warmup_times << ", \"repeats\": " << repeat
+     << ", \"avg_ms\": " << avg
+     << ", \"min_ms\": " << (latencies.empty() ? 0 : latencies.front())
+     << ", \"p50_ms\": " << Percentile(latencies, 0.5)
+     << ", \"p90_ms\": " << Percentile(latencies, 0.9)
+     << ", \"p99_ms\": " << Percentile(latencies, 0.99)
+     << ", \"max_ms\": " << max << ", \"throughput_qps\": " << qps
+     << ", \"rss_kb\": " << result.rss_kb
+     << ", \"peak_rss_kb\": " << result.peak_rss_kb
+     << ", \"avg_peak_rss_kb\": " << result.avg_peak_rss_kb << "}\n";
+  std::ofstream file(FLAGS_result_json, std::ios::app);
+  CHECK(file.is_open()) << "Open " << FLAGS_result_json << " failed";
+  file << ss.str();
 }
 #endif
 
@@ -176,12 +322,23 @@ int main(int argc, char** argv) {
   // Run inference using optimized model
   std::string run_model_dir =
       FLAGS_run_model_optimize ? save_optimized_model_dir : FLAGS_model_dir;
-  paddle::lite_api::Run(input_shapes,
-                        run_model_dir,
-                        FLAGS_repeats,
-                        FLAGS_threads,
-                        FLAGS_warmup,
-                        model_name);
+  std::vector<int> threads_list;
+  for (auto& threads : paddle::lite::Split(FLAGS_threads_list, ",")) {
+    threads_list.push_back(atoi(threads.c_str()));
+  }
+  if (threads_list.empty()) {
+    threads_list.push_back(FLAGS_threads);
+  }
+  for (int threads : threads_list) {
+    auto result = paddle::lite_api::Run(input_shapes,
+                                        run_model_dir,
+                                        FLAGS_repeats,
+                                        threads,
+                                        FLAGS_warmup,
+                                        FLAGS_instances);
+    paddle::lite_api::SaveResult(
+        result, model_name, FLAGS_repeats, FLAGS_warmup);
+  }
 #endif
   return 0;
 }
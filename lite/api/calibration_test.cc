@@ -0,0 +1,146 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/desc_test_helper.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+
+void FillWeight(Scope* scope, const std::string& name, const DDim& dims) {
+  auto* w = scope->Var(name)->GetMutable<Tensor>();
+  w->Resize(dims);
+  w->set_persistable(true);
+  w->set_precision(PRECISION(kFloat));
+  float* data = w->mutable_data<float>();
+  for (int64_t i = 0; i < w->numel(); i++) data[i] = 0.2f * std::sin(i * 0.7f);
+}
+
+// out = fc(relu(conv2d(x))), where the fc is fused from the mul and the
+// elementwise_add of the bias.
+cpp::ProgramDesc ConvFcProgram(Scope* scope) {
+  cpp::ProgramDesc desc;
+  auto* block = desc.AddBlock<cpp::BlockDesc>();
+  AddVar(block, "feed", true, cpp::VarDesc::Type::FEED_MINIBATCH);
+  AddVar(block, "fetch", true, cpp::VarDesc::Type::FETCH_LIST);
+  for (auto name : {"conv_w", "conv_b", "fc_w", "fc_b"}) {
+    AddVar(block, name, true);
+  }
+  // The tensors of the inputs are taken when the ops are attached.
+  for (auto name : {"x", "conv_out", "relu_out", "mul_out", "out"}) {
+    AddVar(block, name, false);
+    scope->Var(name)->GetMutable<Tensor>();
+  }
+  FillWeight(scope, "conv_w", DDim({4, 3, 3, 3}));
+  FillWeight(scope, "conv_b", DDim({4}));
+  FillWeight(scope, "fc_w", DDim({4 * 8 * 8, 10}));
+  FillWeight(scope, "fc_b", DDim({10}));
+
+  AddOp(block, "feed", {{"X", "feed"}}, {{"Out", "x"}})->SetAttr("col", 0);
+  auto* conv = AddOp(block,
+                     "conv2d",
+                     {{"Input", "x"}, {"Filter", "conv_w"}, {"Bias", "conv_b"}},
+                     {{"Output", "conv_out"}});
+  conv->SetAttr("strides", std::vector<int>({1, 1}));
+  conv->SetAttr("paddings", std::vector<int>({1, 1}));
+  conv->SetAttr("dilations", std::vector<int>({1, 1}));
+  conv->SetAttr("groups", 1);
+  AddOp(block, "relu", {{"X", "conv_out"}}, {{"Out", "relu_out"}});
+  auto* mul = AddOp(
+      block, "mul", {{"X", "relu_out"}, {"Y", "fc_w"}}, {{"Out", "mul_out"}});
+  mul->SetAttr("x_num_col_dims", 1);
+  mul->SetAttr("y_num_col_dims", 1);
+  AddOp(block,
+        "elementwise_add",
+        {{"X", "mul_out"}, {"Y", "fc_b"}},
+        {{"Out", "out"}})
+      ->SetAttr("axis", 1);
+  AddOp(block, "fetch", {{"X", "out"}}, {{"Out", "fetch"}})->SetAttr("col", 0);
+  return desc;
+}
+
+void FillInput(Predictor* predictor, int sample) {
+  auto* x = predictor->GetInput(0);
+  x->Resize({2, 3, 8, 8});
+  float* data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    data[i] = std::sin(i * 0.37f + sample);
+  }
+}
+
+TEST(Calibration, conv_fc_x86) {
+  const std::string model_dir = "calibration_conv_fc_int8";
+  auto scope = std::make_shared<Scope>();
+  Predictor predictor(scope);
+  predictor.Build(ConvFcProgram(scope.get()),
+                  Place{TARGET(kX86), PRECISION(kFloat)},
+                  {Place{TARGET(kX86), PRECISION(kFloat)},
+                   Place{TARGET(kHost), PRECISION(kFloat)}});
+  CalibrationConfig config;
+  config.algo = CalibrationAlgo::kMax;
+  predictor.EnableCalibration(config);
+  for (int sample = 0; sample < 4; sample++) {
+    FillInput(&predictor, sample);
+    predictor.Run();
+  }
+  predictor.SaveQuantizedModel(model_dir);
+
+  // The fp32 results of a sample out of the calibration ones.
+  FillInput(&predictor, 7);
+  predictor.Run();
+  auto* out = predictor.GetOutput(0);
+  std::vector<float> ref(out->data<float>(), out->data<float>() + out->numel());
+
+  Predictor quantized;
+  quantized.Build(model_dir,
+                  model_dir + "/model",
+                  model_dir + "/params",
+                  Place{TARGET(kX86), PRECISION(kInt8)},
+                  {Place{TARGET(kX86), PRECISION(kInt8)},
+                   Place{TARGET(kX86), PRECISION(kFloat)},
+                   Place{TARGET(kHost), PRECISION(kFloat)}});
+  FillInput(&quantized, 7);
+  quantized.Run();
+
+  std::set<std::string> int8_ops;
+  for (auto& inst : quantized.runtime_program().instructions()) {
+    if (inst.kernel()->precision() == PRECISION(kInt8)) {
+      int8_ops.insert(inst.op()->op_info()->Type());
+    }
+  }
+  EXPECT_TRUE(int8_ops.count("conv2d"));
+  EXPECT_TRUE(int8_ops.count("fc"));
+
+  out = quantized.GetOutput(0);
+  ASSERT_EQ(out->numel(), static_cast<int64_t>(ref.size()));
+  float max_abs = 0.f;
+  for (auto v : ref) max_abs = std::max(max_abs, std::fabs(v));
+  for (size_t i = 0; i < ref.size(); i++) {
+    EXPECT_NEAR(out->data<float>()[i], ref[i], 0.05f * max_abs) << "at " << i;
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -26,18 +26,25 @@ namespace paddle {
 namespace lite {
 
 void Predictor::SaveModel(const std::string &dir,
-                          lite_api::LiteModelType model_type) {
+                          lite_api::LiteModelType model_type,
+                          bool with_packed_weights) {
   if (!program_) {
     GenRuntimeProgram();
   }
   program_->SaveOpInfosToProgram(&program_desc_);
   program_->UpdateVarsOfProgram(&program_desc_);
+  // The program keeps the original weights, the packed ones are only saved.
+  cpp::ProgramDesc desc = program_desc_;
+  if (with_packed_weights) {
+    program_->SavePackedWeightsToProgram(&desc);
+  }
+  program_->SaveMemoryReuseToProgram(&desc);
   switch (model_type) {
     case lite_api::LiteModelType::kProtobuf:
-      SaveModelPb(dir, *program_->exec_scope(), program_desc_, true);
+      SaveModelPb(dir, *program_->exec_scope(), desc, true);
       break;
     case lite_api::LiteModelType::kNaiveBuffer:
-      SaveModelNaive(dir, *program_->exec_scope(), program_desc_);
+      SaveModelNaive(dir, *program_->exec_scope(), desc);
       break;
     default:
       LOG(FATAL) << "Unknown model type";
@@ -72,6 +79,17 @@ const lite::Tensor *Predictor::GetOutput(size_t offset) const {
   return &fetch_list.at(offset);
 }
 
+void Predictor::BindOutput(size_t offset,
+                           void *data,
+                           size_t memory_size,
+                           TargetType target,
+                           const std::shared_ptr<void> &holder) {
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  program_->BindOutput(offset, data, memory_size, target, holder);
+}
+
 const std::vector<lite::Tensor> *Predictor::GetOutputs() const {
   auto *_fetch_list = exec_scope_->FindVar("fetch");
   CHECK(_fetch_list) << "no fatch variable in exec_scope";
@@ -142,6 +160,8 @@ void Predictor::Build(const cpp::ProgramDesc &desc,
                       const std::vector<Place> &valid_places,
                       const std::vector<std::string> &passes) {
   program_desc_ = desc;
+  prefer_place_ = prefer_place;
+  valid_places_ = valid_places;
   Program program(desc, scope_, valid_places);
   optimizer_.KernelPickPreferPlace(prefer_place);
   core::KernelPickFactor factor;
@@ -156,6 +176,155 @@ void Predictor::GenRuntimeProgram() {
   program_ = optimizer_.GenRuntimeProgram();
   CHECK_EQ(exec_scope_, program_->exec_scope());
   program_generated_ = true;
+  if (kernel_tuning_) {
+    program_->EnableKernelTuning(tuning_cache_file_, autotune_);
+  }
+  if (profile_enabled_) {
+    program_->EnableProfiler(profile_path_);
+  }
+  if (calibrator_) {
+    program_->EnableCalibration(calibrator_.get());
+  }
+#ifdef LITE_WITH_ARM
+  if (run_mode_set_) {
+    program_->SetRunMode(mode_, threads_);
+  }
+#endif
+#ifdef LITE_WITH_X86
+  program_->SetX86Threads(x86_threads_);
+#endif
+  program_->SetInterOpThreads(inter_op_threads_);
+}
+
+void Predictor::EnableKernelTuning(const std::string &cache_file,
+                                   bool autotune) {
+  kernel_tuning_ = true;
+  autotune_ = autotune;
+  tuning_cache_file_ = cache_file;
+  if (program_generated_) {
+    program_->EnableKernelTuning(tuning_cache_file_, autotune_);
+  }
+}
+
+void Predictor::EnableProfiler(const std::string &dump_path) {
+  profile_enabled_ = true;
+  profile_path_ = dump_path;
+  if (program_generated_) {
+    program_->EnableProfiler(profile_path_);
+  }
+}
+
+void Predictor::EnableCalibration(const CalibrationConfig &config) {
+  calibrator_.reset(new Calibrator(config));
+  if (program_generated_) {
+    program_->EnableCalibration(calibrator_.get());
+  }
+}
+
+void Predictor::SaveQuantizedModel(const std::string &dir,
+                                   lite_api::LiteModelType model_type,
+                                   const std::vector<Place> &valid_places) {
+  CHECK(calibrator_) << "the calibration is not enabled";
+  CHECK(program_generated_) << "no samples are run for the calibration";
+  cpp::ProgramDesc desc = OptimizedProgramDesc();
+  // The weights are quantized in a copy, which this predictor does not use.
+  auto scope = std::make_shared<Scope>();
+  auto &main_block = *desc.GetBlock<cpp::BlockDesc>(0);
+  for (size_t i = 0; i < main_block.VarsSize(); ++i) {
+    auto *var_desc = main_block.GetVar<cpp::VarDesc>(i);
+    if (!var_desc->Persistable()) continue;
+    auto *var = scope_->FindLocalVar(var_desc->Name());
+    if (!var || !var->IsType<Tensor>()) continue;
+    auto &src = var->Get<Tensor>();
+    auto *dst = scope->Var(var_desc->Name())->GetMutable<Tensor>();
+    dst->CopyDataFrom(src);
+    dst->set_precision(src.precision());
+    dst->set_persistable(src.persistable());
+  }
+  calibrator_->QuantizeProgram(&desc, scope.get());
+
+  // The int8 kernels are preferred, as for the models trained with the fake
+  // quantization.
+  std::vector<Place> places = valid_places;
+  if (places.empty()) {
+    places = valid_places_;
+    for (auto &place : valid_places_) {
+      if (place.precision == PRECISION(kFloat)) {
+        places.emplace_back(place.target, PRECISION(kInt8), place.layout);
+      }
+    }
+  }
+  Place prefer_place(
+      prefer_place_.target, PRECISION(kInt8), prefer_place_.layout);
+  Predictor quantized(scope);
+  quantized.Build(desc, prefer_place, places);
+  quantized.SaveModel(dir, model_type);
+}
+
+#ifdef LITE_WITH_ARM
+void Predictor::SetRunMode(lite_api::PowerMode mode, int threads) {
+  run_mode_set_ = true;
+  mode_ = mode;
+  threads_ = threads;
+  if (program_generated_) {
+    program_->SetRunMode(mode_, threads_);
+  }
+}
+#endif
+
+#ifdef LITE_WITH_X86
+void Predictor::SetX86Threads(int threads) {
+  x86_threads_ = threads;
+  if (program_generated_) {
+    program_->SetX86Threads(x86_threads_);
+  }
+}
+#endif
+
+void Predictor::SetInterOpThreads(int threads) {
+  inter_op_threads_ = threads;
+  if (program_generated_) {
+    program_->SetInterOpThreads(inter_op_threads_);
+  }
+}
+
+cpp::ProgramDesc Predictor::OptimizedProgramDesc() {
+  cpp::ProgramDesc desc = program_desc_;
+  program_->SaveOpInfosToProgram(&desc);
+  program_->UpdateVarsOfProgram(&desc);
+  // The persistable vars created by the passes, e.g. the outputs of
+  // calib_once, are computed in the exec scope rather than loaded into the
+  // shared scope, so each clone computes its own.
+  auto &main_block = *desc.GetBlock<cpp::BlockDesc>(0);
+  for (size_t i = 0; i < main_block.VarsSize(); ++i) {
+    auto *var = main_block.GetVar<cpp::VarDesc>(i);
+    if (var->Name() == "feed" || var->Name() == "fetch") continue;
+    if (var->Persistable() && !scope_->FindLocalVar(var->Name())) {
+      var->SetPersistable(false);
+    }
+  }
+  return desc;
+}
+
+std::unique_ptr<Predictor> Predictor::Clone() {
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  cpp::ProgramDesc desc = OptimizedProgramDesc();
+  std::unique_ptr<Predictor> res(new Predictor(scope_));
+  res->program_desc_ = program_desc_;
+  res->program_.reset(new RuntimeProgram(desc, scope_));
+  res->program_->BindMemoryArenas(program_->memory_arena_plans());
+  res->exec_scope_ = res->program_->exec_scope();
+  res->program_generated_ = true;
+#ifdef LITE_WITH_ARM
+  res->SetRunMode(program_->power_mode(), program_->threads());
+#endif
+#ifdef LITE_WITH_X86
+  res->SetX86Threads(x86_threads_);
+#endif
+  res->SetInterOpThreads(inter_op_threads_);
+  return res;
 }
 
 const lite::Tensor *Predictor::GetTensor(const std::string &name) const {
@@ -165,7 +334,7 @@ const lite::Tensor *Predictor::GetTensor(const std::string &name) const {
 
 #ifdef LITE_WITH_TRAIN
 void Predictor::FeedVars(const std::vector<framework::Tensor> &tensors) {
-  auto var = scope_->FindVar("feed");
+  auto var = exec_scope_->FindVar("feed");
   auto &feed_list = *(var->GetMutable<std::vector<lite::Tensor>>());
   feed_list.resize(tensors.size());
 
@@ -62,6 +62,56 @@ class LITE_API Predictor {
 
   void GenRuntimeProgram();
 
+  // Create a predictor sharing the weights with this one. The clone runs the
+  // optimized program without optimizing it again, and has its own exec scope
+  // and instructions, so the clones can run in different threads concurrently.
+  std::unique_ptr<Predictor> Clone();
+
+#ifdef LITE_WITH_ARM
+  // Set the power mode and the thread number of this predictor only, it takes
+  // effect when the runtime program is generated if it is not yet.
+  void SetRunMode(lite_api::PowerMode mode, int threads);
+#endif
+
+#ifdef LITE_WITH_X86
+  // Set the thread number of the x86 kernels of this predictor only, it takes
+  // effect when the runtime program is generated if it is not yet.
+  void SetX86Threads(int threads);
+#endif
+
+  // Run the independent instructions in parallel, see
+  // RuntimeProgram::SetInterOpThreads. It takes effect when the runtime
+  // program is generated if it is not yet.
+  void SetInterOpThreads(int threads);
+
+  // Tune the implementations of the kernels in the runs, see
+  // RuntimeProgram::EnableKernelTuning. The picks are kept by SaveModel.
+  void EnableKernelTuning(const std::string& cache_file, bool autotune = true);
+
+  // Profile the runs, see RuntimeProgram::EnableProfiler. It takes effect
+  // when the runtime program is generated if it is not yet.
+  void EnableProfiler(const std::string& dump_path = "");
+  // Null if the profiler is not enabled or the program is not generated.
+  const profile::TraceProfiler* profiler() const {
+    return program_ ? program_->profiler() : nullptr;
+  }
+
+  // Calibrate the int8 scales of the inputs of the convs and the fcs in the
+  // following runs, which feed the sample data to the fp32 program, see
+  // Calibrator. It takes effect when the runtime program is generated if it
+  // is not yet. The runs are slower and run the instructions in order.
+  void EnableCalibration(
+      const CalibrationConfig& config = CalibrationConfig());
+  // Save the model quantized by the calibration, whose calibrated ops run the
+  // int8 kernels with the weights quantized by the output channels. The
+  // program is optimized again for `valid_places`, or for the places of this
+  // predictor with the int8 ones of their targets added if it is empty. This
+  // predictor is not changed and keeps running the fp32 program.
+  void SaveQuantizedModel(
+      const std::string& dir,
+      lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
+      const std::vector<Place>& valid_places = {});
+
   // Run the predictor for a single batch of data.
   void Run() {
     if (!program_generated_) {
@@ -75,6 +125,13 @@ class LITE_API Predictor {
 
   // Get offset-th col of fetch results.
   const lite::Tensor* GetOutput(size_t offset) const;
+  // Produce offset-th col of fetch results in the memory of the caller, see
+  // RuntimeProgram::BindOutput.
+  void BindOutput(size_t offset,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target,
+                  const std::shared_ptr<void>& holder = nullptr);
   const std::vector<lite::Tensor>* GetOutputs() const;
 
   const cpp::ProgramDesc& program_desc() const;
@@ -82,9 +139,13 @@ class LITE_API Predictor {
   const RuntimeProgram& runtime_program() const;
 
   // This method is disabled in mobile, for unnecessary dependencies required.
+  // With `with_packed_weights`, the weights packed by the kernels are saved
+  // in place of the original ones, see
+  // RuntimeProgram::SavePackedWeightsToProgram.
   void SaveModel(
       const std::string& dir,
-      lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf);
+      lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
+      bool with_packed_weights = false);
 
 #ifdef LITE_WITH_TRAIN
   void Run(const std::vector<framework::Tensor>& tensors) {
@@ -96,12 +157,36 @@ class LITE_API Predictor {
 #endif
 
  private:
+  // The optimized program with the kernels picked, which runs on scope_ as
+  // the clones do.
+  cpp::ProgramDesc OptimizedProgramDesc();
+
   Optimizer optimizer_;
   cpp::ProgramDesc program_desc_;
   std::shared_ptr<Scope> scope_;
-  const Scope* exec_scope_;
+  const Scope* exec_scope_{};
   std::unique_ptr<RuntimeProgram> program_;
   bool program_generated_{false};
+  bool kernel_tuning_{false};
+  bool autotune_{true};
+  std::string tuning_cache_file_;
+  bool profile_enabled_{false};
+  std::string profile_path_;
+  std::unique_ptr<Calibrator> calibrator_;
+  // The places the program is optimized for.
+  Place prefer_place_;
+  std::vector<Place> valid_places_;
+#ifdef LITE_WITH_ARM
+  // The run mode set by SetRunMode, the default run mode of DeviceInfo is used
+  // if it is not set.
+  bool run_mode_set_{false};
+  lite_api::PowerMode mode_{lite_api::LITE_POWER_NO_BIND};
+  int threads_{1};
+#endif
+#ifdef LITE_WITH_X86
+  int x86_threads_{1};
+#endif
+  int inter_op_threads_{1};
 };
 
 /*
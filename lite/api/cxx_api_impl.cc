@@ -13,8 +13,11 @@
 // limitations under the License.
 
 #include "lite/api/cxx_api.h"
+#include <functional>
 #include <string>
+#include "lite/api/async_runner.h"
 #include "lite/api/paddle_api.h"
+#include "lite/api/shape_buckets.h"
 #include "lite/core/device_info.h"
 #include "lite/core/version.h"
 
@@ -32,22 +35,47 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
 
   std::unique_ptr<const lite_api::Tensor> GetOutput(int i) const override;
 
+  void BindOutput(int i,
+                  void *data,
+                  size_t memory_size,
+                  lite_api::TargetType target,
+                  const std::function<void(void *)> &deleter) override;
+
   void Run() override;
 
+  void RunAsync(const std::function<void()> &callback) override;
+
+  void Wait() override;
+
+  std::shared_ptr<lite_api::PaddlePredictor> Clone() override;
+
   std::string GetVersion() const override;
 
   std::unique_ptr<const lite_api::Tensor> GetTensor(
       const std::string &name) const override;
 
-  void SaveOptimizedModel(const std::string &model_dir,
-                          lite_api::LiteModelType model_type =
-                              lite_api::LiteModelType::kProtobuf) override;
+  void SaveOptimizedModel(
+      const std::string &model_dir,
+      lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
+      bool with_packed_weights = false) override;
 
  private:
-  Predictor raw_predictor_;
+  // Created by the first RunAsync, the inputs are staged in it since then.
+  AsyncRunner *async_runner();
+  void SetShapeBuckets(const std::vector<std::vector<lite_api::shape_t>> &x,
+                       bool pad);
+  // Run in the plan of the shape bucket if any.
+  void RunPredictor();
+
+  std::unique_ptr<Predictor> raw_predictor_;
+  std::vector<std::vector<lite_api::shape_t>> shape_buckets_;
+  bool pad_to_bucket_{false};
+  // Destroyed before the predictor they run.
+  std::unique_ptr<ShapeBucketRunner<Predictor>> bucket_runner_;
+  std::unique_ptr<AsyncRunner> async_runner_;
 };
 
-CxxPaddleApiImpl::CxxPaddleApiImpl() {}
+CxxPaddleApiImpl::CxxPaddleApiImpl() : raw_predictor_(new Predictor) {}
 
 void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
 #ifdef LITE_WITH_CUDA
@@ -55,33 +83,118 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
 #endif
   auto places = config.valid_places();
   places.emplace_back(TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny));
-  raw_predictor_.Build(config, places);
+  raw_predictor_->Build(config, places);
+  if (!config.profile_path().empty()) {
+    raw_predictor_->EnableProfiler(config.profile_path());
+  }
+  if (config.autotune() || !config.tuning_cache_file().empty()) {
+    raw_predictor_->EnableKernelTuning(config.tuning_cache_file(),
+                                       config.autotune());
+  }
+#ifdef LITE_WITH_ARM
+  raw_predictor_->SetRunMode(config.power_mode(), config.threads());
+#endif
+#ifdef LITE_WITH_X86
+  raw_predictor_->SetX86Threads(config.threads());
+#endif
+  raw_predictor_->SetInterOpThreads(config.inter_op_threads());
+  SetShapeBuckets(config.shape_buckets(), config.pad_to_bucket());
+}
+
+void CxxPaddleApiImpl::SetShapeBuckets(
+    const std::vector<std::vector<lite_api::shape_t>> &x, bool pad) {
+  shape_buckets_ = x;
+  pad_to_bucket_ = pad;
+  if (!x.empty()) {
+    bucket_runner_.reset(
+        new ShapeBucketRunner<Predictor>(raw_predictor_.get(), x, pad));
+  }
+}
+
+void CxxPaddleApiImpl::RunPredictor() {
+  if (bucket_runner_) {
+    bucket_runner_->Run();
+  } else {
+    raw_predictor_->Run();
+  }
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInput(int i) {
-  auto *x = raw_predictor_.GetInput(i);
+  auto *x = async_runner_ ? async_runner_->GetInput(i)
+                          : raw_predictor_->GetInput(i);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetOutput(
     int i) const {
-  const auto *x = raw_predictor_.GetOutput(i);
+  const auto *x = bucket_runner_ ? bucket_runner_->GetOutput(i)
+                                 : raw_predictor_->GetOutput(i);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
-void CxxPaddleApiImpl::Run() { raw_predictor_.Run(); }
+void CxxPaddleApiImpl::BindOutput(
+    int i,
+    void *data,
+    size_t memory_size,
+    lite_api::TargetType target,
+    const std::function<void(void *)> &deleter) {
+  // The bound memory is not changed while the runs are in flight.
+  if (async_runner_) async_runner_->Wait();
+  std::shared_ptr<void> holder;
+  if (deleter) holder.reset(data, deleter);
+  if (bucket_runner_) {
+    bucket_runner_->BindOutput(i, data, memory_size, target, holder);
+  } else {
+    raw_predictor_->BindOutput(i, data, memory_size, target, holder);
+  }
+}
+
+void CxxPaddleApiImpl::Run() {
+  if (async_runner_) {
+    async_runner_->Run(nullptr);
+    async_runner_->Wait();
+  } else {
+    RunPredictor();
+  }
+}
+
+void CxxPaddleApiImpl::RunAsync(const std::function<void()> &callback) {
+  async_runner()->Run(callback);
+}
+
+void CxxPaddleApiImpl::Wait() {
+  if (async_runner_) async_runner_->Wait();
+}
+
+AsyncRunner *CxxPaddleApiImpl::async_runner() {
+  if (!async_runner_) {
+    auto *predictor = raw_predictor_.get();
+    async_runner_.reset(new AsyncRunner(
+        [predictor](size_t i) { return predictor->GetInput(i); },
+        [this] { RunPredictor(); }));
+  }
+  return async_runner_.get();
+}
+
+std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone() {
+  auto cloned = std::make_shared<CxxPaddleApiImpl>();
+  cloned->raw_predictor_ = raw_predictor_->Clone();
+  cloned->SetShapeBuckets(shape_buckets_, pad_to_bucket_);
+  return cloned;
+}
 
 std::string CxxPaddleApiImpl::GetVersion() const { return version(); }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetTensor(
     const std::string &name) const {
-  auto *x = raw_predictor_.GetTensor(name);
+  auto *x = raw_predictor_->GetTensor(name);
   return std::unique_ptr<const lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 void CxxPaddleApiImpl::SaveOptimizedModel(const std::string &model_dir,
-                                          lite_api::LiteModelType model_type) {
-  raw_predictor_.SaveModel(model_dir, model_type);
+                                          lite_api::LiteModelType model_type,
+                                          bool with_packed_weights) {
+  raw_predictor_->SaveModel(model_dir, model_type, with_packed_weights);
 }
 
 }  // namespace lite
@@ -15,11 +15,15 @@
 #include "lite/api/cxx_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <string>
 #include <vector>
 #include "lite/api/lite_api_test_helper.h"
 #include "lite/api/paddle_use_kernels.h"
 #include "lite/api/paddle_use_ops.h"
 #include "lite/api/paddle_use_passes.h"
+#include "lite/core/desc_test_helper.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/tensor.h"
 
@@ -153,5 +157,96 @@ TEST(CXXApi, load_model_naive) {
 }
 #endif
 
+// x -> a -> b -> c -> out by the mul ops of the weights w, 2 times the
+// identity, where a, b and c are placed in the memory arena of the host, and a
+// and c do not live at the same time.
+TEST(CXXApi, clone_memory_arena) {
+  auto scope = std::make_shared<Scope>();
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({16, 16});
+  w->set_persistable(true);
+  w->set_precision(PRECISION(kFloat));
+  auto* w_data = w->mutable_data<float>();
+  for (int i = 0; i < 16 * 16; i++) w_data[i] = i % 17 == 0 ? 2.f : 0.f;
+
+  cpp::ProgramDesc desc;
+  auto* block = desc.AddBlock<cpp::BlockDesc>();
+  AddVar(block, "feed", true, cpp::VarDesc::Type::FEED_MINIBATCH);
+  AddVar(block, "fetch", true, cpp::VarDesc::Type::FETCH_LIST);
+  AddVar(block, "w", true);
+  std::vector<std::string> names({"x", "a", "b", "c", "out"});
+  for (auto& name : names) AddVar(block, name);
+  AddOp(block, "feed", {{"X", "feed"}}, {{"Out", "x"}})->SetAttr("col", 0);
+  for (size_t i = 1; i < names.size(); i++) {
+    auto* mul = AddOp(
+        block, "mul", {{"X", names[i - 1]}, {"Y", "w"}}, {{"Out", names[i]}});
+    mul->SetAttr("x_num_col_dims", 1);
+    mul->SetAttr("y_num_col_dims", 1);
+  }
+  AddOp(block, "fetch", {{"X", "out"}}, {{"Out", "fetch"}})->SetAttr("col", 0);
+
+  // The memory of the arena is planned on the ARM target, the kernels of the
+  // other places run if the ones on ARM are not built.
+  Predictor predictor(scope);
+  predictor.Build(desc,
+                  Place{TARGET(kARM), PRECISION(kFloat)},
+                  {Place{TARGET(kARM), PRECISION(kFloat)},
+                   Place{TARGET(kX86), PRECISION(kFloat)},
+                   Place{TARGET(kHost), PRECISION(kFloat)}});
+  auto fill_and_run = [](Predictor* p) {
+    auto* x = p->GetInput(0);
+    x->Resize({2, 16});
+    auto* data = x->mutable_data<float>();
+    for (int i = 0; i < 32; i++) data[i] = i;
+    p->Run();
+    auto* out = p->GetOutput(0);
+    ASSERT_EQ(out->numel(), 32);
+    for (int i = 0; i < 32; i++) EXPECT_EQ(out->data<float>()[i], 16.f * i);
+  };
+  fill_and_run(&predictor);
+  auto clone = predictor.Clone();
+  fill_and_run(clone.get());
+
+  // The temporaries of each predictor share an arena of its own, smaller than
+  // the total size of them.
+  const size_t var_size = 32 * sizeof(float);
+  std::vector<const char*> arenas;
+  for (auto* p : {&predictor, clone.get()}) {
+    auto* arena = p->GetTensor("__memory_arena_host__");
+    ASSERT_LT(arena->memory_size(), 3 * var_size);
+    auto* begin = static_cast<const char*>(arena->raw_data());
+    for (auto name : {"a", "b", "c"}) {
+      auto* data = static_cast<const char*>(p->GetTensor(name)->raw_data());
+      EXPECT_GE(data, begin) << name;
+      EXPECT_LE(data + var_size, begin + arena->memory_size()) << name;
+    }
+    arenas.push_back(begin);
+  }
+  EXPECT_NE(arenas[0], arenas[1]);
+
+  // The arena is not saved, the temporaries of the saved program share the
+  // tensors of the clusters instead.
+  const std::string model_dir = "clone_memory_arena";
+  predictor.SaveModel(model_dir);
+  Predictor loaded;
+  loaded.Build(model_dir,
+               model_dir + "/model",
+               model_dir + "/params",
+               Place{TARGET(kX86), PRECISION(kFloat)},
+               {Place{TARGET(kX86), PRECISION(kFloat)},
+                Place{TARGET(kHost), PRECISION(kFloat)}});
+  std::set<std::string> temps;
+  auto loaded_desc = loaded.program_desc();
+  auto* loaded_block = loaded_desc.GetBlock<cpp::BlockDesc>(0);
+  for (size_t i = 0; i < loaded_block->OpsSize(); i++) {
+    auto* op = loaded_block->GetOp<cpp::OpDesc>(i);
+    if (op->Type() != "mul") continue;
+    temps.insert(op->Output("Out").front());
+  }
+  temps.erase("out");
+  EXPECT_LT(temps.size(), 3UL);
+  fill_and_run(&loaded);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,197 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Benchmark the kernels of the ops of a model, with the shapes the ops take
+ * for every input shape in --input_shapes, e.g.
+ *
+ *   kernel_benchmark_bin --model_dir=mobilenet_v1 \
+ *     --input_shapes="1,3,224,224;4,3,224,224" --repeats=50 \
+ *     --result_json=result.json --baseline_json=baseline.json
+ *
+ * All the kernels registered for an op are benchmarked, not only the one the
+ * model picks. The results are saved as JSON, see arena::KernelBenchJson. With
+ * --baseline_json, the results slower than the baseline by more than
+ * --max_regression are reported, and the exit code is 1.
+ */
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/api/test_helper.h"
+#include "lite/core/arena/kernel_benchmark.h"
+#include "lite/utils/string.h"
+
+DEFINE_string(input_shapes,
+              "1,3,224,224",
+              "the grid of the input shapes, the points are separated by "
+              "semicolon, the inputs of a point by colon, e.g. "
+              "\"1,3,224,224;4,3,224,224\"");
+DEFINE_string(op_types,
+              "",
+              "the op types to benchmark, separated by comma, all if empty");
+DEFINE_string(result_json, "", "save the results, print them if empty");
+DEFINE_string(baseline_json, "", "the results to compare with");
+DEFINE_double(max_regression,
+              0.1,
+              "the p50 latency slower than the baseline by more than this "
+              "ratio is a regression");
+
+namespace paddle {
+namespace lite {
+
+std::vector<std::vector<int64_t>> ParseInputShapes(const std::string& str) {
+  std::vector<std::vector<int64_t>> shapes;
+  for (auto& input : Split(str, ":")) {
+    std::vector<int64_t> shape;
+    for (auto& dim : Split(input, ",")) {
+      shape.push_back(std::stoll(dim));
+    }
+    shapes.push_back(shape);
+  }
+  return shapes;
+}
+
+bool SkipOp(const OpInfo& op_info, const std::vector<std::string>& op_types) {
+  auto type = op_info.Type();
+  if (type == "feed" || type == "fetch" || type == "io_copy" ||
+      type == "io_copy_once" || op_info.HasAttr("sub_block")) {
+    return true;
+  }
+  return !op_types.empty() &&
+         std::find(op_types.begin(), op_types.end(), type) == op_types.end();
+}
+
+int Main() {
+  std::vector<Place> valid_places{
+#ifdef LITE_WITH_X86
+      Place{TARGET(kX86), PRECISION(kFloat)},
+#endif
+#ifdef LITE_WITH_ARM
+      Place{TARGET(kARM), PRECISION(kFloat)},
+#endif
+      Place{TARGET(kHost), PRECISION(kFloat)},
+  };
+#ifdef LITE_WITH_ARM
+  DeviceInfo::Init();
+  DeviceInfo::Global().SetRunMode(lite_api::LITE_POWER_HIGH, FLAGS_threads);
+#endif
+  auto op_types = Split(FLAGS_op_types, ",");
+  arena::KernelBenchConfig config;
+  config.warmup = FLAGS_warmup;
+  config.repeats = FLAGS_repeats;
+  config.threads = FLAGS_threads;
+
+  std::vector<arena::KernelBenchResult> results;
+  // The op with the same shapes is benchmarked once, the range of its results
+  // by the op type and the shapes.
+  std::map<std::string, std::pair<size_t, size_t>> cases;
+  for (auto& point : Split(FLAGS_input_shapes, ";")) {
+    Predictor predictor;
+#ifdef LITE_WITH_X86
+    predictor.SetX86Threads(FLAGS_threads);
+#endif
+    predictor.Build(
+        FLAGS_model_dir, "", "", valid_places.front(), valid_places);
+    auto input_shapes = ParseInputShapes(point);
+    for (size_t i = 0; i < input_shapes.size(); i++) {
+      auto* input = predictor.GetInput(i);
+      input->Resize(input_shapes[i]);
+      auto* data = input->mutable_data<float>();
+      for (int64_t j = 0; j < input->numel(); j++) {
+        data[j] = (j % 255) / 255.f;
+      }
+    }
+    predictor.Run();
+
+    for (auto& inst : predictor.runtime_program().instructions()) {
+      auto* op = inst.op();
+      auto& op_info = *op->op_info();
+      if (SkipOp(op_info, op_types)) continue;
+      auto& scope = *const_cast<OpLite*>(op)->scope();
+      std::string key = op_info.Type() + "|" + arena::OpShapes(op_info, scope);
+      auto it = cases.find(key);
+      if (it != cases.end()) {
+        for (size_t i = it->second.first; i < it->second.second; i++) {
+          results[i].count++;
+        }
+        continue;
+      }
+      auto op_results = arena::BenchmarkOp(
+          op_info, scope, valid_places, inst.kernel(), config);
+      cases[key] = {results.size(), results.size() + op_results.size()};
+      results.insert(results.end(), op_results.begin(), op_results.end());
+    }
+  }
+
+  // The picked kernels taking the most time in the model first.
+  std::vector<const arena::KernelBenchResult*> picked;
+  for (auto& res : results) {
+    if (res.picked) picked.push_back(&res);
+  }
+  std::sort(picked.begin(),
+            picked.end(),
+            [](const arena::KernelBenchResult* a,
+               const arena::KernelBenchResult* b) {
+              return a->count * a->stats.p50_us > b->count * b->stats.p50_us;
+            });
+  LOG(INFO) << "================== Kernel Report ===================";
+  for (auto* res : picked) {
+    LOG(INFO) << res->kernel << " " << res->impl << " " << res->shapes
+              << " count: " << res->count << " p50: " << res->stats.p50_us
+              << " us, " << res->stats.gflops_per_s() << " GFLOP/s, "
+              << res->stats.gbytes_per_s() << " GB/s";
+  }
+
+  auto json = arena::KernelBenchJson(results);
+  if (FLAGS_result_json.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream file(FLAGS_result_json);
+    CHECK(file.is_open()) << "Open " << FLAGS_result_json << " failed";
+    file << json;
+  }
+
+  if (FLAGS_baseline_json.empty()) return 0;
+  auto regressions = arena::FindKernelBenchRegressions(
+      results,
+      arena::LoadKernelBenchBaseline(FLAGS_baseline_json),
+      FLAGS_max_regression);
+  for (auto& reg : regressions) {
+    LOG(WARNING) << "regression: " << reg.key << " p50 " << reg.p50_us
+                 << " us, baseline " << reg.baseline_us << " us";
+  }
+  return regressions.empty() ? 0 : 1;
+}
+
+}  // namespace lite
+}  // namespace paddle
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_model_dir.empty()) {
+    LOG(INFO) << "usage: --model_dir /path/to/your/model "
+                 "[--input_shapes 1,3,224,224;4,3,224,224]";
+    return 0;
+  }
+  return paddle::lite::Main();
+}
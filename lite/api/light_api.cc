@@ -21,7 +21,8 @@ void LightPredictor::Build(const std::string& model_dir,
                            const std::string& model_buffer,
                            const std::string& param_buffer,
                            lite_api::LiteModelType model_type,
-                           bool model_from_memory) {
+                           bool model_from_memory,
+                           bool use_mmap) {
   switch (model_type) {
 #ifndef LITE_ON_TINY_PUBLISH
     case lite_api::LiteModelType::kProtobuf:
@@ -33,7 +34,8 @@ void LightPredictor::Build(const std::string& model_dir,
         LoadModelNaiveFromMemory(
             model_buffer, param_buffer, scope_.get(), &cpp_program_desc_);
       } else {
-        LoadModelNaive(model_dir, scope_.get(), &cpp_program_desc_);
+        LoadModelNaive(
+            model_dir, scope_.get(), &cpp_program_desc_, true, use_mmap);
       }
       break;
     }
@@ -62,34 +64,20 @@ const Tensor* LightPredictor::GetOutput(size_t offset) {
 }
 
 void LightPredictor::BuildRuntimeProgram(const cpp::ProgramDesc& prog) {
-  std::vector<Instruction> insts;
-  // 1. Create op first
-  Program program(prog, scope_, {});
-
-  // 2. Create Instructs
-
-  // Create the kernels of the target places, and filter out the specific
-  // kernel with the target alias.
-  for (auto& op : program.ops()) {
-    auto kernel_type = op->op_info()->GetAttr<std::string>(kKernelTypeAttr);
-    std::string op_type, alias;
-    Place place;
-    KernelBase::ParseKernelType(kernel_type, &op_type, &alias, &place);
-    auto kernels = op->CreateKernels({place});
-    // filter out a kernel
-    auto it = std::find_if(
-        kernels.begin(), kernels.end(), [&](std::unique_ptr<KernelBase>& it) {
-          return it->alias() == alias;
-        });
-    CHECK(it != kernels.end());
-    (*it)->SetContext(ContextScheduler::Global().NewContext((*it)->target()));
-
-    insts.emplace_back(op, std::move(*it));
-  }
-  program_.reset(new RuntimeProgram(std::move(insts)));
+  program_.reset(new RuntimeProgram(prog, scope_));
+}
 
-  CHECK(program.exec_scope());
-  program_->set_exec_scope(program.exec_scope());
+std::unique_ptr<LightPredictor> LightPredictor::Clone() const {
+  std::unique_ptr<LightPredictor> res(
+      new LightPredictor(cpp_program_desc_, scope_));
+#ifdef LITE_WITH_ARM
+  res->SetRunMode(program_->power_mode(), program_->threads());
+#endif
+#ifdef LITE_WITH_X86
+  res->SetX86Threads(program_->x86_threads());
+#endif
+  res->SetInterOpThreads(program_->inter_op_threads());
+  return res;
 }
 
 }  // namespace lite
@@ -43,18 +43,68 @@ class LITE_API LightPredictor {
       const std::string& model_buffer = "",
       const std::string& param_buffer = "",
       bool model_from_memory = false,
-      lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf) {
+      lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
+      bool use_mmap = false) {
     scope_ = std::make_shared<Scope>();
-    Build(model_dir, model_buffer, param_buffer, model_type, model_from_memory);
+    Build(model_dir,
+          model_buffer,
+          param_buffer,
+          model_type,
+          model_from_memory,
+          use_mmap);
+  }
+  // Create a predictor of a loaded program, which shares the weights in
+  // `root_scope` and has its own temporary vars.
+  LightPredictor(const cpp::ProgramDesc& desc,
+                 const std::shared_ptr<Scope>& root_scope)
+      : scope_(root_scope), cpp_program_desc_(desc) {
+    BuildRuntimeProgram(cpp_program_desc_);
   }
 
+  // Create a predictor sharing the weights with this one, the clones can run
+  // in different threads concurrently.
+  std::unique_ptr<LightPredictor> Clone() const;
+
   void Run() { program_->Run(); }
 
+  // Profile the runs of this predictor, see RuntimeProgram::EnableProfiler.
+  void EnableProfiler(const std::string& dump_path = "") {
+    program_->EnableProfiler(dump_path);
+  }
+  const profile::TraceProfiler* profiler() const {
+    return program_->profiler();
+  }
+
+#ifdef LITE_WITH_ARM
+  // Set the power mode and the thread number of this predictor only.
+  void SetRunMode(lite_api::PowerMode mode, int threads) {
+    program_->SetRunMode(mode, threads);
+  }
+#endif
+
+#ifdef LITE_WITH_X86
+  // Set the thread number of the x86 kernels of this predictor only.
+  void SetX86Threads(int threads) { program_->SetX86Threads(threads); }
+#endif
+
+  // Run the independent instructions in parallel, see
+  // RuntimeProgram::SetInterOpThreads.
+  void SetInterOpThreads(int threads) { program_->SetInterOpThreads(threads); }
+
   // Get offset-th col of feed inputs.
   Tensor* GetInput(size_t offset);
 
   // Get offset-th col of fetch outputs.
   const Tensor* GetOutput(size_t offset);
+  // Produce offset-th col of fetch outputs in the memory of the caller, see
+  // RuntimeProgram::BindOutput.
+  void BindOutput(size_t offset,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target,
+                  const std::shared_ptr<void>& holder = nullptr) {
+    program_->BindOutput(offset, data, memory_size, target, holder);
+  }
 
   const lite::Tensor* GetTensor(const std::string& name) const {
     auto* var = program_->exec_scope()->FindVar(name);
@@ -67,7 +117,8 @@ class LITE_API LightPredictor {
       const std::string& model_buffer,
       const std::string& param_buffer,
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
-      bool model_from_memory = false);
+      bool model_from_memory = false,
+      bool use_mmap = false);
 
   void BuildRuntimeProgram(const cpp::ProgramDesc& prog);
 
@@ -13,8 +13,11 @@
 // limitations under the License.
 
 #include "lite/api/light_api.h"
+#include <functional>
 #include <string>
+#include "lite/api/async_runner.h"
 #include "lite/api/paddle_api.h"
+#include "lite/api/shape_buckets.h"
 #include "lite/core/version.h"
 #include "lite/model_parser/model_parser.h"
 
@@ -29,8 +32,20 @@ class LightPredictorImpl : public PaddlePredictor {
 
   std::unique_ptr<const Tensor> GetOutput(int i) const override;
 
+  void BindOutput(int i,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target,
+                  const std::function<void(void*)>& deleter) override;
+
   void Run() override;
 
+  void RunAsync(const std::function<void()>& callback) override;
+
+  void Wait() override;
+
+  std::shared_ptr<PaddlePredictor> Clone() override;
+
   std::string GetVersion() const override;
 
   std::unique_ptr<const Tensor> GetTensor(
@@ -39,7 +54,19 @@ class LightPredictorImpl : public PaddlePredictor {
   void Init(const MobileConfig& config);
 
  private:
+  // Created by the first RunAsync, the inputs are staged in it since then.
+  lite::AsyncRunner* async_runner();
+  void SetShapeBuckets(const std::vector<std::vector<shape_t>>& x, bool pad);
+  // Run in the plan of the shape bucket if any.
+  void RunPredictor();
+
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  std::vector<std::vector<shape_t>> shape_buckets_;
+  bool pad_to_bucket_{false};
+  // Destroyed before the predictor they run.
+  std::unique_ptr<lite::ShapeBucketRunner<lite::LightPredictor>>
+      bucket_runner_;
+  std::unique_ptr<lite::AsyncRunner> async_runner_;
 };
 
 void LightPredictorImpl::Init(const MobileConfig& config) {
@@ -48,18 +75,100 @@ void LightPredictorImpl::Init(const MobileConfig& config) {
                                                 config.model_buffer(),
                                                 config.param_buffer(),
                                                 config.model_from_memory(),
-                                                LiteModelType::kNaiveBuffer));
+                                                LiteModelType::kNaiveBuffer,
+                                                config.use_mmap()));
+  if (!config.profile_path().empty()) {
+    raw_predictor_->EnableProfiler(config.profile_path());
+  }
+#ifdef LITE_WITH_ARM
+  raw_predictor_->SetRunMode(config.power_mode(), config.threads());
+#endif
+#ifdef LITE_WITH_X86
+  raw_predictor_->SetX86Threads(config.threads());
+#endif
+  raw_predictor_->SetInterOpThreads(config.inter_op_threads());
+  SetShapeBuckets(config.shape_buckets(), config.pad_to_bucket());
+}
+
+void LightPredictorImpl::SetShapeBuckets(
+    const std::vector<std::vector<shape_t>>& x, bool pad) {
+  shape_buckets_ = x;
+  pad_to_bucket_ = pad;
+  if (!x.empty()) {
+    bucket_runner_.reset(new lite::ShapeBucketRunner<lite::LightPredictor>(
+        raw_predictor_.get(), x, pad));
+  }
+}
+
+void LightPredictorImpl::RunPredictor() {
+  if (bucket_runner_) {
+    bucket_runner_->Run();
+  } else {
+    raw_predictor_->Run();
+  }
 }
 
 std::unique_ptr<Tensor> LightPredictorImpl::GetInput(int i) {
-  return std::unique_ptr<Tensor>(new Tensor(raw_predictor_->GetInput(i)));
+  auto* x = async_runner_ ? async_runner_->GetInput(i)
+                          : raw_predictor_->GetInput(i);
+  return std::unique_ptr<Tensor>(new Tensor(x));
 }
 
 std::unique_ptr<const Tensor> LightPredictorImpl::GetOutput(int i) const {
-  return std::unique_ptr<Tensor>(new Tensor(raw_predictor_->GetOutput(i)));
+  const auto* x = bucket_runner_ ? bucket_runner_->GetOutput(i)
+                                 : raw_predictor_->GetOutput(i);
+  return std::unique_ptr<Tensor>(new Tensor(x));
+}
+
+void LightPredictorImpl::BindOutput(int i,
+                                    void* data,
+                                    size_t memory_size,
+                                    TargetType target,
+                                    const std::function<void(void*)>& deleter) {
+  // The bound memory is not changed while the runs are in flight.
+  if (async_runner_) async_runner_->Wait();
+  std::shared_ptr<void> holder;
+  if (deleter) holder.reset(data, deleter);
+  if (bucket_runner_) {
+    bucket_runner_->BindOutput(i, data, memory_size, target, holder);
+  } else {
+    raw_predictor_->BindOutput(i, data, memory_size, target, holder);
+  }
+}
+
+void LightPredictorImpl::Run() {
+  if (async_runner_) {
+    async_runner_->Run(nullptr);
+    async_runner_->Wait();
+  } else {
+    RunPredictor();
+  }
 }
 
-void LightPredictorImpl::Run() { raw_predictor_->Run(); }
+void LightPredictorImpl::RunAsync(const std::function<void()>& callback) {
+  async_runner()->Run(callback);
+}
+
+void LightPredictorImpl::Wait() {
+  if (async_runner_) async_runner_->Wait();
+}
+
+lite::AsyncRunner* LightPredictorImpl::async_runner() {
+  if (!async_runner_) {
+    auto* predictor = raw_predictor_.get();
+    async_runner_.reset(new lite::AsyncRunner(
+        [predictor](size_t i) { return predictor->GetInput(i); },
+        [this] { RunPredictor(); }));
+  }
+  return async_runner_.get();
+}
+
+std::shared_ptr<PaddlePredictor> LightPredictorImpl::Clone() {
+  auto cloned = std::make_shared<LightPredictorImpl>();
+  cloned->raw_predictor_ = raw_predictor_->Clone();
+  cloned->SetShapeBuckets(shape_buckets_, pad_to_bucket_);
+  return cloned;
+}
 
 std::string LightPredictorImpl::GetVersion() const { return lite::version(); }
 
@@ -78,27 +187,8 @@ std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(
 }
 
 MobileConfig::MobileConfig(PowerMode mode, int threads) {
-#ifdef LITE_WITH_ARM
-  lite::DeviceInfo::Global().SetRunMode(mode, threads);
-  mode_ = lite::DeviceInfo::Global().mode();
-  threads_ = lite::DeviceInfo::Global().threads();
-#endif
-}
-
-void MobileConfig::set_power_mode(paddle::lite_api::PowerMode mode) {
-#ifdef LITE_WITH_ARM
-  lite::DeviceInfo::Global().SetRunMode(mode, threads_);
-  mode_ = lite::DeviceInfo::Global().mode();
-  threads_ = lite::DeviceInfo::Global().threads();
-#endif
-}
-
-void MobileConfig::set_threads(int threads) {
-#ifdef LITE_WITH_ARM
-  lite::DeviceInfo::Global().SetRunMode(mode_, threads);
-  mode_ = lite::DeviceInfo::Global().mode();
-  threads_ = lite::DeviceInfo::Global().threads();
-#endif
+  set_power_mode(mode);
+  set_threads(threads);
 }
 
 }  // namespace lite_api
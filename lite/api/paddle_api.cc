@@ -43,14 +43,17 @@ const int8_t *Tensor::data() const {
 
 template <>
 int *Tensor::mutable_data() const {
+  tensor(raw_tensor_)->set_precision(PRECISION(kInt32));
   return tensor(raw_tensor_)->mutable_data<int>();
 }
 template <>
 float *Tensor::mutable_data() const {
+  tensor(raw_tensor_)->set_precision(PRECISION(kFloat));
   return tensor(raw_tensor_)->mutable_data<float>();
 }
 template <>
 int8_t *Tensor::mutable_data() const {
+  tensor(raw_tensor_)->set_precision(PRECISION(kInt8));
   return tensor(raw_tensor_)->mutable_data<int8_t>();
 }
 
@@ -62,8 +65,33 @@ lod_t Tensor::lod() const { return ctensor(raw_tensor_)->lod(); }
 
 void Tensor::SetLoD(const lod_t &lod) { tensor(raw_tensor_)->set_lod(lod); }
 
+void Tensor::ShareExternalMemory(void *data,
+                                 size_t memory_size,
+                                 TargetType target,
+                                 const std::function<void(void *)> &deleter) {
+  std::shared_ptr<void> holder;
+  if (deleter) holder.reset(data, deleter);
+  tensor(raw_tensor_)->ShareExternalMemory(data, memory_size, target, holder);
+}
+
+void PaddlePredictor::BindOutput(int i,
+                                 void *data,
+                                 size_t memory_size,
+                                 TargetType target,
+                                 const std::function<void(void *)> &deleter) {
+  LOG(FATAL) << "The BindOutput API is not supported by this predictor.";
+}
+
+void PaddlePredictor::RunAsync(const std::function<void()> &callback) {
+  Run();
+  if (callback) callback();
+}
+
+void PaddlePredictor::Wait() {}
+
 void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
-                                         LiteModelType model_type) {
+                                         LiteModelType model_type,
+                                         bool with_packed_weights) {
   LOG(FATAL)
       << "The SaveOptimizedModel API is only supported by CxxConfig predictor.";
 }
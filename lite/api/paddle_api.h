@@ -19,6 +19,7 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -54,6 +55,17 @@ struct LITE_API Tensor {
   // Set LoD of the tensor
   void SetLoD(const lod_t& lod);
 
+  /// Use the memory of the caller as the data of the tensor, e.g. of an
+  /// input, so it is not copied. The memory holds `memory_size` bytes on
+  /// `target`, and is not freed by the predictor. It must stay valid until
+  /// `deleter` is called with it, which is done once the predictor no longer
+  /// uses it, or while the tensor uses it if `deleter` is empty.
+  void ShareExternalMemory(
+      void* data,
+      size_t memory_size,
+      TargetType target = TargetType::kHost,
+      const std::function<void(void*)>& deleter = nullptr);
+
  private:
   void* raw_tensor_;
 };
@@ -70,8 +82,41 @@ class LITE_API PaddlePredictor {
   /// Get i-th output.
   virtual std::unique_ptr<const Tensor> GetOutput(int i) const = 0;
 
+  /// Let the i-th output be produced in the memory of the caller by the
+  /// kernel writing it, so it is not copied, and GetOutput gives a tensor on
+  /// the memory. The lifetime of the memory is the same as in
+  /// Tensor::ShareExternalMemory. If the output is not produced in place by
+  /// the kernel, e.g. by reshape, it is copied to the memory after the run,
+  /// and it is fatal if it needs more than `memory_size` bytes.
+  virtual void BindOutput(int i,
+                          void* data,
+                          size_t memory_size,
+                          TargetType target = TargetType::kHost,
+                          const std::function<void(void*)>& deleter = nullptr);
+
   virtual void Run() = 0;
 
+  /// Run with the inputs set by GetInput in a worker thread owned by the
+  /// predictor, and return at once. The inputs are double-buffered: after
+  /// RunAsync, GetInput gives the inputs of the next run, which can be set
+  /// while this one executes. `callback` is called in the worker thread when
+  /// the run completes, the outputs of the run are read by GetOutput in it,
+  /// or after Wait. RunAsync blocks if two runs are already in flight.
+  /// The input buffers are recycled, so the inputs given by GetInput after
+  /// RunAsync keep the dims and the data of an earlier run until they are set.
+  /// The callback may issue the next run by GetInput and RunAsync in place of
+  /// the calling thread, but must not call Run or Wait.
+  virtual void RunAsync(const std::function<void()>& callback);
+
+  /// Block until the runs issued by RunAsync and their callbacks have
+  /// completed.
+  virtual void Wait();
+
+  /// Create a predictor sharing the weights with this one. The clone has its
+  /// own inputs, outputs and temporary vars, so the clones can run in
+  /// different threads concurrently.
+  virtual std::shared_ptr<PaddlePredictor> Clone() = 0;
+
   virtual std::string GetVersion() const = 0;
 
   /// Get a readonly tensor, return null if no one called `name` exists.
@@ -80,9 +125,14 @@ class LITE_API PaddlePredictor {
 
   /// Persist the optimized model to disk. This API is only supported by
   /// CxxConfig, and the persisted model can be reused for MobileConfig.
+  /// With `with_packed_weights`, the conv weights are saved packed for the
+  /// kernels, e.g. transformed for the winograd conv, in place of the
+  /// original ones, so the model loads without packing them. Such a model is
+  /// only loaded on the kind of device it is saved on.
   virtual void SaveOptimizedModel(
       const std::string& model_dir,
-      LiteModelType model_type = LiteModelType::kProtobuf);
+      LiteModelType model_type = LiteModelType::kProtobuf,
+      bool with_packed_weights = false);
 
   virtual ~PaddlePredictor() = default;
 };
@@ -90,11 +140,51 @@ class LITE_API PaddlePredictor {
 /// Base class for all the configs.
 class LITE_API ConfigBase {
   std::string model_dir_;
+  PowerMode mode_{LITE_POWER_NO_BIND};
+  int threads_{1};
+  int inter_op_threads_{1};
+  std::string profile_path_;
+  std::vector<std::vector<shape_t>> shape_buckets_;
+  bool pad_to_bucket_{false};
 
  public:
   void set_model_dir(const std::string& x) { model_dir_ = x; }
+  /// The power mode and the thread number only apply to the predictor created
+  /// with this config, other predictors in the process keep their own. The
+  /// thread number applies to the ARM and the x86 kernels.
+  void set_power_mode(PowerMode mode) { mode_ = mode; }
+  void set_threads(int threads) { threads_ = threads; }
+  /// Run the ops not depending on each other, e.g. the branches of the model,
+  /// in parallel in `threads` threads. Every op running takes the threads set
+  /// by `set_threads` too, so the product should not exceed the cores.
+  void set_inter_op_threads(int threads) { inter_op_threads_ = threads; }
+  /// Profile the ops of the predictor, the Chrome trace and the per-op summary
+  /// are saved to `path`.trace.json and `path`.summary.json when the predictor
+  /// is destroyed. The clones of the predictor are not profiled.
+  void set_profile_path(const std::string& path) { profile_path_ = path; }
+  /// Keep an execution plan per bucket of the input shapes, a bucket has a
+  /// shape per input. A plan is prepared at creation by running the bucket
+  /// with zeros, and keeps the shapes, the kernel workspaces and the memory
+  /// of the bucket, so the runs switching between the buckets do not pay for
+  /// the shape change. The inputs of a bucket run in its plan, and with
+  /// `pad_to_bucket`, the inputs fitting in a bucket are padded by zeros at
+  /// the end of every dim to run in the smallest such bucket, the outputs
+  /// then have the shapes of the bucket. Other inputs run as usual.
+  void set_shape_buckets(const std::vector<std::vector<shape_t>>& buckets,
+                         bool pad_to_bucket = false) {
+    shape_buckets_ = buckets;
+    pad_to_bucket_ = pad_to_bucket;
+  }
 
   const std::string& model_dir() const { return model_dir_; }
+  PowerMode power_mode() const { return mode_; }
+  int threads() const { return threads_; }
+  int inter_op_threads() const { return inter_op_threads_; }
+  const std::string& profile_path() const { return profile_path_; }
+  const std::vector<std::vector<shape_t>>& shape_buckets() const {
+    return shape_buckets_;
+  }
+  bool pad_to_bucket() const { return pad_to_bucket_; }
 };
 
 /// CxxConfig is the config for the Full feature predictor.
@@ -104,6 +194,8 @@ class LITE_API CxxConfig : public ConfigBase {
   std::string model_file_;
   std::string param_file_;
   bool model_from_memory_{false};
+  bool autotune_{false};
+  std::string tuning_cache_file_;
 
  public:
   void set_preferred_place(const Place& x) { preferred_place_ = x; }
@@ -118,27 +210,39 @@ class LITE_API CxxConfig : public ConfigBase {
     param_file_ = std::string(param_buffer, param_buffer + param_buffer_size);
     model_from_memory_ = true;
   }
+  /// Time the implementations of the kernels, e.g. the direct, winograd and
+  /// gemm-like convs, in the first run of every input shape, and use the
+  /// fastest ones. The picks are kept in the optimized model.
+  void set_autotune(bool x) { autotune_ = x; }
+  /// Load the tuned picks from `path` and save the new ones to it, the
+  /// cached picks are applied even if autotune is off.
+  void set_tuning_cache_file(const std::string& path) {
+    tuning_cache_file_ = path;
+  }
 
   const Place& preferred_place() const { return preferred_place_; }
   const std::vector<Place>& valid_places() const { return valid_places_; }
   std::string model_file() const { return model_file_; }
   std::string param_file() const { return param_file_; }
   bool model_from_memory() const { return model_from_memory_; }
+  bool autotune() const { return autotune_; }
+  const std::string& tuning_cache_file() const { return tuning_cache_file_; }
 };
 
 /// MobileConfig is the config for the light weight predictor, it will skip
 /// IR optimization or other unnecessary stages.
 class LITE_API MobileConfig : public ConfigBase {
-  PowerMode mode_{LITE_POWER_HIGH};
-  int threads_{1};
   std::string model_buffer_;
   std::string param_buffer_;
   bool model_from_memory_{false};
+  bool use_mmap_{false};
 
  public:
   explicit MobileConfig(PowerMode mode = LITE_POWER_NO_BIND, int threads = 1);
-  void set_power_mode(PowerMode mode);
-  void set_threads(int threads);
+  /// Map the param file into memory instead of reading it, the weights are
+  /// used in place, and the pages are shared by the processes loading the
+  /// same model. The file must not be modified while the predictor lives.
+  void set_use_mmap(bool x) { use_mmap_ = x; }
   void set_model_buffer(const char* model_buffer,
                         size_t model_buffer_size,
                         const char* param_buffer,
@@ -148,9 +252,8 @@ class LITE_API MobileConfig : public ConfigBase {
     model_from_memory_ = true;
   }
 
-  PowerMode power_mode() const { return mode_; }
-  int threads() const { return threads_; }
   bool model_from_memory() const { return model_from_memory_; }
+  bool use_mmap() const { return use_mmap_; }
   const std::string& model_buffer() const { return model_buffer_; }
   const std::string& param_buffer() const { return param_buffer_; }
 };
@@ -60,6 +60,137 @@ TEST(CxxApi, run) {
                                 LiteModelType::kNaiveBuffer);
 }
 
+TEST(CxxApi, clone) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_preferred_place(Place{TARGET(kX86), PRECISION(kFloat)});
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto cloned = predictor->Clone();
+
+  for (auto* p : {predictor.get(), cloned.get()}) {
+    auto input_tensor = p->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = i;
+    }
+  }
+  // The clone has its own inputs.
+  ASSERT_NE(predictor->GetInput(0)->data<float>(),
+            cloned->GetInput(0)->data<float>());
+
+  predictor->Run();
+  cloned->Run();
+
+  auto* out = predictor->GetOutput(0)->data<float>();
+  auto* cloned_out = cloned->GetOutput(0)->data<float>();
+  EXPECT_NEAR(out[0], 50.2132, 1e-3);
+  EXPECT_NEAR(out[1], -28.8729, 1e-3);
+  EXPECT_NEAR(cloned_out[0], 50.2132, 1e-3);
+  EXPECT_NEAR(cloned_out[1], -28.8729, 1e-3);
+}
+
+TEST(CxxApi, run_async) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_preferred_place(Place{TARGET(kX86), PRECISION(kFloat)});
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto* p = predictor.get();
+  std::vector<float> out0;
+  for (int r = 0; r < 4; r++) {
+    // Stage the inputs of this run while the last one may be running.
+    auto input_tensor = p->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = r % 2 ? 0 : i;
+    }
+    p->RunAsync(
+        [p, &out0] { out0.push_back(p->GetOutput(0)->data<float>()[0]); });
+  }
+  p->Wait();
+  ASSERT_EQ(out0.size(), 4UL);
+  EXPECT_NEAR(out0[0], 50.2132, 1e-3);
+  EXPECT_NEAR(out0[2], 50.2132, 1e-3);
+  EXPECT_NE(out0[1], out0[0]);
+  EXPECT_EQ(out0[1], out0[3]);
+}
+
+TEST(CxxApi, bind_io) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_preferred_place(Place{TARGET(kX86), PRECISION(kFloat)});
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+
+  std::vector<float> input(100 * 100);
+  for (int i = 0; i < 100 * 100; i++) {
+    input[i] = i;
+  }
+  std::vector<float> output(100 * 500);
+  int released = 0;
+  {
+    auto predictor = lite_api::CreatePaddlePredictor(config);
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    input_tensor->ShareExternalMemory(input.data(),
+                                      input.size() * sizeof(float),
+                                      TargetType::kHost,
+                                      [&](void*) { released++; });
+    predictor->BindOutput(
+        0, output.data(), output.size() * sizeof(float), TargetType::kHost);
+
+    predictor->Run();
+
+    // The output is produced in the memory of the caller.
+    auto* out = predictor->GetOutput(0)->data<float>();
+    EXPECT_EQ(out, output.data());
+    EXPECT_NEAR(output[0], 50.2132, 1e-3);
+    EXPECT_NEAR(output[1], -28.8729, 1e-3);
+    EXPECT_EQ(released, 0);
+  }
+  EXPECT_EQ(released, 1);
+}
+
+TEST(CxxApi, inter_op) {
+  lite_api::CxxConfig config;
+  config.set_model_dir(FLAGS_model_dir);
+  config.set_preferred_place(Place{TARGET(kX86), PRECISION(kFloat)});
+  config.set_valid_places({
+      Place{TARGET(kX86), PRECISION(kFloat)},
+      Place{TARGET(kARM), PRECISION(kFloat)},
+  });
+  config.set_inter_op_threads(2);
+
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  // The first run is in order, the next ones keep the input shapes and run
+  // in parallel.
+  for (int repeat = 0; repeat < 3; repeat++) {
+    auto input_tensor = predictor->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = i;
+    }
+    predictor->Run();
+    auto output = predictor->GetOutput(0);
+    EXPECT_NEAR(output->data<float>()[0], 50.2132, 1e-3);
+    EXPECT_NEAR(output->data<float>()[1], -28.8729, 1e-3);
+  }
+}
+
 // Demo1 for Mobile Devices :Load model from file and run
 #ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
 TEST(LightApi, run) {
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/shape_buckets.h"
+
+namespace paddle {
+namespace lite {
+
+int FindShapeBucket(const std::vector<std::vector<DDim>>& buckets,
+                    const std::vector<DDim>& dims,
+                    bool pad,
+                    bool* exact) {
+  int best = -1;
+  int64_t best_size = 0;
+  for (size_t b = 0; b < buckets.size(); b++) {
+    auto& bucket = buckets[b];
+    if (bucket.size() != dims.size()) continue;
+    if (bucket == dims) {
+      *exact = true;
+      return b;
+    }
+    if (!pad) continue;
+    bool fits = true;
+    int64_t size = 0;
+    for (size_t i = 0; i < dims.size() && fits; i++) {
+      fits = bucket[i].size() == dims[i].size();
+      for (size_t j = 0; j < dims[i].size() && fits; j++) {
+        fits = bucket[i][j] >= dims[i][j];
+      }
+      size += bucket[i].production();
+    }
+    if (fits && (best < 0 || size < best_size)) {
+      best = b;
+      best_size = size;
+    }
+  }
+  *exact = false;
+  return best;
+}
+
+void PadTensor(const lite::Tensor& x, const DDim& dims, lite::Tensor* out) {
+  auto& x_dims = x.dims();
+  CHECK_EQ(x_dims.size(), dims.size());
+  CHECK_GT(x_dims.size(), 0UL);
+  CHECK_GT(x.numel(), 0);
+  // The memory of x may be larger than its elements, e.g. the memory of the
+  // caller it shares, so the element size is taken by the precision.
+  CHECK(x.precision() != PRECISION(kUnk) && x.precision() != PRECISION(kAny))
+      << "the precision of the input to pad is not set";
+  size_t elem_size = PrecisionTypeLength(x.precision());
+  CHECK_GT(elem_size, 0UL);
+  out->Resize(dims);
+  out->set_precision(x.precision());
+  auto* dst = static_cast<char*>(
+      out->mutable_data(x.target(), dims.production() * elem_size));
+  std::memset(dst, 0, dims.production() * elem_size);
+
+  // Copy the rows of the innermost dim, `index` is the index of the row in
+  // the outer dims of x.
+  size_t rank = dims.size();
+  size_t row_size = x_dims[rank - 1] * elem_size;
+  int64_t rows = x.numel() / x_dims[rank - 1];
+  std::vector<int64_t> index(rank - 1, 0);
+  auto* src = static_cast<const char*>(x.raw_data());
+  for (int64_t r = 0; r < rows; r++) {
+    int64_t offset = 0;
+    for (size_t d = 0; d + 1 < rank; d++) {
+      offset = offset * dims[d] + index[d];
+    }
+    std::memcpy(dst + offset * dims[rank - 1] * elem_size,
+                src + r * row_size,
+                row_size);
+    for (int d = static_cast<int>(rank) - 2; d >= 0; d--) {
+      if (++index[d] < x_dims[d]) break;
+      index[d] = 0;
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,151 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+// The bucket of the input dims, the one of the same dims, or the smallest one
+// no smaller in every dim if `pad`. -1 if there is none. `exact` tells if the
+// bucket has the same dims.
+int FindShapeBucket(const std::vector<std::vector<DDim>>& buckets,
+                    const std::vector<DDim>& dims,
+                    bool pad,
+                    bool* exact);
+
+// Copy `x` to the leading corner of `out` of `dims`, which is no smaller in
+// every dim, the rest of `out` is filled with zeros. The precision of x must
+// be set, e.g. by lite_api::Tensor::mutable_data.
+void PadTensor(const lite::Tensor& x, const DDim& dims, lite::Tensor* out);
+
+/*
+ * Runs a predictor with an execution plan per shape bucket. A plan is a clone
+ * of the predictor sharing the weights, which is run once with the shapes of
+ * its bucket at creation, so it keeps the shapes inferred, the workspaces of
+ * the kernels and the buffers of the vars for the bucket. As every plan always
+ * runs with the same input shapes, the runs switching between the buckets
+ * neither infer the shapes again nor reinitialize the kernels.
+ *
+ * The inputs are set to the predictor. A run takes the plan of the bucket of
+ * the input shapes, see FindShapeBucket, the inputs are moved to the plan, or
+ * padded by zeros into it if the bucket is larger, and the outputs are read
+ * from the plan, with the shapes of the bucket. The inputs without a bucket,
+ * and the ones with LoD to be padded, run in the predictor itself.
+ *
+ * The plans are run with zeros at creation, so the models need LoD or other
+ * particular data to run are not supported.
+ */
+template <typename PredictorT>
+class ShapeBucketRunner {
+ public:
+  ShapeBucketRunner(
+      PredictorT* predictor,
+      const std::vector<std::vector<std::vector<int64_t>>>& buckets,
+      bool pad)
+      : predictor_(predictor), pad_(pad), last_(predictor) {
+    for (auto& bucket : buckets) {
+      CHECK_EQ(bucket.size(), buckets.front().size())
+          << "the buckets have different input numbers";
+      std::vector<DDim> dims;
+      for (auto& shape : bucket) dims.emplace_back(shape);
+      buckets_.push_back(dims);
+
+      plans_.push_back(predictor_->Clone());
+      auto* plan = plans_.back().get();
+      for (size_t i = 0; i < dims.size(); i++) {
+        auto* input = plan->GetInput(i);
+        input->Resize(dims[i]);
+        // The zeros are allocated by the precision of the input, or by the
+        // widest element size if it is not set, as the zeros read as zeros
+        // of any type. The precision is left to the inputs set in the runs.
+        size_t elem_size = input->precision() == PRECISION(kUnk)
+                               ? sizeof(int64_t)
+                               : PrecisionTypeLength(input->precision());
+        size_t size = dims[i].production() * elem_size;
+        std::memset(input->mutable_data(input->target(), size), 0, size);
+      }
+      plan->Run();
+    }
+  }
+
+  void Run() {
+    size_t num = buckets_.empty() ? 0 : buckets_.front().size();
+    std::vector<DDim> dims;
+    bool has_lod = false;
+    for (size_t i = 0; i < num; i++) {
+      auto* input = predictor_->GetInput(i);
+      dims.push_back(input->dims());
+      has_lod = has_lod || !input->lod().empty();
+    }
+    bool exact = false;
+    int bucket = FindShapeBucket(buckets_, dims, pad_, &exact);
+    if (bucket < 0 || (!exact && has_lod)) {
+      last_ = predictor_;
+      predictor_->Run();
+      return;
+    }
+
+    auto* plan = plans_[bucket].get();
+    last_ = plan;
+    if (exact) {
+      for (size_t i = 0; i < num; i++) {
+        std::swap(*predictor_->GetInput(i), *plan->GetInput(i));
+      }
+      plan->Run();
+      for (size_t i = 0; i < num; i++) {
+        std::swap(*predictor_->GetInput(i), *plan->GetInput(i));
+      }
+    } else {
+      for (size_t i = 0; i < num; i++) {
+        PadTensor(*predictor_->GetInput(i),
+                  buckets_[bucket][i],
+                  plan->GetInput(i));
+      }
+      plan->Run();
+    }
+  }
+
+  // The i-th output of the last run.
+  const lite::Tensor* GetOutput(size_t i) { return last_->GetOutput(i); }
+
+  // Bind the memory to the output of every plan, only one of them runs at a
+  // time.
+  void BindOutput(size_t i,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target,
+                  const std::shared_ptr<void>& holder) {
+    predictor_->BindOutput(i, data, memory_size, target, holder);
+    for (auto& plan : plans_) {
+      plan->BindOutput(i, data, memory_size, target, holder);
+    }
+  }
+
+ private:
+  PredictorT* predictor_;
+  bool pad_;
+  std::vector<std::vector<DDim>> buckets_;
+  std::vector<std::unique_ptr<PredictorT>> plans_;
+  // The predictor or the plan of the last run.
+  PredictorT* last_;
+};
+
+}  // namespace lite
+}  // namespace paddle
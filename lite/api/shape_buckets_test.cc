@@ -0,0 +1,154 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/shape_buckets.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(ShapeBuckets, find) {
+  std::vector<std::vector<DDim>> buckets{
+      {DDim({1, 64}), DDim({1})},
+      {DDim({1, 128}), DDim({1})},
+      {DDim({1, 32}), DDim({1})},
+  };
+  bool exact;
+  EXPECT_EQ(FindShapeBucket(buckets, {DDim({1, 128}), DDim({1})}, true, &exact),
+            1);
+  EXPECT_TRUE(exact);
+  // The smallest bucket fitting the dims.
+  EXPECT_EQ(FindShapeBucket(buckets, {DDim({1, 40}), DDim({1})}, true, &exact),
+            0);
+  EXPECT_FALSE(exact);
+  EXPECT_EQ(FindShapeBucket(buckets, {DDim({1, 40}), DDim({1})}, false, &exact),
+            -1);
+  EXPECT_EQ(FindShapeBucket(buckets, {DDim({1, 200}), DDim({1})}, true, &exact),
+            -1);
+  EXPECT_EQ(FindShapeBucket(buckets, {DDim({2, 32}), DDim({1})}, true, &exact),
+            -1);
+  EXPECT_EQ(FindShapeBucket(buckets, {DDim({32}), DDim({1})}, true, &exact),
+            -1);
+}
+
+TEST(ShapeBuckets, pad) {
+  // x shares a memory larger than its elements.
+  std::vector<float> memory(100, -1.f);
+  for (int i = 0; i < 12; i++) memory[i] = i + 1;
+  Tensor x;
+  x.Resize({2, 2, 3});
+  x.ShareExternalMemory(
+      memory.data(), memory.size() * sizeof(float), TARGET(kHost));
+  x.set_precision(PRECISION(kFloat));
+  const float* x_data = x.data<float>();
+
+  Tensor out;
+  PadTensor(x, DDim({2, 3, 4}), &out);
+  ASSERT_EQ(out.dims(), DDim({2, 3, 4}));
+  auto* out_data = out.data<float>();
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) {
+      for (int k = 0; k < 4; k++) {
+        float expected = j < 2 && k < 3 ? x_data[(i * 2 + j) * 3 + k] : 0;
+        EXPECT_EQ(out_data[(i * 3 + j) * 4 + k], expected);
+      }
+    }
+  }
+
+  // The elements of other sizes.
+  Tensor ids;
+  ids.Resize({3});
+  ids.set_precision(PRECISION(kInt64));
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (int i = 0; i < 3; i++) ids_data[i] = i + 7;
+  PadTensor(ids, DDim({5}), &out);
+  std::vector<int64_t> expected{7, 8, 9, 0, 0};
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(out.data<int64_t>()[i], expected[i]);
+  }
+}
+
+// A predictor doubling its input, recording the dims it runs with.
+class FakePredictor {
+ public:
+  std::unique_ptr<FakePredictor> Clone() {
+    return std::unique_ptr<FakePredictor>(new FakePredictor);
+  }
+  Tensor* GetInput(size_t i) {
+    if (i >= inputs_.size()) inputs_.resize(i + 1);
+    return &inputs_[i];
+  }
+  const Tensor* GetOutput(size_t i) { return &output_; }
+  void BindOutput(size_t i,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target,
+                  const std::shared_ptr<void>& holder) {}
+  void Run() {
+    runs.push_back(inputs_[0].dims());
+    output_.Resize(inputs_[0].dims());
+    auto* out = output_.mutable_data<float>();
+    for (int64_t i = 0; i < inputs_[0].numel(); i++) {
+      out[i] = inputs_[0].data<float>()[i] * 2;
+    }
+  }
+
+  std::vector<DDim> runs;
+
+ private:
+  std::vector<Tensor> inputs_;
+  Tensor output_;
+};
+
+TEST(ShapeBuckets, runner) {
+  FakePredictor predictor;
+  ShapeBucketRunner<FakePredictor> runner(
+      &predictor, {{{1, 4}}, {{1, 8}}}, true);
+  EXPECT_TRUE(predictor.runs.empty());
+
+  auto run = [&](int64_t len) {
+    auto* x = predictor.GetInput(0);
+    x->Resize({1, len});
+    x->set_precision(PRECISION(kFloat));
+    auto* data = x->mutable_data<float>();
+    for (int64_t i = 0; i < len; i++) data[i] = i + 1;
+    runner.Run();
+    return runner.GetOutput(0);
+  };
+
+  // In the plan of the bucket, the input is moved back after the run.
+  auto* out = run(8);
+  EXPECT_EQ(out->dims(), DDim({1, 8}));
+  EXPECT_EQ(out->data<float>()[7], 16);
+  EXPECT_EQ(predictor.GetInput(0)->data<float>()[7], 8);
+  EXPECT_TRUE(predictor.runs.empty());
+
+  // Padded to the bucket.
+  out = run(3);
+  EXPECT_EQ(out->dims(), DDim({1, 4}));
+  EXPECT_EQ(out->data<float>()[2], 6);
+  EXPECT_EQ(out->data<float>()[3], 0);
+  EXPECT_TRUE(predictor.runs.empty());
+
+  // No bucket fits.
+  out = run(9);
+  ASSERT_EQ(predictor.runs.size(), 1UL);
+  EXPECT_EQ(out->dims(), DDim({1, 9}));
+  EXPECT_EQ(out->data<float>()[8], 18);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -78,6 +78,21 @@ void TensorLite::ShareDataWith(const TensorLite &other) {
   throw - 1;
 }
 
+void TensorLite::ShareExternalMemory(void *data,
+                                     size_t memory_size,
+                                     TargetType target,
+                                     const std::shared_ptr<void> &holder) {
+  if (holder) {
+    buffer_.reset(new Buffer(data, target, memory_size),
+                  [holder](Buffer *x) { delete x; });
+  } else {
+    buffer_ = std::make_shared<Buffer>(data, target, memory_size);
+  }
+  memory_size_ = memory_size;
+  target_ = target;
+  offset_ = 0;
+}
+
 void *TensorLite::mutable_data(size_t memory_size) {
   memory_size_ = memory_size;
   buffer_->ResetLazy(target_, memory_size_);
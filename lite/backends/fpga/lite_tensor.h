@@ -152,6 +152,15 @@ class TensorLite {
   // Other share data to this.
   void ShareDataWith(const TensorLite &other);
 
+  // Let this tensor use an external memory region that it does not own, the
+  // memory must stay valid while the tensor uses it. If `holder` is set, it
+  // is kept alive as long as the memory is used by this tensor or the tensors
+  // sharing data with it.
+  void ShareExternalMemory(void *data,
+                           size_t memory_size,
+                           TargetType target,
+                           const std::shared_ptr<void> &holder = nullptr);
+
   void CopyDataFrom(const TensorLite &other);
 
   template <typename T>
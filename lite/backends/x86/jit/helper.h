@@ -23,6 +23,7 @@
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernel_key.h"
 #include "lite/backends/x86/jit/kernel_pool.h"
+#include "lite/backends/x86/jit/tuning.h"
 #include "lite/utils/paddle_enforce.h"
 
 namespace paddle {
@@ -173,6 +174,49 @@ typename KernelTuple::func_type GetDefaultBestFunc(
   return funcs[0];
 }
 
+// The candidate tuned for this CPU by KernelTuningTable. The candidates not
+// in the table are timed if the tuning is enabled, otherwise it is the
+// default best one.
+template <typename KernelTuple, typename PlaceType = lite::fluid::CPUPlace>
+typename KernelTuple::func_type GetTunedBestFunc(
+    const typename KernelTuple::attr_type& attr) {
+  auto& table = KernelTuningTable::Global();
+  bool enabled = table.enabled();
+  if (!enabled && table.empty()) {
+    return GetDefaultBestFunc<KernelTuple, PlaceType>(attr);
+  }
+  auto funcs = GetAllCandidateFuncsWithTypes<KernelTuple, PlaceType>(attr);
+  PADDLE_ENFORCE_GE(funcs.size(), 1UL);
+  if (funcs.size() == 1) {
+    return funcs[0].second;
+  }
+  std::string kernel = TuningKernelName<KernelTuple>();
+  int64_t key = JitCodeKey<typename KernelTuple::attr_type>(attr);
+  std::string impl;
+  if (table.Find(kernel, key, &impl)) {
+    for (auto& func : funcs) {
+      if (func.first == impl) return func.second;
+    }
+  }
+  if (!enabled || !CandidateRunner<KernelTuple>::kTimeable) {
+    return funcs[0].second;
+  }
+  CandidateRunner<KernelTuple> runner(attr);
+  size_t best = 0;
+  double best_time = 0;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    double time = TimeCandidate<KernelTuple>(&runner, funcs[i].second);
+    VLOG(4) << kernel << " " << attr << ": " << funcs[i].first << " " << time
+            << "us";
+    if (i == 0 || time < best_time) {
+      best = i;
+      best_time = time;
+    }
+  }
+  table.Record(kernel, key, funcs[best].first);
+  return funcs[best].second;
+}
+
 template <typename KernelTuple, typename PlaceType>
 class KernelFuncs {
  public:
@@ -190,8 +234,9 @@ class KernelFuncs {
     if (Has(key)) {
       return funcs_.at(key);
     }
-    // If do not have this attr in cache then get the default best
-    auto func = GetDefaultBestFunc<KernelTuple, PlaceType>(attr);
+    // If do not have this attr in cache then get the tuned or the default
+    // best
+    auto func = GetTunedBestFunc<KernelTuple, PlaceType>(attr);
     Insert(key, func);
     return func;
   }
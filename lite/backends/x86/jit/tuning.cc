@@ -0,0 +1,139 @@
+/* Copyright (c) 2018 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "lite/backends/x86/jit/tuning.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace jit {
+
+static std::string TuningKey(const std::string& kernel, int64_t key) {
+  return kernel + " " + std::to_string(key);
+}
+
+KernelTuningTable& KernelTuningTable::Global() {
+  static KernelTuningTable x;
+  return x;
+}
+
+KernelTuningTable::KernelTuningTable() {
+  const char* enabled = std::getenv("LITE_JIT_TUNING");
+  enabled_ = enabled && std::atoi(enabled) != 0;
+  const char* file = std::getenv("LITE_JIT_TUNING_FILE");
+  if (file && *file) {
+    file_ = file;
+    std::ifstream in(file_);
+    if (in.good()) {
+      in.close();
+      Load(file_);
+    }
+  }
+}
+
+KernelTuningTable::~KernelTuningTable() {
+  if (dirty_ && !file_.empty()) {
+    Save(file_);
+  }
+}
+
+bool KernelTuningTable::enabled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return enabled_;
+}
+
+void KernelTuningTable::set_enabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = enabled;
+}
+
+bool KernelTuningTable::empty() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return impls_.empty();
+}
+
+size_t KernelTuningTable::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return impls_.size();
+}
+
+bool KernelTuningTable::Find(const std::string& kernel,
+                             int64_t key,
+                             std::string* impl) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = impls_.find(TuningKey(kernel, key));
+  if (it == impls_.end()) return false;
+  *impl = it->second;
+  return true;
+}
+
+void KernelTuningTable::Record(const std::string& kernel,
+                               int64_t key,
+                               const std::string& impl) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  impls_[TuningKey(kernel, key)] = impl;
+  dirty_ = true;
+}
+
+void KernelTuningTable::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  impls_.clear();
+  dirty_ = false;
+}
+
+bool KernelTuningTable::Load(const std::string& path) {
+  std::ifstream in(path);
+  if (!in.good()) {
+    LOG(WARNING) << "Failed to open the jit tuning file " << path;
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string line;
+  int line_no = 0;
+  while (std::getline(in, line)) {
+    line_no++;
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string kernel, impl;
+    int64_t key;
+    if (!(fields >> kernel >> key >> impl)) {
+      LOG(WARNING) << "Bad line " << line_no << " of the jit tuning file "
+                   << path << ": " << line;
+      continue;
+    }
+    impls_[TuningKey(kernel, key)] = impl;
+  }
+  return true;
+}
+
+bool KernelTuningTable::Save(const std::string& path) const {
+  std::ofstream out(path);
+  if (!out.good()) {
+    LOG(WARNING) << "Failed to write the jit tuning file " << path;
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  out << "# <kernel> <attr key> <implementation>\n";
+  for (auto& item : impls_) {
+    out << item.first << " " << item.second << "\n";
+  }
+  return out.good();
+}
+
+}  // namespace jit
+}  // namespace lite
+}  // namespace paddle
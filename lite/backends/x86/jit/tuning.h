@@ -0,0 +1,233 @@
+/* Copyright (c) 2018 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "lite/backends/x86/jit/kernel_base.h"
+
+namespace paddle {
+namespace lite {
+namespace jit {
+
+// The implementations of the jit kernels picked by timing all the candidates
+// on this CPU, keyed by the kernel, the data type and the key of the attr.
+//
+// The timing is off by default, set the env LITE_JIT_TUNING=1 or call
+// set_enabled(true) to time the candidates on the first use of every attr.
+// If the env LITE_JIT_TUNING_FILE is set, the table is loaded from the file
+// when it exists, and the choices timed by this process are saved back to it
+// at exit, so a table tuned once can be shipped with the model to the
+// machines of the same CPU. The loaded choices are used even when the timing
+// is off.
+class KernelTuningTable {
+ public:
+  static KernelTuningTable& Global();
+
+  bool enabled() const;
+  void set_enabled(bool enabled);
+  bool empty() const;
+  size_t size() const;
+
+  // The implementation type, e.g. "JitCode" or "MKL", tuned for the kernel.
+  bool Find(const std::string& kernel, int64_t key, std::string* impl) const;
+  void Record(const std::string& kernel,
+              int64_t key,
+              const std::string& impl);
+  void Clear();
+
+  // One "<kernel> <key> <impl>" a line, the records of the file override the
+  // ones in the table.
+  bool Load(const std::string& path);
+  bool Save(const std::string& path) const;
+
+  ~KernelTuningTable();
+
+ private:
+  KernelTuningTable();
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::string> impls_;
+  bool enabled_{false};
+  // Save the new records to the file at exit.
+  std::string file_;
+  bool dirty_{false};
+};
+
+const char* to_string(KernelType kt);
+
+// The name of the kernel in the tuning table, e.g. "kVAdd/fp32".
+template <typename KernelTuple>
+std::string TuningKernelName() {
+  return std::string(to_string(KernelTuple::kernel_type)) +
+         (sizeof(typename KernelTuple::data_type) == 4 ? "/fp32" : "/fp64");
+}
+
+// Runs the candidates of a kernel on the buffers sized by the attr for the
+// timing. Only the kernels whose candidates take the same arguments are
+// timed, the jit code of MatMul for example takes the packed weights, the
+// others keep the default best candidate.
+template <typename KernelTuple, typename Enable = void>
+class CandidateRunner {
+ public:
+  static constexpr bool kTimeable = false;
+  explicit CandidateRunner(const typename KernelTuple::attr_type& attr) {}
+  void Run(typename KernelTuple::func_type func) {}
+};
+
+template <typename KernelTuple>
+class CandidateRunner<
+    KernelTuple,
+    typename std::enable_if<std::is_base_of<
+        XYZNTuple<typename KernelTuple::data_type>,
+        KernelTuple>::value>::type> {
+  using T = typename KernelTuple::data_type;
+
+ public:
+  static constexpr bool kTimeable = true;
+  explicit CandidateRunner(int n)
+      : n_(n), x_(Size(n), 0.5), y_(Size(n), 0.25), z_(Size(n)) {}
+  void Run(typename KernelTuple::func_type func) {
+    func(x_.data(), y_.data(), z_.data(), n_);
+  }
+
+ private:
+  static size_t Size(int n) { return n > 1 ? n : 1; }
+  int n_;
+  std::vector<T> x_, y_, z_;
+};
+
+template <typename KernelTuple>
+class CandidateRunner<
+    KernelTuple,
+    typename std::enable_if<std::is_base_of<
+        XYNTuple<typename KernelTuple::data_type>,
+        KernelTuple>::value>::type> {
+  using T = typename KernelTuple::data_type;
+
+ public:
+  static constexpr bool kTimeable = true;
+  explicit CandidateRunner(int n)
+      : n_(n), x_(n > 1 ? n : 1, 0.5), y_(n > 1 ? n : 1) {}
+  void Run(typename KernelTuple::func_type func) {
+    func(x_.data(), y_.data(), n_);
+  }
+
+ private:
+  int n_;
+  std::vector<T> x_, y_;
+};
+
+template <typename KernelTuple>
+class CandidateRunner<
+    KernelTuple,
+    typename std::enable_if<
+        std::is_base_of<GRUTuple<typename KernelTuple::data_type>,
+                        KernelTuple>::value>::type> {
+  using T = typename KernelTuple::data_type;
+
+ public:
+  static constexpr bool kTimeable = true;
+  explicit CandidateRunner(const gru_attr_t& attr)
+      : attr_(attr),
+        gates_(attr.d * 3, 0.5),
+        ht_1_(attr.d, 0.5),
+        ht_(attr.d) {}
+  void Run(typename KernelTuple::func_type func) {
+    gru_t step;
+    step.gates = gates_.data();
+    step.ht_1 = ht_1_.data();
+    step.ht = ht_.data();
+    func(&step, &attr_);
+  }
+
+ private:
+  gru_attr_t attr_;
+  std::vector<T> gates_, ht_1_, ht_;
+};
+
+template <typename T>
+class CandidateRunner<SeqPoolTuple<T>> {
+ public:
+  static constexpr bool kTimeable = true;
+  explicit CandidateRunner(const seq_pool_attr_t& attr)
+      : attr_(attr), x_((attr.h > 1 ? attr.h : 1) * attr.w, 0.5), y_(attr.w) {}
+  void Run(typename SeqPoolTuple<T>::func_type func) {
+    func(x_.data(), y_.data(), &attr_);
+  }
+
+ private:
+  seq_pool_attr_t attr_;
+  std::vector<T> x_, y_;
+};
+
+template <typename T>
+class CandidateRunner<EmbSeqPoolTuple<T>> {
+ public:
+  static constexpr bool kTimeable = true;
+  // All the ids look up the first row.
+  explicit CandidateRunner(const emb_seq_pool_attr_t& attr)
+      : attr_(attr),
+        table_(attr.table_height * attr.table_width, 0.5),
+        idx_(attr.index_height * attr.index_width, 0),
+        out_(attr.out_width) {}
+  void Run(typename EmbSeqPoolTuple<T>::func_type func) {
+    func(table_.data(), idx_.data(), out_.data(), &attr_);
+  }
+
+ private:
+  emb_seq_pool_attr_t attr_;
+  std::vector<T> table_;
+  std::vector<int64_t> idx_;
+  std::vector<T> out_;
+};
+
+// The time in microseconds of a run of the function, the min of several
+// batches of runs.
+template <typename KernelTuple>
+double TimeCandidate(CandidateRunner<KernelTuple>* runner,
+                     typename KernelTuple::func_type func) {
+  using clock = std::chrono::steady_clock;
+  auto elapsed_us = [](clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(clock::now() - start)
+        .count();
+  };
+  // Warm up, and size a batch to about 20us to hide the clock overhead.
+  runner->Run(func);
+  auto start = clock::now();
+  runner->Run(func);
+  double once = elapsed_us(start);
+  int repeat = once > 0 ? static_cast<int>(20. / once) : 1000;
+  repeat = std::max(1, std::min(repeat, 1000));
+  double best = once;
+  for (int batch = 0; batch < 5; batch++) {
+    start = clock::now();
+    for (int i = 0; i < repeat; i++) {
+      runner->Run(func);
+    }
+    best = std::min(best, elapsed_us(start) / repeat);
+  }
+  return best;
+}
+
+}  // namespace jit
+}  // namespace lite
+}  // namespace paddle
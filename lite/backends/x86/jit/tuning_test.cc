@@ -0,0 +1,107 @@
+/* Copyright (c) 2018 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "lite/backends/x86/jit/tuning.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "lite/backends/x86/jit/kernels.h"
+
+namespace paddle {
+namespace lite {
+namespace jit {
+
+TEST(jit_tuning, pick_candidates) {
+  auto& table = KernelTuningTable::Global();
+  table.Clear();
+  table.set_enabled(true);
+
+  const int n = 37;
+  std::vector<float> x(n), y(n), z(n);
+  for (int i = 0; i < n; i++) {
+    x[i] = i * 0.1f;
+    y[i] = 1.f - i * 0.05f;
+  }
+  auto vadd =
+      KernelFuncs<VAddTuple<float>, lite::fluid::CPUPlace>::Cache().At(n);
+  vadd(x.data(), y.data(), z.data(), n);
+  for (int i = 0; i < n; i++) {
+    EXPECT_NEAR(z[i], x[i] + y[i], 1e-6);
+  }
+
+  seq_pool_attr_t attr(n, SeqPoolType::kAvg, 3);
+  std::vector<float> src(3 * n, 0.5f), dst(n);
+  auto seqpool =
+      KernelFuncs<SeqPoolTuple<float>, lite::fluid::CPUPlace>::Cache().At(attr);
+  seqpool(src.data(), dst.data(), &attr);
+  for (int i = 0; i < n; i++) {
+    EXPECT_NEAR(dst[i], 0.5f, 1e-6);
+  }
+
+  // The choices of the kernels having several candidates are recorded.
+  std::string impl;
+  EXPECT_EQ(table.Find(TuningKernelName<VAddTuple<float>>(), n, &impl),
+            GetAllCandidateFuncs<VAddTuple<float>>(n).size() > 1);
+  EXPECT_EQ(table.Find(TuningKernelName<SeqPoolTuple<float>>(),
+                       JitCodeKey<seq_pool_attr_t>(attr),
+                       &impl),
+            GetAllCandidateFuncs<SeqPoolTuple<float>>(attr).size() > 1);
+  table.set_enabled(false);
+}
+
+TEST(jit_tuning, time_candidates) {
+  CandidateRunner<VMulTuple<float>> vmul(64);
+  EXPECT_GE(TimeCandidate(&vmul, GetReferFunc<VMulTuple<float>>()), 0.);
+  CandidateRunner<VSigmoidTuple<float>> sigmoid(64);
+  EXPECT_GE(TimeCandidate(&sigmoid, GetReferFunc<VSigmoidTuple<float>>()), 0.);
+  gru_attr_t gru_attr(16, kVSigmoid, kVTanh);
+  CandidateRunner<GRUHtPart2Tuple<float>> gru(gru_attr);
+  EXPECT_GE(TimeCandidate(&gru, GetReferFunc<GRUHtPart2Tuple<float>>()), 0.);
+  CandidateRunner<EmbSeqPoolTuple<float>> emb(
+      emb_seq_pool_attr_t(10, 8, 4, 1, 8, kSum));
+  EXPECT_GE(TimeCandidate(&emb, GetReferFunc<EmbSeqPoolTuple<float>>()), 0.);
+  EXPECT_FALSE(CandidateRunner<MatMulTuple<float>>::kTimeable);
+}
+
+TEST(jit_tuning, save_load) {
+  auto& table = KernelTuningTable::Global();
+  table.Clear();
+  table.Record("kVAdd/fp32", 8, "Refer");
+  table.Record("kVMul/fp32", 16, "JitCode");
+  std::string path = "jit_tuning_test.txt";
+  ASSERT_TRUE(table.Save(path));
+
+  table.Clear();
+  ASSERT_TRUE(table.empty());
+  ASSERT_TRUE(table.Load(path));
+  EXPECT_EQ(table.size(), 2UL);
+  std::string impl;
+  ASSERT_TRUE(table.Find("kVMul/fp32", 16, &impl));
+  EXPECT_EQ(impl, "JitCode");
+  EXPECT_FALSE(table.Find("kVMul/fp32", 8, &impl));
+
+  // A loaded choice is used without the timing.
+  table.Clear();
+  table.Record(TuningKernelName<VReluTuple<float>>(), 29, "Refer");
+  auto relu =
+      KernelFuncs<VReluTuple<float>, lite::fluid::CPUPlace>::Cache().At(29);
+  EXPECT_EQ(relu, GetReferFunc<VReluTuple<float>>());
+  table.Clear();
+  std::remove(path.c_str());
+}
+
+}  // namespace jit
+}  // namespace lite
+}  // namespace paddle
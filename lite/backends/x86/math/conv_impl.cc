@@ -0,0 +1,309 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_impl.h"
+#include <algorithm>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include "lite/backends/x86/math/blas.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The output of a depthwise conv at (oh, ow), the input out of the image is
+// treated as zero.
+static inline float depthwise_point(const float* in,
+                                    const float* w,
+                                    int hin,
+                                    int win,
+                                    int kh,
+                                    int kw,
+                                    int ih0,
+                                    int iw0) {
+  float sum = 0.f;
+  for (int i = 0; i < kh; ++i) {
+    int ih = ih0 + i;
+    if (ih < 0 || ih >= hin) continue;
+    for (int j = 0; j < kw; ++j) {
+      int iw = iw0 + j;
+      if (iw < 0 || iw >= win) continue;
+      sum += in[ih * win + iw] * w[i * kw + j];
+    }
+  }
+  return sum;
+}
+
+void conv_depthwise_fp32(const float* din,
+                         float* dout,
+                         int num,
+                         int ch,
+                         int hout,
+                         int wout,
+                         int hin,
+                         int win,
+                         const float* weights,
+                         const float* bias,
+                         const operators::ConvParam& param,
+                         const X86Context& ctx) {
+  int kh = param.filter->dims()[2];
+  int kw = param.filter->dims()[3];
+  int sh = param.strides[0];
+  int sw = param.strides[1];
+  int ph = param.paddings[0];
+  int pw = param.paddings[1];
+
+  // The output columns [ow_begin, ow_end) do not read the left and right
+  // paddings, so they skip the bound checks of the columns.
+  int ow_begin = std::min(wout, (pw + sw - 1) / sw);
+  int right = win - kw + pw;
+  int ow_end = right < 0 ? 0 : std::min(wout, right / sw + 1);
+  ow_end = std::max(ow_end, ow_begin);
+
+  ctx.ParallelFor(num * ch, [&](int plane, int tid) {
+    const float* in = din + plane * hin * win;
+    float* out = dout + plane * hout * wout;
+    int c = plane % ch;
+    const float* w = weights + c * kh * kw;
+    float b = bias ? bias[c] : 0.f;
+    for (int oh = 0; oh < hout; ++oh) {
+      int ih0 = oh * sh - ph;
+      int i_begin = std::max(0, -ih0);
+      int i_end = std::min(kh, hin - ih0);
+      float* out_row = out + oh * wout;
+      for (int ow = 0; ow < ow_begin; ++ow) {
+        out_row[ow] =
+            b + depthwise_point(in, w, hin, win, kh, kw, ih0, ow * sw - pw);
+      }
+      int ow = ow_begin;
+#ifdef __AVX__
+      if (sw == 1) {
+        for (; ow + 8 <= ow_end; ow += 8) {
+          __m256 acc = _mm256_set1_ps(b);
+          for (int i = i_begin; i < i_end; ++i) {
+            const float* in_row = in + (ih0 + i) * win + ow - pw;
+            const float* w_row = w + i * kw;
+            for (int j = 0; j < kw; ++j) {
+              acc = _mm256_add_ps(
+                  acc,
+                  _mm256_mul_ps(_mm256_set1_ps(w_row[j]),
+                                _mm256_loadu_ps(in_row + j)));
+            }
+          }
+          _mm256_storeu_ps(out_row + ow, acc);
+        }
+      }
+#endif
+      for (; ow < ow_end; ++ow) {
+        float sum = b;
+        for (int i = i_begin; i < i_end; ++i) {
+          const float* in_row = in + (ih0 + i) * win + ow * sw - pw;
+          const float* w_row = w + i * kw;
+          for (int j = 0; j < kw; ++j) {
+            sum += in_row[j] * w_row[j];
+          }
+        }
+        out_row[ow] = sum;
+      }
+      for (ow = ow_end; ow < wout; ++ow) {
+        out_row[ow] =
+            b + depthwise_point(in, w, hin, win, kh, kw, ih0, ow * sw - pw);
+      }
+    }
+  });
+}
+
+int winograd3x3_weights_size(int chout, int chin) { return 16 * chout * chin; }
+
+void winograd3x3_transform_weights(float* dout,
+                                   const float* din,
+                                   int chout,
+                                   int chin) {
+  // U = G * g * G^T, G = [1, 0, 0; 1/2, 1/2, 1/2; 1/2, -1/2, 1/2; 0, 0, 1]
+  int stride = chout * chin;
+  for (int o = 0; o < chout; ++o) {
+    for (int i = 0; i < chin; ++i) {
+      const float* g = din + (o * chin + i) * 9;
+      float t[4][3];
+      for (int c = 0; c < 3; ++c) {
+        t[0][c] = g[c];
+        t[1][c] = 0.5f * (g[c] + g[3 + c] + g[6 + c]);
+        t[2][c] = 0.5f * (g[c] - g[3 + c] + g[6 + c]);
+        t[3][c] = g[6 + c];
+      }
+      float* u = dout + o * chin + i;
+      for (int r = 0; r < 4; ++r) {
+        u[(r * 4 + 0) * stride] = t[r][0];
+        u[(r * 4 + 1) * stride] = 0.5f * (t[r][0] + t[r][1] + t[r][2]);
+        u[(r * 4 + 2) * stride] = 0.5f * (t[r][0] - t[r][1] + t[r][2]);
+        u[(r * 4 + 3) * stride] = t[r][2];
+      }
+    }
+  }
+}
+
+int winograd3x3_workspace_size(int chout, int chin, int hout, int wout) {
+  int tiles = ((hout + 1) / 2) * ((wout + 1) / 2);
+  return 16 * tiles * (chin + chout);
+}
+
+void conv_winograd3x3_fp32(const float* din,
+                           float* dout,
+                           int num,
+                           int chout,
+                           int hout,
+                           int wout,
+                           int chin,
+                           int hin,
+                           int win,
+                           const float* weights,
+                           const float* bias,
+                           const operators::ConvParam& param,
+                           float* workspace,
+                           const X86Context& ctx) {
+  int ph = param.paddings[0];
+  int pw = param.paddings[1];
+  int tiles_h = (hout + 1) / 2;
+  int tiles_w = (wout + 1) / 2;
+  int tiles = tiles_h * tiles_w;
+  // V: 16 matrices of [chin, tiles], M: 16 matrices of [chout, tiles].
+  float* v_data = workspace;
+  float* m_data = workspace + 16 * chin * tiles;
+  auto blas = GetBlas<lite::TargetType::kX86, float>(ctx);
+
+  for (int n = 0; n < num; ++n) {
+    // V = B^T * d * B, B^T = [1, 0, -1, 0; 0, 1, 1, 0; 0, -1, 1, 0;
+    // 0, 1, 0, -1]
+    ctx.ParallelFor(chin, [&](int ic, int tid) {
+      const float* in = din + (n * chin + ic) * hin * win;
+      float* v = v_data + ic * tiles;
+      for (int th = 0; th < tiles_h; ++th) {
+        for (int tw = 0; tw < tiles_w; ++tw) {
+          int ih0 = th * 2 - ph;
+          int iw0 = tw * 2 - pw;
+          float d[4][4];
+          for (int r = 0; r < 4; ++r) {
+            int ih = ih0 + r;
+            for (int c = 0; c < 4; ++c) {
+              int iw = iw0 + c;
+              d[r][c] = (ih >= 0 && ih < hin && iw >= 0 && iw < win)
+                            ? in[ih * win + iw]
+                            : 0.f;
+            }
+          }
+          float t[4][4];
+          for (int c = 0; c < 4; ++c) {
+            t[0][c] = d[0][c] - d[2][c];
+            t[1][c] = d[1][c] + d[2][c];
+            t[2][c] = d[2][c] - d[1][c];
+            t[3][c] = d[1][c] - d[3][c];
+          }
+          int stride = chin * tiles;
+          float* vt = v + th * tiles_w + tw;
+          for (int r = 0; r < 4; ++r) {
+            vt[(r * 4 + 0) * stride] = t[r][0] - t[r][2];
+            vt[(r * 4 + 1) * stride] = t[r][1] + t[r][2];
+            vt[(r * 4 + 2) * stride] = t[r][2] - t[r][1];
+            vt[(r * 4 + 3) * stride] = t[r][1] - t[r][3];
+          }
+        }
+      }
+    });
+
+    // M = U * V for every element of the tiles.
+    ctx.ParallelFor(16, [&](int k, int tid) {
+      blas.GEMM(CblasNoTrans,
+                CblasNoTrans,
+                chout,
+                tiles,
+                chin,
+                1.f,
+                weights + k * chout * chin,
+                v_data + k * chin * tiles,
+                0.f,
+                m_data + k * chout * tiles);
+    });
+
+    // Y = A^T * M * A, A^T = [1, 1, 1, 0; 0, 1, -1, -1]
+    ctx.ParallelFor(chout, [&](int oc, int tid) {
+      float* out = dout + (n * chout + oc) * hout * wout;
+      const float* m = m_data + oc * tiles;
+      float b = bias ? bias[oc] : 0.f;
+      int stride = chout * tiles;
+      for (int th = 0; th < tiles_h; ++th) {
+        for (int tw = 0; tw < tiles_w; ++tw) {
+          const float* mt = m + th * tiles_w + tw;
+          float t[2][4];
+          for (int c = 0; c < 4; ++c) {
+            float m0 = mt[c * stride];
+            float m1 = mt[(4 + c) * stride];
+            float m2 = mt[(8 + c) * stride];
+            float m3 = mt[(12 + c) * stride];
+            t[0][c] = m0 + m1 + m2;
+            t[1][c] = m1 - m2 - m3;
+          }
+          int oh = th * 2;
+          int ow = tw * 2;
+          for (int r = 0; r < 2 && oh + r < hout; ++r) {
+            float* out_row = out + (oh + r) * wout + ow;
+            out_row[0] = b + t[r][0] + t[r][1] + t[r][2];
+            if (ow + 1 < wout) {
+              out_row[1] = b + t[r][1] - t[r][2] - t[r][3];
+            }
+          }
+        }
+      }
+    });
+  }
+}
+
+void conv_fill_bias_act(float* dout,
+                        int num,
+                        int ch,
+                        int size,
+                        const float* bias,
+                        const operators::ActivationParam& act_param) {
+  bool has_act = act_param.has_active;
+  auto act_type = act_param.active_type;
+  if (has_act && act_type != lite_api::ActivationType::kRelu &&
+      act_type != lite_api::ActivationType::kLeakyRelu) {
+    LOG(FATAL) << "unsupported fused activation of conv: "
+               << static_cast<int>(act_type);
+  }
+  if (!bias && !has_act) return;
+  float alpha = act_type == lite_api::ActivationType::kLeakyRelu
+                    ? act_param.Leaky_relu_alpha
+                    : 0.f;
+  for (int n = 0; n < num; ++n) {
+    for (int c = 0; c < ch; ++c) {
+      float* out = dout + (n * ch + c) * size;
+      float b = bias ? bias[c] : 0.f;
+      if (!has_act) {
+        for (int i = 0; i < size; ++i) out[i] += b;
+      } else {
+        for (int i = 0; i < size; ++i) {
+          float x = out[i] + b;
+          out[i] = x > 0.f ? x : alpha * x;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
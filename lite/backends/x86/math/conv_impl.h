@@ -0,0 +1,78 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/core/context.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The convs run the loops over the channels with the threads of `ctx`.
+
+/// depthwise conv of any kernel size and stride, without dilation
+void conv_depthwise_fp32(const float* din,
+                         float* dout,
+                         int num,
+                         int ch,
+                         int hout,
+                         int wout,
+                         int hin,
+                         int win,
+                         const float* weights,
+                         const float* bias,
+                         const operators::ConvParam& param,
+                         const X86Context& ctx);
+
+/// winograd F(2x2, 3x3) conv, only support 3x3s1 without dilation
+// The size in floats of the transformed weights.
+int winograd3x3_weights_size(int chout, int chin);
+// Transform the oihw weights into 16 matrices of [chout, chin].
+void winograd3x3_transform_weights(float* dout,
+                                   const float* din,
+                                   int chout,
+                                   int chin);
+// The size in floats of the workspace of a batch item.
+int winograd3x3_workspace_size(int chout, int chin, int hout, int wout);
+void conv_winograd3x3_fp32(const float* din,
+                           float* dout,
+                           int num,
+                           int chout,
+                           int hout,
+                           int wout,
+                           int chin,
+                           int hin,
+                           int win,
+                           const float* weights,
+                           const float* bias,
+                           const operators::ConvParam& param,
+                           float* workspace,
+                           const X86Context& ctx);
+
+// Add the bias of each channel and apply the fused activation, relu and
+// leaky relu are supported. `bias` can be null.
+void conv_fill_bias_act(float* dout,
+                        int num,
+                        int ch,
+                        int size,
+                        const float* bias,
+                        const operators::ActivationParam& act_param);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,388 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/elementwise.h"
+#include <algorithm>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The vector of floats of the widest instruction set the file is built with.
+#if defined(__AVX512F__)
+#define ELEMENTWISE_WITH_VEC
+typedef __m512 vec_t;
+constexpr int kLanes = 16;
+inline vec_t VLoad(const float* p) { return _mm512_loadu_ps(p); }
+inline void VStore(float* p, vec_t v) { _mm512_storeu_ps(p, v); }
+inline vec_t VSet1(float v) { return _mm512_set1_ps(v); }
+inline vec_t VAdd(vec_t a, vec_t b) { return _mm512_add_ps(a, b); }
+inline vec_t VSub(vec_t a, vec_t b) { return _mm512_sub_ps(a, b); }
+inline vec_t VMul(vec_t a, vec_t b) { return _mm512_mul_ps(a, b); }
+inline vec_t VDiv(vec_t a, vec_t b) { return _mm512_div_ps(a, b); }
+inline vec_t VMax(vec_t a, vec_t b) { return _mm512_max_ps(a, b); }
+#elif defined(__AVX__)
+#define ELEMENTWISE_WITH_VEC
+typedef __m256 vec_t;
+constexpr int kLanes = 8;
+inline vec_t VLoad(const float* p) { return _mm256_loadu_ps(p); }
+inline void VStore(float* p, vec_t v) { _mm256_storeu_ps(p, v); }
+inline vec_t VSet1(float v) { return _mm256_set1_ps(v); }
+inline vec_t VAdd(vec_t a, vec_t b) { return _mm256_add_ps(a, b); }
+inline vec_t VSub(vec_t a, vec_t b) { return _mm256_sub_ps(a, b); }
+inline vec_t VMul(vec_t a, vec_t b) { return _mm256_mul_ps(a, b); }
+inline vec_t VDiv(vec_t a, vec_t b) { return _mm256_div_ps(a, b); }
+inline vec_t VMax(vec_t a, vec_t b) { return _mm256_max_ps(a, b); }
+#endif
+
+#ifdef ELEMENTWISE_WITH_VEC
+#define ELEMENTWISE_VEC_OP(expr) \
+  static vec_t RunVec(vec_t a, vec_t b) { return expr; }
+#else
+#define ELEMENTWISE_VEC_OP(expr)
+#endif
+
+template <ElementwiseType type>
+struct BinaryOp;
+
+template <>
+struct BinaryOp<ElementwiseType::kAdd> {
+  template <typename T>
+  static T Run(T a, T b) {
+    return a + b;
+  }
+  ELEMENTWISE_VEC_OP(VAdd(a, b))
+};
+
+template <>
+struct BinaryOp<ElementwiseType::kSub> {
+  template <typename T>
+  static T Run(T a, T b) {
+    return a - b;
+  }
+  ELEMENTWISE_VEC_OP(VSub(a, b))
+};
+
+template <>
+struct BinaryOp<ElementwiseType::kMul> {
+  template <typename T>
+  static T Run(T a, T b) {
+    return a * b;
+  }
+  ELEMENTWISE_VEC_OP(VMul(a, b))
+};
+
+template <>
+struct BinaryOp<ElementwiseType::kDiv> {
+  template <typename T>
+  static T Run(T a, T b) {
+    return a / b;
+  }
+  ELEMENTWISE_VEC_OP(VDiv(a, b))
+};
+
+template <>
+struct BinaryOp<ElementwiseType::kMax> {
+  template <typename T>
+  static T Run(T a, T b) {
+    return a > b ? a : b;
+  }
+  ELEMENTWISE_VEC_OP(VMax(a, b))
+};
+
+template <ElementwiseActType act>
+struct Activation;
+
+template <>
+struct Activation<ElementwiseActType::kNone> {
+  template <typename T>
+  static T Run(T v) {
+    return v;
+  }
+#ifdef ELEMENTWISE_WITH_VEC
+  static vec_t RunVec(vec_t v) { return v; }
+#endif
+};
+
+template <>
+struct Activation<ElementwiseActType::kRelu> {
+  template <typename T>
+  static T Run(T v) {
+    return v > T(0) ? v : T(0);
+  }
+#ifdef ELEMENTWISE_WITH_VEC
+  static vec_t RunVec(vec_t v) { return VMax(v, VSet1(0.f)); }
+#endif
+};
+
+// Compute a row of n elements of the output, x and y are rows of n elements
+// when x_row and y_row are set, or else scalars broadcast over the row.
+template <typename T, typename Op, typename Act>
+struct RowKernel {
+  static void Run(
+      const T* x, bool x_row, const T* y, bool y_row, T* out, int64_t n) {
+    if (x_row && y_row) {
+      for (int64_t i = 0; i < n; i++) out[i] = Act::Run(Op::Run(x[i], y[i]));
+    } else if (x_row) {
+      T b = *y;
+      for (int64_t i = 0; i < n; i++) out[i] = Act::Run(Op::Run(x[i], b));
+    } else if (y_row) {
+      T a = *x;
+      for (int64_t i = 0; i < n; i++) out[i] = Act::Run(Op::Run(a, y[i]));
+    } else {
+      T v = Act::Run(Op::Run(*x, *y));
+      for (int64_t i = 0; i < n; i++) out[i] = v;
+    }
+  }
+};
+
+#ifdef ELEMENTWISE_WITH_VEC
+template <typename Op, typename Act>
+struct RowKernel<float, Op, Act> {
+  static void Run(const float* x,
+                  bool x_row,
+                  const float* y,
+                  bool y_row,
+                  float* out,
+                  int64_t n) {
+    int64_t end = n - n % kLanes;
+    int64_t i = 0;
+    if (x_row && y_row) {
+      for (; i < end; i += kLanes) {
+        VStore(out + i, Act::RunVec(Op::RunVec(VLoad(x + i), VLoad(y + i))));
+      }
+    } else if (x_row) {
+      vec_t b = VSet1(*y);
+      for (; i < end; i += kLanes) {
+        VStore(out + i, Act::RunVec(Op::RunVec(VLoad(x + i), b)));
+      }
+    } else if (y_row) {
+      vec_t a = VSet1(*x);
+      for (; i < end; i += kLanes) {
+        VStore(out + i, Act::RunVec(Op::RunVec(a, VLoad(y + i))));
+      }
+    }
+    if (i < n) {
+      RunScalar(x_row ? x + i : x,
+                x_row,
+                y_row ? y + i : y,
+                y_row,
+                out + i,
+                n - i);
+    }
+  }
+
+  static void RunScalar(const float* x,
+                        bool x_row,
+                        const float* y,
+                        bool y_row,
+                        float* out,
+                        int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+      out[i] = Act::Run(Op::Run(x_row ? x[i] : *x, y_row ? y[i] : *y));
+    }
+  }
+};
+#endif
+
+template <typename T>
+using RowFn = void (*)(const T*, bool, const T*, bool, T*, int64_t);
+
+template <typename T, typename Act>
+RowFn<T> GetRowFn(ElementwiseType type) {
+  switch (type) {
+#define ELEMENTWISE_ROW_FN(type__) \
+  case ElementwiseType::type__:    \
+    return &RowKernel<T, BinaryOp<ElementwiseType::type__>, Act>::Run;
+    ELEMENTWISE_ROW_FN(kAdd)
+    ELEMENTWISE_ROW_FN(kSub)
+    ELEMENTWISE_ROW_FN(kMul)
+    ELEMENTWISE_ROW_FN(kDiv)
+    ELEMENTWISE_ROW_FN(kMax)
+#undef ELEMENTWISE_ROW_FN
+  }
+  LOG(FATAL) << "unsupported elementwise type " << static_cast<int>(type);
+  return nullptr;
+}
+
+template <typename T>
+RowFn<T> GetRowFn(ElementwiseType type, ElementwiseActType act) {
+  switch (act) {
+    case ElementwiseActType::kNone:
+      return GetRowFn<T, Activation<ElementwiseActType::kNone>>(type);
+    case ElementwiseActType::kRelu:
+      return GetRowFn<T, Activation<ElementwiseActType::kRelu>>(type);
+  }
+  LOG(FATAL) << "unsupported activation type " << static_cast<int>(act);
+  return nullptr;
+}
+
+// The rows are grouped into the tasks of about kGrainSize elements, so the
+// small tensors are computed in the calling thread.
+constexpr int64_t kGrainSize = 16384;
+
+}  // namespace
+
+ElementwisePlan::ElementwisePlan(const lite::DDim& x_dims,
+                                 const lite::DDim& y_dims,
+                                 int axis) {
+  bool swap = x_dims.size() < y_dims.size();
+  std::vector<int64_t> big = (swap ? y_dims : x_dims).Vectorize();
+  std::vector<int64_t> small = (swap ? x_dims : y_dims).Vectorize();
+  int rank = big.size();
+  if (axis == -1) axis = rank - small.size();
+  // The trailing dims of size 1 past the larger dims are dropped, as in
+  // fluid.
+  while (!small.empty() && axis + static_cast<int>(small.size()) > rank &&
+         small.back() == 1) {
+    small.pop_back();
+  }
+  CHECK(axis >= 0 && axis + static_cast<int>(small.size()) <= rank)
+      << "the dims " << x_dims << " and " << y_dims
+      << " of the elementwise op do not match at axis " << axis;
+  std::vector<int64_t> aligned(rank, 1);
+  std::copy(small.begin(), small.end(), aligned.begin() + axis);
+  const auto& xd = swap ? aligned : big;
+  const auto& yd = swap ? big : aligned;
+
+  std::vector<int64_t> out(rank);
+  std::vector<bool> x_bcast, y_bcast;
+  for (int i = 0; i < rank; i++) {
+    CHECK(xd[i] == yd[i] || xd[i] == 1 || yd[i] == 1)
+        << "the dims " << x_dims << " and " << y_dims
+        << " of the elementwise op do not match at axis " << axis;
+    out[i] = xd[i] == 1 ? yd[i] : xd[i];
+    if (out[i] == 1) continue;
+    bool xb = xd[i] == 1;
+    bool yb = yd[i] == 1;
+    if (!dims.empty() && xb == x_bcast.back() && yb == y_bcast.back()) {
+      dims.back() *= out[i];
+    } else {
+      dims.push_back(out[i]);
+      x_bcast.push_back(xb);
+      y_bcast.push_back(yb);
+    }
+  }
+  out_dims = lite::DDim(out);
+  if (dims.empty()) {
+    dims.push_back(1);
+    x_bcast.push_back(false);
+    y_bcast.push_back(false);
+  }
+
+  int n = dims.size();
+  x_strides.resize(n);
+  y_strides.resize(n);
+  int64_t x_stride = 1;
+  int64_t y_stride = 1;
+  for (int i = n - 1; i >= 0; i--) {
+    x_strides[i] = x_bcast[i] ? 0 : x_stride;
+    y_strides[i] = y_bcast[i] ? 0 : y_stride;
+    if (!x_bcast[i]) x_stride *= dims[i];
+    if (!y_bcast[i]) y_stride *= dims[i];
+  }
+}
+
+int64_t ElementwisePlan::numel() const {
+  int64_t n = 1;
+  for (auto d : dims) n *= d;
+  return n;
+}
+
+template <typename T>
+void Elementwise(const lite::X86Context& ctx,
+                 ElementwiseType type,
+                 ElementwiseActType act,
+                 const lite::Tensor& x,
+                 const lite::Tensor& y,
+                 int axis,
+                 lite::Tensor* out) {
+  ElementwisePlan plan(x.dims(), y.dims(), axis);
+  int64_t numel = plan.numel();
+  CHECK_EQ(out->numel(), numel) << "the output of the elementwise op is "
+                                << out->dims() << ", expected "
+                                << plan.out_dims;
+  if (numel == 0) return;
+  const T* x_data = x.data<T>();
+  const T* y_data = y.data<T>();
+  T* out_data = out->mutable_data<T>();
+  RowFn<T> row_fn = GetRowFn<T>(type, act);
+
+  // The last dim is the rows, the others are walked with the strides.
+  const auto& dims = plan.dims;
+  const auto& x_strides = plan.x_strides;
+  const auto& y_strides = plan.y_strides;
+  int outer = dims.size() - 1;
+  int64_t n = dims.back();
+  bool x_row = x_strides.back() != 0;
+  bool y_row = y_strides.back() != 0;
+  int64_t rows = numel / n;
+  int64_t rows_per_task = std::max<int64_t>(1, kGrainSize / n);
+  int tasks = static_cast<int>((rows + rows_per_task - 1) / rows_per_task);
+  ctx.ParallelFor(tasks, [&](int task, int tid) {
+    int64_t begin = task * rows_per_task;
+    int64_t end = std::min(rows, begin + rows_per_task);
+    // The index of the row in the outer dims, and its offsets in x and y.
+    std::vector<int64_t> index(outer);
+    int64_t x_offset = 0;
+    int64_t y_offset = 0;
+    int64_t rest = begin;
+    for (int d = outer - 1; d >= 0; d--) {
+      index[d] = rest % dims[d];
+      rest /= dims[d];
+      x_offset += index[d] * x_strides[d];
+      y_offset += index[d] * y_strides[d];
+    }
+    for (int64_t r = begin; r < end; r++) {
+      row_fn(x_data + x_offset,
+             x_row,
+             y_data + y_offset,
+             y_row,
+             out_data + r * n,
+             n);
+      for (int d = outer - 1; d >= 0; d--) {
+        x_offset += x_strides[d];
+        y_offset += y_strides[d];
+        if (++index[d] < dims[d]) break;
+        x_offset -= x_strides[d] * dims[d];
+        y_offset -= y_strides[d] * dims[d];
+        index[d] = 0;
+      }
+    }
+  });
+}
+
+#define INSTANTIATE_ELEMENTWISE(T)                              \
+  template void Elementwise<T>(const lite::X86Context& ctx,     \
+                               ElementwiseType type,            \
+                               ElementwiseActType act,          \
+                               const lite::Tensor& x,           \
+                               const lite::Tensor& y,           \
+                               int axis,                        \
+                               lite::Tensor* out);
+
+INSTANTIATE_ELEMENTWISE(float)
+INSTANTIATE_ELEMENTWISE(int32_t)
+INSTANTIATE_ELEMENTWISE(int64_t)
+#undef INSTANTIATE_ELEMENTWISE
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,71 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+enum class ElementwiseType { kAdd, kSub, kMul, kDiv, kMax };
+
+// The activation applied to the result of the elementwise op.
+enum class ElementwiseActType { kNone, kRelu };
+
+/*
+ * The plan of an elementwise op broadcasting x and y to the output.
+ *
+ * Y is aligned with X from `axis`, or with the trailing dims of X when axis
+ * is -1, as in fluid, and the other way round when Y has more dims. Unlike
+ * fluid, the dims of size 1 on either side are broadcast to the other side,
+ * so any N-D broadcast is supported.
+ *
+ * The adjacent dims broadcast the same way are collapsed, e.g. x (2, 3, 4, 5)
+ * and y (3, 1) with axis 1 become x (2, 3, 20) and y (1, 3, 1), so the inner
+ * loop runs over the longest contiguous rows, and the outer dims are walked
+ * with a table of strides, 0 for the broadcast dims.
+ */
+struct ElementwisePlan {
+  ElementwisePlan(const lite::DDim& x_dims, const lite::DDim& y_dims, int axis);
+
+  int64_t numel() const;
+
+  // The collapsed dims of the output, the strides of x and y in them.
+  std::vector<int64_t> dims;
+  std::vector<int64_t> x_strides;
+  std::vector<int64_t> y_strides;
+  // The dims of the output before collapsing.
+  lite::DDim out_dims;
+};
+
+// out = act(x op y), the rows of the output are split among the threads of
+// the context.
+template <typename T>
+void Elementwise(const lite::X86Context& ctx,
+                 ElementwiseType type,
+                 ElementwiseActType act,
+                 const lite::Tensor& x,
+                 const lite::Tensor& y,
+                 int axis,
+                 lite::Tensor* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
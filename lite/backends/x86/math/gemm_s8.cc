@@ -0,0 +1,239 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_s8.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The columns of a block of the packed B.
+constexpr int kBlockN = 8;
+// The rows of a tile of C, the tiles are 2 blocks wide.
+constexpr int kTileM = 4;
+// A is split into the panels of about kPanelBytes, which stay in the cache
+// while all the columns of B are multiplied with them.
+constexpr int kPanelBytes = 1 << 17;
+
+inline int RoundUp(int x, int n) { return (x + n - 1) / n * n; }
+
+// Load the bytes [k, k + 4) of a row of K bytes, the ones past K are 0.
+inline int32_t LoadA4(const int8_t* a, int k, int K) {
+  int32_t a4 = 0;
+  std::memcpy(&a4, a + k, K - k >= 4 ? 4 : K - k);
+  return a4;
+}
+
+#ifdef __AVX2__
+// acc [R, V * 8] = A [R, K] x the V blocks of B.
+template <int R, int V>
+void TileS8(const int8_t* a,
+            int lda,
+            const int8_t* b,
+            int64_t b_stride,
+            int K,
+            int32_t* acc) {
+  __m256i c[R][V];
+  for (int r = 0; r < R; r++) {
+    for (int v = 0; v < V; v++) c[r][v] = _mm256_setzero_si256();
+  }
+#if !(defined(__AVX512VNNI__) && defined(__AVX512VL__))
+  const __m256i ones = _mm256_set1_epi16(1);
+#endif
+  for (int k = 0; k < K; k += 4) {
+    __m256i vb[V];
+    for (int v = 0; v < V; v++) {
+      vb[v] = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(b + v * b_stride + k * kBlockN));
+    }
+    for (int r = 0; r < R; r++) {
+      __m256i va = _mm256_set1_epi32(LoadA4(a + r * lda, k, K));
+      __m256i abs_a = _mm256_abs_epi8(va);
+      for (int v = 0; v < V; v++) {
+        __m256i signed_b = _mm256_sign_epi8(vb[v], va);
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+        c[r][v] = _mm256_dpbusd_epi32(c[r][v], abs_a, signed_b);
+#else
+        __m256i pairs = _mm256_maddubs_epi16(abs_a, signed_b);
+        c[r][v] = _mm256_add_epi32(c[r][v], _mm256_madd_epi16(pairs, ones));
+#endif
+      }
+    }
+  }
+  for (int r = 0; r < R; r++) {
+    for (int v = 0; v < V; v++) {
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(acc + (r * V + v) * kBlockN), c[r][v]);
+    }
+  }
+}
+#else
+template <int R, int V>
+void TileS8(const int8_t* a,
+            int lda,
+            const int8_t* b,
+            int64_t b_stride,
+            int K,
+            int32_t* acc) {
+  for (int r = 0; r < R; r++) {
+    for (int v = 0; v < V; v++) {
+      for (int j = 0; j < kBlockN; j++) {
+        const int8_t* col = b + v * b_stride + j * 4;
+        int32_t sum = 0;
+        for (int k = 0; k < K; k++) {
+          sum += a[r * lda + k] * col[k / 4 * 4 * kBlockN + k % 4];
+        }
+        acc[(r * V + v) * kBlockN + j] = sum;
+      }
+    }
+  }
+}
+#endif
+
+typedef void (*TileFunc)(
+    const int8_t*, int, const int8_t*, int64_t, int, int32_t*);
+
+const TileFunc kTiles[kTileM][2] = {{TileS8<1, 1>, TileS8<1, 2>},
+                                    {TileS8<2, 1>, TileS8<2, 2>},
+                                    {TileS8<3, 1>, TileS8<3, 2>},
+                                    {TileS8<4, 1>, TileS8<4, 2>}};
+
+template <typename T>
+inline T Requantize(float v);
+
+template <>
+inline float Requantize<float>(float v) {
+  return v;
+}
+
+template <>
+inline int8_t Requantize<int8_t>(float v) {
+  v = std::round(v);
+  return static_cast<int8_t>(std::min(127.f, std::max(-127.f, v)));
+}
+
+// Requantize the tile acc [rows, cols] of the row stride `acc_stride` into C
+// from (m, n).
+template <typename T>
+void StoreTile(const int32_t* acc,
+               int acc_stride,
+               int rows,
+               int cols,
+               int m,
+               int n,
+               T* C,
+               int ldc,
+               const GemmS8Requant& requant) {
+  for (int r = 0; r < rows; r++) {
+    const int32_t* in = acc + r * acc_stride;
+    T* out = C + static_cast<int64_t>(m + r) * ldc + n;
+    const float* scale = requant.per_row ? nullptr : requant.scale + n;
+    const float* bias = requant.per_row || !requant.bias ? nullptr
+                                                         : requant.bias + n;
+    float row_scale = requant.per_row ? requant.scale[m + r] : 0.f;
+    float row_bias =
+        requant.per_row && requant.bias ? requant.bias[m + r] : 0.f;
+    for (int j = 0; j < cols; j++) {
+      float v = in[j] * (scale ? scale[j] : row_scale) +
+                (bias ? bias[j] : row_bias);
+      if (requant.has_act && v < 0.f) v *= requant.act_alpha;
+      out[j] = Requantize<T>(v);
+    }
+  }
+}
+
+}  // namespace
+
+int64_t gemm_s8_packed_b_size(int K, int N) {
+  return static_cast<int64_t>(RoundUp(K, 4)) * RoundUp(N, kBlockN);
+}
+
+void gemm_s8_pack_b(const int8_t* B, int K, int N, int ldb, int8_t* packed) {
+  int k4 = RoundUp(K, 4);
+  for (int n0 = 0; n0 < N; n0 += kBlockN) {
+    int8_t* block = packed + static_cast<int64_t>(n0) * k4;
+    int cols = std::min(kBlockN, N - n0);
+    for (int k = 0; k < k4; k++) {
+      int8_t* dst = block + k / 4 * 4 * kBlockN + k % 4;
+      const int8_t* src = B + static_cast<int64_t>(k) * ldb + n0;
+      for (int j = 0; j < kBlockN; j++) {
+        int8_t v = k < K && j < cols ? src[j] : 0;
+        dst[j * 4] = v == -128 ? -127 : v;
+      }
+    }
+  }
+}
+
+template <typename T>
+void gemm_s8(int M,
+             int N,
+             int K,
+             const int8_t* A,
+             int lda,
+             const int8_t* packed_b,
+             T* C,
+             int ldc,
+             const GemmS8Requant& requant) {
+  int64_t b_stride = static_cast<int64_t>(RoundUp(K, 4)) * kBlockN;
+  int panel =
+      std::max(kTileM, kPanelBytes / std::max(K, 1) / kTileM * kTileM);
+  int32_t acc[kTileM * 2 * kBlockN];
+  for (int m0 = 0; m0 < M; m0 += panel) {
+    int m1 = std::min(M, m0 + panel);
+    for (int n = 0; n < N; n += 2 * kBlockN) {
+      int cols = std::min(2 * kBlockN, N - n);
+      int blocks = cols > kBlockN ? 2 : 1;
+      const int8_t* b = packed_b + n / kBlockN * b_stride;
+      for (int m = m0; m < m1; m += kTileM) {
+        int rows = std::min(kTileM, m1 - m);
+        kTiles[rows - 1][blocks - 1](
+            A + static_cast<int64_t>(m) * lda, lda, b, b_stride, K, acc);
+        StoreTile(acc, blocks * kBlockN, rows, cols, m, n, C, ldc, requant);
+      }
+    }
+  }
+}
+
+template void gemm_s8<float>(int M,
+                             int N,
+                             int K,
+                             const int8_t* A,
+                             int lda,
+                             const int8_t* packed_b,
+                             float* C,
+                             int ldc,
+                             const GemmS8Requant& requant);
+template void gemm_s8<int8_t>(int M,
+                              int N,
+                              int K,
+                              const int8_t* A,
+                              int lda,
+                              const int8_t* packed_b,
+                              int8_t* C,
+                              int ldc,
+                              const GemmS8Requant& requant);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,76 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The int8 GEMM of the int8 kernels, C = act(scale * (A x B) + bias) of the
+ * int8 A [M, K] and B [K, N], where the int32 results are requantized to
+ * float or int8 while they are in the registers.
+ *
+ * B is packed by gemm_s8_pack_b into the blocks of 8 columns, every 4 rows of
+ * a block are 32 bytes, i.e. a vector of 8 int32 lanes of 4 bytes of K, which
+ * vpmaddubsw and vpmaddwd, or vpdpbusd of AVX512-VNNI, multiply with 4 bytes
+ * of a row of A broadcast to all the lanes. As vpmaddubsw takes unsigned
+ * bytes, |a| is multiplied with b carrying the sign of a, so the int16 sums
+ * of the pairs never saturate as long as b is not -128, which gemm_s8_pack_b
+ * clamps to -127. The int8 values of the kernels are in [-127, 127] anyway.
+ *
+ * The plain C++ GEMM is used if AVX2 is not enabled.
+ */
+
+// The requantization of the int32 results. The scale and the bias are taken
+// by the rows of C if `per_row`, e.g. the output channels of a conv, or by
+// its columns otherwise, e.g. the outputs of a fc. The bias can be null.
+// With `has_act`, the negative results are multiplied by `act_alpha`, i.e.
+// relu if it is 0, or leaky relu.
+struct GemmS8Requant {
+  const float* scale{nullptr};
+  const float* bias{nullptr};
+  bool per_row{true};
+  bool has_act{false};
+  float act_alpha{0.f};
+};
+
+// The size in bytes of B [K, N] packed. It is also the offset of the column
+// n of the packed B if n is a multiple of 8.
+int64_t gemm_s8_packed_b_size(int K, int N);
+
+// Pack B [K, N] of the row stride `ldb`, the padding is filled with 0.
+void gemm_s8_pack_b(const int8_t* B, int K, int N, int ldb, int8_t* packed);
+
+// C [M, N] with the row stride `ldc` = requant(A x B), A [M, K] has the row
+// stride `lda`. T is float or int8_t, the int8 results are rounded and
+// clamped to [-127, 127].
+template <typename T>
+void gemm_s8(int M,
+             int N,
+             int K,
+             const int8_t* A,
+             int lda,
+             const int8_t* packed_b,
+             T* C,
+             int ldc,
+             const GemmS8Requant& requant);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
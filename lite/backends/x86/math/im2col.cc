@@ -127,6 +127,9 @@ template class Im2ColFunctor<lite::x86::math::ColFormat::kCFO,
 template class Im2ColFunctor<lite::x86::math::ColFormat::kCFO,
                              lite::TargetType::kX86,
                              double>;
+template class Im2ColFunctor<lite::x86::math::ColFormat::kCFO,
+                             lite::TargetType::kX86,
+                             int8_t>;
 template class Col2ImFunctor<lite::x86::math::ColFormat::kCFO,
                              lite::TargetType::kX86,
                              float>;
@@ -57,46 +57,45 @@ class Pool2dFunctor<lite::TargetType::kX86, PoolProcess, T> {
     const T* input_data = input.data<T>();
     T* output_data = output->mutable_data<T>(lite::TargetType::kX86);
 
-    int hstart, hend;
-    int wstart, wend;
-    for (int i = 0; i < batch_size; i++) {
-      for (int c = 0; c < output_channels; ++c) {
-        for (int ph = 0; ph < output_height; ++ph) {
+    // The planes of the images and the channels are pooled in parallel.
+    context.ParallelFor(batch_size * output_channels, [&](int i, int tid) {
+      const T* in = input_data + i * input_stride;
+      T* out = output_data + i * output_stride;
+      int hstart, hend;
+      int wstart, wend;
+      for (int ph = 0; ph < output_height; ++ph) {
+        if (adaptive) {
+          hstart = AdaptStartIndex(ph, input_height, output_height);
+          hend = AdaptEndIndex(ph, input_height, output_height);
+        } else {
+          hstart = ph * stride_height - padding_height;
+          hend = std::min(hstart + ksize_height, input_height);
+          hstart = std::max(hstart, 0);
+        }
+        for (int pw = 0; pw < output_width; ++pw) {
           if (adaptive) {
-            hstart = AdaptStartIndex(ph, input_height, output_height);
-            hend = AdaptEndIndex(ph, input_height, output_height);
+            wstart = AdaptStartIndex(pw, input_width, output_width);
+            wend = AdaptEndIndex(pw, input_width, output_width);
           } else {
-            hstart = ph * stride_height - padding_height;
-            hend = std::min(hstart + ksize_height, input_height);
-            hstart = std::max(hstart, 0);
+            wstart = pw * stride_width - padding_width;
+            wend = std::min(wstart + ksize_width, input_width);
+            wstart = std::max(wstart, 0);
           }
-          for (int pw = 0; pw < output_width; ++pw) {
-            if (adaptive) {
-              wstart = AdaptStartIndex(pw, input_width, output_width);
-              wend = AdaptEndIndex(pw, input_width, output_width);
-            } else {
-              wstart = pw * stride_width - padding_width;
-              wend = std::min(wstart + ksize_width, input_width);
-              wstart = std::max(wstart, 0);
-            }
 
-            T ele = pool_process.initial();
-            for (int h = hstart; h < hend; ++h) {
-              for (int w = wstart; w < wend; ++w) {
-                pool_process.compute(input_data[h * input_width + w], &ele);
-              }
+          T ele = pool_process.initial();
+          for (int h = hstart; h < hend; ++h) {
+            for (int w = wstart; w < wend; ++w) {
+              pool_process.compute(in[h * input_width + w], &ele);
             }
-            int pool_size = (exclusive || adaptive)
-                                ? (hend - hstart) * (wend - wstart)
-                                : ksize_height * ksize_width;
-            pool_process.finalize(static_cast<T>(pool_size), &ele);
-            output_data[ph * output_width + pw] = ele;
           }
+          int pool_size = (exclusive || adaptive)
+                              ? (hend - hstart) * (wend - wstart)
+                              : ksize_height * ksize_width;
+          pool_process.finalize(static_cast<T>(pool_size), &ele);
+          out[ph * output_width + pw] = ele;
         }
-        input_data += input_stride;
-        output_data += output_stride;
       }
-    }
+    });
   }
 };
 
@@ -324,62 +323,60 @@ class Pool3dFunctor<lite::TargetType::kX86, PoolProcess, T> {
     const T* input_data = input.data<T>();
     T* output_data = output->mutable_data<T>(lite::TargetType::kX86);
 
-    int dstart, dend;
-    int hstart, hend;
-    int wstart, wend;
-    for (int i = 0; i < batch_size; i++) {
-      for (int c = 0; c < output_channels; ++c) {
-        for (int pd = 0; pd < output_depth; ++pd) {
+    // The volumes of the images and the channels are pooled in parallel.
+    context.ParallelFor(batch_size * output_channels, [&](int i, int tid) {
+      const T* in = input_data + i * input_stride;
+      T* out = output_data + i * output_stride;
+      int dstart, dend;
+      int hstart, hend;
+      int wstart, wend;
+      for (int pd = 0; pd < output_depth; ++pd) {
+        if (adaptive) {
+          dstart = AdaptStartIndex(pd, input_depth, output_depth);
+          dend = AdaptEndIndex(pd, input_depth, output_depth);
+        } else {
+          dstart = pd * stride_depth - padding_depth;
+          dend = std::min(dstart + ksize_depth, input_depth);
+          dstart = std::max(dstart, 0);
+        }
+        for (int ph = 0; ph < output_height; ++ph) {
           if (adaptive) {
-            dstart = AdaptStartIndex(pd, input_depth, output_depth);
-            dend = AdaptEndIndex(pd, input_depth, output_depth);
+            hstart = AdaptStartIndex(ph, input_height, output_height);
+            hend = AdaptEndIndex(ph, input_height, output_height);
           } else {
-            dstart = pd * stride_depth - padding_depth;
-            dend = std::min(dstart + ksize_depth, input_depth);
-            dstart = std::max(dstart, 0);
+            hstart = ph * stride_height - padding_height;
+            hend = std::min(hstart + ksize_height, input_height);
+            hstart = std::max(hstart, 0);
           }
-          for (int ph = 0; ph < output_height; ++ph) {
+          for (int pw = 0; pw < output_width; ++pw) {
             if (adaptive) {
-              hstart = AdaptStartIndex(ph, input_height, output_height);
-              hend = AdaptEndIndex(ph, input_height, output_height);
+              wstart = AdaptStartIndex(pw, input_width, output_width);
+              wend = AdaptEndIndex(pw, input_width, output_width);
             } else {
-              hstart = ph * stride_height - padding_height;
-              hend = std::min(hstart + ksize_height, input_height);
-              hstart = std::max(hstart, 0);
+              wstart = pw * stride_width - padding_width;
+              wend = std::min(wstart + ksize_width, input_width);
+              wstart = std::max(wstart, 0);
             }
-            for (int pw = 0; pw < output_width; ++pw) {
-              if (adaptive) {
-                wstart = AdaptStartIndex(pw, input_width, output_width);
-                wend = AdaptEndIndex(pw, input_width, output_width);
-              } else {
-                wstart = pw * stride_width - padding_width;
-                wend = std::min(wstart + ksize_width, input_width);
-                wstart = std::max(wstart, 0);
-              }
-              int output_idx = (pd * output_height + ph) * output_width + pw;
-              T ele = pool_process.initial();
-              for (int d = dstart; d < dend; ++d) {
-                for (int h = hstart; h < hend; ++h) {
-                  for (int w = wstart; w < wend; ++w) {
-                    pool_process.compute(
-                        input_data[(d * input_height + h) * input_width + w],
-                        &ele);
-                  }
+            int output_idx = (pd * output_height + ph) * output_width + pw;
+            T ele = pool_process.initial();
+            for (int d = dstart; d < dend; ++d) {
+              for (int h = hstart; h < hend; ++h) {
+                for (int w = wstart; w < wend; ++w) {
+                  pool_process.compute(
+                      in[(d * input_height + h) * input_width + w], &ele);
                 }
               }
-              int pool_size =
-                  (exclusive || adaptive)
-                      ? (dend - dstart) * (hend - hstart) * (wend - wstart)
-                      : ksize_depth * ksize_height * ksize_width;
-              pool_process.finalize(static_cast<T>(pool_size), &ele);
-              output_data[output_idx] = ele;
             }
+            int pool_size =
+                (exclusive || adaptive)
+                    ? (dend - dstart) * (hend - hstart) * (wend - wstart)
+                    : ksize_depth * ksize_height * ksize_width;
+            pool_process.finalize(static_cast<T>(pool_size), &ele);
+            out[output_idx] = ele;
           }
         }
-        input_data += input_stride;
-        output_data += output_stride;
       }
-    }
+    });
   }
 };
 
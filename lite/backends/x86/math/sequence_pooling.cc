@@ -285,53 +285,36 @@ class SequencePoolFunctor<TARGET(kX86), T> {
       return;
     }
 
-    auto lod = input.lod()[0];
+    // The sum, average and sqrt pools run the jit kernel for the CPU.
+    jit::SeqPoolType type;
     if (pooltype == "SUM") {
-      const T* src = input.data<T>();
-      T* dst = output->mutable_data<T>(TARGET(kX86));
-      jit::seq_pool_attr_t attr(
-          static_cast<int>(input.numel() / input.dims()[0]),
-          jit::SeqPoolType::kSum);
-      auto seqpool =
-          jit::KernelFuncs<jit::SeqPoolTuple<T>, lite::fluid::CPUPlace>::Cache()
-              .At(attr);
-      for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-        attr.h = static_cast<int>(lod[i + 1] - lod[i]);
-        if (attr.h == 0) {
-          for (int j = 0; j < attr.w; ++j) {
-            dst[j] = pad_value;
-          }
-        } else {
-          seqpool(src, dst, &attr);
-        }
-        dst += attr.w;
-        src += attr.h * attr.w;
-      }
-      return;
+      type = jit::SeqPoolType::kSum;
+    } else if (pooltype == "AVERAGE") {
+      type = jit::SeqPoolType::kAvg;
+    } else if (pooltype == "SQRT") {
+      type = jit::SeqPoolType::kSqrt;
+    } else {
+      PADDLE_THROW("unsupported pooling pooltype");
     }
-    auto eigen_device = lite::fluid::EigenDeviceType<TARGET(kX86)>();
+    auto lod = input.lod()[0];
+    const T* src = input.data<T>();
+    T* dst = output->mutable_data<T>();
+    jit::seq_pool_attr_t attr(
+        static_cast<int>(input.numel() / input.dims()[0]), type);
+    auto seqpool =
+        jit::KernelFuncs<jit::SeqPoolTuple<T>, lite::fluid::CPUPlace>::Cache()
+            .At(attr);
     for (int i = 0; i < static_cast<int>(lod.size()) - 1; ++i) {
-      Tensor out_t = output->Slice<float>(i, i + 1);
-      int64_t w = input.numel() / input.dims()[0];
-      if (lod[i] == lod[i + 1]) {
-        for (int j = 0; j < w; ++j) {
-          out_t.mutable_data<T>()[j] = pad_value;
+      attr.h = static_cast<int>(lod[i + 1] - lod[i]);
+      if (attr.h == 0) {
+        for (int j = 0; j < attr.w; ++j) {
+          dst[j] = pad_value;
         }
-        continue;
-      }
-      Tensor in_t = input.Slice<float>(static_cast<int>(lod[i]),
-                                       static_cast<int>(lod[i + 1]));
-      int64_t h = static_cast<int64_t>(lod[i + 1] - lod[i]);
-      auto in_e = EigenMatrix<T>::From(in_t, lite::DDim({h, w}));
-      auto out_e = EigenVector<T>::Flatten(out_t);
-      if (pooltype == "AVERAGE") {
-        out_e.device(eigen_device) = in_e.mean(Eigen::array<int, 1>({{0}}));
-      } else if (pooltype == "SQRT") {
-        out_e.device(eigen_device) = in_e.sum(Eigen::array<int, 1>({{0}})) /
-                                     std::sqrt(static_cast<T>(h));
       } else {
-        PADDLE_THROW("unsupported pooling pooltype");
+        seqpool(src, dst, &attr);
       }
+      dst += attr.w;
+      src += attr.h * attr.w;
     }
   }
 };
@@ -27,7 +27,7 @@ void TestCase::CreateInstruction() {
   // filter out the target kernel
   CHECK(!kernels.empty()) << "No kernel found for place "
                           << place_.DebugString();
-  auto it = std::remove_if(
+  auto it = std::find_if(
       kernels.begin(), kernels.end(), [&](std::unique_ptr<KernelBase>& k) {
         return k->alias() == alias_;
       });
@@ -45,6 +45,8 @@ void TestCase::PrepareInputsForInstruction() {
       std::string kernel_key = instruction_->kernel()->key_with_alias();
       const auto* param_type = ParamTypeRegistry::Global().RetrieveInArgument(
           place_, kernel_key, arg);
+      // The optional inputs the kernel does not declare.
+      if (!param_type) continue;
 
       const auto* inst_type = Type::GetTensorTy(TARGET(kHost));
       CHECK(scope_->FindVar(var));
@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 #include "lite/core/op_registry.h"
+#include "lite/core/profile/trace_profiler.h"
 #include "lite/core/program.h"
 #include "lite/core/scope.h"
 #include "lite/core/types.h"
@@ -107,6 +108,7 @@ class TestCase {
 
  public:
   const Instruction& instruction() { return *instruction_; }
+  Instruction* mutable_instruction() { return instruction_.get(); }
 
  private:
   std::unique_ptr<KernelContext> ctx_;
@@ -150,6 +152,23 @@ class TestCase {
   std::unique_ptr<Instruction> instruction_;
 };
 
+// The latencies of the runs of an instruction, in microseconds, and the cost
+// of a run estimated by profile::EstimateOpCost.
+struct PerfStats {
+  int count{0};
+  float avg_us{0};
+  float min_us{0};
+  float p50_us{0};
+  float p90_us{0};
+  float p99_us{0};
+  float max_us{0};
+  int64_t flops{0};
+  int64_t bytes{0};
+
+  double gflops_per_s() const { return avg_us > 0 ? flops / avg_us / 1e3 : 0; }
+  double gbytes_per_s() const { return avg_us > 0 ? bytes / avg_us / 1e3 : 0; }
+};
+
 class Arena {
  public:
   Arena(std::unique_ptr<TestCase>&& tester,
@@ -173,16 +192,48 @@ class Arena {
     return success;
   }
 
-  void TestPerformance(int times = 100) {
-    auto timer = std::chrono::high_resolution_clock::now();
+  // Run the instruction `warmup` times, then time `times` runs one by one.
+  PerfStats TestPerformance(int times = 100, int warmup = 1) {
+    using clock_t = std::chrono::steady_clock;
+    for (int i = 0; i < warmup; i++) {
+      tester_->RunInstruction();
+    }
+    std::vector<float> latencies;
     for (int i = 0; i < times; i++) {
+      auto start = clock_t::now();
       tester_->RunInstruction();
+      latencies.push_back(
+          std::chrono::duration<float, std::micro>(clock_t::now() - start)
+              .count());
     }
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::high_resolution_clock::now() - timer);
-    LOG(INFO) << "average duration: " << duration.count() << " ms";
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](float p) {
+      size_t rank = static_cast<size_t>(std::ceil(p * latencies.size()));
+      return latencies[std::max<size_t>(rank, 1) - 1];
+    };
+
+    PerfStats stats;
+    if (times <= 0) return stats;
+    stats.count = times;
+    float sum = 0;
+    for (float x : latencies) sum += x;
+    stats.avg_us = sum / times;
+    stats.min_us = latencies.front();
+    stats.p50_us = percentile(0.5f);
+    stats.p90_us = percentile(0.9f);
+    stats.p99_us = percentile(0.99f);
+    stats.max_us = latencies.back();
+    auto cost = profile::EstimateOpCost(*tester_->instruction().op());
+    stats.flops = cost.flops;
+    stats.bytes = cost.bytes;
+    LOG(INFO) << "average duration: " << stats.avg_us / 1e3
+              << " ms, p50: " << stats.p50_us / 1e3
+              << " ms, p99: " << stats.p99_us / 1e3 << " ms";
+    return stats;
   }
 
+  TestCase* tester() { return tester_.get(); }
+
  private:
   // input_name: X
   bool CompareTensor(const std::string& arg_name, const std::string& var_name) {
@@ -0,0 +1,245 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/arena/kernel_benchmark.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace arena {
+
+namespace {
+
+std::string Escape(const std::string& x) {
+  std::string res;
+  for (char c : x) {
+    if (c == '"' || c == '\\') res.push_back('\\');
+    res.push_back(c);
+  }
+  return res;
+}
+
+// The string value of `field` in a line of the JSON saved by KernelBenchJson.
+bool ParseStringField(const std::string& line,
+                      const std::string& field,
+                      std::string* value) {
+  std::string prefix = "\"" + field + "\": \"";
+  size_t pos = line.find(prefix);
+  if (pos == std::string::npos) return false;
+  value->clear();
+  for (pos += prefix.size(); pos < line.size(); pos++) {
+    if (line[pos] == '"') return true;
+    if (line[pos] == '\\') pos++;
+    if (pos < line.size()) value->push_back(line[pos]);
+  }
+  return false;
+}
+
+bool ParseNumberField(const std::string& line,
+                      const std::string& field,
+                      float* value) {
+  std::string prefix = "\"" + field + "\": ";
+  size_t pos = line.find(prefix);
+  if (pos == std::string::npos) return false;
+  *value = std::strtof(line.c_str() + pos + prefix.size(), nullptr);
+  return true;
+}
+
+bool IsHostMemoryTarget(TargetType target) {
+  return target == TARGET(kHost) || target == TARGET(kX86) ||
+         target == TARGET(kARM);
+}
+
+}  // namespace
+
+void OpDescTestCase::PrepareData() {
+  for (auto& name : desc_.input_vars()) {
+    auto* var = src_scope_->FindVar(name);
+    CHECK(var && var->IsType<Tensor>()) << "no input tensor " << name;
+    auto& src = var->Get<Tensor>();
+    auto* tensor = scope().NewTensor(name);
+    tensor->Resize(src.dims());
+    tensor->set_lod(src.lod());
+    tensor->set_precision(src.precision());
+    if (src.memory_size() > 0) {
+      std::memcpy(tensor->mutable_data(src.target(), src.memory_size()),
+                  src.raw_data(),
+                  src.memory_size());
+    }
+  }
+}
+
+std::string OpShapes(const cpp::OpDesc& op_desc, const Scope& scope) {
+  std::stringstream ss;
+  auto append = [&](const std::vector<std::string>& args, bool input) {
+    for (size_t i = 0; i < args.size(); i++) {
+      ss << (i ? ";" : "") << args[i] << "=";
+      auto names = input ? op_desc.Input(args[i]) : op_desc.Output(args[i]);
+      for (size_t j = 0; j < names.size(); j++) {
+        auto* var = scope.FindVar(names[j]);
+        if (!var || !var->IsType<Tensor>()) return false;
+        auto& dims = var->Get<Tensor>().dims();
+        ss << (j ? "," : "");
+        for (size_t k = 0; k < dims.size(); k++) {
+          ss << (k ? "x" : "") << dims[k];
+        }
+      }
+    }
+    return true;
+  };
+  if (!append(op_desc.InputArgumentNames(), true)) return "";
+  ss << "->";
+  if (!append(op_desc.OutputArgumentNames(), false)) return "";
+  return ss.str();
+}
+
+std::vector<KernelBenchResult> BenchmarkOp(const cpp::OpDesc& op_desc,
+                                           const Scope& scope,
+                                           const std::vector<Place>& places,
+                                           const KernelBase* picked,
+                                           const KernelBenchConfig& config) {
+  std::vector<KernelBenchResult> results;
+  auto op_type = op_desc.Type();
+  std::string shapes = OpShapes(op_desc, scope);
+  if (shapes.empty()) {
+    LOG(WARNING) << "skip " << op_type << ", its inputs are not all tensors";
+    return results;
+  }
+  auto op = LiteOpRegistry::Global().Create(op_type);
+  if (!op) {
+    LOG(WARNING) << "skip " << op_type << ", the op is not registered";
+    return results;
+  }
+  op->Attach(op_desc, const_cast<Scope*>(&scope));
+
+  std::string picked_impl;
+  if (picked) {
+    auto impls = picked->ImplCandidates();
+    picked_impl = impls.empty() ? "" : impls.front();
+    for (auto& impl : impls) {
+      if (impl == picked->impl_name()) picked_impl = impl;
+    }
+  }
+
+#ifdef LITE_WITH_X86
+  std::shared_ptr<ThreadPool> pool =
+      config.threads > 1 ? std::make_shared<ThreadPool>(config.threads)
+                         : nullptr;
+#endif
+  std::set<std::string> benchmarked;
+  for (auto& kernel : op->CreateKernels(places)) {
+    if (!IsHostMemoryTarget(kernel->target())) continue;
+    if (picked && (kernel->precision() != picked->precision() ||
+                   kernel->layout() != picked->layout())) {
+      continue;
+    }
+    std::string name = kernel->name() + "/" + kernel->alias();
+    if (!benchmarked.insert(name).second) continue;
+
+    auto place = kernel->place();
+    std::unique_ptr<TestCase> tester(
+        new OpDescTestCase(place, kernel->alias(), op_desc, scope));
+    Arena arena(std::move(tester), place);
+    auto* inst_kernel = arena.tester()->mutable_instruction()->mutable_kernel();
+#ifdef LITE_WITH_X86
+    if (place.target == TARGET(kX86)) {
+      inst_kernel->mutable_context()->As<X86Context>().SetThreadPool(pool);
+    } else if (place.target == TARGET(kHost)) {
+      inst_kernel->mutable_context()->As<HostContext>().SetThreadPool(pool);
+    }
+#endif
+    bool is_picked = picked && picked->place() == place &&
+                     picked->alias() == kernel->alias();
+
+    auto impls = inst_kernel->ImplCandidates();
+    if (impls.empty()) impls.emplace_back();
+    for (auto& impl : impls) {
+      if (!impl.empty()) inst_kernel->set_impl_name(impl);
+      LOG(INFO) << "benchmark " << name << " " << impl << " " << shapes;
+      KernelBenchResult result;
+      result.op_type = op_type;
+      result.kernel = name;
+      result.impl = impl;
+      result.shapes = shapes;
+      result.picked = is_picked && impl == picked_impl;
+      result.stats = arena.TestPerformance(config.repeats, config.warmup);
+      results.push_back(result);
+    }
+  }
+  return results;
+}
+
+std::string KernelBenchJson(const std::vector<KernelBenchResult>& results) {
+  std::stringstream ss;
+  ss << "{\"results\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    auto& res = results[i];
+    auto& stats = res.stats;
+    ss << (i ? ",\n" : "\n") << "{\"key\": \"" << Escape(res.key())
+       << "\", \"op_type\": \"" << Escape(res.op_type) << "\", \"kernel\": \""
+       << Escape(res.kernel) << "\", \"impl\": \"" << Escape(res.impl)
+       << "\", \"shapes\": \"" << Escape(res.shapes)
+       << "\", \"count\": " << res.count
+       << ", \"picked\": " << (res.picked ? "true" : "false")
+       << ", \"repeats\": " << stats.count << ", \"avg_us\": " << stats.avg_us
+       << ", \"min_us\": " << stats.min_us << ", \"p50_us\": " << stats.p50_us
+       << ", \"p90_us\": " << stats.p90_us << ", \"p99_us\": " << stats.p99_us
+       << ", \"max_us\": " << stats.max_us << ", \"flops\": " << stats.flops
+       << ", \"bytes\": " << stats.bytes
+       << ", \"gflops_per_s\": " << stats.gflops_per_s()
+       << ", \"gbytes_per_s\": " << stats.gbytes_per_s() << "}";
+  }
+  ss << "\n]}\n";
+  return ss.str();
+}
+
+std::map<std::string, float> LoadKernelBenchBaseline(const std::string& path) {
+  std::map<std::string, float> baseline;
+  std::ifstream file(path);
+  CHECK(file.is_open()) << "Open " << path << " failed";
+  std::string line;
+  while (std::getline(file, line)) {
+    std::string key;
+    float p50_us;
+    if (ParseStringField(line, "key", &key) &&
+        ParseNumberField(line, "p50_us", &p50_us)) {
+      baseline[key] = p50_us;
+    }
+  }
+  return baseline;
+}
+
+std::vector<KernelBenchRegression> FindKernelBenchRegressions(
+    const std::vector<KernelBenchResult>& results,
+    const std::map<std::string, float>& baseline,
+    float threshold) {
+  std::vector<KernelBenchRegression> regressions;
+  for (auto& res : results) {
+    auto it = baseline.find(res.key());
+    if (it == baseline.end() || it->second <= 0) continue;
+    if (res.stats.p50_us > it->second * (1 + threshold)) {
+      regressions.push_back({res.key(), it->second, res.stats.p50_us});
+    }
+  }
+  return regressions;
+}
+
+}  // namespace arena
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,119 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * This file implements the kernel micro-benchmark on the arena framework. An
+ * op of a model is benchmarked with its real inputs, copied from the scope of
+ * a run of the model, for every kernel registered for it on the valid places
+ * and every implementation of the kernel. The results are exported as JSON,
+ * and can be compared with the results saved before to find the regressions.
+ */
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/arena/framework.h"
+
+namespace paddle {
+namespace lite {
+namespace arena {
+
+// The test case running the op `op_desc` with the inputs copied from `scope`.
+// It has no baseline, only the performance is tested.
+class OpDescTestCase : public TestCase {
+ public:
+  OpDescTestCase(const Place& place,
+                 const std::string& alias,
+                 const cpp::OpDesc& op_desc,
+                 const Scope& scope)
+      : TestCase(place, alias), desc_(op_desc), src_scope_(&scope) {}
+
+  void RunBaseline(Scope* scope) override {}
+
+ protected:
+  void PrepareData() override;
+  void PrepareOpDesc(cpp::OpDesc* op_desc) override { *op_desc = desc_; }
+
+ private:
+  cpp::OpDesc desc_;
+  const Scope* src_scope_;
+};
+
+struct KernelBenchConfig {
+  int warmup{1};
+  int repeats{20};
+  // The threads of the x86 and host kernels.
+  int threads{1};
+};
+
+struct KernelBenchResult {
+  std::string op_type;
+  // The kernel, e.g. "conv2d:x86/float/NCHW/def".
+  std::string kernel;
+  // The implementation of the kernel, empty if it has only one.
+  std::string impl;
+  // The input and output dims, e.g. "Input=1x3x224x224;Filter=...->Output=".
+  std::string shapes;
+  // The times the op runs with these dims in the model.
+  int count{1};
+  // Whether it is the kernel and the implementation the model runs.
+  bool picked{false};
+  PerfStats stats;
+
+  // The key to find the same case in the other results.
+  std::string key() const {
+    return op_type + "|" + kernel + "|" + impl + "|" + shapes;
+  }
+};
+
+// The dims of the inputs and the outputs of the op, in the format of
+// KernelBenchResult::shapes. Empty if an argument is not a tensor, e.g. a
+// tensor array, which the benchmark does not support.
+std::string OpShapes(const cpp::OpDesc& op_desc, const Scope& scope);
+
+// Benchmark the op `op_desc` with the inputs in `scope` for every kernel
+// registered for it on `places`. The kernels on the targets other than host,
+// x86 and ARM, and the kernels with the precision or the layout different from
+// the one of `picked` are skipped. `picked` is the kernel the model runs, it
+// can be null.
+std::vector<KernelBenchResult> BenchmarkOp(const cpp::OpDesc& op_desc,
+                                           const Scope& scope,
+                                           const std::vector<Place>& places,
+                                           const KernelBase* picked,
+                                           const KernelBenchConfig& config);
+
+// {"results": [{"key": ..., "op_type": ..., "avg_us": ..., "p50_us": ...,
+// "gflops_per_s": ..., "gbytes_per_s": ..., ...}, ...]}, a result per line.
+std::string KernelBenchJson(const std::vector<KernelBenchResult>& results);
+
+// The p50 latencies of the results saved by KernelBenchJson, by the key.
+std::map<std::string, float> LoadKernelBenchBaseline(const std::string& path);
+
+struct KernelBenchRegression {
+  std::string key;
+  float baseline_us;
+  float p50_us;
+};
+
+// The results whose p50 latency is more than (1 + `threshold`) times the one
+// of the baseline. The results not in the baseline are ignored.
+std::vector<KernelBenchRegression> FindKernelBenchRegressions(
+    const std::vector<KernelBenchResult>& results,
+    const std::map<std::string, float>& baseline,
+    float threshold);
+
+}  // namespace arena
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,84 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/arena/kernel_benchmark.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+
+namespace paddle {
+namespace lite {
+namespace arena {
+
+TEST(kernel_benchmark, scale) {
+#ifdef LITE_WITH_X86
+  Place place(TARGET(kX86));
+#endif
+#ifdef LITE_WITH_ARM
+  Place place(TARGET(kARM));
+#endif
+  Scope scope;
+  auto* x = scope.NewTensor("x");
+  x->Resize({2, 3, 16});
+  auto* x_data = x->mutable_data<float>();
+  for (int i = 0; i < x->numel(); i++) x_data[i] = i * 0.1f;
+  scope.NewTensor("out")->Resize({2, 3, 16});
+
+  cpp::OpDesc desc;
+  desc.SetType("scale");
+  desc.SetInput("X", {"x"});
+  desc.SetOutput("Out", {"out"});
+  desc.SetAttr("scale", 1.2f);
+  desc.SetAttr("bias", 0.f);
+  desc.SetAttr("bias_after_scale", false);
+  EXPECT_EQ(OpShapes(desc, scope), "X=2x3x16->Out=2x3x16");
+
+  KernelBenchConfig config;
+  config.repeats = 5;
+  auto results = BenchmarkOp(desc, scope, {place}, nullptr, config);
+  ASSERT_FALSE(results.empty());
+  for (auto& res : results) {
+    EXPECT_EQ(res.op_type, "scale");
+    EXPECT_FALSE(res.picked);
+    EXPECT_EQ(res.stats.count, 5);
+    EXPECT_LE(res.stats.min_us, res.stats.p50_us);
+    EXPECT_LE(res.stats.p50_us, res.stats.p99_us);
+    EXPECT_LE(res.stats.p99_us, res.stats.max_us);
+    EXPECT_EQ(res.stats.flops, 96);
+    EXPECT_EQ(res.stats.bytes, 2 * 96 * sizeof(float));
+  }
+
+  // Save the results as the baseline, then slow down a result.
+  std::string path = "kernel_benchmark_test.json";
+  {
+    std::ofstream file(path);
+    file << KernelBenchJson(results);
+  }
+  auto baseline = LoadKernelBenchBaseline(path);
+  std::remove(path.c_str());
+  ASSERT_EQ(baseline.size(), results.size());
+  EXPECT_NEAR(baseline[results[0].key()], results[0].stats.p50_us, 1e-2);
+  EXPECT_TRUE(FindKernelBenchRegressions(results, baseline, 0.1f).empty());
+
+  results[0].stats.p50_us = baseline[results[0].key()] * 2 + 1;
+  auto regressions = FindKernelBenchRegressions(results, baseline, 0.1f);
+  ASSERT_EQ(regressions.size(), 1UL);
+  EXPECT_EQ(regressions[0].key, results[0].key());
+}
+
+}  // namespace arena
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,261 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/calibrator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The input and the weights of a quantizable op, and whether the output
+// channels are the rows of the weights, or the columns.
+struct QuantizableOp {
+  const char* input;
+  const char* weight;
+  bool by_rows;
+};
+
+const std::map<std::string, QuantizableOp>& QuantizableOps() {
+  static const std::map<std::string, QuantizableOp> ops = {
+      {"conv2d", {"Input", "Filter", true}},
+      {"depthwise_conv2d", {"Input", "Filter", true}},
+      {"fc", {"Input", "W", false}}};
+  return ops;
+}
+
+// The int8 levels of |x|.
+constexpr int kLevels = 128;
+
+// KL(p || q) of the histograms, the empty bins of q are smoothed.
+double KLDivergence(const std::vector<double>& p,
+                    const std::vector<double>& q) {
+  double p_sum = std::accumulate(p.begin(), p.end(), 0.);
+  double q_sum = std::accumulate(q.begin(), q.end(), 0.);
+  double kl = 0.;
+  for (size_t i = 0; i < p.size(); i++) {
+    if (p[i] <= 0.) continue;
+    double pi = p[i] / p_sum;
+    double qi = std::max(q[i] / q_sum, 1e-10);
+    kl += pi * std::log(pi / qi);
+  }
+  return kl;
+}
+
+}  // namespace
+
+void Calibrator::Watch(const Instruction& inst) {
+  auto* op_info = inst.op()->op_info();
+  auto it = QuantizableOps().find(op_info->Type());
+  if (it == QuantizableOps().end() || op_info->HasAttr("enable_int8")) return;
+  auto* kernel = inst.kernel();
+  if (kernel->precision() != PRECISION(kFloat)) return;
+  if (KernelRegistry::Global()
+          .Create(op_info->Type(),
+                  kernel->target(),
+                  PRECISION(kInt8),
+                  DATALAYOUT(kNCHW))
+          .empty()) {
+    return;
+  }
+  watched_.insert(op_info->Input(it->second.input).front());
+  weights_.insert(op_info->Input(it->second.weight).front());
+}
+
+void Calibrator::Collect(const Instruction& inst, const Scope& scope) {
+  for (auto& name : inst.op()->op_info()->output_names()) {
+    if (!watched_.count(name)) continue;
+    auto* var = scope.FindVar(name);
+    if (!var || !var->IsType<Tensor>()) continue;
+    Collect(name, var->Get<Tensor>());
+  }
+}
+
+void Calibrator::Collect(const std::string& name, const Tensor& x) {
+  int bins = config_.histogram_bins;
+  auto& stats = stats_[name];
+  if (stats.hist.empty()) stats.hist.resize(bins);
+  const float* data = x.data<float>();
+  int64_t numel = x.numel();
+  float max_abs = 0.f;
+  for (int64_t i = 0; i < numel; i++) {
+    max_abs = std::max(max_abs, std::fabs(data[i]));
+  }
+  stats.max_abs = std::max(stats.max_abs, max_abs);
+  if (max_abs > stats.bin_width * bins) {
+    if (stats.bin_width == 0.f) {
+      // Only zeros are collected before, which are in the first bin.
+      stats.bin_width = max_abs / bins;
+    } else {
+      // Merge every `factor` bins, so the histogram covers max_abs.
+      int factor =
+          static_cast<int>(std::ceil(max_abs / (stats.bin_width * bins)));
+      std::vector<double> merged(bins);
+      for (int i = 0; i < bins; i++) merged[i / factor] += stats.hist[i];
+      stats.hist.swap(merged);
+      stats.bin_width *= factor;
+    }
+  }
+  float inv_width = stats.bin_width > 0.f ? 1.f / stats.bin_width : 0.f;
+  for (int64_t i = 0; i < numel; i++) {
+    int bin = static_cast<int>(std::fabs(data[i]) * inv_width);
+    stats.hist[std::min(bin, bins - 1)] += 1.;
+  }
+}
+
+bool Calibrator::Scale(const std::string& name, float* scale) const {
+  auto it = stats_.find(name);
+  if (it == stats_.end()) return false;
+  auto& stats = it->second;
+  float threshold = stats.max_abs;
+  switch (config_.algo) {
+    case CalibrationAlgo::kPercentile:
+      threshold =
+          PercentileThreshold(stats.hist, stats.bin_width, config_.percentile);
+      break;
+    case CalibrationAlgo::kKL:
+      threshold = KLThreshold(stats.hist, stats.bin_width);
+      break;
+    default:
+      break;
+  }
+  threshold = std::min(threshold, stats.max_abs);
+  // Any scale quantizes the activation of zeros.
+  *scale = threshold > 0.f ? threshold / (kLevels - 1) : 1.f;
+  return true;
+}
+
+void Calibrator::QuantizeProgram(cpp::ProgramDesc* desc, Scope* scope) const {
+  CHECK(desc->BlocksSize());
+  auto& main_block = *desc->GetBlock<cpp::BlockDesc>(0);
+  // The scales of the quantized weights, which may be shared by the ops.
+  std::map<std::string, std::vector<float>> weight_scales;
+  for (size_t i = 0; i < main_block.OpsSize(); i++) {
+    auto* op = main_block.GetOp<cpp::OpDesc>(i);
+    auto it = QuantizableOps().find(op->Type());
+    if (it == QuantizableOps().end()) continue;
+    auto& quantizable = it->second;
+    auto weight = op->Input(quantizable.weight).front();
+    float input_scale;
+    if (!weights_.count(weight) ||
+        !Scale(op->Input(quantizable.input).front(), &input_scale)) {
+      continue;
+    }
+    if (!weight_scales.count(weight)) {
+      auto* w = scope->FindVar(weight)->GetMutable<Tensor>();
+      weight_scales[weight] =
+          QuantizeWeights(w, w->dims()[0], quantizable.by_rows);
+    }
+    op->SetAttr("enable_int8", true);
+    op->SetAttr("input_scale", input_scale);
+    op->SetAttr("weight_scale", weight_scales[weight]);
+    // The int8 kernel and its implementation are picked when the program is
+    // optimized again.
+    op->DeleteAttr(kKernelTypeAttr);
+    op->DeleteAttr(kKernelImplAttr);
+  }
+}
+
+std::vector<float> Calibrator::QuantizeWeights(Tensor* w,
+                                               int rows,
+                                               bool by_rows) {
+  CHECK(w->precision() != PRECISION(kInt8)) << "the weights are quantized";
+  Tensor fp32;
+  fp32.CopyDataFrom(*w);
+  const float* data = fp32.data<float>();
+  int64_t cols = w->numel() / rows;
+  std::vector<float> scales(by_rows ? rows : cols, 0.f);
+  for (int64_t r = 0; r < rows; r++) {
+    for (int64_t c = 0; c < cols; c++) {
+      float& max_abs = scales[by_rows ? r : c];
+      max_abs = std::max(max_abs, std::fabs(data[r * cols + c]));
+    }
+  }
+  for (auto& scale : scales) {
+    scale = scale > 0.f ? scale / (kLevels - 1) : 1.f;
+  }
+  int8_t* q = w->mutable_data<int8_t>();
+  for (int64_t r = 0; r < rows; r++) {
+    for (int64_t c = 0; c < cols; c++) {
+      float v = std::round(data[r * cols + c] / scales[by_rows ? r : c]);
+      q[r * cols + c] = static_cast<int8_t>(
+          std::min<float>(kLevels - 1, std::max<float>(1 - kLevels, v)));
+    }
+  }
+  w->set_precision(PRECISION(kInt8));
+  w->set_persistable(true);
+  return scales;
+}
+
+float Calibrator::PercentileThreshold(const std::vector<double>& hist,
+                                      float bin_width,
+                                      float percentile) {
+  double total = std::accumulate(hist.begin(), hist.end(), 0.);
+  double sum = 0.;
+  for (size_t i = 0; i < hist.size(); i++) {
+    sum += hist[i];
+    if (sum >= total * percentile) return (i + 1) * bin_width;
+  }
+  return hist.size() * bin_width;
+}
+
+float Calibrator::KLThreshold(const std::vector<double>& hist,
+                              float bin_width) {
+  int bins = hist.size();
+  if (bins <= kLevels) return bins * bin_width;
+  double total = std::accumulate(hist.begin(), hist.end(), 0.);
+  if (total <= 0.) return 0.f;
+  double kept = std::accumulate(hist.begin(), hist.begin() + kLevels - 1, 0.);
+  double best_kl = std::numeric_limits<double>::max();
+  int best = bins;
+  std::vector<double> p, q;
+  for (int i = kLevels; i <= bins; i++) {
+    // The reference is the histogram clipped to the first i bins, and the
+    // candidate is the first i bins quantized to kLevels levels, expanded
+    // back to the non-empty bins.
+    kept += hist[i - 1];
+    p.assign(hist.begin(), hist.begin() + i);
+    p[i - 1] += total - kept;
+    q.assign(i, 0.);
+    for (int j = 0; j < kLevels; j++) {
+      int begin = static_cast<int64_t>(j) * i / kLevels;
+      int end = static_cast<int64_t>(j + 1) * i / kLevels;
+      double sum = 0.;
+      int nonzeros = 0;
+      for (int k = begin; k < end; k++) {
+        sum += hist[k];
+        nonzeros += hist[k] > 0.;
+      }
+      if (!nonzeros) continue;
+      for (int k = begin; k < end; k++) {
+        if (hist[k] > 0.) q[k] = sum / nonzeros;
+      }
+    }
+    double kl = KLDivergence(p, q);
+    if (kl < best_kl) {
+      best_kl = kl;
+      best = i;
+    }
+  }
+  return (best + 0.5f) * bin_width;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,108 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+#include "lite/model_parser/cpp/program_desc.h"
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+// How the threshold of |x| of an activation, which is quantized to 127, is
+// picked from the values collected:
+// - kMax: the max |x|,
+// - kPercentile: the `percentile` of |x|, so the rare outliers are clipped,
+// - kKL: the threshold minimizing the KL divergence between the histogram of
+//   |x| and the one quantized to 128 levels.
+enum class CalibrationAlgo { kMax = 0, kPercentile, kKL };
+
+struct CalibrationConfig {
+  CalibrationAlgo algo{CalibrationAlgo::kKL};
+  float percentile{0.9999f};
+  // The bins of the histograms of |x|.
+  int histogram_bins{2048};
+};
+
+// The post-training quantization, which quantizes the fp32 models to int8
+// without retraining them. The inputs of the quantizable ops, i.e. the convs
+// and the fcs whose targets have int8 kernels, are collected while the fp32
+// program runs on the sample data, e.g.
+//
+//   Calibrator calibrator(config);
+//   program.EnableCalibration(&calibrator);
+//   ...                          // Run the program on the samples.
+//   calibrator.QuantizeProgram(&desc, scope);
+//
+// and the int8 scales of them are calibrated by the algorithm of the config.
+// QuantizeProgram then sets the ops the same attributes as
+// lite_quant_dequant_fuse_pass does for the models trained with the fake
+// quantization, with the weights quantized by each output channel, so the
+// program optimized from it runs the calib and the int8 kernels.
+class Calibrator {
+ public:
+  explicit Calibrator(const CalibrationConfig& config = CalibrationConfig())
+      : config_(config) {}
+
+  // Watch the input of the op of `inst` if it is quantizable.
+  void Watch(const Instruction& inst);
+  // Collect the values of the outputs of `inst` which are watched, it is
+  // called after the instruction runs.
+  void Collect(const Instruction& inst, const Scope& scope);
+  // Collect the values of the activation `name`.
+  void Collect(const std::string& name, const Tensor& x);
+
+  // The int8 scale of the activation, i.e. the threshold / 127. Return false
+  // if no values of it are collected.
+  bool Scale(const std::string& name, float* scale) const;
+
+  // Quantize the quantizable ops of the main block of the program whose
+  // inputs are calibrated, the weights are quantized in `scope`.
+  void QuantizeProgram(cpp::ProgramDesc* desc, Scope* scope) const;
+
+  // Quantize the float weights `w` to int8 in place by the channels, which
+  // are the rows of w viewed as a matrix of `rows` rows if `by_rows`, or the
+  // columns otherwise. Return the scales of the channels.
+  static std::vector<float> QuantizeWeights(Tensor* w, int rows, bool by_rows);
+
+  // The thresholds of the histogram of |x| of the bins of `bin_width`.
+  static float PercentileThreshold(const std::vector<double>& hist,
+                                   float bin_width,
+                                   float percentile);
+  static float KLThreshold(const std::vector<double>& hist, float bin_width);
+
+ private:
+  // The histogram of |x| of the activation, it covers [0, bins * bin_width),
+  // the width is doubled or more when larger values are collected.
+  struct Stats {
+    float max_abs{0.f};
+    float bin_width{0.f};
+    std::vector<double> hist;
+  };
+
+  CalibrationConfig config_;
+  // The inputs and the weights of the quantizable ops.
+  std::set<std::string> watched_;
+  std::set<std::string> weights_;
+  std::map<std::string, Stats> stats_;
+};
+
+}  // namespace lite
+}  // namespace paddle
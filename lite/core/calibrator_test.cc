@@ -0,0 +1,118 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/calibrator.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+namespace paddle {
+namespace lite {
+
+void FillTensor(Tensor* x, const std::vector<float>& values) {
+  x->Resize({static_cast<int64_t>(values.size())});
+  std::copy(values.begin(), values.end(), x->mutable_data<float>());
+}
+
+TEST(Calibrator, histogram) {
+  CalibrationConfig config;
+  config.algo = CalibrationAlgo::kMax;
+  config.histogram_bins = 256;
+  Calibrator calibrator(config);
+  float scale;
+  ASSERT_FALSE(calibrator.Scale("x", &scale));
+
+  Tensor x;
+  FillTensor(&x, {0.f, 0.f});
+  calibrator.Collect("x", x);
+  ASSERT_TRUE(calibrator.Scale("x", &scale));
+  EXPECT_FLOAT_EQ(scale, 1.f);
+
+  FillTensor(&x, {-1.f, 0.5f, 0.25f});
+  calibrator.Collect("x", x);
+  // The histogram grows to cover the larger values.
+  FillTensor(&x, {3.f, -2.f});
+  calibrator.Collect("x", x);
+  ASSERT_TRUE(calibrator.Scale("x", &scale));
+  EXPECT_FLOAT_EQ(scale, 3.f / 127);
+}
+
+TEST(Calibrator, percentile) {
+  std::vector<double> hist(100, 1.);
+  EXPECT_FLOAT_EQ(Calibrator::PercentileThreshold(hist, 0.1f, 0.5f), 5.f);
+  EXPECT_FLOAT_EQ(Calibrator::PercentileThreshold(hist, 0.1f, 1.f), 10.f);
+
+  CalibrationConfig config;
+  config.algo = CalibrationAlgo::kPercentile;
+  config.percentile = 0.985f;
+  config.histogram_bins = 1000;
+  Calibrator calibrator(config);
+  // The 1% outliers of 100 are clipped.
+  std::vector<float> values(1000, 1.f);
+  for (int i = 0; i < 10; i++) values[i * 100] = 100.f;
+  Tensor x;
+  FillTensor(&x, values);
+  calibrator.Collect("x", x);
+  float scale;
+  ASSERT_TRUE(calibrator.Scale("x", &scale));
+  // The threshold is the upper bound of the bin of 1, the bins are 0.1 wide.
+  EXPECT_NEAR(scale * 127, 1.1f, 1e-5f);
+}
+
+TEST(Calibrator, kl) {
+  // A long tail of the rare values, the threshold clips most of it.
+  std::vector<double> hist(2048, 0.);
+  for (int i = 0; i < 512; i++) hist[i] = 1000. * std::exp(-i / 64.);
+  for (int i = 512; i < 2048; i += 64) hist[i] = 1.;
+  float threshold = Calibrator::KLThreshold(hist, 1.f);
+  EXPECT_GE(threshold, 128.f);
+  EXPECT_LT(threshold, 1024.f);
+
+  // No bins beyond the int8 levels to clip.
+  std::vector<double> short_hist(100, 1.);
+  EXPECT_FLOAT_EQ(Calibrator::KLThreshold(short_hist, 0.5f), 50.f);
+  std::vector<double> empty_hist(2048, 0.);
+  EXPECT_FLOAT_EQ(Calibrator::KLThreshold(empty_hist, 1.f), 0.f);
+}
+
+TEST(Calibrator, quantize_weights) {
+  // 2 rows of 3.
+  Tensor w;
+  w.Resize({2, 3});
+  float values[] = {1.f, -0.5f, 0.f, 0.2f, 0.1f, -0.4f};
+  std::copy(values, values + 6, w.mutable_data<float>());
+  Tensor w1;
+  w1.CopyDataFrom(w);
+
+  auto scales = Calibrator::QuantizeWeights(&w, 2, true);
+  ASSERT_EQ(scales.size(), 2UL);
+  EXPECT_FLOAT_EQ(scales[0], 1.f / 127);
+  EXPECT_FLOAT_EQ(scales[1], 0.4f / 127);
+  EXPECT_EQ(w.precision(), PRECISION(kInt8));
+  EXPECT_TRUE(w.persistable());
+  const int8_t* q = w.data<int8_t>();
+  int8_t expected[] = {127, -64, 0, 64, 32, -127};
+  for (int i = 0; i < 6; i++) EXPECT_EQ(q[i], expected[i]);
+
+  scales = Calibrator::QuantizeWeights(&w1, 2, false);
+  ASSERT_EQ(scales.size(), 3UL);
+  EXPECT_FLOAT_EQ(scales[0], 1.f / 127);
+  EXPECT_FLOAT_EQ(scales[1], 0.5f / 127);
+  EXPECT_FLOAT_EQ(scales[2], 0.4f / 127);
+  q = w1.data<int8_t>();
+  int8_t expected1[] = {127, -127, 0, 25, 25, -127};
+  for (int i = 0; i < 6; i++) EXPECT_EQ(q[i], expected1[i]);
+}
+
+}  // namespace lite
+}  // namespace paddle
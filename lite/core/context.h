@@ -29,6 +29,7 @@
 #include "lite/backends/npu/npu_helper.h"
 #endif
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -38,6 +39,7 @@
 #include "lite/core/device_info.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
+#include "lite/core/thread_pool.h"
 #include "lite/utils/all.h"
 
 #ifdef LITE_WITH_OPENCL
@@ -64,9 +66,28 @@ class Context<TargetType::kHost> {
   // NOTE: InitOnce should only be used by ContextScheduler
   void InitOnce() {}
 
-  void CopySharedTo(HostContext* ctx) {}
+  void CopySharedTo(HostContext* ctx) { ctx->thread_pool_ = thread_pool_; }
 
   std::string name() const { return "HostContext"; }
+
+  // The host kernels run in the calling thread only without a pool.
+  void SetThreadPool(const std::shared_ptr<ThreadPool>& pool) {
+    thread_pool_ = pool;
+  }
+  int threads() const { return thread_pool_ ? thread_pool_->threads() : 1; }
+
+  // Call `fn(i, tid)` for every i in [0, n) with the threads of the context,
+  // see ThreadPool::ParallelFor.
+  void ParallelFor(int n, const std::function<void(int, int)>& fn) const {
+    if (thread_pool_) {
+      thread_pool_->ParallelFor(n, fn);
+    } else {
+      for (int i = 0; i < n; i++) fn(i, 0);
+    }
+  }
+
+ private:
+  std::shared_ptr<ThreadPool> thread_pool_;
 };
 
 #ifdef LITE_WITH_NPU
@@ -101,34 +122,58 @@ class Context<TargetType::kARM> {
 
   void CopySharedTo(ARMContext* ctx) {}
 
+  // Run the kernel with `state`, which is shared by all the ARM kernels of a
+  // program, instead of the default run state of DeviceInfo.
+  void SetRunState(const std::shared_ptr<ARMRunState>& state) {
+    run_state_ = state;
+  }
+
   void SetRunMode(lite_api::PowerMode mode, int threads) {
-    return DeviceInfo::Global().SetRunMode(mode, threads);
+    if (!run_state_) {
+      return DeviceInfo::Global().SetRunMode(mode, threads);
+    }
+    DeviceInfo::Global().SetRunMode(run_state_.get(), mode, threads);
+    DeviceInfo::Global().BindThreads(*run_state_);
   }
   void SetCache(int l1size, int l2size, int l3size) {
     return DeviceInfo::Global().SetCache(l1size, l2size, l3size);
   }
-  void SetArch(ARMArch arch) { return DeviceInfo::Global().SetArch(arch); }
-
-  lite_api::PowerMode mode() const { return DeviceInfo::Global().mode(); }
-  int threads() const { return DeviceInfo::Global().threads(); }
-  ARMArch arch() const { return DeviceInfo::Global().arch(); }
-  int l1_cache_size() const { return DeviceInfo::Global().l1_cache_size(); }
-  int l2_cache_size() const { return DeviceInfo::Global().l2_cache_size(); }
-  int l3_cache_size() const { return DeviceInfo::Global().l3_cache_size(); }
-  int llc_size() const { return DeviceInfo::Global().llc_size(); }
-  bool has_dot() const { return DeviceInfo::Global().has_dot(); }
-  bool has_fp16() const { return DeviceInfo::Global().has_fp16(); }
+  void SetArch(ARMArch arch) { run_state()->arch = arch; }
+
+  lite_api::PowerMode mode() const { return run_state()->mode; }
+  int threads() const { return run_state()->active_ids.size(); }
+  ARMArch arch() const { return run_state()->arch; }
+  int l1_cache_size() const {
+    return DeviceInfo::Global().l1_cache_size(*run_state());
+  }
+  int l2_cache_size() const {
+    return DeviceInfo::Global().l2_cache_size(*run_state());
+  }
+  int l3_cache_size() const {
+    return DeviceInfo::Global().l3_cache_size(*run_state());
+  }
+  int llc_size() const { return DeviceInfo::Global().llc_size(*run_state()); }
+  bool has_dot() const { return DeviceInfo::Global().has_dot(*run_state()); }
+  bool has_fp16() const { return DeviceInfo::Global().has_fp16(*run_state()); }
 
   template <typename T>
   T* workspace_data() {
-    return DeviceInfo::Global().workspace_data<T>();
+    return reinterpret_cast<T*>(run_state()->workspace.mutable_data<int8_t>());
   }
 
   bool ExtendWorkspace(size_t size) {
-    return DeviceInfo::Global().ExtendWorkspace(size);
+    return DeviceInfo::Global().ExtendWorkspace(run_state(), size);
   }
 
   std::string name() const { return "ARMContext"; }
+
+ private:
+  ARMRunState* run_state() const {
+    return run_state_ ? run_state_.get()
+                      : DeviceInfo::Global().mutable_run_state();
+  }
+
+  std::shared_ptr<ARMRunState> run_state_;
 };
 #endif
 
@@ -240,19 +285,34 @@ class Context<TargetType::kX86> {
  public:
   Context() {}
 
-  Context(Context&& ctx) {}
+  Context(Context&& ctx) : thread_pool_(std::move(ctx.thread_pool_)) {}
 
   // NOTE: InitOnce should only be used by ContextScheduler
   void InitOnce() {}
 
-  void CopySharedTo(X86Context* ctx) {}
+  void CopySharedTo(X86Context* ctx) { ctx->thread_pool_ = thread_pool_; }
 
   std::string name() const { return "X86Context"; }
 
+  // The pool is shared by the x86 kernels of a program, the kernels run in
+  // the calling thread only without it.
+  void SetThreadPool(const std::shared_ptr<ThreadPool>& pool) {
+    thread_pool_ = pool;
+  }
+  int threads() const { return thread_pool_ ? thread_pool_->threads() : 1; }
+
+  // Call `fn(i, tid)` for every i in [0, n) with the threads of the context,
+  // see ThreadPool::ParallelFor.
+  void ParallelFor(int n, const std::function<void(int, int)>& fn) const {
+    if (thread_pool_) {
+      thread_pool_->ParallelFor(n, fn);
+    } else {
+      for (int i = 0; i < n; i++) fn(i, 0);
+    }
+  }
+
  private:
-  // overall information
-  //
-  // kernel information
+  std::shared_ptr<ThreadPool> thread_pool_;
 };
 #endif
 
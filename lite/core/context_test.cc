@@ -47,5 +47,31 @@ namespace lite {
 // }
 // #endif
 
+#ifdef LITE_WITH_ARM
+TEST(ARMContext, run_state) {
+  auto ctx1_p = ContextScheduler::Global().NewContext(TargetType::kARM);
+  auto ctx2_p = ContextScheduler::Global().NewContext(TargetType::kARM);
+  auto& ctx1 = ctx1_p->As<ARMContext>();
+  auto& ctx2 = ctx2_p->As<ARMContext>();
+
+  // Without a run state set, the contexts share the default one.
+  ASSERT_EQ(ctx1.workspace_data<int8_t>(), ctx2.workspace_data<int8_t>());
+
+  auto state1 = std::make_shared<ARMRunState>();
+  auto state2 = std::make_shared<ARMRunState>();
+  ctx1.SetRunState(state1);
+  ctx2.SetRunState(state2);
+  ctx1.SetRunMode(lite_api::LITE_POWER_NO_BIND, 1);
+  ctx2.SetRunMode(lite_api::LITE_POWER_NO_BIND, 2);
+  ASSERT_EQ(ctx1.threads(), 1);
+  ASSERT_NE(ctx1.workspace_data<int8_t>(), ctx2.workspace_data<int8_t>());
+  ASSERT_NE(ctx1.workspace_data<int8_t>(),
+            DeviceInfo::Global().workspace_data<int8_t>());
+
+  ASSERT_TRUE(ctx1.ExtendWorkspace(1024));
+  ASSERT_GE(state1->workspace.numel(), 1024 + ctx1.llc_size());
+}
+#endif
+
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,58 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <string>
+#include "lite/core/kernel.h"
+#include "lite/core/program.h"
+#include "lite/model_parser/cpp/block_desc.h"
+#include "lite/model_parser/cpp/op_desc.h"
+#include "lite/model_parser/cpp/var_desc.h"
+
+// The helpers of the tests to build the program descs.
+
+namespace paddle {
+namespace lite {
+
+inline void AddVar(cpp::BlockDesc* block,
+                   const std::string& name,
+                   bool persistable = false,
+                   cpp::VarDesc::Type type = cpp::VarDesc::Type::LOD_TENSOR) {
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName(name);
+  var->SetType(type);
+  var->SetPersistable(persistable);
+}
+
+// Add an op of one var for each argument. The kernel type of `place` is saved
+// in the op if the place is valid, as in an optimized program.
+inline cpp::OpDesc* AddOp(cpp::BlockDesc* block,
+                          const std::string& type,
+                          const std::map<std::string, std::string>& inputs,
+                          const std::map<std::string, std::string>& outputs,
+                          const Place& place = Place()) {
+  auto* op = block->AddOp<cpp::OpDesc>();
+  op->SetType(type);
+  for (auto& item : inputs) op->SetInput(item.first, {item.second});
+  for (auto& item : outputs) op->SetOutput(item.first, {item.second});
+  if (place.is_valid()) {
+    op->SetAttr(kKernelTypeAttr,
+                KernelBase::SerializeKernelType(type, "def", place));
+  }
+  return op;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -817,149 +817,158 @@ void DeviceInfo::SetCPUInfoByProb() {
 #endif  // LITE_WITH_LINUX
 }
 
-void DeviceInfo::RequestPowerFullMode(int thread_num) {
+void DeviceInfo::RequestPowerFullMode(int thread_num,
+                                      ARMRunState* state) const {
   int big_core_size = big_core_ids_.size();
   int little_core_size = little_core_ids_.size();
-  active_ids_.clear();
+  state->active_ids.clear();
   for (int i = 0; i < thread_num; ++i) {
     if (i < big_core_size) {
-      active_ids_.push_back(big_core_ids_[i]);
+      state->active_ids.push_back(big_core_ids_[i]);
     } else if (i < big_core_size + little_core_size) {
-      active_ids_.push_back(little_core_ids_[i - big_core_size]);
+      state->active_ids.push_back(little_core_ids_[i - big_core_size]);
     }
   }
-  mode_ = lite_api::PowerMode::LITE_POWER_FULL;
+  state->mode = lite_api::PowerMode::LITE_POWER_FULL;
 }
 
-void DeviceInfo::RequestPowerHighMode(int thread_num) {
+void DeviceInfo::RequestPowerHighMode(int thread_num,
+                                      ARMRunState* state) const {
   int big_core_size = big_core_ids_.size();
   int little_core_size = little_core_ids_.size();
-  active_ids_.clear();
+  state->active_ids.clear();
   if (big_core_size > 0) {
-    mode_ = lite_api::PowerMode::LITE_POWER_HIGH;
+    state->mode = lite_api::PowerMode::LITE_POWER_HIGH;
     if (thread_num > big_core_size) {
       LOG(ERROR) << "Request thread num: " << thread_num
                  << ", exceed the big cores size: " << big_core_size
                  << ", truncate thread num to " << big_core_size;
-      active_ids_ = big_core_ids_;
+      state->active_ids = big_core_ids_;
     } else {
       for (int i = 0; i < thread_num; ++i) {
-        active_ids_.push_back(big_core_ids_[big_core_size - 1 - i]);
+        state->active_ids.push_back(big_core_ids_[big_core_size - 1 - i]);
       }
     }
   } else {
-    mode_ = lite_api::PowerMode::LITE_POWER_LOW;
+    state->mode = lite_api::PowerMode::LITE_POWER_LOW;
     LOG(ERROR) << "HIGH POWER MODE is not support, switch to little cores.";
     if (thread_num > little_core_size) {
-      active_ids_ = little_core_ids_;
+      state->active_ids = little_core_ids_;
     } else {
       for (int i = 0; i < thread_num; ++i) {
-        active_ids_.push_back(little_core_ids_[i]);
+        state->active_ids.push_back(little_core_ids_[i]);
       }
     }
   }
 }
 
-void DeviceInfo::RequestPowerLowMode(int thread_num) {
+void DeviceInfo::RequestPowerLowMode(int thread_num,
+                                     ARMRunState* state) const {
   int big_core_size = big_core_ids_.size();
   int little_core_size = little_core_ids_.size();
-  active_ids_.clear();
+  state->active_ids.clear();
   if (little_core_size > 0) {
-    mode_ = lite_api::PowerMode::LITE_POWER_LOW;
+    state->mode = lite_api::PowerMode::LITE_POWER_LOW;
     if (thread_num > little_core_size) {
       LOG(WARNING) << "Request thread num: " << thread_num
                    << ", exceed the little cores size: " << little_core_size
                    << ", truncate thread num to " << little_core_size;
-      active_ids_ = little_core_ids_;
+      state->active_ids = little_core_ids_;
     } else {
       for (int i = 0; i < thread_num; i++) {
-        active_ids_.push_back(little_core_ids_[i]);
+        state->active_ids.push_back(little_core_ids_[i]);
       }
     }
   } else {
-    mode_ = lite_api::PowerMode::LITE_POWER_HIGH;
+    state->mode = lite_api::PowerMode::LITE_POWER_HIGH;
     LOG(WARNING) << "LOW POWER MODE is not support, switch to big cores";
     if (thread_num > big_core_size) {
-      active_ids_ = big_core_ids_;
+      state->active_ids = big_core_ids_;
     } else {
       for (int i = 0; i < thread_num; i++) {
-        active_ids_.push_back(big_core_ids_[i]);
+        state->active_ids.push_back(big_core_ids_[i]);
       }
     }
   }
 }
 
-void DeviceInfo::RequestPowerNoBindMode(int thread_num) {
-  active_ids_.clear();
+void DeviceInfo::RequestPowerNoBindMode(int thread_num,
+                                        ARMRunState* state) const {
+  state->active_ids.clear();
   if (thread_num > core_ids_.size()) {
-    active_ids_ = core_ids_;
+    state->active_ids = core_ids_;
   } else {
-    active_ids_.resize(thread_num);
+    state->active_ids.resize(thread_num);
     for (int i = 0; i < thread_num; ++i) {
       if (i < big_core_ids_.size()) {
-        active_ids_[i] = big_core_ids_[i];
+        state->active_ids[i] = big_core_ids_[i];
       } else {
-        active_ids_[i] = little_core_ids_[i - big_core_ids_.size()];
+        state->active_ids[i] = little_core_ids_[i - big_core_ids_.size()];
       }
     }
   }
-  mode_ = lite_api::PowerMode::LITE_POWER_NO_BIND;
+  state->mode = lite_api::PowerMode::LITE_POWER_NO_BIND;
 }
 
-void DeviceInfo::RequestPowerRandHighMode(int shift_num, int thread_num) {
+void DeviceInfo::RequestPowerRandHighMode(int shift_num,
+                                          int thread_num,
+                                          ARMRunState* state) const {
   int big_core_size = big_core_ids_.size();
   int little_core_size = little_core_ids_.size();
-  active_ids_.clear();
+  state->active_ids.clear();
   if (big_core_size > 0) {
-    mode_ = lite_api::PowerMode::LITE_POWER_RAND_HIGH;
+    state->mode = lite_api::PowerMode::LITE_POWER_RAND_HIGH;
     if (thread_num > big_core_size) {
       LOG(WARNING) << "Request thread num: " << thread_num
                    << ", exceed the big cores size: " << big_core_size
                    << ", truncate thread num to " << big_core_size;
-      active_ids_ = big_core_ids_;
+      state->active_ids = big_core_ids_;
     } else {
       for (int i = 0; i < thread_num; ++i) {
-        active_ids_.push_back(big_core_ids_[(i + shift_num) % big_core_size]);
+        state->active_ids.push_back(
+            big_core_ids_[(i + shift_num) % big_core_size]);
       }
     }
   } else {
-    mode_ = lite_api::PowerMode::LITE_POWER_LOW;
+    state->mode = lite_api::PowerMode::LITE_POWER_LOW;
     LOG(WARNING) << "HIGH POWER MODE is not support, switch to little cores.";
     if (thread_num > little_core_size) {
-      active_ids_ = little_core_ids_;
+      state->active_ids = little_core_ids_;
     } else {
       for (int i = 0; i < thread_num; ++i) {
-        active_ids_.push_back(little_core_ids_[i]);
+        state->active_ids.push_back(little_core_ids_[i]);
       }
     }
   }
 }
 
-void DeviceInfo::RequestPowerRandLowMode(int shift_num, int thread_num) {
+void DeviceInfo::RequestPowerRandLowMode(int shift_num,
+                                         int thread_num,
+                                         ARMRunState* state) const {
   int big_core_size = big_core_ids_.size();
   int little_core_size = little_core_ids_.size();
-  active_ids_.clear();
+  state->active_ids.clear();
   if (little_core_size > 0) {
-    mode_ = lite_api::PowerMode::LITE_POWER_RAND_LOW;
+    state->mode = lite_api::PowerMode::LITE_POWER_RAND_LOW;
     if (thread_num > little_core_size) {
       LOG(WARNING) << "Request thread num: " << thread_num
                    << ", exceed the little cores size: " << little_core_size
                    << ", truncate thread num to " << little_core_size;
-      active_ids_ = little_core_ids_;
+      state->active_ids = little_core_ids_;
     } else {
       for (int i = 0; i < thread_num; ++i) {
-        active_ids_.push_back(
+        state->active_ids.push_back(
             little_core_ids_[(i + shift_num) % little_core_size]);
       }
     }
   } else {
-    mode_ = lite_api::PowerMode::LITE_POWER_HIGH;
+    state->mode = lite_api::PowerMode::LITE_POWER_HIGH;
     LOG(WARNING) << "LOW POWER MODE is not support, switch to big cores.";
     if (thread_num > big_core_size) {
-      active_ids_ = big_core_ids_;
+      state->active_ids = big_core_ids_;
     } else {
       for (int i = 0; i < thread_num; ++i) {
-        active_ids_.push_back(big_core_ids_[i]);
+        state->active_ids.push_back(big_core_ids_[i]);
       }
     }
   }
@@ -1038,6 +1047,14 @@ int DeviceInfo::Setup() {
 }
 
 void DeviceInfo::SetRunMode(lite_api::PowerMode mode, int thread_num) {
+  SetRunMode(&run_state_, mode, thread_num);
+  BindThreads(run_state_);
+}
+
+void DeviceInfo::SetRunMode(ARMRunState* state,
+                            lite_api::PowerMode mode,
+                            int thread_num) {
+  CHECK(state);
 #ifdef ARM_WITH_OMP
   thread_num = std::min(thread_num, core_num_);
 #else
@@ -1052,65 +1069,67 @@ void DeviceInfo::SetRunMode(lite_api::PowerMode mode, int thread_num) {
   int shift_num = (count_ / 10) % big_core_size;
   switch (mode) {
     case lite_api::LITE_POWER_FULL:
-      RequestPowerFullMode(thread_num);
+      RequestPowerFullMode(thread_num, state);
       break;
     case lite_api::LITE_POWER_HIGH:
-      RequestPowerHighMode(thread_num);
+      RequestPowerHighMode(thread_num, state);
       break;
     case lite_api::LITE_POWER_LOW:
-      RequestPowerLowMode(thread_num);
+      RequestPowerLowMode(thread_num, state);
       break;
     case lite_api::LITE_POWER_NO_BIND:
-      RequestPowerNoBindMode(thread_num);
+      RequestPowerNoBindMode(thread_num, state);
       break;
     case lite_api::LITE_POWER_RAND_HIGH:
-      RequestPowerRandHighMode(shift_num, thread_num);
+      RequestPowerRandHighMode(shift_num, thread_num, state);
       break;
     case lite_api::LITE_POWER_RAND_LOW:
-      RequestPowerRandLowMode(shift_num, thread_num);
+      RequestPowerRandLowMode(shift_num, thread_num, state);
       break;
     default:
       LOG(FATAL) << "Unsupported power mode: " << mode;
       break;
   }
-  if (active_ids_.empty()) {
-    active_ids_.push_back(0);
+  if (state->active_ids.empty()) {
+    state->active_ids.push_back(0);
   }
-#ifdef ARM_WITH_OMP
-  omp_set_num_threads(active_ids_.size());
-#endif
-  if (mode_ != lite_api::LITE_POWER_NO_BIND) {
-    if (check_cpu_online(active_ids_)) {
-      bind_threads(active_ids_);
-    } else {
-      LOG(WARNING) << "Some cores are offline, switch to NO BIND MODE";
-      mode_ = lite_api::LITE_POWER_NO_BIND;
-    }
+  if (state->mode != lite_api::LITE_POWER_NO_BIND &&
+      !check_cpu_online(state->active_ids)) {
+    LOG(WARNING) << "Some cores are offline, switch to NO BIND MODE";
+    state->mode = lite_api::LITE_POWER_NO_BIND;
   }
 #else  // LITE_WITH_LINUX
   // only LITE_POWER_NO_BIND is supported in other OS
-  RequestPowerNoBindMode(thread_num);
+  RequestPowerNoBindMode(thread_num, state);
+#endif  // LITE_WITH_LINUX
+  //! alloc memory for sgemm in this context
+  state->workspace.Resize({llc_size(*state)});
+  state->workspace.mutable_data<int8_t>();
+  state->arch = archs_[state->active_ids[0]];
+}
+
+void DeviceInfo::BindThreads(const ARMRunState& state) const {
 #ifdef ARM_WITH_OMP
-  omp_set_num_threads(active_ids_.size());
+  omp_set_num_threads(state.active_ids.size());
 #endif
+#ifdef LITE_WITH_LINUX
+  if (state.mode != lite_api::LITE_POWER_NO_BIND) {
+    bind_threads(state.active_ids);
+  }
 #endif  // LITE_WITH_LINUX
-  //! alloc memory for sgemm in this context
-  workspace_.Resize({llc_size()});
-  workspace_.mutable_data<int8_t>();
-  arch_ = archs_[active_ids_[0]];
 }
 
 void DeviceInfo::SetCache(int l1size, int l2size, int l3size) {
   SetCacheInfo(0, 1, l1size);
   SetCacheInfo(1, 1, l2size);
   SetCacheInfo(2, 1, l3size);
-  workspace_.Resize({llc_size()});
-  workspace_.mutable_data<int8_t>();
+  run_state_.workspace.Resize({llc_size()});
+  run_state_.workspace.mutable_data<int8_t>();
 }
 
-bool DeviceInfo::ExtendWorkspace(size_t size) {
-  workspace_.Resize({size + llc_size()});
-  return workspace_.mutable_data<int8_t>() != nullptr;
+bool DeviceInfo::ExtendWorkspace(ARMRunState* state, size_t size) const {
+  state->workspace.Resize({size + llc_size(*state)});
+  return state->workspace.mutable_data<int8_t>() != nullptr;
 }
 
 #endif  // LITE_WITH_ARM
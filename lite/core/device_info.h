@@ -37,6 +37,21 @@ typedef enum {
   kARMArch_UNKOWN = -1
 } ARMArch;
 
+// The state the ARM kernels run with: the power mode, the cores the threads
+// are bound to and the workspace for the kernels. DeviceInfo holds a default
+// one for the whole process, and a RuntimeProgram can own another one, so
+// that predictors with different power modes and thread numbers can run in
+// one process without stepping on each other.
+struct ARMRunState {
+  // LITE_POWER_HIGH stands for using big cores,
+  // LITE_POWER_LOW stands for using small core,
+  // LITE_POWER_FULL stands for using all cores
+  lite_api::PowerMode mode{lite_api::LITE_POWER_NO_BIND};
+  std::vector<int> active_ids{0};
+  ARMArch arch{kARMArch_UNKOWN};
+  TensorLite workspace;
+};
+
 class DeviceInfo {
  public:
   static DeviceInfo& Global() {
@@ -51,29 +66,58 @@ class DeviceInfo {
 
   int Setup();
 
+  // Set the run mode of the default run state, and bind the calling thread.
   void SetRunMode(lite_api::PowerMode mode, int thread_num);
+  // Select the cores for `mode` and `thread_num` into `state`, and resize its
+  // workspace. The threads are not bound until BindThreads is called.
+  void SetRunMode(ARMRunState* state, lite_api::PowerMode mode, int thread_num);
+  // Set the OpenMP thread number of the calling thread, and bind its threads
+  // to the active cores of `state` if the mode asks for it.
+  void BindThreads(const ARMRunState& state) const;
   void SetCache(int l1size, int l2size, int l3size);
-  void SetArch(ARMArch arch) { arch_ = arch; }
-
-  lite_api::PowerMode mode() const { return mode_; }
-  int threads() const { return active_ids_.size(); }
-  ARMArch arch() const { return arch_; }
-  int l1_cache_size() const { return L1_cache_[active_ids_[0]]; }
-  int l2_cache_size() const { return L2_cache_[active_ids_[0]]; }
-  int l3_cache_size() const { return L3_cache_[active_ids_[0]]; }
-  int llc_size() const {
-    auto size = L3_cache_[active_ids_[0]] > 0 ? L3_cache_[active_ids_[0]]
-                                              : L2_cache_[active_ids_[0]];
+  void SetArch(ARMArch arch) { run_state_.arch = arch; }
+
+  ARMRunState* mutable_run_state() { return &run_state_; }
+
+  lite_api::PowerMode mode() const { return run_state_.mode; }
+  int threads() const { return run_state_.active_ids.size(); }
+  ARMArch arch() const { return run_state_.arch; }
+  int l1_cache_size() const { return l1_cache_size(run_state_); }
+  int l2_cache_size() const { return l2_cache_size(run_state_); }
+  int l3_cache_size() const { return l3_cache_size(run_state_); }
+  int llc_size() const { return llc_size(run_state_); }
+  bool has_dot() const { return has_dot(run_state_); }
+  bool has_fp16() const { return has_fp16(run_state_); }
+
+  int l1_cache_size(const ARMRunState& state) const {
+    return L1_cache_[state.active_ids[0]];
+  }
+  int l2_cache_size(const ARMRunState& state) const {
+    return L2_cache_[state.active_ids[0]];
+  }
+  int l3_cache_size(const ARMRunState& state) const {
+    return L3_cache_[state.active_ids[0]];
+  }
+  int llc_size(const ARMRunState& state) const {
+    int id = state.active_ids[0];
+    auto size = L3_cache_[id] > 0 ? L3_cache_[id] : L2_cache_[id];
     return size > 0 ? size : 512 * 1024;
   }
-  bool has_dot() const { return dot_[active_ids_[0]]; }
-  bool has_fp16() const { return fp16_[active_ids_[0]]; }
+  bool has_dot(const ARMRunState& state) const {
+    return dot_[state.active_ids[0]];
+  }
+  bool has_fp16(const ARMRunState& state) const {
+    return fp16_[state.active_ids[0]];
+  }
 
   template <typename T>
   T* workspace_data() {
-    return reinterpret_cast<T*>(workspace_.mutable_data<int8_t>());
+    return reinterpret_cast<T*>(run_state_.workspace.mutable_data<int8_t>());
+  }
+  bool ExtendWorkspace(size_t size) {
+    return ExtendWorkspace(&run_state_, size);
   }
-  bool ExtendWorkspace(size_t size);
+  bool ExtendWorkspace(ARMRunState* state, size_t size) const;
 
  private:
   int core_num_;
@@ -94,13 +138,7 @@ class DeviceInfo {
   std::vector<bool> fp16_;
   std::vector<bool> dot_;
 
-  ARMArch arch_;
-  // LITE_POWER_HIGH stands for using big cores,
-  // LITE_POWER_LOW stands for using small core,
-  // LITE_POWER_FULL stands for using all cores
-  lite_api::PowerMode mode_;
-  std::vector<int> active_ids_;
-  TensorLite workspace_;
+  ARMRunState run_state_;
   int64_t count_{0};
 
   void SetDotInfo(int argc, ...);
@@ -110,12 +148,16 @@ class DeviceInfo {
   void SetArchInfo(int argc, ...);
   bool SetCPUInfoByName();
   void SetCPUInfoByProb();
-  void RequestPowerFullMode(int thread_num);
-  void RequestPowerHighMode(int thread_num);
-  void RequestPowerLowMode(int thread_num);
-  void RequestPowerNoBindMode(int thread_num);
-  void RequestPowerRandHighMode(int shift_num, int thread_num);
-  void RequestPowerRandLowMode(int shift_num, int thread_num);
+  void RequestPowerFullMode(int thread_num, ARMRunState* state) const;
+  void RequestPowerHighMode(int thread_num, ARMRunState* state) const;
+  void RequestPowerLowMode(int thread_num, ARMRunState* state) const;
+  void RequestPowerNoBindMode(int thread_num, ARMRunState* state) const;
+  void RequestPowerRandHighMode(int shift_num,
+                                int thread_num,
+                                ARMRunState* state) const;
+  void RequestPowerRandLowMode(int shift_num,
+                               int thread_num,
+                               ARMRunState* state) const;
 
   DeviceInfo() = default;
 };
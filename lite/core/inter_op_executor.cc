@@ -0,0 +1,178 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/inter_op_executor.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+InterOpExecutor::InterOpExecutor(int threads)
+    : threads_(std::max(threads, 1)),
+      deques_(threads_),
+      deque_mutexes_(new std::mutex[threads_]) {
+  for (int tid = 1; tid < threads_; tid++) {
+    workers_.emplace_back(&InterOpExecutor::WorkerLoop, this, tid);
+  }
+}
+
+InterOpExecutor::~InterOpExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void InterOpExecutor::Build(const std::vector<std::vector<int>>& reads,
+                            const std::vector<std::vector<int>>& writes) {
+  CHECK_EQ(reads.size(), writes.size());
+  int n = reads.size();
+  std::vector<std::set<int>> preds(n);
+  // The last writer of a resource and its readers since then.
+  std::map<int, int> writer;
+  std::map<int, std::vector<int>> readers;
+  for (int i = 0; i < n; i++) {
+    for (int r : reads[i]) {
+      auto it = writer.find(r);
+      if (it != writer.end() && it->second != i) preds[i].insert(it->second);
+    }
+    for (int w : writes[i]) {
+      auto it = writer.find(w);
+      if (it != writer.end() && it->second != i) preds[i].insert(it->second);
+      for (int reader : readers[w]) {
+        if (reader != i) preds[i].insert(reader);
+      }
+    }
+    for (int r : reads[i]) readers[r].push_back(i);
+    for (int w : writes[i]) {
+      writer[w] = i;
+      readers[w].clear();
+    }
+  }
+
+  succs_.assign(n, {});
+  num_preds_.assign(n, 0);
+  for (int i = 0; i < n; i++) {
+    num_preds_[i] = preds[i].size();
+    for (int p : preds[i]) succs_[p].push_back(i);
+  }
+  pending_.reset(new std::atomic<int>[n]);
+}
+
+void InterOpExecutor::Run(const std::function<void(int, int)>& fn) {
+  int n = num_tasks();
+  if (n == 0) return;
+  fn_ = &fn;
+  for (int i = 0; i < n; i++) pending_[i] = num_preds_[i];
+  remaining_ = n;
+  int next = 0;
+  for (int i = 0; i < n; i++) {
+    if (num_preds_[i] == 0) Push(next++ % threads_, i);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+  }
+  cv_.notify_all();
+  Work(0);
+
+  // The workers may still be looking for tasks, wait for them to leave, so
+  // the next run starts clean.
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return active_ == 0; });
+  fn_ = nullptr;
+}
+
+void InterOpExecutor::Push(int tid, int task) {
+  {
+    std::lock_guard<std::mutex> lock(deque_mutexes_[tid]);
+    deques_[tid].push_back(task);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_++;
+  }
+  task_cv_.notify_one();
+}
+
+bool InterOpExecutor::Pop(int tid, int* task) {
+  {
+    std::lock_guard<std::mutex> lock(deque_mutexes_[tid]);
+    if (!deques_[tid].empty()) {
+      *task = deques_[tid].back();
+      deques_[tid].pop_back();
+      queued_--;
+      return true;
+    }
+  }
+  for (int k = 1; k < threads_; k++) {
+    int victim = (tid + k) % threads_;
+    std::lock_guard<std::mutex> lock(deque_mutexes_[victim]);
+    if (!deques_[victim].empty()) {
+      *task = deques_[victim].front();
+      deques_[victim].pop_front();
+      queued_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void InterOpExecutor::Work(int tid) {
+  while (remaining_ > 0) {
+    int task;
+    if (!Pop(tid, &task)) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_cv_.wait(lock, [this] { return queued_ > 0 || remaining_ == 0; });
+      continue;
+    }
+    (*fn_)(task, tid);
+    for (int succ : succs_[task]) {
+      if (--pending_[succ] == 0) Push(tid, succ);
+    }
+    if (--remaining_ == 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_cv_.notify_all();
+    }
+  }
+}
+
+void InterOpExecutor::WorkerLoop(int tid) {
+  uint64_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return stop_ || generation_ != generation; });
+      if (stop_) return;
+      generation = generation_;
+      active_++;
+    }
+    Work(tid);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      active_--;
+    }
+    done_cv_.notify_all();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,101 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * InterOpExecutor runs the tasks of a dependency graph, e.g. the instructions
+ * of a program, in a fixed set of threads, a task starts as soon as the tasks
+ * it depends on are done.
+ *
+ * The dependencies are derived from the resources the tasks read and write in
+ * their order in the program, a task depends on the last task writing a
+ * resource it reads or writes, and on the tasks reading a resource it writes
+ * since then. So the tasks run in any order the graph allows give the same
+ * results as in the program order.
+ *
+ * Every thread has a deque of the ready tasks, it runs the tasks it made
+ * ready last first, and steals the oldest ones of the other threads when its
+ * deque is empty. The calling thread takes part in the run, so an executor
+ * of `threads` threads starts `threads - 1` workers.
+ */
+class InterOpExecutor {
+ public:
+  explicit InterOpExecutor(int threads);
+  ~InterOpExecutor();
+
+  int threads() const { return threads_; }
+
+  // Build the graph of the tasks, `reads[i]` and `writes[i]` are the ids of
+  // the resources the i-th task reads and writes.
+  void Build(const std::vector<std::vector<int>>& reads,
+             const std::vector<std::vector<int>>& writes);
+
+  int num_tasks() const { return static_cast<int>(succs_.size()); }
+  // The tasks depending on the i-th task.
+  const std::vector<int>& successors(int i) const { return succs_[i]; }
+
+  // Call `fn(i, tid)` for every task and wait for all of them. `tid` in
+  // [0, threads()) is the index of the thread running the task.
+  void Run(const std::function<void(int i, int tid)>& fn);
+
+ private:
+  void WorkerLoop(int tid);
+  // Run the tasks until all of them are done.
+  void Work(int tid);
+  void Push(int tid, int task);
+  bool Pop(int tid, int* task);
+
+  int threads_;
+  std::vector<std::vector<int>> succs_;
+  std::vector<int> num_preds_;
+
+  // The state of the run.
+  const std::function<void(int, int)>* fn_{nullptr};
+  std::unique_ptr<std::atomic<int>[]> pending_;
+  std::atomic<int> remaining_{0};
+  std::atomic<int> queued_{0};
+  std::vector<std::deque<int>> deques_;
+  std::unique_ptr<std::mutex[]> deque_mutexes_;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  // Notified on a new run.
+  std::condition_variable cv_;
+  // Notified on a new ready task, or when the tasks are all done.
+  std::condition_variable task_cv_;
+  // Notified when a worker leaves the run.
+  std::condition_variable done_cv_;
+  uint64_t generation_{0};
+  // The workers in the run.
+  int active_{0};
+  bool stop_{false};
+
+  DISALLOW_COPY_AND_ASSIGN(InterOpExecutor);
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,86 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/inter_op_executor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(InterOpExecutor, dependencies) {
+  InterOpExecutor executor(2);
+  // 0 writes a, 1 and 2 read a and write b and c, 3 reads b and c and writes
+  // a, the readers of a run before it.
+  executor.Build({{}, {0}, {0}, {1, 2}}, {{0}, {1}, {2}, {0}});
+  ASSERT_EQ(executor.num_tasks(), 4);
+  EXPECT_EQ(executor.successors(0), std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(executor.successors(1), std::vector<int>({3}));
+  EXPECT_EQ(executor.successors(2), std::vector<int>({3}));
+  EXPECT_TRUE(executor.successors(3).empty());
+}
+
+TEST(InterOpExecutor, branches) {
+  for (int threads : {1, 2, 4}) {
+    InterOpExecutor executor(threads);
+    ASSERT_EQ(executor.threads(), threads);
+    // A diamond of two chains of 4 tasks between the first and the last one.
+    std::vector<std::vector<int>> reads{{}}, writes{{0}};
+    for (int branch = 0; branch < 2; branch++) {
+      for (int k = 0; k < 4; k++) {
+        int in = k == 0 ? 0 : 1 + branch * 4 + k - 1;
+        reads.push_back({in});
+        writes.push_back({1 + branch * 4 + k});
+      }
+    }
+    reads.push_back({4, 8});
+    writes.push_back({9});
+    executor.Build(reads, writes);
+    int n = executor.num_tasks();
+
+    // The most tasks running at a time.
+    std::atomic<int> max_running{0};
+    for (int repeat = 0; repeat < 10; repeat++) {
+      std::vector<std::atomic<int>> done(n);
+      for (auto& d : done) d = 0;
+      std::atomic<int> running{0}, bad{0};
+      executor.Run([&](int i, int tid) {
+        if (tid < 0 || tid >= threads) bad++;
+        for (int p = 0; p < i; p++) {
+          for (int s : executor.successors(p)) {
+            if (s == i && !done[p]) bad++;
+          }
+        }
+        int now = ++running;
+        int max = max_running;
+        while (now > max && !max_running.compare_exchange_weak(max, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        running--;
+        done[i]++;
+      });
+      for (int i = 0; i < n; i++) {
+        EXPECT_EQ(done[i], 1);
+      }
+      EXPECT_EQ(bad, 0);
+    }
+    // The two branches run concurrently.
+    EXPECT_EQ(max_running, threads > 1 ? 2 : 1);
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
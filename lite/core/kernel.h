@@ -91,6 +91,8 @@ class KernelBase {
   void SetContext(std::unique_ptr<KernelContext>&& ctx) {
     ctx_ = std::move(ctx);
   }
+  // Take the context back, e.g. from the implementation a kernel delegates to.
+  std::unique_ptr<KernelContext> ReleaseContext() { return std::move(ctx_); }
   template <typename T>
   void SetParam(T param) {
     param_.set<T>(param);
@@ -127,6 +129,49 @@ class KernelBase {
   void set_alias(const std::string& x) { alias_ = x; }
   const std::string& alias() const { return alias_; }
 
+  // For the kernels having several implementations of the computation, such
+  // as the direct, winograd and gemm-like convolutions, the names of the ones
+  // applicable to the current param, and the first is the one the kernel
+  // picks by its own rules. Empty for the other kernels.
+  virtual std::vector<std::string> ImplCandidates() const { return {}; }
+  // Ask the kernel to use the implementation `name`, it takes effect in the
+  // next launch. The kernel falls back to its own rules if `name` is not a
+  // candidate.
+  void set_impl_name(const std::string& name) {
+    if (name != impl_name_) {
+      impl_name_ = name;
+      is_first_epoch_ = true;
+    }
+  }
+  const std::string& impl_name() const { return impl_name_; }
+
+  // Pack the weights of the input `arg` the way the kernel computes with them
+  // on this device, e.g. the transformed winograd weights, so the model can
+  // save them in place of the input. `layout` names the packing, only the
+  // kernels packing the weights the same take them back. Returns false if the
+  // kernel does not pack its weights.
+  virtual bool PackWeights(std::string* arg,
+                           std::string* layout,
+                           Tensor* packed) {
+    return false;
+  }
+  // Give the kernel the weights it packed as `layout` before, it takes effect
+  // in the next launch. The input the weights were packed from may hold no
+  // data then.
+  void SetPackedWeights(const std::string& layout, const Tensor* packed) {
+    packed_weights_layout_ = layout;
+    packed_weights_ = packed;
+    is_first_epoch_ = true;
+  }
+  const std::string& packed_weights_layout() const {
+    return packed_weights_layout_;
+  }
+  // The weights given by `SetPackedWeights` if they are packed as `layout`,
+  // otherwise null.
+  const Tensor* packed_weights(const std::string& layout) const {
+    return layout == packed_weights_layout_ ? packed_weights_ : nullptr;
+  }
+
   virtual Place place() const = 0;
   virtual TargetType target() const = 0;
   virtual PrecisionType precision() const = 0;
@@ -169,6 +214,11 @@ class KernelBase {
   // The extra identity to help defficiate a specific kernel, op_type_ + alias_
   // is the unique ID for the kernel.
   std::string alias_{};
+  // The implementation asked by `set_impl_name`.
+  std::string impl_name_{};
+  // The weights loaded by `SetPackedWeights`, owned by the scope.
+  std::string packed_weights_layout_{};
+  const Tensor* packed_weights_{nullptr};
   bool is_first_epoch_{true};
 
 #ifdef LITE_WITH_PROFILE
@@ -0,0 +1,112 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_tuner.h"
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+bool KernelTuner::LoadCache(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    auto pos = line.find('\t');
+    if (line.empty() || pos == std::string::npos) continue;
+    cache_[line.substr(0, pos)] = line.substr(pos + 1);
+  }
+  updated_ = false;
+  return true;
+}
+
+void KernelTuner::SaveCache(const std::string& path) {
+  std::ofstream file(path);
+  CHECK(file.is_open()) << "Fail to open the tuning cache file " << path;
+  for (auto& item : cache_) {
+    file << item.first << "\t" << item.second << "\n";
+  }
+  updated_ = false;
+}
+
+std::string KernelTuner::Key(const Instruction& inst) {
+  // The output names tell the ops of the same kernel type and input shapes
+  // apart, e.g. the convs with different strides.
+  auto* op = const_cast<OpLite*>(inst.op());
+  std::stringstream ss;
+  ss << inst.kernel()->SerializedKernelType();
+  for (auto& name : op->op_info()->output_names()) {
+    ss << " " << name;
+  }
+  for (auto& name : op->op_info()->input_names()) {
+    auto* var = op->scope()->FindVar(name);
+    if (var && var->IsType<lite::Tensor>()) {
+      ss << " " << var->Get<lite::Tensor>().dims().repr();
+    }
+  }
+  return ss.str();
+}
+
+bool KernelTuner::Apply(Instruction* inst) {
+  auto* kernel = inst->mutable_kernel();
+  if (kernel->ImplCandidates().empty()) return false;
+  auto it = cache_.find(Key(*inst));
+  if (it != cache_.end()) {
+    kernel->set_impl_name(it->second);
+    return false;
+  }
+  return autotune_;
+}
+
+void KernelTuner::Tune(Instruction* inst) {
+  auto* kernel = inst->mutable_kernel();
+  auto candidates = kernel->ImplCandidates();
+  if (candidates.empty()) return;
+  std::string best;
+  double best_time = std::numeric_limits<double>::max();
+  for (auto& impl : candidates) {
+    kernel->set_impl_name(impl);
+    for (int i = 0; i < warmup_times_; i++) {
+      kernel->Launch();
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repeat_times_; i++) {
+      kernel->Launch();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double time =
+        std::chrono::duration<double, std::milli>(end - start).count() /
+        repeat_times_;
+    VLOG(4) << kernel->SerializedKernelType() << " impl " << impl << ": "
+            << time << " ms";
+    if (time < best_time) {
+      best_time = time;
+      best = impl;
+    }
+  }
+  // Leave the outputs computed by the picked implementation.
+  kernel->set_impl_name(best);
+  kernel->Launch();
+  cache_[Key(*inst)] = best;
+  updated_ = true;
+  VLOG(3) << "tuned " << kernel->SerializedKernelType() << ": " << best;
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,69 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <string>
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+// Picks the implementations of the kernels by timing them. For the kernels
+// having several implementations (see `KernelBase::ImplCandidates`), every
+// candidate is launched on the real inputs in the first run, and the fastest
+// one is kept. The picks are cached by the kernel type and the input shapes,
+// and the cache can be saved to and loaded from a file, so the tuning is done
+// once offline, e.g.
+//
+//   KernelTuner tuner;
+//   tuner.LoadCache("conv.tuning");  // If exists.
+//   ...                              // Run the program with the tuner.
+//   tuner.SaveCache("conv.tuning");
+class KernelTuner {
+ public:
+  // `autotune`: time the candidates missing in the cache, or only apply the
+  // cached picks.
+  explicit KernelTuner(bool autotune = true) : autotune_(autotune) {}
+
+  // The cache file has a line of "key\timpl" for every entry. Return false if
+  // the file can not be read.
+  bool LoadCache(const std::string& path);
+  void SaveCache(const std::string& path);
+
+  // Apply the cached pick to the kernel of `inst`, it takes effect in the
+  // next launch. Return whether the kernel needs to be tuned by `Tune`, which
+  // is called after the instruction runs, so the inputs are ready.
+  bool Apply(Instruction* inst);
+  // Launch every candidate and keep the fastest one.
+  void Tune(Instruction* inst);
+
+  // The cache key of the kernel of `inst` with the current input shapes.
+  static std::string Key(const Instruction& inst);
+
+  const std::map<std::string, std::string>& cache() const { return cache_; }
+  // Whether some entries are added since the cache is loaded or saved.
+  bool updated() const { return updated_; }
+
+ private:
+  bool autotune_{true};
+  bool updated_{false};
+  int warmup_times_{1};
+  int repeat_times_{3};
+  std::map<std::string, std::string> cache_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,44 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_tuner.h"
+#include <gtest/gtest.h>
+#include <fstream>
+
+namespace paddle {
+namespace lite {
+
+TEST(KernelTuner, cache) {
+  const std::string path = "kernel_tuner_test.cache";
+  {
+    std::ofstream file(path);
+    file << "conv2d/def/1/1/1 conv1.out {1,32,56,56}\twinograd\n";
+    file << "conv2d/def/1/1/1 conv2.out {1,64,28,28}\tgemm_like\n";
+  }
+  KernelTuner tuner;
+  ASSERT_FALSE(tuner.LoadCache("not_exist.cache"));
+  ASSERT_TRUE(tuner.LoadCache(path));
+  ASSERT_EQ(tuner.cache().size(), 2UL);
+  ASSERT_EQ(tuner.cache().at("conv2d/def/1/1/1 conv1.out {1,32,56,56}"),
+            "winograd");
+  ASSERT_FALSE(tuner.updated());
+
+  tuner.SaveCache(path);
+  KernelTuner tuner1(false);
+  ASSERT_TRUE(tuner1.LoadCache(path));
+  ASSERT_EQ(tuner1.cache(), tuner.cache());
+}
+
+}  // namespace lite
+}  // namespace paddle
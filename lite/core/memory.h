@@ -71,6 +71,10 @@ class Buffer {
  public:
   Buffer() = default;
   Buffer(TargetType target, size_t size) : space_(size), target_(target) {}
+  // Wrap an external memory region, the buffer does not own it and will not
+  // free it. A larger `ResetLazy` request falls back to an owned allocation.
+  Buffer(void* data, TargetType target, size_t size)
+      : space_(size), data_(data), own_data_(false), target_(target) {}
 
   void* data() const { return data_; }
   TargetType target() const { return target_; }
@@ -82,17 +86,20 @@ class Buffer {
       data_ = TargetMalloc(target, size);
       target_ = target;
       space_ = size;
+      own_data_ = true;
     }
   }
 
   void ResizeLazy(size_t size) { ResetLazy(target_, size); }
 
   void Free() {
-    if (space_ > 0) {
+    if (space_ > 0 && own_data_) {
       TargetFree(target_, data_);
     }
+    data_ = nullptr;
     target_ = TargetType::kHost;
     space_ = 0;
+    own_data_ = true;
   }
 
   void CopyDataFrom(const Buffer& other, size_t nbytes) {
@@ -108,6 +115,7 @@ class Buffer {
   // memory it actually malloced.
   size_t space_{0};
   void* data_{nullptr};
+  bool own_data_{true};
   TargetType target_{TargetType::kHost};
 };
 
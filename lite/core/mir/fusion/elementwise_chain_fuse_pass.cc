@@ -0,0 +1,238 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+using Code = operators::ElementwiseChainCode;
+
+// An instruction of an op, the binary ones read X and Y of the op, the unary
+// ones read X or the result of the previous instruction.
+struct Step {
+  Code code;
+  bool binary;
+  float alpha;
+  float beta;
+  int axis;
+};
+
+// Get the instructions of an op, false if it can't be fused.
+bool OpSteps(const OpInfo& op, std::vector<Step>* steps) {
+  static const std::map<std::string, Code> binary_ops = {
+      {"elementwise_add", Code::kAdd},
+      {"elementwise_sub", Code::kSub},
+      {"elementwise_mul", Code::kMul},
+      {"elementwise_div", Code::kDiv},
+      {"elementwise_max", Code::kMax},
+      {"fusion_elementwise_add_activation", Code::kAdd},
+      {"fusion_elementwise_sub_activation", Code::kSub},
+      {"fusion_elementwise_mul_activation", Code::kMul},
+      {"fusion_elementwise_div_activation", Code::kDiv},
+      {"fusion_elementwise_max_activation", Code::kMax}};
+  static const std::map<std::string, Code> unary_ops = {
+      {"relu", Code::kRelu},
+      {"sigmoid", Code::kSigmoid},
+      {"tanh", Code::kTanh},
+      {"exp", Code::kExp},
+      {"log", Code::kLog},
+      {"square", Code::kSquare}};
+  auto attr = [&](const std::string& name, float value) {
+    return op.HasAttr(name) ? op.GetAttr<float>(name) : value;
+  };
+
+  steps->clear();
+  const std::string& type = op.Type();
+  if (binary_ops.count(type)) {
+    if (!op.HasInput("Y") || op.Input("Y").size() != 1) return false;
+    int axis = op.HasAttr("axis") ? op.GetAttr<int>("axis") : -1;
+    steps->push_back({binary_ops.at(type), true, 0.f, 0.f, axis});
+    if (op.HasAttr("act_type")) {
+      if (op.GetAttr<std::string>("act_type") != "relu") return false;
+      steps->push_back({Code::kRelu, false, 0.f, 0.f, -1});
+    }
+  } else if (unary_ops.count(type)) {
+    steps->push_back({unary_ops.at(type), false, 0.f, 0.f, -1});
+  } else if (type == "relu6") {
+    steps->push_back({Code::kRelu6, false, attr("threshold", 6.f), 0.f, -1});
+  } else if (type == "leaky_relu") {
+    steps->push_back({Code::kLeakyRelu, false, attr("alpha", 0.02f), 0.f, -1});
+  } else if (type == "swish") {
+    steps->push_back({Code::kSwish, false, attr("beta", 1.f), 0.f, -1});
+  } else if (type == "hard_sigmoid") {
+    steps->push_back({Code::kHardSigmoid,
+                      false,
+                      attr("slope", 0.2f),
+                      attr("offset", 0.5f),
+                      -1});
+  } else if (type == "scale") {
+    float scale = attr("scale", 1.f);
+    float bias = attr("bias", 0.f);
+    if (op.HasAttr("bias_after_scale") &&
+        !op.GetAttr<bool>("bias_after_scale")) {
+      bias *= scale;
+    }
+    steps->push_back({Code::kScale, false, scale, bias, -1});
+  } else {
+    return false;
+  }
+  return op.HasInput("X") && op.Input("X").size() == 1 &&
+         op.HasOutput("Out") && op.Output("Out").size() == 1;
+}
+
+// Whether an op can be fused, i.e. its picked kernel computes floats on the
+// host, and its instructions are known.
+bool Chainable(Node* node, std::vector<Step>* steps) {
+  if (!node->IsStmt() || node->outlinks.size() != 1) return false;
+  auto& stmt = node->AsStmt();
+  if (stmt.kernels().size() != 1) return false;
+  auto& kernel = stmt.picked_kernel();
+  if (kernel.precision() != PRECISION(kFloat)) return false;
+  if (kernel.target() != TARGET(kHost) && kernel.target() != TARGET(kX86) &&
+      kernel.target() != TARGET(kARM)) {
+    return false;
+  }
+  if (stmt.op_info()->HasAttr("enable_int8")) return false;
+  return OpSteps(*stmt.op_info(), steps);
+}
+
+}  // namespace
+
+void ElementwiseChainFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The chains are collected before changing the graph, the fused ops are
+  // removed from it.
+  std::vector<std::vector<Node*>> chains;
+  std::unordered_set<Node*> visited;
+  std::vector<Step> steps;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (visited.count(node) || !Chainable(node, &steps)) continue;
+    std::vector<Node*> chain{node};
+    visited.insert(node);
+    while (true) {
+      auto* out = chain.back()->outlinks.front();
+      auto& arg = out->AsArg();
+      if (out->outlinks.size() != 1 || arg.is_weight || arg.is_persist ||
+          arg.is_outer) {
+        break;
+      }
+      auto* next = out->outlinks.front();
+      if (visited.count(next) || !Chainable(next, &steps)) break;
+      chain.push_back(next);
+      visited.insert(next);
+    }
+    if (chain.size() > 1) chains.push_back(chain);
+  }
+
+  for (auto& chain : chains) {
+    FuseChain(graph.get(), chain);
+  }
+}
+
+void ElementwiseChainFusePass::FuseChain(SSAGraph* graph,
+                                         const std::vector<Node*>& chain) {
+  // The vars read by the chain and not computed by it are the inputs.
+  std::vector<std::string> inputs;
+  std::unordered_set<std::string> computed;
+  for (auto* node : chain) {
+    auto* op = node->AsStmt().op_info();
+    for (auto* param : {"X", "Y"}) {
+      if (!op->HasInput(param)) continue;
+      auto name = op->Input(param).front();
+      if (computed.count(name) ||
+          std::find(inputs.begin(), inputs.end(), name) != inputs.end()) {
+        continue;
+      }
+      inputs.push_back(name);
+    }
+    computed.insert(op->Output("Out").front());
+  }
+
+  // The registers of the vars, the inputs are the first ones, see
+  // FusionElementwiseChainOp.
+  std::map<std::string, int> regs;
+  for (size_t i = 0; i < inputs.size(); i++) regs[inputs[i]] = i;
+  int num_regs = inputs.size();
+  std::vector<int> codes;
+  std::vector<float> attrs;
+  std::vector<Step> steps;
+  for (auto* node : chain) {
+    auto* op = node->AsStmt().op_info();
+    CHECK(OpSteps(*op, &steps));
+    int result = regs.at(op->Input("X").front());
+    for (auto& step : steps) {
+      int b = step.binary ? regs.at(op->Input("Y").front()) : -1;
+      codes.insert(codes.end(),
+                   {static_cast<int>(step.code), result, b, step.axis});
+      attrs.insert(attrs.end(), {step.alpha, step.beta});
+      result = num_regs++;
+    }
+    regs[op->Output("Out").front()] = result;
+  }
+
+  auto* out = chain.back()->outlinks.front();
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fusion_elementwise_chain");
+  op_desc.SetInput("X", inputs);
+  op_desc.SetOutput("Out", {out->AsArg().name});
+  op_desc.SetAttr("codes", codes);
+  op_desc.SetAttr("attrs", attrs);
+
+  auto op = LiteOpRegistry::Global().Create("fusion_elementwise_chain");
+  auto* scope = chain.front()->AsStmt().op()->scope();
+  op->Attach(op_desc, scope);
+  auto* new_op_node = graph->GraphCreateInstructNode(
+      op, {Place{TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW)}});
+
+  // The input nodes, in the order of the inputs of the op.
+  std::vector<Node*> input_nodes(inputs.size());
+  std::unordered_set<const Node*> nodes2rm;
+  for (auto* node : chain) {
+    nodes2rm.insert(node);
+    for (auto* in : node->inlinks) {
+      auto it = std::find(inputs.begin(), inputs.end(), in->AsArg().name);
+      if (it != inputs.end()) input_nodes[it - inputs.begin()] = in;
+    }
+    if (node != chain.back()) nodes2rm.insert(node->outlinks.front());
+  }
+  GraphSafeRemoveNodes(graph, nodes2rm);
+  for (auto* in : input_nodes) {
+    CHECK(in);
+    IR_NODE_LINK_TO(in, new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, out);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_elementwise_chain_fuse_pass,
+                  paddle::lite::mir::ElementwiseChainFusePass)
+    .BindTargets({TARGET(kAny)})
+    .BindKernel("fusion_elementwise_chain",
+                paddle::lite::Place(
+                    TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW)));
@@ -0,0 +1,47 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Fuse the chains of elementwise ops and activations, e.g.
+ * scale -> elementwise_add -> relu6, into a fusion_elementwise_chain op, so
+ * the intermediate tensors of the chain are never written to memory.
+ *
+ * The pass runs after static_kernel_pick_pass, and only the ops whose picked
+ * kernels are float kernels on the host, x86 or arm are fused, the fused op
+ * is run by the float host kernel. A chain is cut at the vars used by other
+ * ops too, or kept in the scope, i.e. the weights and the vars of the outer
+ * blocks.
+ */
+class ElementwiseChainFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  void FuseChain(SSAGraph* graph, const std::vector<Node*>& chain);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
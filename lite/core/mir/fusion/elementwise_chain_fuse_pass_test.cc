@@ -0,0 +1,130 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/desc_test_helper.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+using Code = operators::ElementwiseChainCode;
+
+// c = z * relu(x + y), where relu(x + y) is the Y of the mul, and c is read
+// by two chains:
+//   e = square(sigmoid(c)), cut at the persistable sigmoid(c),
+//   g = scale(tanh(c)).
+cpp::ProgramDesc ChainProgram() {
+  cpp::ProgramDesc desc;
+  auto* block = desc.AddBlock<cpp::BlockDesc>();
+  for (auto name : {"x", "y", "z", "a", "b", "c", "e", "f", "g"}) {
+    AddVar(block, name, false);
+  }
+  AddVar(block, "d", true);
+  AddOp(block, "elementwise_add", {{"X", "x"}, {"Y", "y"}}, {{"Out", "a"}})
+      ->SetAttr("axis", -1);
+  AddOp(block, "relu", {{"X", "a"}}, {{"Out", "b"}});
+  AddOp(block, "elementwise_mul", {{"X", "z"}, {"Y", "b"}}, {{"Out", "c"}})
+      ->SetAttr("axis", -1);
+  AddOp(block, "sigmoid", {{"X", "c"}}, {{"Out", "d"}});
+  AddOp(block, "square", {{"X", "d"}}, {{"Out", "e"}});
+  AddOp(block, "tanh", {{"X", "c"}}, {{"Out", "f"}});
+  auto* scale = AddOp(block, "scale", {{"X", "f"}}, {{"Out", "g"}});
+  scale->SetAttr("scale", 2.f);
+  scale->SetAttr("bias", 1.f);
+  scale->SetAttr("bias_after_scale", false);
+  return desc;
+}
+
+TEST(ElementwiseChainFusePass, fuse) {
+  std::vector<Place> places{Place{TARGET(kX86), PRECISION(kFloat)},
+                            Place{TARGET(kHost), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  for (auto name : {"x", "y", "z"}) scope->Var(name)->GetMutable<Tensor>();
+  Program program(ChainProgram(), scope, places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, places);
+  // The pass runs on the picked kernels.
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsStmt()) continue;
+    auto& kernels = node.AsStmt().kernels();
+    ASSERT_FALSE(kernels.empty()) << node.AsStmt().op_type();
+    kernels.resize(1);
+  }
+
+  ElementwiseChainFusePass pass;
+  pass.Apply(graph);
+
+  std::map<std::string, Node*> ops;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto* op_info = node->AsStmt().op_info();
+    ops[op_info->Type() + ":" + op_info->Output("Out").front()] = node;
+  }
+  ASSERT_EQ(ops.size(), 4UL);
+  ASSERT_TRUE(ops.count("sigmoid:d"));
+  ASSERT_TRUE(ops.count("square:e"));
+
+  // The registers are x, y, z, then the results in order.
+  ASSERT_TRUE(ops.count("fusion_elementwise_chain:c"));
+  auto* chain = ops.at("fusion_elementwise_chain:c");
+  auto* op_info = chain->AsStmt().op_info();
+  EXPECT_EQ(op_info->Input("X"), std::vector<std::string>({"x", "y", "z"}));
+  std::vector<int> codes{static_cast<int>(Code::kAdd), 0, 1, -1,
+                         static_cast<int>(Code::kRelu), 3, -1, -1,
+                         static_cast<int>(Code::kMul), 2, 4, -1};
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("codes"), codes);
+  std::vector<std::string> inlinks;
+  for (auto* in : chain->inlinks) inlinks.push_back(in->AsArg().name);
+  EXPECT_EQ(inlinks, std::vector<std::string>({"x", "y", "z"}));
+  ASSERT_EQ(chain->outlinks.size(), 1UL);
+  // c keeps its readers.
+  EXPECT_EQ(chain->outlinks.front()->outlinks.size(), 2UL);
+
+  ASSERT_TRUE(ops.count("fusion_elementwise_chain:g"));
+  op_info = ops.at("fusion_elementwise_chain:g")->AsStmt().op_info();
+  EXPECT_EQ(op_info->Input("X"), std::vector<std::string>({"c"}));
+  codes = {static_cast<int>(Code::kTanh), 0, -1, -1,
+           static_cast<int>(Code::kScale), 1, -1, -1};
+  EXPECT_EQ(op_info->GetAttr<std::vector<int>>("codes"), codes);
+  // The bias before the scale is scaled.
+  std::vector<float> attrs{0.f, 0.f, 2.f, 2.f};
+  EXPECT_EQ(op_info->GetAttr<std::vector<float>>("attrs"), attrs);
+
+  // The intermediate vars are removed.
+  for (auto& node : graph->mutable_nodes()) {
+    if (!node.IsArg()) continue;
+    auto& name = node.AsArg().name;
+    EXPECT_TRUE(name != "a" && name != "b" && name != "f") << name;
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(elementwise_mul);
+USE_LITE_OP(relu);
+USE_LITE_OP(sigmoid);
+USE_LITE_OP(square);
+USE_LITE_OP(tanh);
+USE_LITE_OP(scale);
+USE_LITE_OP(fusion_elementwise_chain);
@@ -0,0 +1,80 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/embedding_seqpool_fuser.h"
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+void EmbeddingSeqPoolFuser::BuildPattern() {
+  // create nodes.
+  auto* W = VarNode("W")->assert_is_op_input("lookup_table", "W");
+  auto* ids = VarNode("ids")->assert_is_op_input("lookup_table", "Ids");
+  // The fused kernel does not skip the padding ids.
+  auto* lookup_table =
+      OpNode("lookup_table", "lookup_table")
+          ->assert_op_attr_satisfied<int64_t>(
+              "padding_idx", [](const int64_t& idx) { return idx == -1; });
+  auto* emb = VarNode("emb")
+                  ->assert_is_op_output("lookup_table", "Out")
+                  ->assert_is_op_input("sequence_pool", "X");
+  auto* sequence_pool =
+      OpNode("sequence_pool", "sequence_pool")
+          ->assert_op_attr<std::string>("pooltype", "SUM");
+  auto* Out = VarNode("Out")->assert_is_op_output("sequence_pool", "Out");
+
+  // create topology.
+  std::vector<PMNode*> lookup_table_inputs{W, ids};
+  lookup_table_inputs >> *lookup_table >> *emb >> *sequence_pool >> *Out;
+
+  // Some op specialities.
+  emb->AsIntermediate();
+  lookup_table->AsIntermediate();
+  sequence_pool->AsIntermediate();
+}
+
+void EmbeddingSeqPoolFuser::InsertNewNode(SSAGraph* graph,
+                                          const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto fused_op = LiteOpRegistry::Global().Create("fused_embedding_seq_pool");
+  auto lookup_table = matched.at("lookup_table")->stmt()->op();
+  auto* scope = lookup_table->scope();
+  auto& valid_places = lookup_table->valid_places();
+  fused_op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(fused_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("W"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("ids"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("Out"));
+}
+
+cpp::OpDesc EmbeddingSeqPoolFuser::GenOpDesc(const key2nodes_t& matched) {
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_embedding_seq_pool");
+  op_desc.SetInput("W", {matched.at("W")->arg()->name});
+  op_desc.SetInput("Ids", {matched.at("ids")->arg()->name});
+  op_desc.SetOutput("Out", {matched.at("Out")->arg()->name});
+  op_desc.SetAttr<std::string>("combiner", "sum");
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
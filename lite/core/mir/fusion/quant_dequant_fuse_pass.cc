@@ -28,11 +28,16 @@ void QuantDequantFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
       "fake_quantize_range_abs_max", "fake_quantize_moving_average_abs_max"};
   std::unordered_set<std::string> quantized_op_types = {
       "conv2d", "mul", "depthwise_conv2d"};
+  std::unordered_set<std::string> dequant_types = {
+      "fake_dequantize_max_abs", "fake_channel_wise_dequantize_max_abs"};
   for (auto& quant_type : quant_types) {
     for (auto& op_type : quantized_op_types) {
-      for (int i = 6; i >= 1; i--) {
-        fusion::QuantDequantOpFuser fuser(op_type, quant_type, i);
-        fuser(graph.get());
+      for (auto& dequant_type : dequant_types) {
+        for (int i = 6; i >= 1; i--) {
+          fusion::QuantDequantOpFuser fuser(
+              op_type, quant_type, i, dequant_type);
+          fuser(graph.get());
+        }
       }
     }
   }
@@ -0,0 +1,142 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/quant_dequant_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/desc_test_helper.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// out = dequant(mul(quant(x), w)), the weights w of 3 rows and 4 columns are
+// dequantized by the channel-wise scales w_scale.
+cpp::ProgramDesc ChannelWiseMul() {
+  cpp::ProgramDesc desc;
+  auto* block = desc.AddBlock<cpp::BlockDesc>();
+  for (auto name : {"x", "xq", "x_scale", "m", "out"}) {
+    AddVar(block, name, false);
+  }
+  for (auto name : {"in_scale", "w", "w_scale"}) AddVar(block, name, true);
+
+  auto* quant = block->AddOp<cpp::OpDesc>();
+  quant->SetType("fake_quantize_moving_average_abs_max");
+  quant->SetInput("X", {"x"});
+  quant->SetInput("InScale", {"in_scale"});
+  quant->SetOutput("Out", {"xq"});
+  quant->SetOutput("OutScale", {"x_scale"});
+  quant->SetAttr("bit_length", 8);
+  auto* mul = block->AddOp<cpp::OpDesc>();
+  mul->SetType("mul");
+  mul->SetInput("X", {"xq"});
+  mul->SetInput("Y", {"w"});
+  mul->SetOutput("Out", {"m"});
+  mul->SetAttr("x_num_col_dims", 1);
+  mul->SetAttr("y_num_col_dims", 1);
+  auto* dequant = block->AddOp<cpp::OpDesc>();
+  dequant->SetType("fake_channel_wise_dequantize_max_abs");
+  dequant->SetInput("X", {"m"});
+  dequant->SetInput("Scales", {"w_scale", "x_scale"});
+  dequant->SetOutput("Out", {"out"});
+  dequant->SetAttr("quant_bits", std::vector<int>({8, 8}));
+  return desc;
+}
+
+void FillTensor(Scope* scope,
+                const std::string& name,
+                const DDim& dims,
+                const std::vector<float>& values) {
+  auto* t = scope->Var(name)->GetMutable<Tensor>();
+  t->Resize(dims);
+  std::copy(values.begin(), values.end(), t->mutable_data<float>());
+}
+
+std::unique_ptr<SSAGraph> FuseChannelWiseMul(std::shared_ptr<Scope> scope,
+                                             int scale_size) {
+  std::vector<Place> places{Place{TARGET(kX86), PRECISION(kFloat)}};
+  scope->Var("x")->GetMutable<Tensor>();
+  FillTensor(scope.get(), "in_scale", DDim({1}), {2.54f});
+  FillTensor(scope.get(),
+             "w",
+             DDim({3, 4}),
+             {1, -2, 3, 4, 5, 6, -7, 8, 9, 10, 11, -127});
+  std::vector<float> w_scale(scale_size);
+  for (int i = 0; i < scale_size; i++) w_scale[i] = 0.127f * (i + 1);
+  FillTensor(scope.get(), "w_scale", DDim({scale_size}), w_scale);
+
+  Program program(ChannelWiseMul(), scope, places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, places);
+  QuantDequantFusePass pass;
+  pass.Apply(graph);
+  return graph;
+}
+
+TEST(QuantDequantFusePass, channel_wise_mul) {
+  auto scope = std::make_shared<Scope>();
+  auto graph = FuseChannelWiseMul(scope, 4);
+  auto ops = graph->StmtTopologicalOrder();
+  ASSERT_EQ(ops.size(), 1UL);
+  auto* op_info = ops.front()->AsStmt().op_info();
+  EXPECT_EQ(op_info->Type(), "mul");
+  EXPECT_EQ(op_info->Input("X"), std::vector<std::string>({"x"}));
+  EXPECT_EQ(op_info->Output("Out"), std::vector<std::string>({"out"}));
+  EXPECT_TRUE(op_info->GetAttr<bool>("enable_int8"));
+  EXPECT_FLOAT_EQ(op_info->GetAttr<float>("input_scale"), 0.02f);
+  // A scale of each column of w.
+  auto weight_scale = op_info->GetAttr<std::vector<float>>("weight_scale");
+  ASSERT_EQ(weight_scale.size(), 4UL);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_FLOAT_EQ(weight_scale[i], 0.001f * (i + 1));
+  }
+
+  auto& w = scope->FindVar("w")->Get<Tensor>();
+  EXPECT_EQ(w.precision(), PRECISION(kInt8));
+  EXPECT_EQ(w.data<int8_t>()[11], -127);
+}
+
+TEST(QuantDequantFusePass, channel_wise_scales_mismatch) {
+  // 3 scales of the 4 columns, the match is left as it is.
+  auto scope = std::make_shared<Scope>();
+  auto graph = FuseChannelWiseMul(scope, 3);
+  std::vector<std::string> ops;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    ops.push_back(node->AsStmt().op_type());
+  }
+  EXPECT_EQ(ops,
+            std::vector<std::string>({"fake_quantize_moving_average_abs_max",
+                                      "mul",
+                                      "fake_channel_wise_dequantize_max_abs"}));
+  int args = 0;
+  for (auto& node : graph->mutable_nodes()) args += node.IsArg();
+  EXPECT_EQ(args, 8);
+
+  auto& w = scope->FindVar("w")->Get<Tensor>();
+  EXPECT_NE(w.precision(), PRECISION(kInt8));
+  EXPECT_FLOAT_EQ(w.data<float>()[11], -127.f);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(fake_quantize_moving_average_abs_max);
+USE_LITE_OP(fake_channel_wise_dequantize_max_abs);
+USE_LITE_OP(mul);
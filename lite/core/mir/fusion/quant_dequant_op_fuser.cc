@@ -30,6 +30,7 @@ void QuantDequantOpFuser::BuildPattern() {
   const int kDequantOpOffset = 3;
   const int kDequantOpOutOffset = 4;
 
+  bool channel_wise = dequant_type_ != "fake_dequantize_max_abs";
   std::string weight_name = "";
   if (op_type_ == "conv2d" || op_type_ == "depthwise_conv2d") {
     weight_name = "Filter";
@@ -46,18 +47,30 @@ void QuantDequantOpFuser::BuildPattern() {
                        ->assert_is_op(quant_type_)
                        ->AsIntermediate();
 
-  auto* quant_op_out_scale =
-      VarNode("quant_op_out_scale")
-          ->assert_is_op_output(quant_type_, "OutScale")
-          ->assert_is_op_input("fake_dequantize_max_abs", "Scale")
-          ->AsIntermediate();
+  // The channel-wise dequant op takes the scales of the weights and the
+  // input as Scales.
+  auto* quant_op_out_scale = VarNode("quant_op_out_scale")
+                                 ->assert_is_op_output(quant_type_, "OutScale")
+                                 ->AsIntermediate();
+  if (channel_wise) {
+    quant_op_out_scale->assert_is_op_nth_input(dequant_type_, "Scales", 1);
+  } else {
+    quant_op_out_scale->assert_is_op_input(dequant_type_, "Scale");
+  }
 
   auto* quant_op_out = VarNode("quant_op_out")
                            ->assert_is_op_output(quant_type_, "Out")
                            ->assert_is_op_input(op_type_)
                            ->AsIntermediate();
   std::vector<PMNode*> nodes;
+  std::vector<PMNode*> channel_scales;
   for (int i = 0; i < times_; i++) {
+    if (channel_wise) {
+      channel_scales.push_back(
+          VarNode(string_format("dequant_op_channel_scale%d", i))
+              ->assert_is_op_nth_input(dequant_type_, "Scales", 0)
+              ->AsIntermediate());
+    }
     nodes.push_back(VarNode(string_format("quantized_op_weight%d", i))
                         ->assert_is_op_input(op_type_, weight_name)
                         ->AsInput());
@@ -68,15 +81,14 @@ void QuantDequantOpFuser::BuildPattern() {
 
     nodes.push_back(VarNode(string_format("quantized_op_out%d", i))
                         ->assert_is_op_output(op_type_)
-                        ->assert_is_op_input("fake_dequantize_max_abs", "X")
+                        ->assert_is_op_input(dequant_type_, "X")
                         ->AsIntermediate());
 
-    nodes.push_back(
-        OpNode(string_format("dequant_op%d", i), "fake_dequantize_max_abs")
-            ->assert_is_op("fake_dequantize_max_abs")
-            ->AsIntermediate());
+    nodes.push_back(OpNode(string_format("dequant_op%d", i), dequant_type_)
+                        ->assert_is_op(dequant_type_)
+                        ->AsIntermediate());
     nodes.push_back(VarNode(string_format("dequant_op_out%d", i))
-                        ->assert_is_op_output("fake_dequantize_max_abs", "Out")
+                        ->assert_is_op_output(dequant_type_, "Out")
                         ->AsOutput());
   }
 
@@ -88,8 +100,10 @@ void QuantDequantOpFuser::BuildPattern() {
         {quant_op_out, nodes[i * kNumFields + kQuantizedWeightOffset]});
     nodes[i * kNumFields + kQuantizedOpOutOffset]->LinksFrom(
         {nodes[i * kNumFields + kQuantizedOpOffset]});
-    nodes[i * kNumFields + kDequantOpOffset]->LinksFrom(
-        {nodes[i * kNumFields + kQuantizedOpOutOffset], quant_op_out_scale});
+    std::vector<PMNode*> dequant_inputs{
+        nodes[i * kNumFields + kQuantizedOpOutOffset], quant_op_out_scale};
+    if (channel_wise) dequant_inputs.push_back(channel_scales[i]);
+    nodes[i * kNumFields + kDequantOpOffset]->LinksFrom(dequant_inputs);
     nodes[i * kNumFields + kDequantOpOutOffset]->LinksFrom(
         {nodes[i * kNumFields + kDequantOpOffset]});
   }
@@ -124,15 +138,35 @@ void QuantDequantOpFuser::InsertNewNode(SSAGraph* graph,
   float input_scale = input_scale_t->data<float>()[0] / range;
 
   VLOG(4) << "range: " << range << " input_scale: " << input_scale;
+  // The weights are changed in place below, so the scales of all of them are
+  // checked before fusing any.
+  if (dequant_type_ != "fake_dequantize_max_abs") {
+    for (int i = 0; i < times_; i++) {
+      auto weight_name =
+          nodes[i * kNumFields + kQuantizedWeightOffset]->arg()->name;
+      auto weight_dims =
+          scope->FindVar(weight_name)->GetMutable<lite::Tensor>()->dims();
+      auto channel_scale_name =
+          matched.at(string_format("dequant_op_channel_scale%d", i))
+              ->arg()
+              ->name;
+      int64_t channel_scale_size = scope->FindVar(channel_scale_name)
+                                       ->GetMutable<lite::Tensor>()
+                                       ->numel();
+      int64_t out_channels =
+          op_type_ == "mul" ? weight_dims[1] : weight_dims[0];
+      if (channel_scale_size != out_channels) {
+        LOG(WARNING) << "skip fusing " << op_type_ << " of " << weight_name
+                     << ", it has " << out_channels << " output channels but "
+                     << channel_scale_size << " channel scales";
+        SkipMatched(matched);
+        return;
+      }
+    }
+  }
   for (int i = 0; i < times_; i++) {
-    float max_range = nodes[i * kNumFields + kDequantOpOffset]
-                          ->stmt()
-                          ->op_info()
-                          ->GetAttr<float>("max_range");
-    // weight_scale = max(abs(weight))
-    float whole_weight_scale =
-        static_cast<float>(range * range) / max_range / range;
-
+    auto* dequant_op_info =
+        nodes[i * kNumFields + kDequantOpOffset]->stmt()->op_info();
     cpp::OpDesc op_desc =
         *nodes[i * kNumFields + kQuantizedOpOffset]->stmt()->op_info();
 
@@ -141,7 +175,7 @@ void QuantDequantOpFuser::InsertNewNode(SSAGraph* graph,
     auto quantized_weight_t =
         scope->FindVar(quantized_weight_var_name)->GetMutable<lite::Tensor>();
     std::vector<float> weight_scale;
-    int weight_scale_size;
+    int weight_scale_size = 0;
 
     if (op_type_ == "conv2d" || op_type_ == "depthwise_conv2d") {
       op_desc.SetInput("Input", {matched.at("quant_op_input")->arg()->name});
@@ -157,8 +191,29 @@ void QuantDequantOpFuser::InsertNewNode(SSAGraph* graph,
       // Fc weight: Cin * Cout, the weight_scale_size should be Cout.
       weight_scale_size = quantized_weight_t->dims()[1];
     }
-    for (int i = 0; i < weight_scale_size; i++) {
-      weight_scale.push_back(whole_weight_scale);
+    if (dequant_type_ == "fake_dequantize_max_abs") {
+      float max_range = dequant_op_info->GetAttr<float>("max_range");
+      // weight_scale = max(abs(weight))
+      float whole_weight_scale =
+          static_cast<float>(range * range) / max_range / range;
+      for (int i = 0; i < weight_scale_size; i++) {
+        weight_scale.push_back(whole_weight_scale);
+      }
+    } else {
+      // The first scale is max(abs(weight)) of each output channel.
+      int weight_bits =
+          dequant_op_info->GetAttr<std::vector<int>>("quant_bits").front();
+      int weight_range = (1 << (weight_bits - 1)) - 1;
+      auto channel_scale_name =
+          matched.at(string_format("dequant_op_channel_scale%d", i))
+              ->arg()
+              ->name;
+      auto* channel_scale_t =
+          scope->FindVar(channel_scale_name)->GetMutable<lite::Tensor>();
+      const float* channel_scale = channel_scale_t->data<float>();
+      for (int c = 0; c < weight_scale_size; c++) {
+        weight_scale.push_back(channel_scale[c] / weight_range);
+      }
     }
     op_desc.SetAttr("enable_int8", true);
     op_desc.SetAttr("input_scale", input_scale);
@@ -34,13 +34,23 @@ namespace fusion {
  * the quantized_op.
  * In addition, the fuser delete fake_quant and fake_dequant op in the graph at
  * the last.
+ *
+ * The weights quantized by each output channel are dequantized by
+ * fake_channel_wise_dequantize_max_abs, whose first scale is the one of the
+ * weights of each channel, so the weight_scale is per channel. Otherwise a
+ * single scale of the whole weights is set for every channel.
  */
 class QuantDequantOpFuser : public FuseBase {
  public:
   explicit QuantDequantOpFuser(const std::string& op_type,
                                const std::string& quant_type,
-                               int times)
-      : op_type_(op_type), quant_type_(quant_type), times_(times) {}
+                               int times,
+                               const std::string& dequant_type =
+                                   "fake_dequantize_max_abs")
+      : op_type_(op_type),
+        quant_type_(quant_type),
+        dequant_type_(dequant_type),
+        times_(times) {}
   void BuildPattern() override;
   void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
 
@@ -50,6 +60,7 @@ class QuantDequantOpFuser : public FuseBase {
  private:
   std::string op_type_{"conv2d"};
   std::string quant_type_;
+  std::string dequant_type_;
   int times_;
 };
 
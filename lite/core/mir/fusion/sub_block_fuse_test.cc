@@ -0,0 +1,94 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/desc_test_helper.h"
+#include "lite/core/mir/fusion/elementwise_add_activation_fuse_pass.h"
+#include "lite/core/mir/ssa_graph.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// The body of a while op, out = relu(x + y), with `t` = x + y declared in the
+// main block if `t_is_outer`, i.e. the main block or the condition reads it.
+cpp::ProgramDesc WhileBody(bool t_is_outer) {
+  cpp::ProgramDesc desc;
+  desc.AddBlock<cpp::BlockDesc>();
+  desc.AddBlock<cpp::BlockDesc>();
+  auto* main_block = desc.GetBlock<cpp::BlockDesc>(0);
+  auto* sub_block = desc.GetBlock<cpp::BlockDesc>(1);
+  for (auto name : {"x", "y", "out", "cond"}) AddVar(main_block, name);
+  AddVar(t_is_outer ? main_block : sub_block, "t");
+
+  auto* add = sub_block->AddOp<cpp::OpDesc>();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"x"});
+  add->SetInput("Y", {"y"});
+  add->SetOutput("Out", {"t"});
+  add->SetAttr("axis", -1);
+  auto* relu = sub_block->AddOp<cpp::OpDesc>();
+  relu->SetType("relu");
+  relu->SetInput("X", {"t"});
+  relu->SetOutput("Out", {"out"});
+  return desc;
+}
+
+std::vector<std::string> FuseSubBlock(bool t_is_outer) {
+  std::vector<Place> places{Place{TARGET(kX86), PRECISION(kFloat)}};
+  Scope scope;
+  for (auto name : {"x", "y", "t", "out", "cond"}) {
+    scope.Var(name)->GetMutable<Tensor>();
+  }
+  Program program(WhileBody(t_is_outer), 1, &scope, places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, places);
+  ElementwiseAddActivationFusePass pass;
+  pass.Apply(graph);
+
+  std::vector<std::string> ops;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    ops.push_back(node->AsStmt().op_type());
+  }
+  return ops;
+}
+
+TEST(SubBlockFuse, local_intermediate) {
+  auto ops = FuseSubBlock(false);
+  ASSERT_EQ(ops.size(), 1UL);
+  EXPECT_EQ(ops[0], "fusion_elementwise_add_activation");
+}
+
+TEST(SubBlockFuse, outer_intermediate) {
+  // t is read outside the sub-block, so it is still produced.
+  auto ops = FuseSubBlock(true);
+  ASSERT_EQ(ops.size(), 2UL);
+  EXPECT_EQ(ops[0], "elementwise_add");
+  EXPECT_EQ(ops[1], "relu");
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(fusion_elementwise_add_activation);
+USE_LITE_OP(relu);
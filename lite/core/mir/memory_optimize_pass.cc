@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "lite/core/mir/memory_optimize_pass.h"
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -24,6 +27,8 @@ namespace paddle {
 namespace lite {
 namespace mir {
 
+constexpr size_t MemoryOptimizePass::kArenaAlignment;
+
 typedef struct {
   std::string name;
   int cluster;
@@ -72,6 +77,14 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
     return true;
   };
 
+  // The vars of a sub-block living across its runs keep their memory.
+  std::set<std::string> outer_vars;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg() && node.AsArg().is_outer) {
+      outer_vars.insert(node.AsArg().name);
+    }
+  }
+
   for (auto& op_node : graph->StmtTopologicalOrder()) {
     if (op_node->IsStmt()) {
       auto inputs = op_node->inlinks;
@@ -82,6 +95,7 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
         CHECK(node->IsArg());
         auto& arg = node->AsArg();
         if (arg.is_weight || arg.is_persist) continue;
+        if (outer_vars.count(arg.name)) continue;
         if (!valid_var(node)) continue;
         std::string var_name = arg.name;
         TargetType target_type = node->AsArg().type->target();
@@ -103,6 +117,123 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
   LOG(INFO) << "There are " << (*lifecycles).size() << " types device var.";
 }
 
+bool MemoryOptimizePass::InferVarShapes(SSAGraph* graph) {
+  // The inputs of a sub-block are not known before the block runs.
+  if (graph->block_idx() > 0) return false;
+  auto nodes = graph->StmtTopologicalOrder();
+  lite::Scope* scope = nullptr;
+  for (auto* node : nodes) {
+    if (!node->IsStmt()) continue;
+    auto& stmt = node->AsStmt();
+    // The input data is not computed before the kernels run.
+    if (stmt.op()->InferShapeDependsOnData()) {
+      VLOG(4) << "The output shape of " << stmt.op_type()
+              << " depends on the input data";
+      return false;
+    }
+    if (!scope) scope = stmt.op()->scope();
+  }
+  if (!scope) return false;
+
+  auto* feed_var = scope->FindVar("feed");
+  if (!feed_var) return false;
+  auto& feed_list = feed_var->Get<std::vector<lite::Tensor>>();
+  if (feed_list.empty()) return false;
+  for (auto& feed : feed_list) {
+    if (feed.dims().empty()) return false;
+  }
+
+  for (auto* node : nodes) {
+    if (!node->IsStmt()) continue;
+    auto& stmt = node->AsStmt();
+    if (!stmt.op()->CheckShape() || !stmt.op()->InferShape()) {
+      LOG(WARNING) << "Failed to infer the shape of " << stmt.op_type();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MemoryOptimizePass::CollectVarSizes(SSAGraph* graph,
+                                         const lifecycle_map_t& lifecycles,
+                                         std::vector<MemoryBlock>* blocks) {
+  std::unordered_map<std::string, Node*> var_nodes;
+  lite::Scope* scope = nullptr;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg()) {
+      var_nodes[node.AsArg().name] = &node;
+    } else if (node.IsStmt() && !scope) {
+      scope = node.AsStmt().op()->scope();
+    }
+  }
+  CHECK(scope);
+
+  blocks->clear();
+  for (auto& item : lifecycles) {
+    auto* var = scope->FindVar(item.first);
+    auto it = var_nodes.find(item.first);
+    if (!var || !var->IsType<lite::Tensor>() || it == var_nodes.end()) {
+      return false;
+    }
+    auto& dims = var->Get<lite::Tensor>().dims();
+    if (dims.empty() || dims.production() <= 0) return false;
+    auto* type = it->second->AsArg().type;
+    size_t elem_size =
+        type ? PrecisionTypeLength(type->precision()) : sizeof(float);
+    MemoryBlock block;
+    block.name = item.first;
+    block.lifecycle = item.second;
+    block.size = dims.production() * elem_size;
+    blocks->push_back(block);
+  }
+  return true;
+}
+
+size_t MemoryOptimizePass::MakeOffsetPlan(std::vector<MemoryBlock>* blocks,
+                                          size_t alignment) {
+  auto align = [=](size_t x) {
+    return (x + alignment - 1) / alignment * alignment;
+  };
+  auto overlap = [](lifecycle_t a, lifecycle_t b) -> bool {
+    return b.second >= a.first && a.second >= b.first;
+  };
+  // Place the large blocks first, they are the hardest to fit. Sort by the
+  // lifecycle and name too, to make the plan deterministic.
+  std::sort(blocks->begin(),
+            blocks->end(),
+            [](const MemoryBlock& a, const MemoryBlock& b) {
+              if (a.size != b.size) return a.size > b.size;
+              if (a.lifecycle != b.lifecycle) return a.lifecycle < b.lifecycle;
+              return a.name < b.name;
+            });
+
+  size_t arena_size = 0;
+  // The placed blocks ordered by offset.
+  std::multimap<size_t, const MemoryBlock*> placed;
+  for (auto& block : *blocks) {
+    size_t best_offset = 0;
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t prev_end = 0;
+    for (auto& item : placed) {
+      auto* other = item.second;
+      if (!overlap(block.lifecycle, other->lifecycle)) continue;
+      if (other->offset >= prev_end) {
+        size_t gap = other->offset - prev_end;
+        if (gap >= block.size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = prev_end;
+        }
+      }
+      prev_end = std::max(prev_end, align(other->offset + other->size));
+    }
+    block.offset =
+        best_gap == std::numeric_limits<size_t>::max() ? prev_end : best_offset;
+    placed.emplace(block.offset, &block);
+    arena_size = std::max(arena_size, align(block.offset + block.size));
+  }
+  return arena_size;
+}
+
 void MemoryOptimizePass::MakeReusePlan(
     const lifecycle_map_t& lifecycles,
     std::unordered_map<std::string, std::string>* node2cluster) {
@@ -230,6 +361,32 @@ void MemoryOptimizePass::PerformReusePlan(
   }
 }
 
+void MemoryOptimizePass::PerformOffsetPlan(
+    SSAGraph* graph,
+    const std::string& device,
+    const std::vector<MemoryBlock>& blocks,
+    size_t arena_size,
+    const std::unordered_map<std::string, std::string>& reuse_table) {
+  lite::Scope* scope = nullptr;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsStmt()) {
+      scope = node.AsStmt().op()->scope();
+      break;
+    }
+  }
+
+  MemoryArenaPlan plan;
+  plan.device = device;
+  plan.size = arena_size;
+  for (auto& block : blocks) {
+    plan.blocks.push_back({block.name, block.offset, block.size});
+  }
+  plan.reuse_table = reuse_table;
+  plan.Bind(scope);
+  // Kept for the runtime programs created from the optimized program.
+  graph->AddMemoryArenaPlan(plan);
+}
+
 void MemoryOptimizePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   // Memory optimization.
   // We will perform the following operation:
@@ -241,11 +398,27 @@ void MemoryOptimizePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   // name of var and the value in the table represents the current name of var.
   // 3. Perform reuse plan: Replace all var's name in the model according to the
   // mapping table.
+  // If the shapes of the vars are known, the host vars are placed in a memory
+  // arena instead, with the offsets planned by their sizes and lifecycles.
   std::unordered_map<std::string, lifecycle_map_t> lifecycles;
   CollectLifeCycleByDevice(&lifecycles, graph.get());
+  bool shape_inferred = InferVarShapes(graph.get());
   for (auto& ele : lifecycles) {
+    std::vector<MemoryBlock> blocks;
     std::unordered_map<std::string, std::string> node2cluster;
     MakeReusePlan(ele.second, &node2cluster);
+    if (shape_inferred && ele.first == TargetToStr(TARGET(kHost)) &&
+        CollectVarSizes(graph.get(), ele.second, &blocks)) {
+      size_t total_size = 0;
+      for (auto& block : blocks) total_size += block.size;
+      size_t arena_size = MakeOffsetPlan(&blocks);
+      LOG(INFO) << "memory arena of " << ele.first << ": " << blocks.size()
+                << " vars, " << arena_size << " bytes, " << total_size
+                << " bytes without reuse";
+      PerformOffsetPlan(
+          graph.get(), ele.first, blocks, arena_size, node2cluster);
+      continue;
+    }
     PerformReusePlan(graph.get(), node2cluster);
   }
 }
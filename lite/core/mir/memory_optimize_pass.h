@@ -33,23 +33,67 @@ namespace lite {
 namespace mir {
 
 /*
- * MemoryOptimizePass will
+ * MemoryOptimizePass will reuse the memory of the temporary vars whose
+ * lifecycles do not overlap.
+ *
+ * If the shapes of all the vars on the host can be inferred, that is the input
+ * dims are set before the runtime program is generated, the host vars are
+ * packed into one memory arena with an offset for each var. Otherwise, the
+ * vars are grouped into clusters by lifecycle and renamed to share a tensor.
+ * The arena is only bound at runtime, the saved programs take the clusters,
+ * see RuntimeProgram::SaveMemoryReuseToProgram.
+ *
+ * In a sub-block, e.g. the body of a while op, only the vars produced and
+ * used within one run of the block are reused, by clusters.
  */
 class MemoryOptimizePass : public ProgramPass {
  public:
   using lifecycle_t = std::pair<int, int>;
   using lifecycle_map_t = std::unordered_map<std::string, lifecycle_t>;
+
+  // A var placed in the memory arena.
+  struct MemoryBlock {
+    std::string name;
+    lifecycle_t lifecycle;
+    size_t size{0};
+    size_t offset{0};
+  };
+
+  static constexpr size_t kArenaAlignment = 64;
+
   void Apply(const std::unique_ptr<SSAGraph>& graph) override;
 
+  // Assign an offset to each block, the blocks whose lifecycles overlap never
+  // overlap in memory. Blocks are placed from the largest to the smallest,
+  // each in the best fitting gap left by the placed ones. Returns the size of
+  // the arena.
+  static size_t MakeOffsetPlan(std::vector<MemoryBlock>* blocks,
+                               size_t alignment = kArenaAlignment);
+
  private:
   void CollectLifeCycleByDevice(
       std::unordered_map<std::string, lifecycle_map_t>* lifecycles, SSAGraph*);
+  // Run InferShape of all the ops to get the shapes of the vars, return false
+  // if the shapes can not be inferred before running the kernels.
+  bool InferVarShapes(SSAGraph* graph);
+  // Get the byte size of the vars, return false if any of them is unknown.
+  bool CollectVarSizes(SSAGraph* graph,
+                       const lifecycle_map_t& lifecycles,
+                       std::vector<MemoryBlock>* blocks);
   void MakeReusePlan(
       const lifecycle_map_t& lifecycles,
       std::unordered_map<std::string, std::string>* node2cluster);
   void PerformReusePlan(
       SSAGraph* graph,
       const std::unordered_map<std::string, std::string>& reuse_table);
+  // Bind the vars to the arena of `blocks`, and keep the plan with the
+  // `reuse_table` of the same vars for the saved programs in the graph.
+  void PerformOffsetPlan(
+      SSAGraph* graph,
+      const std::string& device,
+      const std::vector<MemoryBlock>& blocks,
+      size_t arena_size,
+      const std::unordered_map<std::string, std::string>& reuse_table);
 
  private:
   int max_lifecycle_{-1};
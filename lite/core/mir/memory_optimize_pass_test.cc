@@ -0,0 +1,73 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/memory_optimize_pass.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+using MemoryBlock = MemoryOptimizePass::MemoryBlock;
+
+MemoryBlock NewBlock(const std::string& name, int start, int end, size_t size) {
+  MemoryBlock block;
+  block.name = name;
+  block.lifecycle = std::make_pair(start, end);
+  block.size = size;
+  return block;
+}
+
+bool Overlap(const MemoryBlock& a, const MemoryBlock& b) {
+  bool time = b.lifecycle.second >= a.lifecycle.first &&
+              a.lifecycle.second >= b.lifecycle.first;
+  bool space = b.offset < a.offset + a.size && a.offset < b.offset + b.size;
+  return time && space;
+}
+
+TEST(MemoryOptimizePass, offset_plan_chain) {
+  // A chain of ops: each var lives from its producer to its consumer.
+  std::vector<MemoryBlock> blocks{NewBlock("a", 0, 1, 1024),
+                                  NewBlock("b", 1, 2, 4096),
+                                  NewBlock("c", 2, 3, 1024),
+                                  NewBlock("d", 3, 4, 4096)};
+  size_t arena_size = MemoryOptimizePass::MakeOffsetPlan(&blocks);
+  ASSERT_EQ(arena_size, 4096 + 1024);
+  for (size_t i = 0; i < blocks.size(); i++) {
+    for (size_t j = i + 1; j < blocks.size(); j++) {
+      ASSERT_FALSE(Overlap(blocks[i], blocks[j]));
+    }
+  }
+}
+
+TEST(MemoryOptimizePass, offset_plan_best_fit) {
+  // "small" fits in the gap left by "x" which is dead when "small" lives.
+  std::vector<MemoryBlock> blocks{NewBlock("big", 0, 4, 4096),
+                                  NewBlock("x", 0, 1, 2048),
+                                  NewBlock("y", 0, 4, 2048),
+                                  NewBlock("small", 2, 3, 100)};
+  size_t arena_size = MemoryOptimizePass::MakeOffsetPlan(&blocks, 64);
+  ASSERT_EQ(arena_size, 4096 + 2048 + 2048);
+  for (size_t i = 0; i < blocks.size(); i++) {
+    ASSERT_EQ(blocks[i].offset % 64, 0);
+    for (size_t j = i + 1; j < blocks.size(); j++) {
+      ASSERT_FALSE(Overlap(blocks[i], blocks[j]));
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
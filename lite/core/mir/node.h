@@ -96,6 +96,9 @@ class Node {
     // if the need more than one tool operator(eg. io_copy layout calib), the
     // argument between them should be persist to make sure it's only run once
     bool is_persist{false};
+    // The argument of a sub-block living across the runs of the block, that
+    // is a var of the parent blocks, or read before written in the block.
+    bool is_outer{false};
   };
 
   Arg& AsArg(const std::string& name, int id);
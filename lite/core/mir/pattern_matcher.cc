@@ -136,7 +136,8 @@ bool PatternMatcher::MarkPMNodesInGraph(SSAGraph *graph) {
 }
 
 // The intermediate Nodes can only link to the nodes inside the pattern, or this
-// subgraph will be droped.
+// subgraph will be droped. The vars of a sub-block shared with the outer block
+// are read outside the graph, so they are never intermediate.
 void PatternMatcher::ValidateByNodeRole(
     std::vector<PatternMatcher::subgraph_t> *subgraphs) {
   std::vector<PatternMatcher::subgraph_t> result;
@@ -152,6 +153,10 @@ void PatternMatcher::ValidateByNodeRole(
                        }
                        for (auto &item : subgraph) {
                          if (item.first->IsIntermediate()) {
+                           if (item.second->IsArg() &&
+                               item.second->AsArg().is_outer) {
+                             return true;
+                           }
                            for (auto *x : item.second->inlinks) {
                              if (!ios.count(x)) {
                                return true;
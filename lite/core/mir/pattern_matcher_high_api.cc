@@ -44,6 +44,7 @@ void FuseBase::DeleteInterNodes(SSAGraph *graph) {
   VLOG(4) << "keys: " << key2nodes_.size();
   std::unordered_set<const Node *> nodes2rm;
   for (auto &matched : key2nodes_) {
+    if (skipped_.count(&matched)) continue;
     for (const auto &key : keys) {
       nodes2rm.insert(matched.at(key));
     }
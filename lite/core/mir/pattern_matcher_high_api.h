@@ -64,6 +64,10 @@ class FuseBase {
  protected:
   virtual void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) = 0;
 
+  // Called by InsertNewNode to leave a matched subgraph unfused, its
+  // intermediate nodes are kept in the graph.
+  void SkipMatched(const key2nodes_t& matched) { skipped_.insert(&matched); }
+
  private:
   void PerformPatternMatcher(SSAGraph* graph);
 
@@ -76,6 +80,9 @@ class FuseBase {
   PatternMatcher matcher_;
   std::map<std::string, PMNode*> nodes_;
   std::vector<key2nodes_t> key2nodes_;
+
+ private:
+  std::set<const key2nodes_t*> skipped_;
 };
 
 }  // namespace mir
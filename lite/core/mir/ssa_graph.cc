@@ -123,6 +123,14 @@ void SSAGraph::Build(const Program &program,
     return true;
   };
 
+  block_idx_ = program.block_idx();
+  std::set<std::string> tmp_vars(program.tmp_vars().begin(),
+                                 program.tmp_vars().end());
+  auto is_outer = [&](const std::string &name, bool produced) -> bool {
+    if (block_idx_ == 0 || is_weights(name)) return false;
+    return !produced || !tmp_vars.count(name);
+  };
+
   std::unordered_map<std::string, mir::Node *> arg_update_node_map_;
   for (auto &op : program.ops()) {
     VLOG(3) << op->op_info()->Type();
@@ -136,6 +144,7 @@ void SSAGraph::Build(const Program &program,
         arg_node = &node_storage_.back();
         arg_node->AsArg(name, node_storage_.size() - 1);
         arg_update_node_map_[name] = arg_node;
+        arg_node->AsArg().is_outer = is_outer(name, false);
       }
       if (is_weights(name)) arg_node->AsArg().is_weight = true;
       CHECK(arg_node->IsRoleSet());
@@ -146,6 +155,7 @@ void SSAGraph::Build(const Program &program,
       auto *arg_node = &node_storage_.back();
       arg_node->AsArg(name, node_storage_.size() - 1);
       arg_update_node_map_[name] = arg_node;
+      arg_node->AsArg().is_outer = is_outer(name, true);
 
       if (is_weights(name)) arg_node->AsArg().is_weight = true;
       CHECK(arg_node->IsRoleSet());
@@ -65,10 +65,21 @@ class SSAGraph : GraphBase {
   Node *GraphCreateInstructNode(const std::shared_ptr<OpLite> &op,
                                 const std::vector<Place> &valid_places);
 
+  // The index of the block of the graph, 0 for the main block.
+  int block_idx() const { return block_idx_; }
+
   // Device related attributes
   const std::vector<Place> &valid_places() const { return valid_places_; }
   void SetValidPlaces(const std::vector<Place> &x) { valid_places_ = x; }
 
+  // The memory arenas planned by memory_optimize_pass, see MemoryArenaPlan.
+  const std::vector<MemoryArenaPlan> &memory_arena_plans() const {
+    return memory_arena_plans_;
+  }
+  void AddMemoryArenaPlan(const MemoryArenaPlan &plan) {
+    memory_arena_plans_.push_back(plan);
+  }
+
  private:
   mir::Node *Argument(const std::string &name);
   // Check the bidirectional connection.
@@ -95,6 +106,8 @@ class SSAGraph : GraphBase {
   std::list<mir::Node> node_storage_;
   std::map<std::string, mir::Node *> arguments_;
   std::vector<Place> valid_places_;
+  int block_idx_{0};
+  std::vector<MemoryArenaPlan> memory_arena_plans_;
 };
 
 // Remove the link between a -> b.
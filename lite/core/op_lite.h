@@ -65,6 +65,10 @@ class OpLite : public Registry {
   virtual bool CheckShape() const { return true; }
   // Inference the outputs' shape.
   virtual bool InferShape() const { return true; }
+  // Whether the outputs' shape is inferred from the data of the inputs, not
+  // only from their shapes, so it can not be inferred before the inputs are
+  // computed or be reused while the input shapes keep unchanged.
+  virtual bool InferShapeDependsOnData() const { return false; }
   // Run this operator.
   virtual bool Run();
   // Indicate whether the Op runs only once or not
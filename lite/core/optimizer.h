@@ -34,7 +34,8 @@ namespace lite {
 
 /*
  * lite::Optimizer optimize a program. It utilize the mir passes to analysis the
- * program and export an optimized program.
+ * program and export an optimized program. The sub-blocks of the while ops
+ * are optimized by the same passes into runtime programs of their own.
  */
 class Optimizer {
  public:
@@ -43,7 +44,10 @@ class Optimizer {
            core::KernelPickFactor kernel_pick_factor,
            const std::vector<std::string>& passes = {}) {
     program_ = &program;
+    program_desc_ = program.desc();
     valid_places_ = valid_places;
+    kernel_pick_factor_ = kernel_pick_factor;
+    passes_ = passes;
     CHECK(!valid_places.empty()) << "At least one valid_place should be set";
     CHECK(!graph_) << "duplicate optimize found";
     graph_.reset(new mir::SSAGraph);
@@ -69,13 +73,18 @@ class Optimizer {
            "lite_shuffle_channel_fuse_pass",              //
            "lite_transpose_softmax_transpose_fuse_pass",  //
            "lite_interpolate_fuse_pass",                  //
+#ifdef LITE_WITH_X86
+           "lite_embedding_seqpool_fuse_pass",  //
+#endif
            "identity_scale_eliminate_pass",               //
 #ifdef LITE_WITH_LIGHT_WEIGHT_FRAMEWORK
            "lite_elementwise_add_activation_fuse_pass",  //
 #endif
            "static_kernel_pick_pass",        //
-           "variable_place_inference_pass",  //
-           "argument_type_display_pass",     //
+           // Only the ops picked float kernels on the cpu are fused.
+           "lite_elementwise_chain_fuse_pass",  //
+           "variable_place_inference_pass",     //
+           "argument_type_display_pass",        //
 
            "type_target_cast_pass",          //
            "variable_place_inference_pass",  //
@@ -93,8 +102,10 @@ class Optimizer {
            "variable_place_inference_pass",  //
            "argument_type_display_pass",     //
 
-           "runtime_context_assign_pass",
-           "memory_optimize_pass"}});
+           "runtime_context_assign_pass"}});
+      // The memory plan is made when generating the runtime program, the
+      // input shapes may be set by then and the vars' sizes can be inferred.
+      deferred_passes_ = {"memory_optimize_pass"};
     } else {
       RunPasses(passes);
     }
@@ -112,6 +123,8 @@ class Optimizer {
 
   // Generate a new program based on the mir graph.
   std::unique_ptr<RuntimeProgram> GenRuntimeProgram() {
+    RunPasses(deferred_passes_);
+    deferred_passes_.clear();
 #ifdef LITE_WITH_NPU
     if (std::find(valid_places_.begin(),
                   valid_places_.end(),
@@ -126,6 +139,7 @@ class Optimizer {
         auto program = pass->GenProgram();
         CHECK(exec_scope_);
         program->set_exec_scope(exec_scope_);
+        GenSubPrograms(program.get());
         return program;
       } catch (...) {
         LOG(WARNING) << "Build NPU graph failed";
@@ -138,9 +152,30 @@ class Optimizer {
     auto program = pass->GenProgram();
     CHECK(exec_scope_);
     program->set_exec_scope(exec_scope_);
+    // The vars are bound to the arenas by the pass already.
+    program->set_memory_arena_plans(graph_->memory_arena_plans());
+    GenSubPrograms(program.get());
     return program;
   }
 
+  // Optimize the sub-blocks of the while ops in `program` with the passes of
+  // this program, and let the ops run the generated runtime programs.
+  void GenSubPrograms(RuntimeProgram* program) {
+    auto& instructions = program->instructions();
+    for (size_t i = 0; i < instructions.size(); i++) {
+      auto* op_info = instructions[i].op()->op_info();
+      if (op_info->Type() != "while") continue;
+      Program sub_block(program_desc_,
+                        op_info->GetAttr<int32_t>("sub_block"),
+                        exec_scope_,
+                        valid_places_);
+      Optimizer optimizer;
+      optimizer.Run(
+          std::move(sub_block), valid_places_, kernel_pick_factor_, passes_);
+      program->SetSubProgram(i, optimizer.GenRuntimeProgram());
+    }
+  }
+
   // check the input dims in the scope, must not be empty
   void CheckInputDimsNotEmpty(const lite::Scope* scope) {
     CHECK(scope);
@@ -205,7 +240,11 @@ class Optimizer {
 
  private:
   std::unique_ptr<mir::SSAGraph> graph_;
+  cpp::ProgramDesc program_desc_;
   std::vector<Place> valid_places_;
+  core::KernelPickFactor kernel_pick_factor_;
+  std::vector<std::string> passes_;
+  std::vector<std::string> deferred_passes_;
   lite::Scope* exec_scope_{};
   Program* program_{};
 };
@@ -0,0 +1,285 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/trace_profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "lite/core/op_lite.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+namespace {
+
+const Tensor* ArgTensor(const OpLite& op, const std::string& arg, bool input) {
+  auto* op_info = op.op_info();
+  auto* scope = const_cast<OpLite&>(op).scope();
+  if (!scope) return nullptr;
+  if (input ? !op_info->HasInput(arg) : !op_info->HasOutput(arg)) {
+    return nullptr;
+  }
+  auto names = input ? op_info->Input(arg) : op_info->Output(arg);
+  if (names.empty()) return nullptr;
+  auto* var = scope->FindVar(names.front());
+  if (!var || !var->IsType<Tensor>()) return nullptr;
+  return &var->Get<Tensor>();
+}
+
+int64_t Production(const DDim& dims, size_t begin, size_t end) {
+  int64_t res = 1;
+  for (size_t i = begin; i < end && i < dims.size(); i++) {
+    res *= dims[i];
+  }
+  return res;
+}
+
+std::string Escape(const std::string& x) {
+  std::string res;
+  for (char c : x) {
+    if (c == '"' || c == '\\') res.push_back('\\');
+    res.push_back(c);
+  }
+  return res;
+}
+
+// The nearest-rank percentile of the sorted values.
+float Percentile(const std::vector<float>& sorted, float p) {
+  if (sorted.empty()) return 0;
+  size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+}  // namespace
+
+OpCost EstimateOpCost(const OpLite& op) {
+  OpCost cost;
+  auto* op_info = op.op_info();
+  auto* scope = const_cast<OpLite&>(op).scope();
+  if (!op_info || !scope) return cost;
+
+  const Tensor* out = nullptr;
+  for (auto& name : op_info->input_names()) {
+    auto* var = scope->FindVar(name);
+    if (var && var->IsType<Tensor>()) {
+      cost.bytes += var->Get<Tensor>().memory_size();
+    }
+  }
+  for (auto& name : op_info->output_names()) {
+    auto* var = scope->FindVar(name);
+    if (var && var->IsType<Tensor>()) {
+      cost.bytes += var->Get<Tensor>().memory_size();
+      if (!out) out = &var->Get<Tensor>();
+    }
+  }
+  int64_t out_numel = out ? out->numel() : 0;
+
+  // A multiply-add is counted as 2 FLOPs. The ops not listed are counted as
+  // an operation per output element, e.g. the elementwise and activation ops.
+  auto op_type = op_info->Type();
+  if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+    auto* filter = ArgTensor(op, "Filter", true);
+    if (filter) {
+      cost.flops = 2 * out_numel * Production(filter->dims(), 1, 4);
+    }
+  } else if (op_type == "conv2d_transpose") {
+    auto* input = ArgTensor(op, "Input", true);
+    auto* filter = ArgTensor(op, "Filter", true);
+    if (input && filter) {
+      cost.flops = 2 * input->numel() * Production(filter->dims(), 1, 4);
+    }
+  } else if (op_type == "fc") {
+    auto* w = ArgTensor(op, "W", true);
+    if (w) cost.flops = 2 * out_numel * w->dims()[0];
+  } else if (op_type == "mul") {
+    auto* x = ArgTensor(op, "X", true);
+    if (x && op_info->HasAttr("x_num_col_dims")) {
+      auto& x_dims = x->dims();
+      int x_num_col_dims = op_info->GetAttr<int>("x_num_col_dims");
+      cost.flops =
+          2 * out_numel * Production(x_dims, x_num_col_dims, x_dims.size());
+    }
+  } else if (op_type == "matmul") {
+    auto* x = ArgTensor(op, "X", true);
+    if (x && x->dims().size() >= 2) {
+      auto& x_dims = x->dims();
+      bool transpose_x = op_info->HasAttr("transpose_X") &&
+                         op_info->GetAttr<bool>("transpose_X");
+      int64_t k = transpose_x ? x_dims[x_dims.size() - 2]
+                              : x_dims[x_dims.size() - 1];
+      cost.flops = 2 * out_numel * k;
+    }
+  } else if (op_type == "pool2d") {
+    auto* x = ArgTensor(op, "X", true);
+    int64_t window = 1;
+    if (op_info->HasAttr("global_pooling") &&
+        op_info->GetAttr<bool>("global_pooling")) {
+      if (x) window = Production(x->dims(), 2, x->dims().size());
+    } else if (op_info->HasAttr("ksize")) {
+      for (int k : op_info->GetAttr<std::vector<int>>("ksize")) window *= k;
+    }
+    cost.flops = out_numel * window;
+  } else {
+    cost.flops = out_numel;
+  }
+  return cost;
+}
+
+TraceProfiler::TraceProfiler(const std::string& dump_path,
+                             size_t max_trace_events)
+    : dump_path_(dump_path),
+      max_trace_events_(max_trace_events),
+      origin_(clock_t::now()) {}
+
+TraceProfiler::~TraceProfiler() {
+  if (dump_path_.empty()) return;
+  SaveChromeTrace(dump_path_ + ".trace.json");
+  SaveSummaryJson(dump_path_ + ".summary.json");
+}
+
+int TraceProfiler::NewOp(const std::string& op_type,
+                         const std::string& kernel) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ops_.emplace_back();
+  ops_.back().op_type = op_type;
+  ops_.back().kernel = kernel;
+  return ops_.size() - 1;
+}
+
+int TraceProfiler::ThreadId() {
+  auto it = thread_ids_.find(std::this_thread::get_id());
+  if (it != thread_ids_.end()) return it->second;
+  int id = thread_ids_.size();
+  thread_ids_.emplace(std::this_thread::get_id(), id);
+  return id;
+}
+
+void TraceProfiler::Record(int id,
+                           clock_t::time_point start,
+                           clock_t::time_point end,
+                           const OpCost& cost) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto dur = duration_cast<microseconds>(end - start).count();
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK_GE(id, 0);
+  CHECK_LT(static_cast<size_t>(id), ops_.size());
+  auto& op = ops_[id];
+  op.latencies_us.push_back(
+      std::chrono::duration<float, std::micro>(end - start).count());
+  op.flops += cost.flops;
+  op.bytes += cost.bytes;
+  if (events_.size() < max_trace_events_) {
+    Event event;
+    event.op_id = id;
+    event.tid = ThreadId();
+    event.ts_us = duration_cast<microseconds>(start - origin_).count();
+    event.dur_us = dur;
+    events_.push_back(event);
+  }
+}
+
+std::string TraceProfiler::ChromeTrace() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::stringstream ss;
+  ss << "{\"traceEvents\": [";
+  for (size_t i = 0; i < events_.size(); i++) {
+    auto& event = events_[i];
+    auto& op = ops_[event.op_id];
+    ss << (i ? ",\n" : "\n") << "{\"name\": \"" << Escape(op.op_type)
+       << "\", \"cat\": \"op\", \"ph\": \"X\", \"ts\": " << event.ts_us
+       << ", \"dur\": " << event.dur_us << ", \"pid\": 0, \"tid\": "
+       << event.tid << ", \"args\": {\"id\": " << event.op_id
+       << ", \"kernel\": \"" << Escape(op.kernel) << "\"}}";
+  }
+  ss << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  return ss.str();
+}
+
+std::string TraceProfiler::SummaryJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  struct TypeSummary {
+    double total_us{0};
+    double flops{0};
+    double bytes{0};
+    size_t count{0};
+  };
+  std::map<std::string, TypeSummary> types;
+  double total_us = 0;
+
+  std::stringstream ss;
+  ss << "{\"ops\": [";
+  for (size_t i = 0; i < ops_.size(); i++) {
+    auto& op = ops_[i];
+    auto sorted = op.latencies_us;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (float x : sorted) sum += x;
+    size_t count = sorted.size();
+    double avg = count ? sum / count : 0;
+    double flops = count ? op.flops / count : 0;
+    double bytes = count ? op.bytes / count : 0;
+    total_us += sum;
+    auto& type = types[op.op_type];
+    type.total_us += sum;
+    type.flops += op.flops;
+    type.bytes += op.bytes;
+    type.count += count;
+
+    ss << (i ? ",\n" : "\n") << "{\"id\": " << i << ", \"op_type\": \""
+       << Escape(op.op_type) << "\", \"kernel\": \"" << Escape(op.kernel)
+       << "\", \"count\": " << count << ", \"avg_us\": " << avg
+       << ", \"min_us\": " << (count ? sorted.front() : 0)
+       << ", \"p50_us\": " << Percentile(sorted, 0.5)
+       << ", \"p90_us\": " << Percentile(sorted, 0.9)
+       << ", \"p99_us\": " << Percentile(sorted, 0.99)
+       << ", \"max_us\": " << (count ? sorted.back() : 0)
+       << ", \"flops\": " << static_cast<int64_t>(flops)
+       << ", \"bytes\": " << static_cast<int64_t>(bytes)
+       << ", \"gflops_per_s\": " << (avg > 0 ? flops / avg / 1e3 : 0) << "}";
+  }
+  ss << "\n], \"op_types\": [";
+  bool first = true;
+  for (auto& item : types) {
+    auto& type = item.second;
+    ss << (first ? "\n" : ",\n") << "{\"op_type\": \"" << Escape(item.first)
+       << "\", \"count\": " << type.count << ", \"total_us\": "
+       << type.total_us << ", \"percent\": "
+       << (total_us > 0 ? type.total_us / total_us * 100 : 0)
+       << ", \"flops\": " << static_cast<int64_t>(type.flops)
+       << ", \"bytes\": " << static_cast<int64_t>(type.bytes) << "}";
+    first = false;
+  }
+  ss << "\n], \"total_us\": " << total_us << "}\n";
+  return ss.str();
+}
+
+void TraceProfiler::SaveChromeTrace(const std::string& path) const {
+  std::ofstream file(path);
+  CHECK(file.is_open()) << "Open " << path << " failed";
+  file << ChromeTrace();
+}
+
+void TraceProfiler::SaveSummaryJson(const std::string& path) const {
+  std::ofstream file(path);
+  CHECK(file.is_open()) << "Open " << path << " failed";
+  file << SummaryJson();
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,109 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * This file implements TraceProfiler, a profiler of a runtime program that is
+ * enabled at runtime, unlike BasicProfiler which needs LITE_WITH_PROFILE. It
+ * records the timeline of the instructions in every thread, and the latency,
+ * FLOPs and memory traffic of every op, and exports them as JSON:
+ * - the Chrome trace events, which can be loaded in chrome://tracing,
+ * - the per-op summary with the latency percentiles, for diffing the
+ *   profiles of the releases by scripts.
+ */
+#pragma once
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+class OpLite;
+
+namespace profile {
+
+// The floating point operations and the bytes of the inputs and outputs of an
+// op, estimated from the params and the tensor shapes.
+struct OpCost {
+  int64_t flops{0};
+  int64_t bytes{0};
+};
+
+OpCost EstimateOpCost(const OpLite& op);
+
+class TraceProfiler {
+ public:
+  using clock_t = std::chrono::steady_clock;
+
+  // The timeline keeps at most `max_trace_events` events, the statistics are
+  // kept for all the runs. If `dump_path` is not empty, the trace and the
+  // summary are saved to `dump_path`.trace.json and `dump_path`.summary.json
+  // when the profiler is destroyed.
+  explicit TraceProfiler(const std::string& dump_path = "",
+                         size_t max_trace_events = 100000);
+  ~TraceProfiler();
+
+  // Register an op, return the id to record it with.
+  int NewOp(const std::string& op_type, const std::string& kernel);
+  // Record a run of the op `id` in the calling thread.
+  void Record(int id,
+              clock_t::time_point start,
+              clock_t::time_point end,
+              const OpCost& cost);
+
+  // {"traceEvents": [{"name": "conv2d", "ph": "X", "ts": ..., "dur": ...,
+  // "tid": ...}, ...]}, the time is in microseconds.
+  std::string ChromeTrace() const;
+  // {"ops": [{"id": 0, "op_type": "conv2d", "kernel": ..., "count": ...,
+  // "avg_us": ..., "p50_us": ..., "p90_us": ..., "p99_us": ..., ...}, ...],
+  // "op_types": [...], "total_us": ...}, the FLOPs and the bytes are the
+  // average of a run.
+  std::string SummaryJson() const;
+
+  void SaveChromeTrace(const std::string& path) const;
+  void SaveSummaryJson(const std::string& path) const;
+
+ private:
+  struct OpRecord {
+    std::string op_type;
+    std::string kernel;
+    std::vector<float> latencies_us;
+    double flops{0};
+    double bytes{0};
+  };
+  struct Event {
+    int op_id;
+    int tid;
+    int64_t ts_us;
+    int64_t dur_us;
+  };
+
+  int ThreadId();
+
+  std::string dump_path_;
+  size_t max_trace_events_;
+  clock_t::time_point origin_;
+  mutable std::mutex mutex_;
+  std::vector<OpRecord> ops_;
+  std::vector<Event> events_;
+  std::map<std::thread::id, int> thread_ids_;
+};
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,55 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/trace_profiler.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>  // NOLINT
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+TEST(TraceProfiler, record) {
+  TraceProfiler profiler;
+  int conv = profiler.NewOp("conv2d", "conv2d/def/1/1/1");
+  int relu = profiler.NewOp("relu", "relu/def/1/1/1");
+  auto origin = TraceProfiler::clock_t::now();
+  auto us = [&](int x) { return origin + std::chrono::microseconds(x); };
+  OpCost cost;
+  cost.flops = 1000;
+  cost.bytes = 400;
+  for (int i = 0; i < 10; i++) {
+    profiler.Record(conv, us(100 * i), us(100 * i + 10 + i), cost);
+  }
+  std::thread([&] { profiler.Record(relu, us(0), us(5), OpCost()); }).join();
+
+  auto trace = profiler.ChromeTrace();
+  ASSERT_NE(trace.find("\"traceEvents\""), std::string::npos);
+  ASSERT_NE(trace.find("\"name\": \"relu\""), std::string::npos);
+  ASSERT_NE(trace.find("\"tid\": 1"), std::string::npos);
+
+  auto summary = profiler.SummaryJson();
+  ASSERT_NE(summary.find("\"count\": 10"), std::string::npos);
+  ASSERT_NE(summary.find("\"min_us\": 10"), std::string::npos);
+  ASSERT_NE(summary.find("\"p50_us\": 14"), std::string::npos);
+  ASSERT_NE(summary.find("\"p90_us\": 18"), std::string::npos);
+  ASSERT_NE(summary.find("\"max_us\": 19"), std::string::npos);
+  ASSERT_NE(summary.find("\"flops\": 1000"), std::string::npos);
+  ASSERT_NE(summary.find("\"bytes\": 400"), std::string::npos);
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "lite/core/program.h"
+#include <algorithm>
+#include <set>
 #include <unordered_map>
 #include "lite/model_parser/cpp/block_desc.h"
 #include "lite/model_parser/cpp/op_desc.h"
@@ -25,101 +27,731 @@
 namespace paddle {
 namespace lite {
 
+RuntimeProgram::RuntimeProgram(const cpp::ProgramDesc& desc,
+                               const std::shared_ptr<Scope>& root) {
+  // 1. Create op first
+  Program program(desc, root, {});
+
+  // 2. Create Instructs
+  CreateInstructions(program, {});
+
+  CHECK(program.exec_scope());
+  exec_scope_ = program.exec_scope();
+  InitRunState();
+  ApplyKernelImpls();
+  ApplyPackedWeights();
+  CreateSubPrograms(desc);
+}
+
+RuntimeProgram::RuntimeProgram(const cpp::ProgramDesc& desc,
+                               int block_idx,
+                               lite::Scope* exec_scope,
+                               const std::vector<Place>& places)
+    : exec_scope_(exec_scope), block_idx_(block_idx) {
+  Program program(desc, block_idx, exec_scope, {});
+  CreateInstructions(program, places);
+  InitRunState();
+  ApplyKernelImpls();
+  CreateSubPrograms(desc);
+}
+
+void RuntimeProgram::CreateInstructions(const Program& program,
+                                        const std::vector<Place>& places) {
+  // Create the kernels of the target places, and filter out the specific
+  // kernel with the target alias.
+  for (auto& op : program.ops()) {
+    auto* op_info = op->op_info();
+    std::unique_ptr<KernelBase> kernel;
+    if (op_info->HasAttr(kKernelTypeAttr)) {
+      auto kernel_type = op_info->GetAttr<std::string>(kKernelTypeAttr);
+      std::string op_type, alias;
+      Place place;
+      KernelBase::ParseKernelType(kernel_type, &op_type, &alias, &place);
+      auto kernels = op->CreateKernels({place});
+      // filter out a kernel
+      auto it = std::find_if(kernels.begin(),
+                             kernels.end(),
+                             [&](std::unique_ptr<KernelBase>& it) {
+                               return it->alias() == alias;
+                             });
+      CHECK(it != kernels.end());
+      kernel = std::move(*it);
+    } else {
+      // The sub-blocks saved before they were optimized.
+      CHECK(!places.empty()) << "no kernel type saved in " << op_info->Type();
+      auto kernels = op->CreateKernels(places);
+      CHECK(!kernels.empty()) << "no kernel found for " << op_info->Type();
+      kernel = std::move(kernels.front());
+    }
+    kernel->SetContext(ContextScheduler::Global().NewContext(kernel->target()));
+
+    instructions_.emplace_back(op, std::move(kernel));
+  }
+  CHECK(!instructions_.empty()) << "no instructions";
+}
+
+void RuntimeProgram::CreateSubPrograms(const cpp::ProgramDesc& desc) {
+  for (size_t i = 0; i < instructions_.size(); i++) {
+    auto* op_info = instructions_[i].op()->op_info();
+    if (op_info->Type() != "while") continue;
+    auto place = instructions_[i].kernel()->place();
+    auto host_place = place;
+    host_place.target = TARGET(kHost);
+    std::unique_ptr<RuntimeProgram> program(
+        new RuntimeProgram(desc,
+                           op_info->GetAttr<int32_t>("sub_block"),
+                           exec_scope_,
+                           {place, host_place}));
+    SetSubProgram(i, std::move(program));
+  }
+}
+
+void RuntimeProgram::SetSubProgram(size_t i,
+                                   std::unique_ptr<RuntimeProgram>&& program) {
+  auto& inst = instructions_[i];
+  auto* op_info = inst.op()->op_info();
+  CHECK_EQ(op_info->Type(), "while") << "no sub-block run by the op";
+  program->block_idx_ = op_info->GetAttr<int32_t>("sub_block");
+#ifdef LITE_WITH_ARM
+  program->SetARMRunState(arm_run_state_);
+#endif
+#ifdef LITE_WITH_X86
+  program->SetX86ThreadPool(x86_thread_pool_);
+#endif
+  inst.mutable_kernel()->Param<operators::WhileParam>().program = program.get();
+  sub_programs_.push_back(std::move(program));
+}
+
+void MemoryArenaPlan::Bind(lite::Scope* scope) const {
+  CHECK(scope);
+  auto* arena =
+      scope->Var("__memory_arena_" + device + "__")->GetMutable<lite::Tensor>();
+  arena->Resize({static_cast<int64_t>(size)});
+  auto* base = arena->mutable_data<int8_t>(TARGET(kHost));
+  for (auto& block : blocks) {
+    auto* var = scope->FindVar(block.name);
+    CHECK(var) << "no var " << block.name << " in the scope to bind";
+    // A tensor growing larger than its planned block, e.g. when the input
+    // shapes change, will leave the arena and allocate its own memory. The
+    // tensors of the x86 and ARM kernels keep the host target too.
+    var->GetMutable<lite::Tensor>()->ShareExternalMemory(
+        base + block.offset, block.size, TARGET(kHost));
+    VLOG(4) << "var " << block.name << " offset " << block.offset << " size "
+            << block.size;
+  }
+}
+
+void RuntimeProgram::BindMemoryArenas(
+    const std::vector<MemoryArenaPlan>& plans) {
+  for (auto& plan : plans) plan.Bind(exec_scope_);
+  memory_arena_plans_ = plans;
+}
+
+void RuntimeProgram::InitRunState() {
+#ifdef LITE_WITH_ARM
+  // Start with the default run mode, but with a workspace of its own.
+  DeviceInfo::Init();
+  auto& device = DeviceInfo::Global();
+  auto* default_state = device.mutable_run_state();
+  auto state = std::make_shared<ARMRunState>();
+  state->mode = default_state->mode;
+  state->active_ids = default_state->active_ids;
+  state->arch = default_state->arch;
+  device.ExtendWorkspace(state.get(), 0);
+  SetARMRunState(state);
+#endif
+}
+
+#ifdef LITE_WITH_ARM
+void RuntimeProgram::SetARMRunState(const std::shared_ptr<ARMRunState>& state) {
+  arm_run_state_ = state;
+  for (auto& inst : instructions_) {
+    auto* kernel = inst.mutable_kernel();
+    if (kernel->target() != TARGET(kARM)) continue;
+    kernel->mutable_context()->As<ARMContext>().SetRunState(arm_run_state_);
+  }
+  for (auto& program : sub_programs_) {
+    program->SetARMRunState(state);
+  }
+}
+#endif
+
+void RuntimeProgram::ApplyKernelImpls() {
+  for (auto& inst : instructions_) {
+    auto* op_info = inst.op()->op_info();
+    if (op_info->HasAttr(kKernelImplAttr)) {
+      inst.mutable_kernel()->set_impl_name(
+          op_info->GetAttr<std::string>(kKernelImplAttr));
+    }
+  }
+}
+
+void RuntimeProgram::ApplyPackedWeights() {
+  for (auto& inst : instructions_) {
+    auto* op_info = inst.op()->op_info();
+    if (!op_info->HasAttr(kPackedWeightsAttr)) continue;
+    auto* scope = const_cast<OpLite*>(inst.op())->scope();
+    auto* packed_var =
+        scope->FindVar(op_info->GetAttr<std::string>(kPackedWeightsAttr));
+    CHECK(packed_var) << "no packed weights found for " << op_info->Type();
+    // The released weights keep their dims for the shape inference.
+    auto arg = op_info->GetAttr<std::string>(kPackedWeightsArgAttr);
+    auto dims = op_info->GetAttr<std::vector<int>>(kPackedWeightsDimsAttr);
+    auto* weights = scope->FindVar(op_info->Input(arg).front());
+    CHECK(weights);
+    auto* tensor = weights->GetMutable<Tensor>();
+    if (!tensor->IsInitialized()) {
+      tensor->Resize(std::vector<int64_t>(dims.begin(), dims.end()));
+    }
+    inst.mutable_kernel()->SetPackedWeights(
+        op_info->GetAttr<std::string>(kPackedWeightsLayoutAttr),
+        &packed_var->Get<Tensor>());
+  }
+}
+
+void RuntimeProgram::EnableKernelTuning(const std::string& cache_file,
+                                        bool autotune) {
+  kernel_tuner_.reset(new KernelTuner(autotune));
+  tuning_cache_file_ = cache_file;
+  if (!cache_file.empty() && !kernel_tuner_->LoadCache(cache_file)) {
+    LOG(INFO) << "No tuning cache found in " << cache_file;
+  }
+  // Tune in the next run.
+  shape_stable_ = false;
+}
+
+void RuntimeProgram::EnableCalibration(Calibrator* calibrator) {
+  calibrator_ = calibrator;
+  if (!calibrator_) return;
+  for (auto& inst : instructions_) calibrator_->Watch(inst);
+}
+
+void RuntimeProgram::EnableProfiler(const std::string& dump_path) {
+  profiler_.reset(new profile::TraceProfiler(dump_path));
+  profile_ids_.clear();
+  for (auto& inst : instructions_) {
+    profile_ids_.push_back(profiler_->NewOp(
+        inst.op()->op_info()->Type(), inst.kernel()->SerializedKernelType()));
+  }
+}
+
+#ifdef LITE_WITH_ARM
+void RuntimeProgram::SetRunMode(lite_api::PowerMode mode, int threads) {
+  DeviceInfo::Global().SetRunMode(arm_run_state_.get(), mode, threads);
+}
+#endif
+
+#ifdef LITE_WITH_X86
+void RuntimeProgram::SetX86Threads(int threads) {
+  SetX86ThreadPool(threads > 1 ? std::make_shared<ThreadPool>(threads)
+                               : nullptr);
+}
+
+void RuntimeProgram::SetX86ThreadPool(const std::shared_ptr<ThreadPool>& pool) {
+  x86_thread_pool_ = pool;
+  for (auto& inst : instructions_) {
+    auto* kernel = inst.mutable_kernel();
+    if (kernel->target() == TARGET(kX86)) {
+      kernel->mutable_context()->As<X86Context>().SetThreadPool(
+          x86_thread_pool_);
+    } else if (kernel->target() == TARGET(kHost)) {
+      kernel->mutable_context()->As<HostContext>().SetThreadPool(
+          x86_thread_pool_);
+    }
+  }
+  for (auto& program : sub_programs_) {
+    program->SetX86ThreadPool(pool);
+  }
+}
+#endif
+
+void RuntimeProgram::BindOutput(int col,
+                                void* data,
+                                size_t memory_size,
+                                TargetType target,
+                                const std::shared_ptr<void>& holder) {
+  std::string name;
+  for (auto& inst : instructions_) {
+    auto* op_info = inst.op()->op_info();
+    if (op_info->Type() == "fetch" && op_info->GetAttr<int>("col") == col) {
+      name = op_info->Input("X").front();
+    }
+  }
+  CHECK(!name.empty()) << "no fetch op of col " << col;
+  // The kernels on x86 and ARM reallocate the memory of another target, so
+  // the host memory takes the target of the kernel producing the var.
+  for (auto& inst : instructions_) {
+    auto outputs = inst.op()->op_info()->output_names();
+    auto target_of_kernel = inst.kernel()->target();
+    if (target == TARGET(kHost) &&
+        (target_of_kernel == TARGET(kX86) ||
+         target_of_kernel == TARGET(kARM)) &&
+        std::find(outputs.begin(), outputs.end(), name) != outputs.end()) {
+      target = target_of_kernel;
+    }
+  }
+  auto* var = exec_scope_->FindVar(name);
+  CHECK(var) << "no var " << name;
+  output_bindings_[col] = {
+      var->GetMutable<Tensor>(), data, memory_size, target, holder};
+}
+
+void RuntimeProgram::ApplyOutputBindings() {
+  for (auto& item : output_bindings_) {
+    auto& binding = item.second;
+    if (binding.var->raw_data() != binding.data) {
+      binding.var->ShareExternalMemory(binding.data,
+                                       binding.memory_size,
+                                       binding.target,
+                                       binding.holder);
+    }
+  }
+}
+
+void RuntimeProgram::CompleteOutputBindings() {
+  auto& fetch_list =
+      *exec_scope_->FindVar("fetch")->GetMutable<std::vector<Tensor>>();
+  for (auto& item : output_bindings_) {
+    auto& binding = item.second;
+    CHECK_LT(static_cast<size_t>(item.first), fetch_list.size());
+    auto& fetch = fetch_list[item.first];
+    if (fetch.raw_data() == binding.data) continue;
+    size_t size = fetch.memory_size();
+    CHECK_LE(size, binding.memory_size)
+        << "the output " << item.first << " of " << size
+        << " bytes does not fit the bound memory of " << binding.memory_size
+        << " bytes";
+    TargetCopy(binding.target, binding.data, fetch.raw_data(), size);
+    fetch.ShareExternalMemory(
+        binding.data, size, binding.target, binding.holder);
+  }
+}
+
 void RuntimeProgram::SaveOpInfosToProgram(cpp::ProgramDesc* desc) {
   CHECK(desc);
   // NOTE: RuntimeProgram do not has all meta info, so save model just update
   // upon origin model
   CHECK(desc->BlocksSize());
-  auto& main_block = *desc->GetBlock<cpp::BlockDesc>(0);
+  auto& main_block = *desc->GetBlock<cpp::BlockDesc>(block_idx_);
   main_block.ClearOps();
   for (auto& node : instructions_) {
     auto* op = main_block.AddOp<cpp::OpDesc>();
     *op = *node.op()->op_info();
     op->SetAttr(kKernelTypeAttr, node.kernel()->SerializedKernelType());
+    if (!node.kernel()->impl_name().empty()) {
+      op->SetAttr(kKernelImplAttr, node.kernel()->impl_name());
+    }
+  }
+  for (auto& program : sub_programs_) {
+    program->SaveOpInfosToProgram(desc);
   }
 }
 
 // `UpdateVarsOfProgram` will remove unused var_descs and add new created
-// vars' descs in the block 0. Now, the type of a new created var can only
-// be LOD_TENSOR.
+// vars' descs in the blocks. The vars are kept in the blocks declaring them,
+// and the new ones are added to the blocks using them. Now, the type of a new
+// created var can only be LOD_TENSOR.
 void RuntimeProgram::UpdateVarsOfProgram(cpp::ProgramDesc* desc) {
   CHECK(desc);
   CHECK(desc->BlocksSize());
-  std::unordered_map<std::string, cpp::VarDesc> origin_var_maps;
-  auto& main_block = *desc->GetBlock<cpp::BlockDesc>(0);
-  auto var_size = main_block.VarsSize();
-  for (int i = 0; i < var_size; i++) {
-    auto v = main_block.GetVar<cpp::VarDesc>(i);
-    auto name = v->Name();
-    origin_var_maps.emplace(name, *v);
+  VarDescMap origin_vars;
+  for (size_t b = 0; b < desc->BlocksSize(); b++) {
+    auto& block = *desc->GetBlock<cpp::BlockDesc>(b);
+    for (size_t i = 0; i < block.VarsSize(); i++) {
+      auto* v = block.GetVar<cpp::VarDesc>(i);
+      origin_vars.emplace(v->Name(), std::make_pair(static_cast<int>(b), *v));
+    }
+  }
+  ClearVarsOfBlocks(desc);
+  std::set<std::string> added;
+  AddVarsOfBlocks(desc, origin_vars, &added);
+}
+
+void RuntimeProgram::ClearVarsOfBlocks(cpp::ProgramDesc* desc) {
+  desc->GetBlock<cpp::BlockDesc>(block_idx_)->ClearVars();
+  for (auto& program : sub_programs_) {
+    program->ClearVarsOfBlocks(desc);
   }
+}
 
-  main_block.ClearVars();
+void RuntimeProgram::AddVarsOfBlocks(cpp::ProgramDesc* desc,
+                                     const VarDescMap& origin_vars,
+                                     std::set<std::string>* added) {
   for (auto& node : instructions_) {
-    auto* op = const_cast<lite::OpLite*>(node.op());
+    auto* op = node.op();
     auto* kernel = node.kernel();
-    auto* scope = op->scope();
-    auto in_names = op->op_info()->input_names();
-    auto out_names = op->op_info()->output_names();
-    for (auto& in_name : in_names) {
-      auto it = origin_var_maps.find(in_name);
-      if (it != origin_var_maps.end()) {
-        auto* v = main_block.AddVar<cpp::VarDesc>();
-        v->SetName((it->second).Name());
-        v->SetType((it->second).GetType());
-        v->SetPersistable((it->second).Persistable());
+    auto* scope = const_cast<lite::OpLite*>(op)->scope();
+    auto add_var = [&](const std::string& name, bool is_input) {
+      if (!added->insert(name).second) return;
+      auto it = origin_vars.find(name);
+      if (it != origin_vars.end()) {
+        auto& block = *desc->GetBlock<cpp::BlockDesc>(it->second.first);
+        auto* v = block.AddVar<cpp::VarDesc>();
+        v->SetName(it->second.second.Name());
+        v->SetType(it->second.second.GetType());
+        v->SetPersistable(it->second.second.Persistable());
+        return;
+      }
+      // New created vars must be LOD_TENSOR
+      auto& block = *desc->GetBlock<cpp::BlockDesc>(block_idx_);
+      auto* v = block.AddVar<cpp::VarDesc>();
+      v->SetName(name);
+      v->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+      std::string arg_name;
+      const Type* type;
+      if (is_input) {
+        op->op_info()->GetInputArgname(name, &arg_name);
+        type = kernel->GetInputDeclType(arg_name);
       } else {
-        // New created vars must be LOD_TENSOR
-        auto* v = main_block.AddVar<cpp::VarDesc>();
-        v->SetName(in_name);
-        v->SetType(cpp::VarDesc::Type::LOD_TENSOR);
-        std::string in_arg_name;
-        op->op_info()->GetInputArgname(in_name, &in_arg_name);
-        auto type = kernel->GetInputDeclType(in_arg_name);
-        if (type->IsTensor()) {
-          auto tensor = scope->FindVar(in_name)->GetMutable<Tensor>();
-          v->SetPersistable(tensor->persistable());
-        } else {
-          CHECK(false) << "unsupported var type";
-        }
+        op->op_info()->GetOutputArgname(name, &arg_name);
+        type = kernel->GetOutputDeclType(arg_name);
       }
-    }
-
-    for (auto& out_name : out_names) {
-      auto it = origin_var_maps.find(out_name);
-      if (it != origin_var_maps.end()) {
-        auto* v = main_block.AddVar<cpp::VarDesc>();
-        v->SetName((it->second).Name());
-        v->SetType((it->second).GetType());
-        v->SetPersistable((it->second).Persistable());
+      if (type->IsTensor()) {
+        auto tensor = scope->FindVar(name)->GetMutable<Tensor>();
+        v->SetPersistable(tensor->persistable());
       } else {
-        // New created vars must be LOD_TENSOR
-        auto* v = main_block.AddVar<cpp::VarDesc>();
-        v->SetName(out_name);
-        v->SetType(cpp::VarDesc::Type::LOD_TENSOR);
-        std::string out_arg_name;
-        op->op_info()->GetOutputArgname(out_name, &out_arg_name);
-        auto type = kernel->GetOutputDeclType(out_arg_name);
-        if (type->IsTensor()) {
-          auto tensor = scope->FindVar(out_name)->GetMutable<Tensor>();
-          v->SetPersistable(tensor->persistable());
-        } else {
-          CHECK(false) << "unsupported var type";
-        }
+        CHECK(false) << "unsupported var type";
       }
+    };
+    for (auto& name : op->op_info()->input_names()) add_var(name, true);
+    for (auto& name : op->op_info()->output_names()) add_var(name, false);
+  }
+  for (auto& program : sub_programs_) {
+    program->AddVarsOfBlocks(desc, origin_vars, added);
+  }
+}
+
+void RuntimeProgram::SavePackedWeightsToProgram(cpp::ProgramDesc* desc) {
+  CHECK(desc);
+  CHECK(desc->BlocksSize());
+  auto& main_block = *desc->GetBlock<cpp::BlockDesc>(0);
+  CHECK_EQ(main_block.OpsSize(), instructions_.size())
+      << "SaveOpInfosToProgram should be called first";
+  std::unordered_map<std::string, cpp::VarDesc*> var_descs;
+  for (size_t i = 0; i < main_block.VarsSize(); i++) {
+    auto* v = main_block.GetVar<cpp::VarDesc>(i);
+    var_descs[v->Name()] = v;
+  }
+  // The weights read by other ops are kept.
+  std::unordered_map<std::string, int> readers;
+  for (auto& inst : instructions_) {
+    for (auto& name : inst.op()->op_info()->input_names()) readers[name]++;
+  }
+
+  for (size_t i = 0; i < instructions_.size(); i++) {
+    auto& inst = instructions_[i];
+    std::string arg, layout;
+    Tensor packed;
+    if (!inst.mutable_kernel()->PackWeights(&arg, &layout, &packed)) continue;
+    auto* op_info = inst.op()->op_info();
+    auto names = op_info->Input(arg);
+    if (names.size() != 1 || readers[names.front()] != 1) continue;
+    auto& name = names.front();
+    auto it = var_descs.find(name);
+    if (it == var_descs.end() || !it->second->Persistable()) continue;
+    auto* weights = exec_scope_->FindVar(name);
+    CHECK(weights);
+    auto dims = weights->Get<Tensor>().dims().Vectorize();
+
+    auto packed_name = name + "@packed";
+    auto* packed_tensor = exec_scope_->Var(packed_name)->GetMutable<Tensor>();
+    packed_tensor->ShareDataWith(packed);
+    packed_tensor->set_precision(packed.precision());
+    packed_tensor->set_persistable(true);
+    auto* v = main_block.AddVar<cpp::VarDesc>();
+    v->SetName(packed_name);
+    v->SetType(cpp::VarDesc::Type::LOD_TENSOR);
+    v->SetPersistable(true);
+    it->second->SetPersistable(false);
+
+    auto* op = main_block.GetOp<cpp::OpDesc>(i);
+    op->SetAttr(kPackedWeightsAttr, packed_name);
+    op->SetAttr(kPackedWeightsLayoutAttr, layout);
+    op->SetAttr(kPackedWeightsArgAttr, arg);
+    op->SetAttr(kPackedWeightsDimsAttr,
+                std::vector<int>(dims.begin(), dims.end()));
+    VLOG(4) << "save " << name << " packed as " << layout;
+  }
+}
+
+void RuntimeProgram::SaveMemoryReuseToProgram(cpp::ProgramDesc* desc) const {
+  CHECK(desc);
+  std::unordered_map<std::string, std::string> reuse_table;
+  for (auto& plan : memory_arena_plans_) {
+    reuse_table.insert(plan.reuse_table.begin(), plan.reuse_table.end());
+  }
+  if (reuse_table.empty()) return;
+  auto rename = [&](const std::vector<std::string>& names) {
+    std::vector<std::string> res;
+    for (auto& name : names) {
+      auto it = reuse_table.find(name);
+      res.push_back(it == reuse_table.end() ? name : it->second);
+    }
+    return res;
+  };
+
+  auto* block = desc->GetBlock<cpp::BlockDesc>(block_idx_);
+  for (size_t i = 0; i < block->OpsSize(); i++) {
+    auto* op = block->GetOp<cpp::OpDesc>(i);
+    for (auto& arg : op->InputArgumentNames()) {
+      op->SetInput(arg, rename(op->Input(arg)));
+    }
+    for (auto& arg : op->OutputArgumentNames()) {
+      op->SetOutput(arg, rename(op->Output(arg)));
+    }
+  }
+  std::vector<cpp::VarDesc> vars;
+  for (size_t i = 0; i < block->VarsSize(); i++) {
+    auto& var = *block->GetVar<cpp::VarDesc>(i);
+    auto it = reuse_table.find(var.Name());
+    if (it == reuse_table.end() || it->second == var.Name()) {
+      vars.push_back(var);
     }
   }
+  block->ClearVars();
+  for (auto& var : vars) *block->AddVar<cpp::VarDesc>() = var;
+}
+
+bool RuntimeProgram::FeedShapesUnchanged() {
+  // The inputs of a sub-block change in every run of it, the instructions
+  // check their own input shapes.
+  if (block_idx_ > 0) return false;
+  auto* feed_var = exec_scope_ ? exec_scope_->FindVar("feed") : nullptr;
+  if (!feed_var) return false;
+  auto& feed_list = feed_var->Get<std::vector<lite::Tensor>>();
+  bool unchanged = feed_list.size() == feed_dims_.size();
+  feed_dims_.resize(feed_list.size());
+  feed_lods_.resize(feed_list.size());
+  for (size_t i = 0; i < feed_list.size(); i++) {
+    if (feed_list[i].dims() != feed_dims_[i] ||
+        feed_list[i].lod() != feed_lods_[i]) {
+      unchanged = false;
+      feed_dims_[i] = feed_list[i].dims();
+      feed_lods_[i] = feed_list[i].lod();
+    }
+  }
+  return unchanged;
 }
 
 void RuntimeProgram::Run() {
+#ifdef LITE_WITH_ARM
+  // The OpenMP thread number and the affinity belong to the calling thread,
+  // so they are set on every run, for the thread may run other programs too.
+  // The sub-programs run in the thread bound by the main program.
+  if (block_idx_ == 0) DeviceInfo::Global().BindThreads(*arm_run_state_);
+#endif
+  // If the feed shapes are not changed and all the instructions inferred the
+  // same shapes as the kernels produced in the last run, the inputs of every
+  // instruction keep their shapes, so the instructions skip the checks.
+  bool input_shapes_unchanged = FeedShapesUnchanged() && shape_stable_;
+  // The picks of the implementations hold until the input shapes change.
+  bool tuning = kernel_tuner_ && !input_shapes_unchanged;
+  ApplyOutputBindings();
+  // The instructions run in parallel with the buffers of the last run, which
+  // are kept until the input shapes change.
+  bool inter_op =
+      inter_op_executor_ && input_shapes_unchanged && !calibrator_;
+#ifdef LITE_WITH_PROFILE
+  inter_op = false;
+#endif
+  if (!input_shapes_unchanged) inter_op_graph_built_ = false;
+  if (inter_op && !inter_op_graph_built_) {
+    inter_op_graph_built_ = true;
+    inter_op_parallel_ = BuildInterOpGraph();
+  }
+  if (inter_op && inter_op_parallel_) {
+    RunInterOp();
+  } else {
+    for (size_t i = 0; i < instructions_.size(); i++) {
+      RunInstruction(i, input_shapes_unchanged, tuning);
+    }
+  }
+  shape_stable_ = true;
   for (auto& inst : instructions_) {
-    inst.Run();
+    // The feed op reads the feed shapes checked above, and the fetch outputs
+    // are not used by other instructions.
+    if (!inst.shape_stable()) {
+      auto op_type = inst.op()->op_info()->Type();
+      if (op_type != "feed" && op_type != "fetch") shape_stable_ = false;
+    }
+  }
+  CompleteOutputBindings();
+  if (tuning && kernel_tuner_->updated() && !tuning_cache_file_.empty()) {
+    kernel_tuner_->SaveCache(tuning_cache_file_);
+  }
+}
+
+void RuntimeProgram::RunInstruction(size_t i,
+                                    bool input_shapes_unchanged,
+                                    bool tuning) {
+  auto& inst = instructions_[i];
+  bool tune = tuning && kernel_tuner_->Apply(&inst);
+  profile::TraceProfiler::clock_t::time_point start;
+  if (profiler_) start = profile::TraceProfiler::clock_t::now();
+  inst.Run(input_shapes_unchanged);
+  if (profiler_) {
+    auto end = profile::TraceProfiler::clock_t::now();
+    profiler_->Record(
+        profile_ids_[i], start, end, profile::EstimateOpCost(*inst.op()));
+  }
+  if (tune) kernel_tuner_->Tune(&inst);
+  if (calibrator_) calibrator_->Collect(inst, *exec_scope_);
 #ifdef LITE_WITH_PROFILE
 #ifdef LITE_WITH_PRECISION_PROFILE
-    LITE_PRECISION_PROFILE(inst)
+  LITE_PRECISION_PROFILE(inst)
 #endif  // LITE_WITH_PRECISION_PROFILE
 #endif  // LITE_WITH_PROFILE
+}
+
+void RuntimeProgram::SetInterOpThreads(int threads) {
+  inter_op_executor_.reset(threads > 1 ? new InterOpExecutor(threads)
+                                       : nullptr);
+  inter_op_graph_built_ = false;
+#ifdef LITE_WITH_ARM
+  inter_op_arm_states_.clear();
+  for (int tid = 1; tid < threads; tid++) {
+    auto state = std::make_shared<ARMRunState>();
+    DeviceInfo::Global().ExtendWorkspace(state.get(), 0);
+    inter_op_arm_states_.push_back(state);
   }
+#endif
+}
+
+bool RuntimeProgram::BuildInterOpGraph() {
+  // The kernels of the other targets are ordered by their streams or queues.
+  for (auto& inst : instructions_) {
+    auto target = inst.kernel()->target();
+    if (target != TARGET(kHost) && target != TARGET(kX86) &&
+        target != TARGET(kARM)) {
+      LOG(WARNING) << "the instructions on " << TargetToStr(target)
+                   << " run in order";
+      return false;
+    }
+  }
+
+  // The resources are the vars, and the vars sharing memory are one resource,
+  // e.g. the vars at the same arena offsets, or reshaped in place.
+  std::map<std::string, int> ids;
+  auto id_of = [&](const std::string& name) {
+    auto it = ids.find(name);
+    if (it == ids.end()) it = ids.emplace(name, ids.size()).first;
+    return it->second;
+  };
+  size_t n = instructions_.size();
+  std::vector<std::vector<int>> reads(n), writes(n);
+  for (size_t i = 0; i < n; i++) {
+    auto* op_info = instructions_[i].op()->op_info();
+    auto input_names = op_info->input_names();
+    auto output_names = op_info->output_names();
+    for (auto& name : input_names) reads[i].push_back(id_of(name));
+    for (auto& name : output_names) writes[i].push_back(id_of(name));
+  }
+
+  struct Range {
+    const char* begin;
+    const char* end;
+    int id;
+  };
+  std::vector<Range> ranges;
+  for (auto& item : ids) {
+    auto* var = exec_scope_->FindVar(item.first);
+    if (!var || !var->IsType<Tensor>()) continue;
+    auto& tensor = var->Get<Tensor>();
+    if (!tensor.IsInitialized() || tensor.memory_size() == 0) continue;
+    auto* begin = static_cast<const char*>(tensor.raw_data());
+    ranges.push_back({begin, begin + tensor.memory_size(), item.second});
+  }
+  std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+    return a.begin < b.begin;
+  });
+  std::vector<int> resource(ids.size());
+  for (size_t k = 0; k < resource.size(); k++) resource[k] = k;
+  const char* end = nullptr;
+  int merged = -1;
+  for (auto& range : ranges) {
+    if (merged >= 0 && range.begin < end) {
+      resource[range.id] = merged;
+      end = std::max(end, range.end);
+    } else {
+      merged = range.id;
+      end = range.end;
+    }
+  }
+
+  // The ops running sub-blocks, e.g. while, use the vars not in their inputs
+  // and outputs, so they run after all the instructions before, and before
+  // all the ones after.
+  int barrier = ids.size();
+  for (size_t i = 0; i < n; i++) {
+    for (auto& id : reads[i]) id = resource[id];
+    for (auto& id : writes[i]) id = resource[id];
+    if (instructions_[i].op()->op_info()->HasAttr("sub_block")) {
+      writes[i].push_back(barrier);
+    } else {
+      reads[i].push_back(barrier);
+    }
+  }
+  inter_op_executor_->Build(reads, writes);
+  return true;
+}
+
+void RuntimeProgram::RunInterOp() {
+#ifdef LITE_WITH_ARM
+  // Every thread runs the ARM kernels with a run state and a workspace of its
+  // own, in the run mode of this program.
+  for (auto& state : inter_op_arm_states_) {
+    state->mode = arm_run_state_->mode;
+    state->active_ids = arm_run_state_->active_ids;
+    state->arch = arm_run_state_->arch;
+  }
+  std::vector<char> bound(inter_op_executor_->threads(), 0);
+  bound[0] = 1;
+#endif
+  inter_op_executor_->Run([&](int i, int tid) {
+#ifdef LITE_WITH_ARM
+    auto& state = tid == 0 ? arm_run_state_ : inter_op_arm_states_[tid - 1];
+    if (!bound[tid]) {
+      DeviceInfo::Global().BindThreads(*state);
+      bound[tid] = 1;
+    }
+    auto* kernel = instructions_[i].mutable_kernel();
+    bool arm = kernel->target() == TARGET(kARM);
+    if (arm) kernel->mutable_context()->As<ARMContext>().SetRunState(state);
+#endif
+    RunInstruction(i, true, false);
+#ifdef LITE_WITH_ARM
+    if (arm) {
+      kernel->mutable_context()->As<ARMContext>().SetRunState(arm_run_state_);
+    }
+#endif
+  });
+}
+
+Program::Program(const cpp::ProgramDesc& desc,
+                 int block_idx,
+                 lite::Scope* exec_scope,
+                 const std::vector<Place>& valid_places)
+    : valid_places_(valid_places),
+      exec_scope_(exec_scope),
+      desc_(desc),
+      block_idx_(block_idx) {
+  CHECK(exec_scope_) << "the exec scope of the main block should be created";
+  CHECK_LT(block_idx_, static_cast<int>(desc_.BlocksSize()));
+  // The weights may be declared in any block, the temporary vars are the ones
+  // declared in this block.
+  for (size_t b = 0; b < desc_.BlocksSize(); ++b) {
+    auto& block = *desc_.GetBlock<cpp::BlockDesc>(b);
+    for (size_t i = 0; i < block.VarsSize(); ++i) {
+      auto& var_desc = *block.GetVar<cpp::VarDesc>(i);
+      if (var_desc.Name() == "feed" || var_desc.Name() == "fetch") continue;
+      if (var_desc.Persistable()) {
+        weights_.push_back(var_desc.Name());
+      } else if (static_cast<int>(b) == block_idx_) {
+        tmp_vars_.push_back(var_desc.Name());
+      }
+    }
+  }
+  Build(desc);
 }
 
 void Program::Build(const cpp::ProgramDesc& prog) {
@@ -128,7 +760,7 @@ void Program::Build(const cpp::ProgramDesc& prog) {
   // Create operators.
   auto program = prog;
   CHECK(program.BlocksSize());
-  auto& main_block = *program.GetBlock<cpp::BlockDesc>(0);
+  auto& main_block = *program.GetBlock<cpp::BlockDesc>(block_idx_);
   for (size_t i = 0; i < main_block.OpsSize(); ++i) {
     auto& op_desc = *main_block.GetOp<cpp::OpDesc>(i);
     auto op_type = op_desc.Type();
@@ -151,9 +783,10 @@ void Program::Build(const cpp::ProgramDesc& prog) {
 void Program::PrepareWorkspace(const cpp::ProgramDesc& prog) {
   CHECK(!exec_scope_) << "Duplicate PrepareWorkspace found";
   exec_scope_ = &scope_->NewScope();
-  // Create Feed and Fetch var.
-  scope_->Var("feed")->GetMutable<std::vector<lite::Tensor>>();
-  scope_->Var("fetch")->GetMutable<std::vector<lite::Tensor>>();
+  // Create Feed and Fetch var in the exec scope, the programs sharing the
+  // weights in `scope_` have their own inputs and outputs.
+  exec_scope_->Var("feed")->GetMutable<std::vector<lite::Tensor>>();
+  exec_scope_->Var("fetch")->GetMutable<std::vector<lite::Tensor>>();
   tmp_vars_.push_back("feed");
   tmp_vars_.push_back("fetch");
 
@@ -178,7 +811,78 @@ void Program::PrepareWorkspace(const cpp::ProgramDesc& prog) {
   }
 }
 
-void Instruction::Run() {
+void Instruction::UpdateShapeCache() {
+  if (!has_run_) {
+    // The vars are checked after the first InferShape, by then the outputs
+    // are created as tensors.
+    shape_cache_enabled_ = !op_->InferShapeDependsOnData();
+    auto* scope = const_cast<OpLite*>(op_.get())->scope();
+    for (auto& name : op_->op_info()->input_names()) {
+      auto* var = scope ? scope->FindVar(name) : nullptr;
+      if (!var || !var->IsType<lite::Tensor>()) {
+        shape_cache_enabled_ = false;
+        break;
+      }
+      input_tensors_.push_back(&var->Get<lite::Tensor>());
+    }
+    for (auto& name : op_->op_info()->output_names()) {
+      auto* var = scope ? scope->FindVar(name) : nullptr;
+      if (!var || !var->IsType<lite::Tensor>()) {
+        shape_cache_enabled_ = false;
+        break;
+      }
+      output_tensors_.push_back(var->GetMutable<lite::Tensor>());
+    }
+    if (!shape_cache_enabled_) {
+      input_tensors_.clear();
+      output_tensors_.clear();
+    }
+  }
+  if (!shape_cache_enabled_) return;
+  input_dims_.resize(input_tensors_.size());
+  input_lods_.resize(input_tensors_.size());
+  for (size_t i = 0; i < input_tensors_.size(); i++) {
+    input_dims_[i] = input_tensors_[i]->dims();
+    input_lods_[i] = input_tensors_[i]->lod();
+  }
+  output_dims_.resize(output_tensors_.size());
+  output_lods_.resize(output_tensors_.size());
+  for (size_t i = 0; i < output_tensors_.size(); i++) {
+    output_dims_[i] = output_tensors_[i]->dims();
+    output_lods_[i] = output_tensors_[i]->lod();
+  }
+}
+
+bool Instruction::InputShapesHitCache() const {
+  for (size_t i = 0; i < input_tensors_.size(); i++) {
+    if (input_tensors_[i]->dims() != input_dims_[i] ||
+        input_tensors_[i]->lod() != input_lods_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Instruction::InferShape(bool input_shapes_unchanged) {
+  if (!shape_cache_enabled_ ||
+      !(input_shapes_unchanged || InputShapesHitCache())) {
+    op_->InferShape();
+    UpdateShapeCache();
+    return;
+  }
+  // The output tensors may be shared with other ops by the memory reuse, so
+  // the cached shapes are restored rather than assumed to be kept.
+  for (size_t i = 0; i < output_tensors_.size(); i++) {
+    if (output_tensors_[i]->dims() != output_dims_[i]) {
+      output_tensors_[i]->Resize(output_dims_[i]);
+    }
+    if (output_tensors_[i]->lod() != output_lods_[i]) {
+      output_tensors_[i]->set_lod(output_lods_[i]);
+    }
+  }
+}
+
+void Instruction::Run(bool input_shapes_unchanged) {
   CHECK(op_) << "op null";
   CHECK(kernel_) << "kernel null";
 #ifdef LITE_WITH_PROFILE
@@ -194,11 +898,19 @@ void Instruction::Run() {
   }
 
   VLOG(4) << "kernel launch";
-  op_->InferShape();
+  InferShape(input_shapes_unchanged);
   VLOG(4) << ">> Running kernel: " << op_->op_info()->Repr() << " on Target "
           << TargetToStr(kernel_->target());
   kernel_->Launch();
   has_run_ = true;
+
+  // Some kernels decide the output shapes by the data, e.g. the detection
+  // ops, check whether the inferred shapes are kept.
+  shape_stable_ = shape_cache_enabled_;
+  for (size_t i = 0; shape_stable_ && i < output_tensors_.size(); i++) {
+    shape_stable_ = output_tensors_[i]->dims() == output_dims_[i] &&
+                    output_tensors_[i]->lod() == output_lods_[i];
+  }
 }
 
 STL::ostream& operator<<(STL::ostream& os, const Instruction& other) {
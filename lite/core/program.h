@@ -14,13 +14,20 @@
 
 #pragma once
 #include <list>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
+#include "lite/core/calibrator.h"
+#include "lite/core/inter_op_executor.h"
 #include "lite/core/kernel.h"
+#include "lite/core/kernel_tuner.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/profile/trace_profiler.h"
 #include "lite/model_parser/cpp/program_desc.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/basic_profiler.h"
@@ -30,6 +37,16 @@ namespace paddle {
 namespace lite {
 
 static const char kKernelTypeAttr[] = "__@kernel_type_attr@__";
+// The implementation picked for the kernel by tuning, if any.
+static const char kKernelImplAttr[] = "__@kernel_impl_attr@__";
+// The weights packed by the kernel, see KernelBase::PackWeights. The packed
+// weights are saved as the var named by kPackedWeightsAttr, in place of the
+// input kPackedWeightsArgAttr of the dims kPackedWeightsDimsAttr.
+static const char kPackedWeightsAttr[] = "__@packed_weights_attr@__";
+static const char kPackedWeightsLayoutAttr[] =
+    "__@packed_weights_layout_attr@__";
+static const char kPackedWeightsArgAttr[] = "__@packed_weights_arg_attr@__";
+static const char kPackedWeightsDimsAttr[] = "__@packed_weights_dims_attr@__";
 
 // A program is used to represent a code program, in Paddle, a code program
 // contains:
@@ -49,6 +66,13 @@ struct Program {
     Build(desc);
     VLOG(4) << "build desc finished";
   }
+  // Create the program of the sub-block `block_idx` of `desc`, e.g. the body
+  // of a while op. The vars of all the blocks are created in the exec scope of
+  // the main block, and the ops are attached to it.
+  Program(const cpp::ProgramDesc& desc,
+          int block_idx,
+          lite::Scope* exec_scope,
+          const std::vector<Place>& valid_places);
 
   std::unique_ptr<Program> Clone() const {
     std::unique_ptr<Program> res(new Program(desc_, scope_, valid_places_));
@@ -66,6 +90,10 @@ struct Program {
   lite::Scope* exec_scope() { return exec_scope_; }
   lite::Scope* scope() { return scope_.get(); }
 
+  const cpp::ProgramDesc& desc() const { return desc_; }
+  // The index of the block of the ops, 0 for the main block.
+  int block_idx() const { return block_idx_; }
+
  private:
   // Build from a program and scope.
   void Build(const cpp::ProgramDesc& program);
@@ -82,6 +110,7 @@ struct Program {
   // Runtime scope.
   lite::Scope* exec_scope_{};
   cpp::ProgramDesc desc_;
+  int block_idx_{0};
 };
 
 struct Instruction {
@@ -102,8 +131,13 @@ struct Instruction {
 #endif  // LITE_WITH_PROFILE
   }
 
-  // Run the instruction.
-  void Run();
+  // Run the instruction. `input_shapes_unchanged` tells that the inputs are
+  // known to keep the shapes of the last run, so the check is skipped.
+  void Run(bool input_shapes_unchanged = false);
+
+  // Whether the output shapes only depend on the input shapes, and the kernel
+  // kept the shapes inferred by the op in the last run.
+  bool shape_stable() const { return shape_stable_; }
 
   friend STL::ostream& operator<<(STL::ostream& os, const Instruction& other);
 
@@ -117,12 +151,57 @@ struct Instruction {
   bool first_epoch_{true};
   bool has_run_{false};
 
+  // Infer the output shapes, the shapes inferred in the last run are reused
+  // if the input shapes are not changed.
+  void InferShape(bool input_shapes_unchanged);
+  void UpdateShapeCache();
+  bool InputShapesHitCache() const;
+
+  // The InferShape cache, which records the input and output shapes of the
+  // last InferShape. It is disabled if any of the vars is not a tensor or the
+  // op infers the shapes from the input data.
+  bool shape_cache_enabled_{false};
+  bool shape_stable_{false};
+  std::vector<const Tensor*> input_tensors_;
+  std::vector<Tensor*> output_tensors_;
+  std::vector<DDim> input_dims_;
+  std::vector<LoD> input_lods_;
+  std::vector<DDim> output_dims_;
+  std::vector<LoD> output_lods_;
+
 #ifdef LITE_WITH_PROFILE
   // for profiler
   int profile_id_{-1};
 #endif  // LITE_WITH_PROFILE
 };
 
+/*
+ * The temporary vars of a device packed into one memory arena by
+ * memory_optimize_pass, each at the offset planned by the sizes and the
+ * lifecycles of the vars. The plan is not in the program desc, so the runtime
+ * program keeps it to bind the vars of another exec scope, e.g. the one of a
+ * clone, to an arena of their own.
+ */
+struct MemoryArenaPlan {
+  struct Block {
+    std::string name;
+    size_t offset;
+    size_t size;
+  };
+  std::string device;
+  size_t size{0};
+  std::vector<Block> blocks;
+  // The same vars grouped into clusters by lifecycle, from the name of a var
+  // to the one of its cluster. The arena is only bound at runtime, so the
+  // saved programs share the tensors of the clusters instead.
+  std::unordered_map<std::string, std::string> reuse_table;
+
+  // Create the arena in `scope` and let the vars of the blocks found in it
+  // share the memory of the arena. The arena is held by the scope, so it
+  // lives as long as the vars.
+  void Bind(lite::Scope* scope) const;
+};
+
 /*
  * A program contains kernels for runtime.
  */
@@ -133,30 +212,216 @@ class LITE_API RuntimeProgram {
     if (instructions_.empty()) {
       LOG(FATAL) << "no instructions";
     }
+    InitRunState();
+    ApplyKernelImpls();
+    ApplyPackedWeights();
   }
+  // Create the runtime program of an optimized program, the kernels are
+  // picked by the kernel types saved in the ops. The weights are found in
+  // `root`, and the temporary vars are created in a new exec scope of it.
+  RuntimeProgram(const cpp::ProgramDesc& desc,
+                 const std::shared_ptr<Scope>& root);
+  // Create the runtime program of the sub-block `block_idx` of an optimized
+  // program, run in `exec_scope` of the main block. The ops saved without
+  // the kernel types take the first kernel of `places`.
+  RuntimeProgram(const cpp::ProgramDesc& desc,
+                 int block_idx,
+                 lite::Scope* exec_scope,
+                 const std::vector<Place>& places = {});
 
   void Run();
 
+  // Tune the implementations of the kernels in the runs with new input
+  // shapes. The picks are loaded from and saved to `cache_file` if it is not
+  // empty, and only the cached picks are applied if `autotune` is false. The
+  // picks are also saved in the ops by `SaveOpInfosToProgram`.
+  void EnableKernelTuning(const std::string& cache_file, bool autotune = true);
+
+  // Profile the instructions in the following runs, see TraceProfiler. The
+  // trace and the summary are saved with the prefix `dump_path` when the
+  // program is destroyed if it is not empty.
+  void EnableProfiler(const std::string& dump_path = "");
+  // Null if the profiler is not enabled.
+  const profile::TraceProfiler* profiler() const { return profiler_.get(); }
+
+  // Collect the inputs of the quantizable ops into `calibrator` in the
+  // following runs, which run in order. The activations are collected right
+  // after the instructions producing them, before their memory is reused.
+  // The calibrator is not owned, null disables the calibration.
+  void EnableCalibration(Calibrator* calibrator);
+
   void set_exec_scope(lite::Scope* x) { exec_scope_ = x; }
   lite::Scope* exec_scope() { return exec_scope_; }
 
+  // The memory arenas the temporary vars of the exec scope are bound to, see
+  // MemoryArenaPlan. A program created from the desc of this one binds its
+  // vars by `BindMemoryArenas`.
+  const std::vector<MemoryArenaPlan>& memory_arena_plans() const {
+    return memory_arena_plans_;
+  }
+  void set_memory_arena_plans(const std::vector<MemoryArenaPlan>& plans) {
+    memory_arena_plans_ = plans;
+  }
+  // Bind the vars of the exec scope to the arenas of `plans`, and keep them.
+  void BindMemoryArenas(const std::vector<MemoryArenaPlan>& plans);
+
   size_t num_instructions() const { return instructions_.size(); }
 
   const std::vector<Instruction>& instructions() const { return instructions_; }
 
+  // Run the sub-block of the i-th instruction, a while op, by `program`. The
+  // sub-program shares the run state and the threads of this program.
+  void SetSubProgram(size_t i, std::unique_ptr<RuntimeProgram>&& program);
+
   // `SaveOpInfosToProgram` will update the op list(ops_) of the block 0
-  // in ProgramDesc.
+  // in ProgramDesc, and the ones of the sub-blocks run by the sub-programs.
   void SaveOpInfosToProgram(cpp::ProgramDesc* desc);
 
   // `UpdateVarsOfProgram` will update the var list(vars_) of the block 0 in
   // ProgramDesc. Namely, if a new var created in some passes, its var_desc will
-  // be added in vars_.
+  // be added in vars_. The sub-blocks are updated too, keeping the vars of the
+  // other blocks out of them.
   void UpdateVarsOfProgram(cpp::ProgramDesc* desc);
 
+  // Save the weights packed by the kernels to `desc`, in place of the
+  // weights they are packed from, so the program loaded from `desc` skips
+  // packing them. The packed weights are created in the exec scope. It is
+  // called after `SaveOpInfosToProgram` and `UpdateVarsOfProgram`.
+  // NOTE: the packing may depend on the device, e.g. the GEMM blocks of the
+  // ARM CPU, so `desc` is only loaded on the kind of device it is saved on.
+  void SavePackedWeightsToProgram(cpp::ProgramDesc* desc);
+
+  // Rename the vars placed in the memory arenas to their clusters in `desc`,
+  // see MemoryArenaPlan::reuse_table, and drop the descs of the renamed vars,
+  // so the program loaded from `desc` reuses the memory without the arenas,
+  // e.g. by the light predictor. It is called after `UpdateVarsOfProgram`.
+  void SaveMemoryReuseToProgram(cpp::ProgramDesc* desc) const;
+
+#ifdef LITE_WITH_ARM
+  // Set the power mode and the thread number of the ARM kernels in this
+  // program, the other programs keep their own.
+  void SetRunMode(lite_api::PowerMode mode, int threads);
+  lite_api::PowerMode power_mode() const { return arm_run_state_->mode; }
+  int threads() const { return arm_run_state_->active_ids.size(); }
+#endif
+
+  // Let the kernel producing the var fetched to `col` write into the memory
+  // of the caller, so the output is not copied. The memory holds
+  // `memory_size` bytes, and is used as long as `holder` lives if it is set.
+  // The host memory is given to the kernels on x86 and ARM too. If the kernel
+  // outputs in place of its input or needs more memory, the output is copied
+  // to the memory after the run, it is fatal if the output does not fit.
+  void BindOutput(int col,
+                  void* data,
+                  size_t memory_size,
+                  TargetType target,
+                  const std::shared_ptr<void>& holder = nullptr);
+
+  // Run the instructions not depending on each other in parallel in
+  // `threads` threads, or in order if `threads` is 1. An instruction depends
+  // on the ones before it writing the vars it reads or writes, or reading the
+  // vars it writes, the vars sharing memory count as one. The parallel runs
+  // keep the buffers of the last run, so they only start when the input shapes
+  // are unchanged, and the first run of new shapes is in order.
+  // NOTE: the threads of the kernels are taken by every instruction running,
+  // so the product of the two thread numbers should not exceed the cores.
+  void SetInterOpThreads(int threads);
+  int inter_op_threads() const {
+    return inter_op_executor_ ? inter_op_executor_->threads() : 1;
+  }
+
+#ifdef LITE_WITH_X86
+  // Set the thread number of the x86 and the host kernels in this program,
+  // the kernels share a thread pool of this program.
+  void SetX86Threads(int threads);
+  int x86_threads() const {
+    return x86_thread_pool_ ? x86_thread_pool_->threads() : 1;
+  }
+#endif
+
  private:
+  // Create the instructions of the ops by the kernel types saved in them, or
+  // by the first kernel of `places` if there is none.
+  void CreateInstructions(const Program& program,
+                          const std::vector<Place>& places);
+  // Create the sub-programs of the while ops from `desc`.
+  void CreateSubPrograms(const cpp::ProgramDesc& desc);
+  // The var descs of a program by name, with the index of their blocks.
+  typedef std::unordered_map<std::string, std::pair<int, cpp::VarDesc>>
+      VarDescMap;
+  void ClearVarsOfBlocks(cpp::ProgramDesc* desc);
+  // Add the descs of the vars used by the instructions and not `added` yet.
+  void AddVarsOfBlocks(cpp::ProgramDesc* desc,
+                       const VarDescMap& origin_vars,
+                       std::set<std::string>* added);
+  // Give the kernels the run state of this program.
+  void InitRunState();
+#ifdef LITE_WITH_ARM
+  void SetARMRunState(const std::shared_ptr<ARMRunState>& state);
+#endif
+#ifdef LITE_WITH_X86
+  void SetX86ThreadPool(const std::shared_ptr<ThreadPool>& pool);
+#endif
+  // Apply the implementations saved in the ops.
+  void ApplyKernelImpls();
+  // Give the kernels the packed weights saved in the ops.
+  void ApplyPackedWeights();
+  // Whether the feed tensors keep the shapes of the last run.
+  bool FeedShapesUnchanged();
+  // Give the bound memory to the vars before the run, and copy the outputs
+  // not produced in it after the run.
+  void ApplyOutputBindings();
+  void CompleteOutputBindings();
+  void RunInstruction(size_t i, bool input_shapes_unchanged, bool tuning);
+  // Build the dependencies of the instructions on the vars of the last run,
+  // false if they have to run in order.
+  bool BuildInterOpGraph();
+  void RunInterOp();
+
+  struct OutputBinding {
+    Tensor* var;
+    void* data;
+    size_t memory_size;
+    TargetType target;
+    std::shared_ptr<void> holder;
+  };
+
   RuntimeProgram(const RuntimeProgram&) = delete;
   std::vector<Instruction> instructions_;
   lite::Scope* exec_scope_{};
+  // The block run by this program, and the programs of the sub-blocks of its
+  // instructions.
+  int block_idx_{0};
+  std::vector<std::unique_ptr<RuntimeProgram>> sub_programs_;
+  std::vector<MemoryArenaPlan> memory_arena_plans_;
+  // The feed shapes of the last run, and whether all the instructions had
+  // stable shapes in it.
+  std::vector<DDim> feed_dims_;
+  std::vector<LoD> feed_lods_;
+  bool shape_stable_{false};
+  std::unique_ptr<KernelTuner> kernel_tuner_;
+  std::string tuning_cache_file_;
+  std::unique_ptr<profile::TraceProfiler> profiler_;
+  Calibrator* calibrator_{nullptr};
+  // The op ids in the profiler of the instructions.
+  std::vector<int> profile_ids_;
+  // The bound outputs by the fetch col.
+  std::map<int, OutputBinding> output_bindings_;
+  std::unique_ptr<InterOpExecutor> inter_op_executor_;
+  // Whether the graph is built for the current input shapes, and whether the
+  // instructions can run in parallel.
+  bool inter_op_graph_built_{false};
+  bool inter_op_parallel_{false};
+#ifdef LITE_WITH_ARM
+  // Shared by all the ARM kernels of this program, so they use one workspace
+  // and run with the threads of this program.
+  std::shared_ptr<ARMRunState> arm_run_state_;
+  // The run states of the inter-op threads but the calling one.
+  std::vector<std::shared_ptr<ARMRunState>> inter_op_arm_states_;
+#endif
+#ifdef LITE_WITH_X86
+  std::shared_ptr<ThreadPool> x86_thread_pool_;
+#endif
 };
 
 }  // namespace lite
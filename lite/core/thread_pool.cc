@@ -0,0 +1,101 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <algorithm>
+
+namespace paddle {
+namespace lite {
+
+// A loop is kept alive by the threads running it, so a worker waking up late
+// only finds no iteration left.
+struct ThreadPool::Job {
+  const std::function<void(int, int)>* fn;
+  int n;
+  std::atomic<int> next{0};
+  std::atomic<int> pending{0};
+};
+
+ThreadPool::ThreadPool(int threads) : threads_(std::max(threads, 1)) {
+  for (int tid = 1; tid < threads_; tid++) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, tid);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::ParallelFor(int n,
+                             const std::function<void(int, int)>& fn) {
+  if (n <= 0) return;
+  if (n == 1 || workers_.empty() || running_.exchange(true)) {
+    for (int i = 0; i < n; i++) fn(i, 0);
+    return;
+  }
+
+  auto job = std::make_shared<Job>();
+  job->fn = &fn;
+  job->n = n;
+  job->pending = n;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = job;
+    generation_++;
+  }
+  cv_.notify_all();
+  RunJob(job.get(), 0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [&] { return job->pending == 0; });
+  job_.reset();
+  running_ = false;
+}
+
+void ThreadPool::RunJob(Job* job, int tid) {
+  while (true) {
+    int i = job->next++;
+    if (i >= job->n) break;
+    (*job->fn)(i, tid);
+    if (--job->pending == 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_cv_.notify_all();
+    }
+  }
+}
+
+void ThreadPool::WorkerLoop(int tid) {
+  uint64_t generation = 0;
+  while (true) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return stop_ || generation_ != generation; });
+      if (stop_) return;
+      generation = generation_;
+      job = job_;
+    }
+    if (job) RunJob(job.get(), tid);
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,74 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * ThreadPool runs the iterations of a loop in a fixed set of worker threads,
+ * it is used by the kernels of the targets without OpenMP, e.g. x86.
+ *
+ * The calling thread takes part in the loop, so a pool of `threads` threads
+ * starts `threads - 1` workers. A loop runs in the calling thread only if
+ * the pool is running another loop, e.g. a nested loop, or a loop from
+ * another thread.
+ */
+class ThreadPool {
+ public:
+  explicit ThreadPool(int threads);
+  ~ThreadPool();
+
+  int threads() const { return threads_; }
+
+  // Call `fn(i, tid)` for every i in [0, n) and wait for all of them. `tid`
+  // in [0, threads()) is the index of the thread running the iteration, for
+  // the buffers of the threads. The iterations are scheduled dynamically, so
+  // the iterations should be coarse, e.g. an image or a channel.
+  void ParallelFor(int n, const std::function<void(int i, int tid)>& fn);
+
+ private:
+  struct Job;
+
+  void WorkerLoop(int tid);
+  // Run the iterations of the job left.
+  void RunJob(Job* job, int tid);
+
+  int threads_;
+  std::vector<std::thread> workers_;
+  // Set while a loop runs, the loops started meanwhile run in the calling
+  // thread.
+  std::atomic<bool> running_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  std::shared_ptr<Job> job_;
+  uint64_t generation_{0};
+  bool stop_{false};
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+}  // namespace lite
+}  // namespace paddle
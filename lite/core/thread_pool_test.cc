@@ -0,0 +1,54 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(ThreadPool, parallel_for) {
+  for (int threads : {1, 2, 4}) {
+    ThreadPool pool(threads);
+    ASSERT_EQ(pool.threads(), threads);
+    for (int n : {0, 1, 3, 100}) {
+      std::vector<int> visits(n, 0);
+      std::atomic<int> bad_tid{0};
+      pool.ParallelFor(n, [&](int i, int tid) {
+        visits[i]++;
+        if (tid < 0 || tid >= threads) bad_tid++;
+      });
+      for (int i = 0; i < n; i++) {
+        EXPECT_EQ(visits[i], 1);
+      }
+      EXPECT_EQ(bad_tid, 0);
+    }
+  }
+}
+
+TEST(ThreadPool, nested) {
+  ThreadPool pool(4);
+  std::atomic<int> sum{0};
+  for (int repeat = 0; repeat < 10; repeat++) {
+    pool.ParallelFor(8, [&](int i, int tid) {
+      pool.ParallelFor(8, [&](int j, int inner_tid) { sum += i * 8 + j; });
+    });
+  }
+  EXPECT_EQ(sum, 10 * 63 * 64 / 2);
+}
+
+}  // namespace lite
+}  // namespace paddle
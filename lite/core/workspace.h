@@ -74,7 +74,7 @@ class WorkSpace {
 
   TargetType target_;
   Buffer buffer_;
-  size_t cursor_;
+  size_t cursor_{0};
 
   DISALLOW_COPY_AND_ASSIGN(WorkSpace);
 };
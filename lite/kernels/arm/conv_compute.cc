@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "lite/kernels/arm/conv_compute.h"
+#include <string>
 #include <utility>
+#include <vector>
 #include "lite/core/op_registry.h"
 #include "lite/core/type_system.h"
 #include "lite/kernels/arm/conv_depthwise.h"
@@ -27,10 +29,10 @@ namespace kernels {
 namespace arm {
 
 template <>
-void ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+std::vector<std::string>
+ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::ImplCandidates() const {
   auto& param = this->Param<param_t>();
   auto w_dims = param.filter->dims();
-  auto& ctx = this->ctx_->template As<ARMContext>();
 
   int ic = w_dims[1] * param.groups;
   int oc = w_dims[0];
@@ -47,43 +49,63 @@ void ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
       (kw == 5 && stride == 1) || (kw == 5 && stride == 2 && pad == 2);
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
 
-  /// select conv impl
+  // The order follows the preference of the rules, gemm-like conv supports
+  // all the cases.
+  std::vector<std::string> candidates;
   if (param.groups == ic && ic == oc && kps_equal && no_dilation && flag_dw) {
-    /// dw conv impl
-    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    VLOG(3) << "invoking dw conv";
+    candidates.push_back("depthwise");
   } else if (param.groups == 1 && kw == 3 && stride == 1 && kps_equal &&
              no_dilation) {
     if (ic >= 32 && oc >= 32) {
-      /// winograd conv impl
-      impl_ = new WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>;
-      VLOG(3) << "invoking winograd conv";
+      candidates = {"winograd", "direct"};
     } else {
-      /// direct conv impl
-      impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>;
-      VLOG(3) << "invoking direct conv";
+      candidates = {"direct", "winograd"};
     }
   } else if (param.groups == 1 && kw == 3 && stride == 2 && kps_equal &&
              no_dilation) {
-    /// direct conv impl
-    impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    VLOG(3) << "invoking direct conv";
+    candidates.push_back("direct");
+  }
+  candidates.push_back("gemm_like");
+  return candidates;
+}
+
+template <>
+void ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto impl = PickImpl();
+  VLOG(3) << "invoking " << impl << " conv";
+  if (impl == "depthwise") {
+    ResetImpl(new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>);
+  } else if (impl == "winograd") {
+    ResetImpl(new WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>);
+  } else if (impl == "direct") {
+    ResetImpl(new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>);
   } else {
-    impl_ = new GemmLikeConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    VLOG(3) << "invoking gemm like conv";
+    ResetImpl(new GemmLikeConv<PRECISION(kFloat), PRECISION(kFloat)>);
   }
-  impl_->SetContext(std::move(this->ctx_));
-  impl_->SetParam(param);
-  impl_->PrepareForRun();
-  is_first_epoch_ = false;
 }
 
 template <>
-void ConvCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
-  auto& param = this->Param<param_t>();
-  auto w_dims = param.filter->dims();
+bool ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PackWeights(
+    std::string* arg, std::string* layout, Tensor* packed) {
+  if (PickImpl() != "winograd") return false;
+  // The context is moved to the implementation in the first run.
+  auto* ctx = impl_ ? impl_->mutable_context() : this->ctx_.get();
+  auto& arm_ctx = ctx->As<ARMContext>();
+  *arg = "Filter";
+  *layout = WinogradWeightsLayout(&arm_ctx);
+  auto* loaded = this->packed_weights(*layout);
+  if (loaded) {
+    packed->ShareDataWith(*loaded);
+  } else {
+    PackWinogradWeights(*this->Param<param_t>().filter, &arm_ctx, packed);
+  }
+  return true;
+}
 
-  auto& ctx = this->ctx_->template As<ARMContext>();
+// The int8 convs share the rules of picking the implementation.
+static std::vector<std::string> Int8ConvImplCandidates(
+    const operators::ConvParam& param) {
+  auto w_dims = param.filter->dims();
 
   int ic = param.groups * w_dims[1];
   int oc = w_dims[0];
@@ -100,60 +122,65 @@ void ConvCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
   bool flag_dw_5x5 = (kw == 5 && sw == 1 && ph == 2);
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
 
+  std::vector<std::string> candidates;
   if (param.groups == ic && ic == oc && kps_equal && no_dilation && flag_dw) {
-    impl_ = new DepthwiseConv<PRECISION(kInt8), PRECISION(kFloat)>;
-    VLOG(3) << "Run DepthwiseConv Int8";
+    candidates.push_back("depthwise");
   } else if (param.groups == 1 && kw == 3 && (sw == 1 || sw == 2) &&
              kps_equal && no_dilation) {
-    impl_ = new DirectConv<PRECISION(kInt8), PRECISION(kFloat)>;
-    VLOG(3) << "Run DirectConv Int8";
-  } else {
-    impl_ = new GemmLikeConv<PRECISION(kInt8), PRECISION(kFloat)>;
-    VLOG(3) << "Run GemmLikeConvInt8";
+    candidates.push_back("direct");
   }
-  impl_->SetContext(std::move(this->ctx_));
-  impl_->SetParam(param);
-  impl_->PrepareForRun();
-  is_first_epoch_ = false;
+  candidates.push_back("gemm_like");
+  return candidates;
 }
 
 template <>
-void ConvCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
-  auto& param = this->Param<param_t>();
-  auto w_dims = param.filter->dims();
+std::vector<std::string>
+ConvCompute<PRECISION(kInt8), PRECISION(kFloat)>::ImplCandidates() const {
+  return Int8ConvImplCandidates(this->Param<param_t>());
+}
 
-  auto& ctx = this->ctx_->template As<ARMContext>();
+template <>
+void ConvCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
+  auto impl = PickImpl();
+  VLOG(3) << "Run " << impl << " conv Int8";
+  if (impl == "depthwise") {
+    ResetImpl(new DepthwiseConv<PRECISION(kInt8), PRECISION(kFloat)>);
+  } else if (impl == "direct") {
+    ResetImpl(new DirectConv<PRECISION(kInt8), PRECISION(kFloat)>);
+  } else {
+    ResetImpl(new GemmLikeConv<PRECISION(kInt8), PRECISION(kFloat)>);
+  }
+}
 
-  int ic = w_dims[1] * param.groups;
-  int oc = w_dims[0];
-  int kh = w_dims[2];  // oihw
-  int kw = w_dims[3];
-  int ph = param.paddings[1];
-  int pw = param.paddings[0];
-  int sh = param.strides[1];
-  int sw = param.strides[0];
+template <>
+bool ConvCompute<PRECISION(kInt8), PRECISION(kFloat)>::PackWeights(
+    std::string* arg, std::string* layout, Tensor* packed) {
+  return false;
+}
 
-  bool kps_equal = (pw == ph) && (sh == sw) && (kw == kh);
-  bool no_dilation = (param.dilations[0] == 1) && (param.dilations[1] == 1);
-  bool flag_dw_3x3 = (kw == 3 && kh == 3) && (sw == 1 || sw == 2);
-  bool flag_dw_5x5 = (kw == 5 && sw == 1 && ph == 2);
-  bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
+template <>
+std::vector<std::string>
+ConvCompute<PRECISION(kInt8), PRECISION(kInt8)>::ImplCandidates() const {
+  return Int8ConvImplCandidates(this->Param<param_t>());
+}
 
-  if (param.groups == ic && ic == oc && kps_equal && no_dilation && flag_dw) {
-    impl_ = new DepthwiseConv<PRECISION(kInt8), PRECISION(kInt8)>;
-    VLOG(3) << "Run DepthwiseConv Int8";
-  } else if (param.groups == 1 && kw == 3 && (sw == 1 || sw == 2) &&
-             kps_equal && no_dilation) {
-    impl_ = new DirectConv<PRECISION(kInt8), PRECISION(kInt8)>;
-    VLOG(3) << "Run DirectConv Int8";
+template <>
+void ConvCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
+  auto impl = PickImpl();
+  VLOG(3) << "Run " << impl << " conv Int8";
+  if (impl == "depthwise") {
+    ResetImpl(new DepthwiseConv<PRECISION(kInt8), PRECISION(kInt8)>);
+  } else if (impl == "direct") {
+    ResetImpl(new DirectConv<PRECISION(kInt8), PRECISION(kInt8)>);
   } else {
-    impl_ = new GemmLikeConv<PRECISION(kInt8), PRECISION(kInt8)>;
-    VLOG(3) << "Run GemmLikeConvInt8";
+    ResetImpl(new GemmLikeConv<PRECISION(kInt8), PRECISION(kInt8)>);
   }
-  impl_->SetContext(std::move(this->ctx_));
-  impl_->SetParam(param);
-  impl_->PrepareForRun();
-  is_first_epoch_ = false;
+}
+
+template <>
+bool ConvCompute<PRECISION(kInt8), PRECISION(kInt8)>::PackWeights(
+    std::string* arg, std::string* layout, Tensor* packed) {
+  return false;
 }
 
 }  // namespace arm
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "lite/backends/arm/math/funcs.h"
 #include "lite/core/kernel.h"
 
@@ -26,6 +29,15 @@ class ConvCompute : public KernelLite<TARGET(kARM), Ptype> {
  public:
   virtual void PrepareForRun();
 
+  // The candidates are "depthwise", "winograd", "direct" and "gemm_like".
+  std::vector<std::string> ImplCandidates() const override;
+
+  // Only the winograd conv packs the weights, the other implementations read
+  // the filter in some cases.
+  bool PackWeights(std::string* arg,
+                   std::string* layout,
+                   Tensor* packed) override;
+
   virtual void ReInitWhenNeeded() {
     CHECK(impl_);
     impl_->ReInitWhenNeeded();
@@ -44,6 +56,43 @@ class ConvCompute : public KernelLite<TARGET(kARM), Ptype> {
 
  private:
   using param_t = operators::ConvParam;
+
+  // The implementation asked by `set_impl_name` if it is applicable, or the
+  // one picked by the rules.
+  std::string PickImpl() const {
+    // The weights loaded packed are only taken by the winograd conv.
+    if (this->packed_weights_layout().find("arm_winograd") == 0) {
+      return "winograd";
+    }
+    auto candidates = ImplCandidates();
+    CHECK(!candidates.empty());
+    const auto& name = this->impl_name();
+    if (name.empty()) return candidates.front();
+    if (std::find(candidates.begin(), candidates.end(), name) ==
+        candidates.end()) {
+      LOG(WARNING) << "conv impl " << name << " is not applicable, use "
+                   << candidates.front();
+      return candidates.front();
+    }
+    return name;
+  }
+
+  void ResetImpl(KernelLite<TARGET(kARM), Ptype>* impl) {
+    if (impl_ != nullptr) {
+      // The context was moved to the old implementation.
+      this->ctx_ = impl_->ReleaseContext();
+      delete impl_;
+    }
+    impl_ = impl;
+    impl_->SetContext(std::move(this->ctx_));
+    impl_->SetParam(this->template Param<param_t>());
+    impl_->SetPackedWeights(
+        this->packed_weights_layout(),
+        this->packed_weights(this->packed_weights_layout()));
+    impl_->PrepareForRun();
+    this->is_first_epoch_ = false;
+  }
+
   KernelLite<TARGET(kARM), Ptype>* impl_{nullptr};
 };
 
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/kernels/arm/conv_winograd.h"
+#include <string>
 #include <vector>
 #include "lite/backends/arm/math/conv_impl.h"
 #include "lite/backends/arm/math/packed_sgemm.h"
@@ -51,13 +52,50 @@ void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::ReInitWhenNeeded() {
   last_shape_ = x_dims;
 }
 
+std::string WinogradWeightsLayout(ARMContext* ctx) {
+  return "arm_winograd_f6x6_h" +
+         std::to_string(lite::arm::math::get_hblock(ctx)) + "_v1";
+}
+
+void PackWinogradWeights(const Tensor& filter,
+                         ARMContext* ctx,
+                         Tensor* weights) {
+  int oc = filter.dims()[0];
+  int ic = filter.dims()[1];
+  const int m_wino = oc;
+  int hblock = lite::arm::math::get_hblock(ctx);
+  int m_round = hblock * ((m_wino + hblock - 1) / hblock);
+  weights->Resize({1, 1, 1, 8 * 8 * m_round * ic});
+  auto weights_wino =
+      static_cast<float*>(malloc(sizeof(float) * 8 * 8 * oc * ic));
+  void* trans_tmp_ptr = malloc(sizeof(float) * 8 * 8 * oc * ic);
+  lite::arm::math::winograd_transform_weights(
+      weights_wino, filter.data<float>(), oc, ic, trans_tmp_ptr);
+  auto weights_trans = weights->mutable_data<float>();
+  for (int i = 0; i < 64; ++i) {
+    float* packed_weights = weights_trans + i * m_round * ic;
+    const float* weights_wino_ptr = weights_wino + i * oc * ic;
+    lite::arm::math::prepackA(packed_weights,
+                              weights_wino_ptr,
+                              1.f,
+                              ic,
+                              0,
+                              m_wino,
+                              0,
+                              ic,
+                              false,
+                              ctx);
+  }
+  free(trans_tmp_ptr);
+  free(weights_wino);
+}
+
 template <>
 void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   auto& param = this->Param<param_t>();
   auto& ctx = this->ctx_->template As<ARMContext>();
 
   auto x_dims = param.x->dims();
-  auto w_dims = param.filter->dims();
   auto o_dims = param.output->dims();
   last_shape_ = x_dims;
 
@@ -71,35 +109,21 @@ void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   int size_trans_channel = 8 * 8 * size_tile;
   int max_ch = ic > oc ? ic : oc;
 
-  const int m_wino = oc;
   const int n_wino = size_tile;
-  int hblock = lite::arm::math::get_hblock(&ctx);
-  int m_round = hblock * ((m_wino + hblock - 1) / hblock);
-  weights_.Resize({1, 1, 1, 8 * 8 * m_round * ic});
   ctx.ExtendWorkspace((size_trans_channel * max_ch * 2 + n_wino) *
                       sizeof(float));
-  auto weights_wino =
-      static_cast<float*>(malloc(sizeof(float) * 8 * 8 * oc * ic));
-  void* trans_tmp_ptr = malloc(sizeof(float) * 8 * 8 * oc * ic);
-  lite::arm::math::winograd_transform_weights(
-      weights_wino, param.filter->data<float>(), oc, ic, trans_tmp_ptr);
-  auto weights_trans = weights_.mutable_data<float>();
-  for (int i = 0; i < 64; ++i) {
-    float* packed_weights = weights_trans + i * m_round * ic;
-    const float* weights_wino_ptr = weights_wino + i * oc * ic;
-    lite::arm::math::prepackA(packed_weights,
-                              weights_wino_ptr,
-                              1.f,
-                              ic,
-                              0,
-                              m_wino,
-                              0,
-                              ic,
-                              false,
-                              &ctx);
+
+  auto layout = WinogradWeightsLayout(&ctx);
+  auto* packed = this->packed_weights(layout);
+  if (packed) {
+    weights_.ShareDataWith(*packed);
+    return;
   }
-  free(trans_tmp_ptr);
-  free(weights_wino);
+  CHECK(param.filter->IsInitialized())
+      << "The filter was released for the weights packed as "
+      << this->packed_weights_layout() << ", but they are packed as "
+      << layout << " on this device, save the model on it again";
+  PackWinogradWeights(*param.filter, &ctx, &weights_);
 }
 
 template <>
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cmath>
+#include <string>
 #include "lite/backends/arm/math/conv_impl.h"
 #include "lite/core/context.h"
 #include "lite/core/kernel.h"
@@ -25,6 +26,15 @@ namespace lite {
 namespace kernels {
 namespace arm {
 
+// The layout of the weights packed by `PackWinogradWeights`, it depends on
+// the GEMM blocks of the device.
+std::string WinogradWeightsLayout(ARMContext* ctx);
+// Transform the oihw 3x3 `filter` to the winograd weights packed for the
+// GEMMs of conv_winograd3x3.
+void PackWinogradWeights(const Tensor& filter,
+                         ARMContext* ctx,
+                         Tensor* weights);
+
 /// only support 3x3s1 and 3x3s2
 template <PrecisionType Ptype, PrecisionType OutType>
 class WinogradConv : public KernelLite<TARGET(kARM), Ptype> {
@@ -71,8 +71,19 @@ inline bool is_broadcast(const DDim& x_dims,
   return true;
 }
 
+// The kernels only broadcast Y to the dims of X. The op also infers the
+// outputs of the broadcasts of X, e.g. of its size-1 dims or to Y of a higher
+// rank, which are only run by the x86 kernels.
+template <typename ParamT>
+inline void check_out_dims(const ParamT& param) {
+  CHECK(param.Out->dims() == param.X->dims())
+      << "the ARM kernels can not broadcast X of " << param.X->dims()
+      << " to the output of " << param.Out->dims();
+}
+
 void ElementwiseAddCompute::Run() {
   auto& param = Param<operators::ElementwiseParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -91,6 +102,7 @@ void ElementwiseAddCompute::Run() {
 
 void ElementwiseAddActivationCompute::Run() {
   auto& param = Param<operators::FusionElementwiseActivationParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -118,6 +130,7 @@ void ElementwiseAddActivationCompute::Run() {
 
 void ElementwiseSubCompute::Run() {
   auto& param = Param<operators::ElementwiseParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -136,6 +149,7 @@ void ElementwiseSubCompute::Run() {
 
 void ElementwiseSubActivationCompute::Run() {
   auto& param = Param<operators::FusionElementwiseActivationParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -163,6 +177,7 @@ void ElementwiseSubActivationCompute::Run() {
 
 void ElementwiseMulCompute::Run() {
   auto& param = Param<operators::ElementwiseParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -181,6 +196,7 @@ void ElementwiseMulCompute::Run() {
 
 void ElementwiseMulActivationCompute::Run() {
   auto& param = Param<operators::FusionElementwiseActivationParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -208,6 +224,7 @@ void ElementwiseMulActivationCompute::Run() {
 
 void ElementwiseMaxCompute::Run() {
   auto& param = Param<operators::ElementwiseParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -226,6 +243,7 @@ void ElementwiseMaxCompute::Run() {
 
 void ElementwiseMaxActivationCompute::Run() {
   auto& param = Param<operators::FusionElementwiseActivationParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -253,6 +271,7 @@ void ElementwiseMaxActivationCompute::Run() {
 
 void ElementwiseDivCompute::Run() {
   auto& param = Param<operators::ElementwiseParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -271,6 +290,7 @@ void ElementwiseDivCompute::Run() {
 
 void ElementwiseDivActivationCompute::Run() {
   auto& param = Param<operators::FusionElementwiseActivationParam>();
+  check_out_dims(param);
   const float* x_data = param.X->data<float>();
   const float* y_data = param.Y->data<float>();
   float* out_data = param.Out->mutable_data<float>();
@@ -16,7 +16,7 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include "lite/backends/arm/math/funcs.h"
+#include "lite/core/program.h"
 #include "lite/core/tensor.h"
 #include "lite/core/type_system.h"
 
@@ -25,17 +25,11 @@ namespace lite {
 namespace kernels {
 namespace arm {
 
-void WhileCompute::PrepareForRun() {
-  auto &param = Param<operators::WhileParam>();
-  auto cur_scope = param.scope;
-
-  executor_ =
-      std::make_shared<StepExecutor>(param.sub_block, cur_scope, place());
-}
 void WhileCompute::Run() {
   auto &param = Param<operators::WhileParam>();
+  CHECK(param.program) << "the sub-block of while is not created";
   while (param.cond->data<bool>()[0]) {
-    executor_->Run();
+    param.program->Run();
   }
 }
 
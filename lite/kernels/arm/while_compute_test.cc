@@ -0,0 +1,142 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/arm/while_compute.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/desc_test_helper.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace arm {
+
+// x = x * 2 * 2 while i < n, the kernel types are only saved in the main
+// block, the sub-block takes the first kernels.
+cpp::ProgramDesc WhileProgram() {
+  Place arm(TARGET(kARM), PRECISION(kFloat), DATALAYOUT(kNCHW));
+  Place host(TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny));
+  cpp::ProgramDesc desc;
+  desc.AddBlock<cpp::BlockDesc>();
+  desc.AddBlock<cpp::BlockDesc>();
+  auto* main_block = desc.GetBlock<cpp::BlockDesc>(0);
+  auto* sub_block = desc.GetBlock<cpp::BlockDesc>(1);
+  for (auto name : {"feed", "fetch", "x", "i", "n", "cond", "steps"}) {
+    AddVar(main_block, name);
+  }
+  AddVar(sub_block, "t");
+
+  auto add_less_than = [](cpp::BlockDesc* block, const Place& place) {
+    auto* op = AddOp(
+        block, "less_than", {{"X", "i"}, {"Y", "n"}}, {{"Out", "cond"}}, place);
+    op->SetAttr("axis", -1);
+    op->SetAttr("force_cpu", false);
+  };
+
+  int col = 0;
+  for (auto name : {"x", "i", "n"}) {
+    AddOp(main_block, "feed", {{"X", "feed"}}, {{"Out", name}}, host)
+        ->SetAttr("col", col++);
+  }
+  add_less_than(main_block, arm);
+  AddOp(main_block,
+        "while",
+        {{"X", "x"}, {"Condition", "cond"}},
+        {{"Out", "x"}, {"StepScopes", "steps"}},
+        arm)
+      ->SetAttr("sub_block", 1);
+  AddOp(main_block, "fetch", {{"X", "x"}}, {{"Out", "fetch"}}, host)
+      ->SetAttr("col", 0);
+
+  Place none;
+  for (auto io : {std::make_pair("x", "t"), std::make_pair("t", "x")}) {
+    auto* scale = AddOp(
+        sub_block, "scale", {{"X", io.first}}, {{"Out", io.second}}, none);
+    scale->SetAttr("scale", 2.f);
+    scale->SetAttr("bias", 0.f);
+    scale->SetAttr("bias_after_scale", true);
+  }
+  AddOp(sub_block, "increment", {{"X", "i"}}, {{"Out", "i"}}, none)
+      ->SetAttr("step", 1.f);
+  add_less_than(sub_block, none);
+  return desc;
+}
+
+void RunWhile(RuntimeProgram* program) {
+  auto* feed = program->exec_scope()
+                   ->FindVar("feed")
+                   ->GetMutable<std::vector<lite::Tensor>>();
+  feed->resize(3);
+  auto& x = feed->at(0);
+  x.Resize({2});
+  x.mutable_data<float>()[0] = 1;
+  x.mutable_data<float>()[1] = 2;
+  auto& i = feed->at(1);
+  i.Resize({1});
+  i.mutable_data<int>()[0] = 0;
+  auto& n = feed->at(2);
+  n.Resize({1});
+  n.mutable_data<float>()[0] = 3;
+
+  program->Run();
+  auto& fetch = program->exec_scope()
+                    ->FindVar("fetch")
+                    ->Get<std::vector<lite::Tensor>>()
+                    .at(0);
+  EXPECT_EQ(fetch.data<float>()[0], 64);
+  EXPECT_EQ(fetch.data<float>()[1], 128);
+}
+
+TEST(while_arm, sub_program) {
+  DeviceInfo::Init();
+  auto desc = WhileProgram();
+  auto scope = std::make_shared<Scope>();
+  RuntimeProgram program(desc, scope);
+  RunWhile(&program);
+
+  // The kernels picked for the sub-block are saved, and its vars stay in it.
+  program.SaveOpInfosToProgram(&desc);
+  program.UpdateVarsOfProgram(&desc);
+  auto* sub_block = desc.GetBlock<cpp::BlockDesc>(1);
+  ASSERT_EQ(sub_block->OpsSize(), 4UL);
+  for (size_t i = 0; i < sub_block->OpsSize(); i++) {
+    EXPECT_TRUE(sub_block->GetOp<cpp::OpDesc>(i)->HasAttr(kKernelTypeAttr));
+  }
+  ASSERT_EQ(sub_block->VarsSize(), 1UL);
+  EXPECT_EQ(sub_block->GetVar<cpp::VarDesc>(0)->Name(), "t");
+
+  RuntimeProgram saved_program(desc, scope);
+  RunWhile(&saved_program);
+}
+
+}  // namespace arm
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(feed);
+USE_LITE_OP(fetch);
+USE_LITE_OP(while);
+USE_LITE_OP(scale);
+USE_LITE_OP(increment);
+USE_LITE_OP(less_than);
+USE_LITE_KERNEL(feed, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(fetch, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(while, kARM, kFloat, kNCHW, def);
+USE_LITE_KERNEL(scale, kARM, kFloat, kNCHW, def);
+USE_LITE_KERNEL(increment, kARM, kFloat, kNCHW, def);
+USE_LITE_KERNEL(less_than, kARM, kFloat, kNCHW, def);
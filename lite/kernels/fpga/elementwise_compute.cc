@@ -26,6 +26,10 @@ using float16 = zynqmp::float16;
 void ElementwiseAddCompute::PrepareForRun() {
   zynqmp::ElementwiseAddParam& ew_param = pe_.param();
   auto& param = Param<operators::ElementwiseParam>();
+  // Only Y is broadcast to the dims of X.
+  CHECK(param.Out->dims() == param.X->dims())
+      << "can not broadcast X of " << param.X->dims() << " to the output of "
+      << param.Out->dims();
 
   param.Out->mutable_data<float16>();
 
@@ -42,6 +46,10 @@ void ElementwiseAddCompute::Run() { pe_.dispatch(); }
 void ElementwiseAddActivationCompute::PrepareForRun() {
   zynqmp::ElementwiseAddParam& ew_param = pe_.param();
   auto& param = Param<operators::FusionElementwiseActivationParam>();
+  // Only Y is broadcast to the dims of X.
+  CHECK(param.Out->dims() == param.X->dims())
+      << "can not broadcast X of " << param.X->dims() << " to the output of "
+      << param.Out->dims();
   if (param.act_type != "relu") {
     LOG(FATAL) << "unsupported Activation type: " << param.act_type;
   }
@@ -0,0 +1,328 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/fusion_elementwise_chain_compute.h"
+#include <algorithm>
+#include <cmath>
+#include "lite/operators/elementwise_ops.h"
+#include "lite/operators/fusion_elementwise_chain_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+namespace {
+
+// The elements computed at a time by an instruction.
+constexpr int kBlock = 256;
+// The rows are grouped into the tasks of about kGrainSize elements, so the
+// small tensors are computed in the calling thread.
+constexpr int64_t kGrainSize = 16384;
+
+// An operand of an instruction in a block, a vector of the block or a scalar
+// broadcast over it.
+struct Operand {
+  const float* data;
+  bool vec;
+};
+
+template <typename Fn>
+inline void Unary(Operand a, float* out, int n, Fn fn) {
+  if (a.vec) {
+    for (int i = 0; i < n; i++) out[i] = fn(a.data[i]);
+  } else {
+    std::fill(out, out + n, fn(*a.data));
+  }
+}
+
+template <typename Fn>
+inline void Binary(Operand a, Operand b, float* out, int n, Fn fn) {
+  if (a.vec && b.vec) {
+    for (int i = 0; i < n; i++) out[i] = fn(a.data[i], b.data[i]);
+  } else if (a.vec) {
+    float y = *b.data;
+    for (int i = 0; i < n; i++) out[i] = fn(a.data[i], y);
+  } else if (b.vec) {
+    float x = *a.data;
+    for (int i = 0; i < n; i++) out[i] = fn(x, b.data[i]);
+  } else {
+    std::fill(out, out + n, fn(*a.data, *b.data));
+  }
+}
+
+inline float Sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+void RunCode(int code,
+             float alpha,
+             float beta,
+             Operand a,
+             Operand b,
+             float* out,
+             int n) {
+  switch (static_cast<operators::ElementwiseChainCode>(code)) {
+    case operators::ElementwiseChainCode::kAdd:
+      return Binary(a, b, out, n, [](float x, float y) { return x + y; });
+    case operators::ElementwiseChainCode::kSub:
+      return Binary(a, b, out, n, [](float x, float y) { return x - y; });
+    case operators::ElementwiseChainCode::kMul:
+      return Binary(a, b, out, n, [](float x, float y) { return x * y; });
+    case operators::ElementwiseChainCode::kDiv:
+      return Binary(a, b, out, n, [](float x, float y) { return x / y; });
+    case operators::ElementwiseChainCode::kMax:
+      return Binary(
+          a, b, out, n, [](float x, float y) { return x > y ? x : y; });
+    case operators::ElementwiseChainCode::kScale:
+      return Unary(a, out, n, [=](float x) { return x * alpha + beta; });
+    case operators::ElementwiseChainCode::kRelu:
+      return Unary(a, out, n, [](float x) { return x > 0.f ? x : 0.f; });
+    case operators::ElementwiseChainCode::kRelu6:
+      return Unary(a, out, n, [=](float x) {
+        return std::min(std::max(x, 0.f), alpha);
+      });
+    case operators::ElementwiseChainCode::kLeakyRelu:
+      return Unary(a, out, n, [=](float x) { return x > 0.f ? x : x * alpha; });
+    case operators::ElementwiseChainCode::kSigmoid:
+      return Unary(a, out, n, [](float x) { return Sigmoid(x); });
+    case operators::ElementwiseChainCode::kTanh:
+      return Unary(a, out, n, [](float x) { return std::tanh(x); });
+    case operators::ElementwiseChainCode::kSwish:
+      return Unary(a, out, n, [=](float x) { return x * Sigmoid(alpha * x); });
+    case operators::ElementwiseChainCode::kExp:
+      return Unary(a, out, n, [](float x) { return std::exp(x); });
+    case operators::ElementwiseChainCode::kLog:
+      return Unary(a, out, n, [](float x) { return std::log(x); });
+    case operators::ElementwiseChainCode::kSquare:
+      return Unary(a, out, n, [](float x) { return x * x; });
+    case operators::ElementwiseChainCode::kHardSigmoid:
+      return Unary(a, out, n, [=](float x) {
+        return std::min(std::max(x * alpha + beta, 0.f), 1.f);
+      });
+  }
+  LOG(FATAL) << "unsupported elementwise chain code " << code;
+}
+
+// Instructions run over an output in one pass, the inputs are read with the
+// strides of their broadcast to the output.
+class FusedLoop {
+ public:
+  // Add an input with its dims aligned to the output, return its operand.
+  int AddInput(const float* data, const std::vector<int64_t>& dims) {
+    inputs_.push_back(data);
+    input_dims_.push_back(dims);
+    return inputs_.size() - 1;
+  }
+
+  // Add an instruction reading the operands a and b, b is ignored by the
+  // unary ones, return the operand of its result.
+  int AddInstruction(int code, float alpha, float beta, int a, int b) {
+    insts_.push_back({code, alpha, beta, a, b});
+    return -static_cast<int>(insts_.size());
+  }
+
+  void Run(const HostContext& ctx, const DDim& out_dims, float* out) const;
+
+ private:
+  struct Instruction {
+    int code;
+    float alpha;
+    float beta;
+    // The inputs are the operands from 0, the results of the instructions
+    // are the operands from -1.
+    int a;
+    int b;
+  };
+
+  std::vector<const float*> inputs_;
+  std::vector<std::vector<int64_t>> input_dims_;
+  std::vector<Instruction> insts_;
+};
+
+void FusedLoop::Run(const HostContext& ctx,
+                    const DDim& out_dims,
+                    float* out) const {
+  // The adjacent dims every input broadcasts the same way are collapsed.
+  int num_inputs = inputs_.size();
+  std::vector<int64_t> dims;
+  std::vector<std::vector<bool>> bcast;
+  for (size_t d = 0; d < out_dims.size(); d++) {
+    if (out_dims[d] == 1) continue;
+    std::vector<bool> flags(num_inputs);
+    for (int i = 0; i < num_inputs; i++) flags[i] = input_dims_[i][d] == 1;
+    if (!dims.empty() && flags == bcast.back()) {
+      dims.back() *= out_dims[d];
+    } else {
+      dims.push_back(out_dims[d]);
+      bcast.push_back(flags);
+    }
+  }
+  if (dims.empty()) {
+    dims.push_back(1);
+    bcast.emplace_back(num_inputs, false);
+  }
+  int rank = dims.size();
+  std::vector<std::vector<int64_t>> strides(num_inputs,
+                                            std::vector<int64_t>(rank));
+  for (int i = 0; i < num_inputs; i++) {
+    int64_t stride = 1;
+    for (int d = rank - 1; d >= 0; d--) {
+      strides[i][d] = bcast[d][i] ? 0 : stride;
+      if (!bcast[d][i]) stride *= dims[d];
+    }
+  }
+
+  int64_t numel = 1;
+  for (auto d : dims) numel *= d;
+  if (numel == 0) return;
+  // The last dim is the rows, the others are walked with the strides.
+  int outer = rank - 1;
+  int64_t n = dims.back();
+  int64_t rows = numel / n;
+  int64_t rows_per_task = std::max<int64_t>(1, kGrainSize / n);
+  int tasks = static_cast<int>((rows + rows_per_task - 1) / rows_per_task);
+  int num_insts = insts_.size();
+  ctx.ParallelFor(tasks, [&](int task, int tid) {
+    std::vector<float> regs(num_insts * kBlock);
+    // The index of the row in the outer dims, and its offsets in the inputs.
+    std::vector<int64_t> index(outer);
+    std::vector<int64_t> offsets(num_inputs, 0);
+    int64_t begin = task * rows_per_task;
+    int64_t end = std::min(rows, begin + rows_per_task);
+    int64_t rest = begin;
+    for (int d = outer - 1; d >= 0; d--) {
+      index[d] = rest % dims[d];
+      rest /= dims[d];
+      for (int i = 0; i < num_inputs; i++) {
+        offsets[i] += index[d] * strides[i][d];
+      }
+    }
+
+    for (int64_t r = begin; r < end; r++) {
+      for (int64_t j = 0; j < n; j += kBlock) {
+        int len = static_cast<int>(std::min<int64_t>(kBlock, n - j));
+        auto operand = [&](int id) -> Operand {
+          if (id < 0) return {regs.data() + (-id - 1) * kBlock, true};
+          bool vec = strides[id][rank - 1] != 0;
+          return {inputs_[id] + offsets[id] + (vec ? j : 0), vec};
+        };
+        for (int k = 0; k < num_insts; k++) {
+          auto& inst = insts_[k];
+          float* dst =
+              k + 1 == num_insts ? out + r * n + j : regs.data() + k * kBlock;
+          RunCode(inst.code,
+                  inst.alpha,
+                  inst.beta,
+                  operand(inst.a),
+                  operand(inst.b),
+                  dst,
+                  len);
+        }
+      }
+      for (int d = outer - 1; d >= 0; d--) {
+        for (int i = 0; i < num_inputs; i++) offsets[i] += strides[i][d];
+        if (++index[d] < dims[d]) break;
+        for (int i = 0; i < num_inputs; i++) {
+          offsets[i] -= strides[i][d] * dims[d];
+        }
+        index[d] = 0;
+      }
+    }
+  });
+}
+
+}  // namespace
+
+void FusionElementwiseChainCompute::Run() {
+  auto& param = Param<operators::FusionElementwiseChainParam>();
+  auto& ctx = ctx_->As<HostContext>();
+  std::vector<DDim> dims;
+  CHECK(operators::ElementwiseChainDims(param, &dims));
+  int num_inputs = param.X.size();
+  int num_insts = param.codes.size() / 4;
+  const DDim& out_dims = dims.back();
+
+  // The dims of the operands of the k-th instruction aligned to its result.
+  auto align = [&](int k,
+                   std::vector<int64_t>* a_dims,
+                   std::vector<int64_t>* b_dims) {
+    const int* codes = &param.codes[k * 4];
+    if (codes[2] < 0) {
+      *a_dims = dims[codes[1]].Vectorize();
+      return;
+    }
+    CHECK(operators::ElementwiseAlignDims(
+        dims[codes[1]], dims[codes[2]], codes[3], a_dims, b_dims));
+  };
+
+  bool fused = true;
+  for (int k = 0; k < num_insts; k++) {
+    if (dims[num_inputs + k] != out_dims) fused = false;
+  }
+  if (fused) {
+    FusedLoop loop;
+    // The operands of the registers of the instructions.
+    std::vector<int> results(num_insts);
+    auto operand = [&](int reg, const std::vector<int64_t>& aligned) {
+      if (reg >= num_inputs) return results[reg - num_inputs];
+      return loop.AddInput(param.X[reg]->data<float>(), aligned);
+    };
+    for (int k = 0; k < num_insts; k++) {
+      const int* codes = &param.codes[k * 4];
+      std::vector<int64_t> a_dims, b_dims;
+      align(k, &a_dims, &b_dims);
+      int a = operand(codes[1], a_dims);
+      int b = codes[2] < 0 ? -1 : operand(codes[2], b_dims);
+      results[k] = loop.AddInstruction(
+          codes[0], param.attrs[k * 2], param.attrs[k * 2 + 1], a, b);
+    }
+    loop.Run(ctx, out_dims, param.Out->mutable_data<float>());
+    return;
+  }
+
+  temps_.resize(num_insts);
+  auto reg_tensor = [&](int reg) -> const lite::Tensor* {
+    return reg < num_inputs ? param.X[reg] : &temps_[reg - num_inputs];
+  };
+  for (int k = 0; k < num_insts; k++) {
+    const int* codes = &param.codes[k * 4];
+    std::vector<int64_t> a_dims, b_dims;
+    align(k, &a_dims, &b_dims);
+    FusedLoop loop;
+    int a = loop.AddInput(reg_tensor(codes[1])->data<float>(), a_dims);
+    int b = -1;
+    if (codes[2] >= 0) {
+      b = loop.AddInput(reg_tensor(codes[2])->data<float>(), b_dims);
+    }
+    loop.AddInstruction(
+        codes[0], param.attrs[k * 2], param.attrs[k * 2 + 1], a, b);
+    auto* result = k + 1 == num_insts ? param.Out : &temps_[k];
+    result->Resize(dims[num_inputs + k]);
+    loop.Run(ctx, result->dims(), result->mutable_data<float>());
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fusion_elementwise_chain,
+                     kHost,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::host::FusionElementwiseChainCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kHost))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kHost))})
+    .Finalize();
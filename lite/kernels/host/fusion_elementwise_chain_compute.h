@@ -0,0 +1,51 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+/*
+ * Interpret the instructions of fusion_elementwise_chain block by block, every
+ * instruction computes a block of the output into a small register kept in
+ * the cache, and the last one writes the output, so the intermediate tensors
+ * of the chain are never written to memory.
+ *
+ * The inputs may be broadcast to the output as in the elementwise ops. If an
+ * instruction broadcasts its result, e.g. two small inputs are added before
+ * being added to a larger one, the instructions run one by one over the whole
+ * tensors instead.
+ */
+class FusionElementwiseChainCompute
+    : public KernelLite<TARGET(kHost), PRECISION(kFloat)> {
+ public:
+  void Run() override;
+
+  virtual ~FusionElementwiseChainCompute() = default;
+
+ private:
+  // The results of the instructions run one by one.
+  std::vector<lite::Tensor> temps_;
+};
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,130 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/host/fusion_elementwise_chain_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/operators/fusion_elementwise_chain_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace host {
+
+using Code = operators::ElementwiseChainCode;
+
+void FillTensor(lite::Tensor* tensor, const std::vector<int64_t>& dims) {
+  tensor->Resize(dims);
+  auto* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = (i % 13) * 0.25f - 1.5f;
+  }
+}
+
+void RunChain(const operators::FusionElementwiseChainParam& param,
+              int threads) {
+  FusionElementwiseChainCompute chain;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<HostContext>().SetThreadPool(std::make_shared<ThreadPool>(threads));
+  chain.SetContext(std::move(ctx));
+  std::vector<DDim> dims;
+  ASSERT_TRUE(operators::ElementwiseChainDims(param, &dims));
+  param.Out->Resize(dims.back());
+  chain.SetParam(param);
+  chain.Run();
+}
+
+TEST(fusion_elementwise_chain_host, init) {
+  FusionElementwiseChainCompute chain;
+  ASSERT_EQ(chain.precision(), PRECISION(kFloat));
+  ASSERT_EQ(chain.target(), TARGET(kHost));
+}
+
+// relu6(x * 2 + 1 + y), y (4, 1) is broadcast to x (2, 4, 300) from axis 1.
+TEST(fusion_elementwise_chain_host, fused) {
+  lite::Tensor x, y, out;
+  FillTensor(&x, {2, 4, 300});
+  FillTensor(&y, {4, 1});
+  operators::FusionElementwiseChainParam param;
+  param.X = {&x, &y};
+  param.Out = &out;
+  param.codes = {static_cast<int>(Code::kScale), 0, -1, -1,
+                 static_cast<int>(Code::kAdd),   2, 1,  1,
+                 static_cast<int>(Code::kRelu6), 3, -1, -1};
+  param.attrs = {2.f, 1.f, 0.f, 0.f, 6.f, 0.f};
+
+  for (int threads : {1, 4}) {
+    RunChain(param, threads);
+    ASSERT_EQ(out.dims(), x.dims());
+    for (int64_t i = 0; i < out.numel(); i++) {
+      float ref = x.data<float>()[i] * 2.f + 1.f + y.data<float>()[i / 300 % 4];
+      ref = std::min(std::max(ref, 0.f), 6.f);
+      ASSERT_NEAR(out.data<float>()[i], ref, 1e-5) << "threads " << threads
+                                                   << " at " << i;
+    }
+  }
+}
+
+// swish(x) * x reads x twice, and the rows are longer than a block.
+TEST(fusion_elementwise_chain_host, swish) {
+  lite::Tensor x, out;
+  FillTensor(&x, {3, 1000});
+  operators::FusionElementwiseChainParam param;
+  param.X = {&x};
+  param.Out = &out;
+  param.codes = {static_cast<int>(Code::kSwish), 0, -1, -1,
+                 static_cast<int>(Code::kMul),   1, 0,  -1};
+  param.attrs = {1.5f, 0.f, 0.f, 0.f};
+
+  RunChain(param, 2);
+  for (int64_t i = 0; i < out.numel(); i++) {
+    float v = x.data<float>()[i];
+    float ref = v / (1.f + std::exp(-1.5f * v)) * v;
+    ASSERT_NEAR(out.data<float>()[i], ref, 1e-5) << "at " << i;
+  }
+}
+
+// sigmoid(x + (a - b)), a - b is broadcast to x, so the instructions run one
+// by one.
+TEST(fusion_elementwise_chain_host, unfused) {
+  lite::Tensor x, a, b, out;
+  FillTensor(&x, {5, 3, 7});
+  FillTensor(&a, {3, 1});
+  FillTensor(&b, {3, 7});
+  operators::FusionElementwiseChainParam param;
+  param.X = {&x, &a, &b};
+  param.Out = &out;
+  param.codes = {static_cast<int>(Code::kSub),     1, 2, -1,
+                 static_cast<int>(Code::kAdd),     0, 3, -1,
+                 static_cast<int>(Code::kSigmoid), 4, -1, -1};
+  param.attrs = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+
+  RunChain(param, 2);
+  ASSERT_EQ(out.dims(), x.dims());
+  for (int64_t i = 0; i < out.numel(); i++) {
+    int64_t j = i % 21;
+    float v = x.data<float>()[i] + a.data<float>()[j / 7] - b.data<float>()[j];
+    ASSERT_NEAR(out.data<float>()[i], 1.f / (1.f + std::exp(-v)), 1e-5)
+        << "at " << i;
+  }
+}
+
+}  // namespace host
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -13,7 +13,8 @@
 // limitations under the License.
 
 #include "lite/kernels/host/multiclass_nms_compute.h"
-#include <map>
+#include <algorithm>
+#include <cstring>
 #include <utility>
 #include <vector>
 
@@ -22,41 +23,44 @@ namespace lite {
 namespace kernels {
 namespace host {
 
+// The score and the index of a candidate box, or of a detection of an image.
 template <class T>
-bool SortScorePairDescend(const std::pair<float, T>& pair1,
-                          const std::pair<float, T>& pair2) {
-  return pair1.first > pair2.first;
+struct ScoreIndex {
+  T score;
+  int index;
+};
+
+// Orders by the scores in descending order, and by the indices for the same
+// scores, it is the order of a stable sort by the scores.
+template <class T>
+static bool ScoreIndexDescend(const ScoreIndex<T>& a, const ScoreIndex<T>& b) {
+  return a.score > b.score || (a.score == b.score && a.index < b.index);
 }
 
+// Sort the first `top_k` items of `items`, and drop the others. Only the
+// items kept are sorted.
 template <class T>
-static void GetMaxScoreIndex(const std::vector<T>& scores,
-                             const T threshold,
-                             int top_k,
-                             std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
-    }
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
+static void TopK(int64_t top_k, std::vector<ScoreIndex<T>>* items) {
+  if (top_k > -1 && top_k < static_cast<int64_t>(items->size())) {
+    std::partial_sort(items->begin(),
+                      items->begin() + top_k,
+                      items->end(),
+                      ScoreIndexDescend<T>);
+    items->resize(top_k);
+  } else {
+    std::sort(items->begin(), items->end(), ScoreIndexDescend<T>);
   }
 }
 
 template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
+static T BBoxArea(T xmin, T ymin, T xmax, T ymax, const bool normalized) {
+  if (xmax < xmin || ymax < ymin) {
     // If coordinate values are is invalid
     // (e.g. xmax < xmin or ymax < ymin), return 0.
     return static_cast<T>(0.);
   } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
+    const T w = xmax - xmin;
+    const T h = ymax - ymin;
     if (normalized) {
       return w * h;
     } else {
@@ -66,247 +70,178 @@ static T BBoxArea(const T* box, const bool normalized) {
   }
 }
 
+// The boxes kept by the NMS of a class in the structure of arrays, so the
+// overlaps of a box with all of them are computed in vectors.
 template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = std::max(box1[0], box2[0]);
-    const T inter_ymin = std::max(box1[1], box2[1]);
-    const T inter_xmax = std::min(box1[2], box2[2]);
-    const T inter_ymax = std::min(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
+struct KeptBoxes {
+  std::vector<T> xmin, ymin, xmax, ymax, area;
 
-template <class T>
-T PolyIoU(const T* box1,
-          const T* box2,
-          const size_t box_size,
-          const bool normalized) {
-  LOG(FATAL) << "PolyIoU not implement.";
-}
+  void Add(const T* box, T box_area) {
+    xmin.push_back(box[0]);
+    ymin.push_back(box[1]);
+    xmax.push_back(box[2]);
+    ymax.push_back(box[3]);
+    area.push_back(box_area);
+  }
+  size_t size() const { return area.size(); }
 
-template <class T>
-void SliceOneClass(const Tensor& items,
-                   const int class_id,
-                   Tensor* one_class_item) {
-  T* item_data = one_class_item->mutable_data<T>();
-  const T* items_data = items.data<T>();
-  const int64_t num_item = items.dims()[0];
-  const int64_t class_num = items.dims()[1];
-  if (items.dims().size() == 3) {
-    int64_t item_size = items.dims()[2];
-    for (int i = 0; i < num_item; ++i) {
-      std::memcpy(item_data + i * item_size,
-                  items_data + i * class_num * item_size + class_id * item_size,
-                  sizeof(T) * item_size);
-    }
-  } else {
-    for (int i = 0; i < num_item; ++i) {
-      item_data[i] = items_data[i * class_num + class_id];
+  // Whether the Jaccard overlap of `box` with any box kept is greater than
+  // `threshold`.
+  bool Overlaps(const T* box, T box_area, T threshold, T norm) const {
+    const T x0 = box[0], y0 = box[1], x1 = box[2], y1 = box[3];
+    const size_t n = size();
+    const T* kx0 = xmin.data();
+    const T* ky0 = ymin.data();
+    const T* kx1 = xmax.data();
+    const T* ky1 = ymax.data();
+    const T* karea = area.data();
+    // The blocks are branch-free to vectorize, and the overlaps of the
+    // boxes kept first are checked first, as the most likely to suppress.
+    constexpr size_t kBlock = 32;
+    for (size_t begin = 0; begin < n; begin += kBlock) {
+      const size_t end = std::min(n, begin + kBlock);
+      int suppressed = 0;
+      for (size_t j = begin; j < end; ++j) {
+        int disjoint = (kx0[j] > x1) | (kx1[j] < x0) | (ky0[j] > y1) |
+                       (ky1[j] < y0);
+        T inter_w = std::min(x1, kx1[j]) - std::max(x0, kx0[j]) + norm;
+        T inter_h = std::min(y1, ky1[j]) - std::max(y0, ky0[j]) + norm;
+        T inter_area = inter_w * inter_h;
+        T overlap = inter_area / (box_area + karea[j] - inter_area);
+        suppressed |= (disjoint == 0) & (overlap > threshold);
+      }
+      if (suppressed) return true;
     }
+    return false;
   }
-}
+};
 
+// The NMS of a class. The score and the box of the i-th candidate are at
+// `scores + i * score_stride` and `boxes + i * box_stride`. The kept indices
+// are in the descending order of the scores.
 template <typename T>
-void NMSFast(const Tensor& bbox,
-             const Tensor& scores,
+void NMSFast(const T* scores,
+             int64_t score_stride,
+             const T* boxes,
+             int64_t box_stride,
+             int64_t box_size,
+             int64_t num_boxes,
              const T score_threshold,
              const T nms_threshold,
              const T eta,
              const int64_t top_k,
              std::vector<int>* selected_indices,
              const bool normalized) {
-  // The total boxes for each instance.
-  int64_t num_boxes = bbox.dims()[0];
-  // 4: [xmin ymin xmax ymax]
-  // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
-  // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
-  int64_t box_size = bbox.dims()[1];
-
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  GetMaxScoreIndex(scores_data, score_threshold, top_k, &sorted_indices);
+  std::vector<ScoreIndex<T>> sorted_indices;
+  for (int64_t i = 0; i < num_boxes; ++i) {
+    T score = scores[i * score_stride];
+    if (score > score_threshold) {
+      sorted_indices.push_back({score, static_cast<int>(i)});
+    }
+  }
+  TopK(top_k, &sorted_indices);
 
   selected_indices->clear();
   T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox.data<T>();
-
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
+  // 4: [xmin ymin xmax ymax]
+  // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
+  // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
+  // The first box is always kept, the overlaps are needed from the second.
+  if ((box_size == 8 || box_size == 16 || box_size == 24 || box_size == 32) &&
+      sorted_indices.size() > 1) {
+    LOG(FATAL) << "PolyIoU not implement.";
+  }
+  KeptBoxes<T> kept;
+  const T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
+  for (auto& candidate : sorted_indices) {
+    const int idx = candidate.index;
+    const T* box = boxes + idx * box_stride;
+    T area = static_cast<T>(0.);
     bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = JaccardOverlap<T>(bbox_data + idx * box_size,
-                                      bbox_data + kept_idx * box_size,
-                                      normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap = PolyIoU<T>(bbox_data + idx * box_size,
-                               bbox_data + kept_idx * box_size,
-                               box_size,
-                               normalized);
-        }
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
+    if (box_size == 4) {
+      area = BBoxArea<T>(box[0], box[1], box[2], box[3], normalized);
+      keep = !kept.Overlaps(box, area, adaptive_threshold, norm);
     }
     if (keep) {
       selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
+      if (box_size == 4) kept.Add(box, area);
+      if (eta < 1 && adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
     }
   }
 }
 
+// Keep the top keep_top_k detections of an image, `indices[c]` is the
+// indices kept by the NMS of the class c. Returns the number of the
+// detections kept.
 template <typename T>
-void MultiClassNMS(const operators::MulticlassNmsParam& param,
-                   const Tensor& scores,
-                   const Tensor& bboxes,
-                   const int scores_size,
-                   std::map<int, std::vector<int>>* indices,
-                   int* num_nmsed_out) {
-  int64_t background_label = param.background_label;
-  int64_t nms_top_k = param.nms_top_k;
+int KeepTopK(const operators::MulticlassNmsParam& param,
+             const T* scores,
+             int64_t class_stride,
+             int64_t score_stride,
+             const int scores_size,
+             std::vector<std::vector<int>>* indices) {
   int64_t keep_top_k = param.keep_top_k;
-  bool normalized = param.normalized;
-  T nms_threshold = static_cast<T>(param.nms_threshold);
-  T nms_eta = static_cast<T>(param.nms_eta);
-  T score_threshold = static_cast<T>(param.score_threshold);
-
   int num_det = 0;
-
-  int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
-  for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
-    } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
-      SliceOneClass<T>(scores, c, &score_slice);
-      SliceOneClass<T>(bboxes, c, &bbox_slice);
-    }
-    NMSFast(bbox_slice,
-            score_slice,
-            score_threshold,
-            nms_threshold,
-            nms_eta,
-            nms_top_k,
-            &((*indices)[c]),
-            normalized);
-    if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
-    }
-    num_det += (*indices)[c].size();
+  for (auto& class_indices : *indices) {
+    num_det += class_indices.size();
+  }
+  if (keep_top_k <= -1 || num_det <= keep_top_k) {
+    return num_det;
   }
 
-  *num_nmsed_out = num_det;
-  const T* scores_data = scores.data<T>();
-  if (keep_top_k > -1 && num_det > keep_top_k) {
-    const T* sdata;
-    std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
-    for (const auto& it : *indices) {
-      int label = it.first;
-      if (scores_size == 3) {
-        sdata = scores_data + label * scores.dims()[1];
-      } else {
-        score_slice.Resize({scores.dims()[0], 1});
-        SliceOneClass<T>(scores, label, &score_slice);
-        sdata = score_slice.data<T>();
-      }
-      const std::vector<int>& label_indices = it.second;
-      for (size_t j = 0; j < label_indices.size(); ++j) {
-        int idx = label_indices[j];
-        score_index_pairs.push_back(
-            std::make_pair(sdata[idx], std::make_pair(label, idx)));
-      }
+  // The detections are ordered by the scores, and by the labels and the
+  // indices in the classes for the same scores.
+  std::vector<ScoreIndex<T>> detections;
+  std::vector<std::pair<int, int>> label_indices;
+  detections.reserve(num_det);
+  label_indices.reserve(num_det);
+  for (size_t label = 0; label < indices->size(); ++label) {
+    for (int idx : (*indices)[label]) {
+      T score = scores[label * class_stride + idx * score_stride];
+      detections.push_back({score, static_cast<int>(label_indices.size())});
+      label_indices.emplace_back(label, idx);
     }
-    // Keep top k results per image.
-    std::stable_sort(score_index_pairs.begin(),
-                     score_index_pairs.end(),
-                     SortScorePairDescend<std::pair<int, int>>);
-    score_index_pairs.resize(keep_top_k);
+  }
+  TopK(keep_top_k, &detections);
 
-    // Store the new indices.
-    std::map<int, std::vector<int>> new_indices;
-    for (size_t j = 0; j < score_index_pairs.size(); ++j) {
-      int label = score_index_pairs[j].second.first;
-      int idx = score_index_pairs[j].second.second;
-      new_indices[label].push_back(idx);
-    }
-    if (scores_size == 2) {
-      for (const auto& it : new_indices) {
-        int label = it.first;
-        std::stable_sort(new_indices[label].begin(), new_indices[label].end());
-      }
+  for (auto& class_indices : *indices) {
+    class_indices.clear();
+  }
+  for (auto& detection : detections) {
+    auto& label_index = label_indices[detection.index];
+    (*indices)[label_index.first].push_back(label_index.second);
+  }
+  if (scores_size == 2) {
+    for (auto& class_indices : *indices) {
+      std::sort(class_indices.begin(), class_indices.end());
     }
-    new_indices.swap(*indices);
-    *num_nmsed_out = keep_top_k;
   }
+  return keep_top_k;
 }
 
 template <typename T>
-void MultiClassOutput(const Tensor& scores,
-                      const Tensor& bboxes,
-                      const std::map<int, std::vector<int>>& selected_indices,
-                      const int scores_size,
-                      Tensor* outs) {
-  int64_t class_num = scores.dims()[1];
-  int64_t predict_dim = scores.dims()[1];
-  int64_t box_size = bboxes.dims()[1];
-  if (scores_size == 2) {
-    box_size = bboxes.dims()[2];
-  }
+void MultiClassOutput(const T* scores,
+                      int64_t class_stride,
+                      int64_t score_stride,
+                      const T* bboxes,
+                      int64_t box_class_stride,
+                      int64_t box_stride,
+                      int64_t box_size,
+                      const std::vector<std::vector<int>>& selected_indices,
+                      T* odata) {
   int64_t out_dim = box_size + 2;
-  auto* scores_data = scores.data<T>();
-  auto* bboxes_data = bboxes.data<T>();
-  auto* odata = outs->mutable_data<T>();
-  const T* sdata;
-  Tensor bbox;
-  bbox.Resize({scores.dims()[0], box_size});
   int count = 0;
-  for (const auto& it : selected_indices) {
-    int label = it.first;
-    const std::vector<int>& indices = it.second;
-    if (scores_size == 2) {
-      SliceOneClass<T>(bboxes, label, &bbox);
-    } else {
-      sdata = scores_data + label * predict_dim;
-    }
-    for (size_t j = 0; j < indices.size(); ++j) {
-      int idx = indices[j];
+  for (size_t label = 0; label < selected_indices.size(); ++label) {
+    for (int idx : selected_indices[label]) {
       odata[count * out_dim] = label;  // label
-      const T* bdata;
-      if (scores_size == 3) {
-        bdata = bboxes_data + idx * box_size;
-        odata[count * out_dim + 1] = sdata[idx];  // score
-      } else {
-        bdata = bbox.data<T>() + idx * box_size;
-        odata[count * out_dim + 1] = *(scores_data + idx * class_num + label);
-      }
+      odata[count * out_dim + 1] =
+          scores[label * class_stride + idx * score_stride];  // score
       // xmin, ymin, xmax, ymax or multi-points coordinates
-      std::memcpy(odata + count * out_dim + 2, bdata, box_size * sizeof(T));
+      std::memcpy(odata + count * out_dim + 2,
+                  bboxes + label * box_class_stride + idx * box_stride,
+                  box_size * sizeof(T));
       count++;
     }
   }
@@ -320,30 +255,86 @@ void MulticlassNmsCompute::Run() {
 
   auto score_dims = scores->dims();
   auto score_size = score_dims.size();
-
-  std::vector<std::map<int, std::vector<int>>> all_indices;
-  std::vector<uint64_t> batch_starts = {0};
-  int64_t batch_size = score_dims[0];
   int64_t box_dim = boxes->dims()[2];
   int64_t out_dim = box_dim + 2;
-  int num_nmsed_out = 0;
-  Tensor boxes_slice, scores_slice;
-  int n = score_size == 3 ? batch_size : boxes->lod().back().size() - 1;
-  for (int i = 0; i < n; ++i) {
-    if (score_size == 3) {
-      scores_slice = scores->Slice<float>(i, i + 1);
-      scores_slice.Resize({score_dims[1], score_dims[2]});
-      boxes_slice = boxes->Slice<float>(i, i + 1);
-      boxes_slice.Resize({score_dims[2], box_dim});
-    } else {
-      auto boxes_lod = boxes->lod().back();
-      scores_slice = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-      boxes_slice = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
+
+  // The layout of image i, the score of the class c of the box j is at
+  // scores + score_offsets[i] + c * class_stride + j * score_stride, and so
+  // on for the boxes:
+  // 3: scores [N, C, M], boxes [N, M, box_dim] shared by the classes.
+  // 2: scores [M, C], boxes [M, C, box_dim] with the lod of the images.
+  int64_t class_num, class_stride, score_stride;
+  int64_t box_class_stride, box_stride;
+  int n;
+  std::vector<int64_t> starts;
+  if (score_size == 3) {
+    n = score_dims[0];
+    class_num = score_dims[1];
+    class_stride = score_dims[2];
+    score_stride = 1;
+    box_class_stride = 0;
+    box_stride = box_dim;
+    for (int i = 0; i <= n; ++i) {
+      starts.push_back(i * score_dims[2]);
+    }
+  } else {
+    auto& boxes_lod = boxes->lod().back();
+    n = boxes_lod.size() - 1;
+    class_num = score_dims[1];
+    class_stride = 1;
+    score_stride = class_num;
+    box_class_stride = box_dim;
+    box_stride = class_num * box_dim;
+    starts.assign(boxes_lod.begin(), boxes_lod.end());
+  }
+  auto score_offset = [&](int i) { return starts[i] * class_num; };
+  auto box_offset = [&](int i) {
+    return score_size == 3 ? starts[i] * box_dim
+                           : starts[i] * class_num * box_dim;
+  };
+  const float* scores_data = scores->data<float>();
+  const float* boxes_data = boxes->data<float>();
+
+  // The classes of all the images run in parallel.
+  std::vector<std::vector<std::vector<int>>> all_indices(
+      n, std::vector<std::vector<int>>(class_num));
+  auto nms = [&](int task, int tid) {
+    int i = task / class_num;
+    int c = task % class_num;
+    if (c == param.background_label) return;
+    auto& indices = all_indices[i][c];
+    NMSFast<float>(scores_data + score_offset(i) + c * class_stride,
+                   score_stride,
+                   boxes_data + box_offset(i) + c * box_class_stride,
+                   box_stride,
+                   box_dim,
+                   starts[i + 1] - starts[i],
+                   param.score_threshold,
+                   param.nms_threshold,
+                   param.nms_eta,
+                   param.nms_top_k,
+                   &indices,
+                   param.normalized);
+    if (score_size == 2) {
+      std::sort(indices.begin(), indices.end());
     }
-    std::map<int, std::vector<int>> indices;
-    MultiClassNMS<float>(
-        param, scores_slice, boxes_slice, score_size, &indices, &num_nmsed_out);
-    all_indices.push_back(indices);
+  };
+  int tasks = n * class_num;
+  if (ctx_) {
+    ctx_->As<HostContext>().ParallelFor(tasks, nms);
+  } else {
+    for (int task = 0; task < tasks; ++task) nms(task, 0);
+  }
+
+  std::vector<uint64_t> batch_starts = {0};
+  for (int i = 0; i < n; ++i) {
+    int num_nmsed_out =
+        KeepTopK<float>(param,
+                        scores_data + score_offset(i),
+                        class_stride,
+                        score_stride,
+                        score_size,
+                        &all_indices[i]);
     batch_starts.push_back(batch_starts.back() + num_nmsed_out);
   }
 
@@ -355,24 +346,17 @@ void MulticlassNmsCompute::Run() {
     batch_starts = {0, 1};
   } else {
     outs->Resize({static_cast<int64_t>(num_kept), out_dim});
+    float* odata = outs->mutable_data<float>();
     for (int i = 0; i < n; ++i) {
-      if (score_size == 3) {
-        scores_slice = scores->Slice<float>(i, i + 1);
-        boxes_slice = boxes->Slice<float>(i, i + 1);
-        scores_slice.Resize({score_dims[1], score_dims[2]});
-        boxes_slice.Resize({score_dims[2], box_dim});
-      } else {
-        auto boxes_lod = boxes->lod().back();
-        scores_slice = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-        boxes_slice = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-      }
-      int64_t s = static_cast<int64_t>(batch_starts[i]);
-      int64_t e = static_cast<int64_t>(batch_starts[i + 1]);
-      if (e > s) {
-        Tensor out = outs->Slice<float>(s, e);
-        MultiClassOutput<float>(
-            scores_slice, boxes_slice, all_indices[i], score_dims.size(), &out);
-      }
+      MultiClassOutput<float>(scores_data + score_offset(i),
+                              class_stride,
+                              score_stride,
+                              boxes_data + box_offset(i),
+                              box_class_stride,
+                              box_stride,
+                              box_dim,
+                              all_indices[i],
+                              odata + batch_starts[i] * out_dim);
     }
   }
 
@@ -15,6 +15,7 @@
 #include "lite/kernels/host/multiclass_nms_compute.h"
 #include <gtest/gtest.h>
 #include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -360,6 +361,68 @@ TEST(multiclass_nms_host, compute) {
   }
 }
 
+TEST(multiclass_nms_host, random_boxes) {
+  // {images, boxes, classes, nms_top_k, keep_top_k, nms_eta}
+  std::vector<std::vector<float>> cases{{1, 500, 5, 100, 50, 1.f},
+                                        {2, 300, 8, -1, -1, 1.f},
+                                        {3, 200, 4, 64, 100, 0.9f},
+                                        {1, 1000, 21, 400, 200, 1.f}};
+  for (auto& c : cases) {
+    int N = c[0], M = c[1], class_num = c[2];
+    lite::Tensor bbox, conf, out;
+    bbox.Resize({N, M, 4});
+    conf.Resize({N, class_num, M});
+    auto* bbox_data = bbox.mutable_data<float>();
+    auto* conf_data = conf.mutable_data<float>();
+    unsigned seed = 7;
+    auto rand_uniform = [&seed]() {
+      seed = seed * 1103515245 + 12345;
+      return ((seed >> 8) & 0xffff) / 65536.f;
+    };
+    for (int i = 0; i < N * M; ++i) {
+      float x = rand_uniform() * 0.9f, y = rand_uniform() * 0.9f;
+      bbox_data[i * 4] = x;
+      bbox_data[i * 4 + 1] = y;
+      bbox_data[i * 4 + 2] = x + rand_uniform() * 0.2f;
+      bbox_data[i * 4 + 3] = y + rand_uniform() * 0.2f;
+    }
+    for (int i = 0; i < conf.numel(); ++i) {
+      // Quantized so some scores are the same.
+      conf_data[i] = static_cast<int>(rand_uniform() * 64) / 64.f;
+    }
+
+    operators::MulticlassNmsParam param;
+    param.bboxes = &bbox;
+    param.scores = &conf;
+    param.out = &out;
+    param.background_label = 0;
+    param.nms_top_k = c[3];
+    param.keep_top_k = c[4];
+    param.nms_eta = c[5];
+    param.score_threshold = 0.3f;
+    param.nms_threshold = 0.45f;
+    std::vector<float> out_ref;
+    multiclass_nms_compute_ref<float>(
+        param, class_num, std::vector<int>(N, M), true, &out_ref);
+
+    for (int threads : {1, 4}) {
+      MulticlassNmsCompute multiclass_nms;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<HostContext>().SetThreadPool(
+          std::make_shared<ThreadPool>(threads));
+      multiclass_nms.SetContext(std::move(ctx));
+      multiclass_nms.SetParam(param);
+      multiclass_nms.Run();
+      ASSERT_EQ(out.numel(), static_cast<int64_t>(out_ref.size()));
+      for (int64_t i = 0; i < out.numel(); i++) {
+        ASSERT_EQ(out.data<float>()[i], out_ref[i])
+            << "case " << &c - &cases[0] << " threads " << threads << " at "
+            << i;
+      }
+    }
+  }
+}
+
 }  // namespace host
 }  // namespace kernels
 }  // namespace lite
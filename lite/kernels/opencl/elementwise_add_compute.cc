@@ -75,6 +75,9 @@ void ElementwiseAddCompute::UpdateParams() {
   const auto& x_dims = ele_param_->X->dims();
   const auto& y_dims = ele_param_->Y->dims();
   const auto& out_dims = ele_param_->Out->dims();
+  // Only Y is broadcast to the dims of X.
+  CHECK(out_dims == x_dims) << "can not broadcast X of " << x_dims
+                            << " to the output of " << out_dims;
   if (axis < 0) {
     axis = static_cast<int>(x_dims.size() - y_dims.size());
   }
@@ -13,12 +13,13 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
 #include <utility>
 #include <vector>
+#include "lite/backends/x86/jit/kernels.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
-#include "lite/fluid/eigen.h"
 #include "lite/operators/activation_ops.h"
 
 namespace paddle {
@@ -55,27 +56,40 @@ struct BaseActivationFunctor {
   bool Inplace() const { return false; }
 };
 
-template <typename Functor>
+// The length of the jit kernels of the activations. The jit code is
+// unrolled for the length, so the tensors run by the blocks of it, and the
+// cache keeps one kernel whatever the sizes of the tensors are.
+constexpr int kActivateBlock = 1024;
+
+// Run the activation by the jit kernel of `KernelTuple`, it is the code
+// generated for the features of the CPU, e.g. AVX or AVX512, or the reference
+// code if the CPU has none of them.
+template <typename KernelTuple>
 bool Activate(const lite::Tensor* X, lite::Tensor* Out) {
-  using T = typename Functor::ELEMENT_TYPE;
-  auto place = lite::fluid::EigenDeviceType<TARGET(kX86)>();
+  using T = typename KernelTuple::data_type;
   CHECK_OR_FALSE(X)
   CHECK_OR_FALSE(Out)
-  auto x = lite::fluid::EigenVector<T>::Flatten(*X);
-  auto out = lite::fluid::EigenVector<T>::Flatten(*Out);
-  Functor()(place, x, out);
+  auto act = jit::KernelFuncs<KernelTuple, lite::fluid::CPUPlace>::Cache().At(
+      kActivateBlock);
+  const T* x = X->data<T>();
+  T* out = Out->template mutable_data<T>();
+  int64_t n = X->numel();
+  int64_t i = 0;
+  for (; i + kActivateBlock <= n; i += kActivateBlock) {
+    act(x + i, out + i, kActivateBlock);
+  }
+  if (i < n) {
+    // The tail is padded to a block.
+    T tail_x[kActivateBlock] = {};
+    T tail_out[kActivateBlock];
+    std::copy(x + i, x + n, tail_x);
+    act(tail_x, tail_out, kActivateBlock);
+    std::copy(tail_out, tail_out + (n - i), out + i);
+  }
   return true;
 }
 
 // square(x) = x^2
-template <typename T>
-struct SquareFunctor : public BaseActivationFunctor<T> {
-  template <typename Device, typename X, typename Out>
-  void operator()(Device d, X x, Out out) const {
-    out.device(d) = x.square();
-  }
-};
-
 template <typename T>
 class SquareCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -83,9 +97,7 @@ class SquareCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<operators::ActivationParam>();
-
-    param.Out->template mutable_data<T>();
-    Activate<SquareFunctor<T>>(param.X, param.Out);
+    Activate<jit::VSquareTuple<T>>(param.X, param.Out);
   }
 
   virtual ~SquareCompute() = default;
@@ -93,26 +105,45 @@ class SquareCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
 // relu(x) = max(x, 0)
 template <typename T>
-struct ReluFunctor : public BaseActivationFunctor<T> {
-  template <typename Device, typename X, typename Out>
-  void operator()(Device d, X x, Out out) const {
-    out.device(d) = x.cwiseMax(static_cast<T>(0));
+class ReluCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::ActivationParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<operators::ActivationParam>();
+    Activate<jit::VReluTuple<T>>(param.X, param.Out);
   }
+
+  virtual ~ReluCompute() = default;
 };
 
+// sigmoid(x) = 1 / (1 + exp(-x)), x is clipped to [-40, 13] as in the
+// reference kernel.
 template <typename T>
-class ReluCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+class SigmoidCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::ActivationParam;
 
   void Run() override {
     auto& param = *param_.get_mutable<operators::ActivationParam>();
+    Activate<jit::VSigmoidTuple<T>>(param.X, param.Out);
+  }
 
-    param.Out->template mutable_data<T>();
-    Activate<ReluFunctor<T>>(param.X, param.Out);
+  virtual ~SigmoidCompute() = default;
+};
+
+// tanh(x) = 2 * sigmoid(2x) - 1
+template <typename T>
+class TanhCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::ActivationParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<operators::ActivationParam>();
+    Activate<jit::VTanhTuple<T>>(param.X, param.Out);
   }
 
-  virtual ~ReluCompute() = default;
+  virtual ~TanhCompute() = default;
 };
 
 }  // namespace x86
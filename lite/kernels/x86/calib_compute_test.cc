@@ -0,0 +1,67 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/kernels/x86/calib_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(calib_x86, retrive_op) {
+  auto calib =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kInt8)>("calib");
+  ASSERT_EQ(calib.size(), 2UL);
+}
+
+TEST(calib_x86, run_test) {
+  lite::Tensor x, q, y;
+  x.Resize({2, 50});
+  q.Resize(x.dims());
+  y.Resize(x.dims());
+  auto* x_data = x.mutable_data<float>();
+  for (int i = 0; i < x.numel(); i++) x_data[i] = (i - 50) * 0.07f;
+
+  operators::CalibParam param;
+  param.scale = 0.025f;
+  param.input = &x;
+  param.output = &q;
+  CalibComputeFp32ToInt8 quantize;
+  quantize.SetParam(param);
+  quantize.Run();
+
+  param.input = &q;
+  param.output = &y;
+  CalibComputeInt8ToFp32 dequantize;
+  dequantize.SetParam(param);
+  dequantize.Run();
+
+  for (int i = 0; i < x.numel(); i++) {
+    float ref = std::round(x_data[i] / 0.025f);
+    ref = std::fmin(127.f, std::fmax(-127.f, ref));
+    EXPECT_EQ(q.data<int8_t>()[i], static_cast<int8_t>(ref));
+    EXPECT_NEAR(y.data<float>()[i], ref * 0.025f, 1e-6);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(calib, kX86, kInt8, kNCHW, fp32_to_int8);
+USE_LITE_KERNEL(calib, kX86, kInt8, kNCHW, int8_to_fp32);
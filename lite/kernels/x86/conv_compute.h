@@ -13,18 +13,20 @@
 // limitations under the License.
 #pragma once
 
-#include <Eigen/Core>
+#include <algorithm>
 #include <string>
+#include <type_traits>
 #include <vector>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/conv_impl.h"
+#include "lite/backends/x86/math/gemm_s8.h"
+#include "lite/backends/x86/math/im2col.h"
+#include "lite/backends/x86/math/vol2col.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
+#include "lite/core/workspace.h"
 #include "lite/operators/conv_op.h"
-#include "paddle/fluid/framework/eigen.h"
-#include "paddle/fluid/operators/math/blas.h"
-#include "paddle/fluid/operators/math/depthwise_conv.h"
-#include "paddle/fluid/operators/math/im2col.h"
-#include "paddle/fluid/operators/math/vol2col.h"
 
 namespace paddle {
 namespace lite {
@@ -45,19 +47,169 @@ inline bool IsExpand(const std::vector<int64_t>& filter_dim,
   return !(filter_1 && strides_1 && padding_0 && dilation_1);
 }
 
+// The conv is computed by one of the implementations:
+// - "depthwise": the direct depthwise conv,
+// - "winograd": the winograd F(2x2, 3x3) conv for 3x3s1,
+// - "gemm_like": im2col + GEMM, the 1x1s1 conv without padding runs the GEMM
+//   on the input directly.
+// The implementation is picked by the shapes, or by `set_impl_name`.
 template <typename T>
 class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::ConvParam;
+
+  std::vector<std::string> ImplCandidates() const override {
+    auto& param = this->Param<param_t>();
+    auto w_dims = param.filter->dims();
+    if (w_dims.size() != 4) return {"gemm_like"};
+    int ic = w_dims[1] * param.groups;
+    int oc = w_dims[0];
+    int kh = w_dims[2];
+    int kw = w_dims[3];
+    bool no_dilation = param.dilations[0] == 1 && param.dilations[1] == 1;
+    if (param.groups == ic && ic == oc && no_dilation) {
+      return {"depthwise", "gemm_like"};
+    }
+    if (param.groups == 1 && kh == 3 && kw == 3 && param.strides[0] == 1 &&
+        param.strides[1] == 1 && no_dilation) {
+      // The transforms cost more than the GEMMs save for few channels.
+      if (ic >= 16 && oc >= 16) return {"winograd", "gemm_like"};
+      return {"gemm_like", "winograd"};
+    }
+    return {"gemm_like"};
+  }
+
+  // Only the winograd conv packs the weights, the weights of the others are
+  // the filter itself.
+  bool PackWeights(std::string* arg,
+                   std::string* layout,
+                   Tensor* packed) override {
+    if (PickImpl() != "winograd") return false;
+    *arg = "Filter";
+    *layout = kWinogradWeightsLayout;
+    auto* loaded = this->packed_weights(*layout);
+    if (loaded) {
+      packed->ShareDataWith(*loaded);
+    } else {
+      TransformWinogradWeights(packed);
+    }
+    return true;
+  }
+
+  void PrepareForRun() override {
+    impl_ = PickImpl();
+    VLOG(3) << "invoking " << impl_ << " conv";
+    if (impl_ == "winograd") {
+      auto* loaded = this->packed_weights(kWinogradWeightsLayout);
+      if (loaded) {
+        winograd_weights_.ShareDataWith(*loaded);
+      } else {
+        TransformWinogradWeights(&winograd_weights_);
+      }
+    } else {
+      winograd_weights_ = lite::Tensor();
+    }
+  }
+
   void Run() override {
     auto& param = *param_.get_mutable<operators::ConvParam>();
-    lite::Tensor filter = *param.filter;
+    auto x_dims = param.x->dims();
+    auto o_dims = param.output->dims();
     param.output->template mutable_data<T>();
+    const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+    if (impl_ == "depthwise") {
+      lite::x86::math::conv_depthwise_fp32(param.x->data<float>(),
+                                           param.output->mutable_data<float>(),
+                                           x_dims[0],
+                                           x_dims[1],
+                                           o_dims[2],
+                                           o_dims[3],
+                                           x_dims[2],
+                                           x_dims[3],
+                                           param.filter->data<float>(),
+                                           bias,
+                                           param,
+                                           ctx_->As<X86Context>());
+      bias = nullptr;
+    } else if (impl_ == "winograd") {
+      auto& ctx = ctx_->As<X86Context>();
+      int size = lite::x86::math::winograd3x3_workspace_size(
+          o_dims[1], x_dims[1], o_dims[2], o_dims[3]);
+      auto* workspace = reinterpret_cast<float*>(
+          WorkSpace::Global_X86().Alloc(size * sizeof(float)));
+      lite::x86::math::conv_winograd3x3_fp32(
+          param.x->data<float>(),
+          param.output->mutable_data<float>(),
+          x_dims[0],
+          o_dims[1],
+          o_dims[2],
+          o_dims[3],
+          x_dims[1],
+          x_dims[2],
+          x_dims[3],
+          winograd_weights_.data<float>(),
+          bias,
+          param,
+          workspace,
+          ctx);
+      bias = nullptr;
+    } else {
+      RunGemmLike();
+    }
+    lite::x86::math::conv_fill_bias_act(param.output->mutable_data<float>(),
+                                        o_dims[0],
+                                        o_dims[1],
+                                        o_dims.production() /
+                                            (o_dims[0] * o_dims[1]),
+                                        bias,
+                                        param.activation_param);
+  }
 
+  virtual ~Conv2dCompute() = default;
+
+ private:
+  static constexpr const char* kWinogradWeightsLayout = "x86_winograd_f2x2_v1";
+
+  // The implementation asked by `set_impl_name` if it is applicable, or the
+  // one picked by the shapes.
+  std::string PickImpl() const {
+    // The weights loaded packed are only taken by the winograd conv.
+    if (this->packed_weights_layout() == kWinogradWeightsLayout) {
+      return "winograd";
+    }
+    auto candidates = ImplCandidates();
+    if (impl_name().empty()) return candidates.front();
+    if (std::find(candidates.begin(), candidates.end(), impl_name()) ==
+        candidates.end()) {
+      LOG(WARNING) << "conv impl " << impl_name() << " is not applicable, use "
+                   << candidates.front();
+      return candidates.front();
+    }
+    return impl_name();
+  }
+
+  void TransformWinogradWeights(lite::Tensor* weights) {
+    auto& param = this->Param<param_t>();
+    CHECK(param.filter->IsInitialized())
+        << "The filter was released for the weights packed as "
+        << this->packed_weights_layout()
+        << ", which the winograd conv does not take";
+    int oc = param.filter->dims()[0];
+    int ic = param.filter->dims()[1];
+    weights->Resize({lite::x86::math::winograd3x3_weights_size(oc, ic)});
+    lite::x86::math::winograd3x3_transform_weights(
+        weights->mutable_data<float>(), param.filter->data<float>(), oc, ic);
+  }
+
+  void RunGemmLike() {
+    auto& ctx = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::ConvParam>();
+    const lite::Tensor& filter = *param.filter;
+    auto* output = param.output;
     const int batch_size = static_cast<int>(param.x->dims()[0]);
 
     std::vector<int64_t> filter_shape_vec(filter.dims().Vectorize());
-    std::vector<int64_t> output_shape_vec(param.output->dims().Vectorize());
+    std::vector<int64_t> output_shape_vec(output->dims().Vectorize());
 
     size_t data_dim = filter_shape_vec.size() - 2;
     std::vector<int64_t> col_shape_vec(1 + 2 * data_dim);
@@ -67,98 +219,265 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       col_shape_vec[j + 1 + data_dim] = output_shape_vec[j + 2];
     }
     lite::DDim col_shape(col_shape_vec);
-    lite::DDim col_matrix_shape = col_shape.Flatten2D(data_dim + 1);
     bool is_expand = IsExpand(
         filter_shape_vec, param.strides, param.paddings, param.dilations);
 
-    lite::Tensor col;
-    lite::Tensor col_matrix;
+    lite::DDim input_shape = param.x->dims().Slice(1, param.x->dims().size());
+    input_shape[0] /= param.groups;
+
+    int out_step = static_cast<int>(output->dims()[1]) / param.groups;
+    int in_size = input_shape.production();
+    int out_size = output->dims().production() /
+                   (output->dims()[0] * output->dims()[1]);
+    int k = filter.dims().production() / filter.dims()[0];
+    int tasks = batch_size * param.groups;
+    // Every thread computes whole images and groups if there are enough of
+    // them, otherwise the GEMM of an image is split into the tiles of the
+    // output channels.
+    bool split_channels = tasks < ctx.threads() && out_step > 1;
+    int col_buffers = split_channels ? 1 : ctx.threads();
+
+    // The col buffers are taken from the workspace shared by the kernels.
+    int64_t col_numel = col_shape.production();
+    T* col_data = nullptr;
     if (is_expand) {
-      col.Resize(col_shape);
-      col.mutable_data<T>();
-      col_matrix.ShareDataWith(col);
-      col_matrix.Resize(col_matrix_shape);
+      col_data = reinterpret_cast<T*>(
+          WorkSpace::Global_X86().Alloc(col_numel * col_buffers * sizeof(T)));
     }
-    lite::DDim input_shape = param.x->dims().Slice(1, param.x->dims().size());
 
-    lite::DDim filter_matrix_shape(std::vector<int64_t>{
-        filter.dims()[0], filter.dims().production() / filter.dims()[0]});
-    filter.Resize(filter_matrix_shape);
-
-    lite::DDim output_matrix_shape(std::vector<int64_t>{
-        param.output->dims()[1],
-        param.output->dims().production() /
-            (param.output->dims()[0] * param.output->dims()[1])});
-
-    int in_step = static_cast<int>(param.x->dims()[1]) / param.groups;
-    int out_step = static_cast<int>(param.output->dims()[1]) / param.groups;
-
-    paddle::operators::math::Vol2ColFunctor<platform::CPUDeviceContext, T>
-        vol2col;
-    paddle::operators::math::Im2ColFunctor<
-        paddle::operators::math::ColFormat::kCFO,
-        platform::CPUDeviceContext,
-        T>
-        im2col;
-    auto blas = paddle::operators::math::GetBlas<platform::CPUDeviceContext, T>(
-        platform::CPUDeviceContext());
-    for (int i = 0; i < batch_size; i++) {
-      lite::Tensor in_batch;
-      in_batch.ShareDataWith(
-          param.x->raw_tensor().Slice(i, i + 1).Resize(input_shape.data()));
-      lite::Tensor out_batch;
-      out_batch.ShareDataWith(param.output->raw_tensor().Slice(i, i + 1).Resize(
-          output_matrix_shape.data()));
-
-      for (int g = 0; g < param.groups; g++) {
-        lite::Tensor in_slice;
-        in_slice.ShareDataWith(
-            in_batch.raw_tensor().Slice(g * in_step, (g + 1) * in_step));
-
-        if (!is_expand) {
-          col.ShareDataWith(in_slice);
-          col_matrix.ShareDataWith(col);
-          col_matrix.Resize(col_matrix_shape);
-        } else if (data_dim == 2U) {
-          // im2col
-          im2col(platform::CPUDeviceContext(),
-                 in_slice.raw_tensor(),
-                 param.dilations,
-                 param.strides,
-                 std::vector<int>{param.paddings[0],
-                                  param.paddings[1],
-                                  param.paddings[0],
-                                  param.paddings[1]},
-                 &(col.raw_tensor()));
-        } else if (data_dim == 3U) {
-          // vol2col
-          vol2col(platform::CPUDeviceContext(),
-                  in_slice.raw_tensor(),
-                  param.dilations,
-                  param.strides,
-                  param.paddings,
-                  &(col.raw_tensor()));
-        }
-
-        // gemm
-        lite::Tensor out_slice;
-        out_slice.ShareDataWith(
-            out_batch.raw_tensor().Slice(g * out_step, (g + 1) * out_step));
-        lite::Tensor filter_slice;
-        filter_slice.ShareDataWith(
-            filter.raw_tensor().Slice(g * out_step, (g + 1) * out_step));
-        blas.MatMul(filter_slice.raw_tensor(),
-                    false,
-                    col_matrix.raw_tensor(),
-                    false,
-                    T(1.0),
-                    &(out_slice.raw_tensor()),
-                    T(0.0));
+    const T* in_data = param.x->data<T>();
+    const T* filter_data = filter.data<T>();
+    T* out_data = output->mutable_data<T>();
+    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(ctx);
+    // Lower the image and group `task` into the columns in `col`, and return
+    // the columns to multiply.
+    auto lower = [&](int task, T* col) -> const T* {
+      const T* in_slice = in_data + task * in_size;
+      if (!is_expand) return in_slice;
+      lite::Tensor in_tensor, col_tensor;
+      in_tensor.ShareExternalMemory(
+          const_cast<T*>(in_slice), in_size * sizeof(T), TARGET(kX86));
+      in_tensor.Resize(input_shape);
+      col_tensor.ShareExternalMemory(col, col_numel * sizeof(T), TARGET(kX86));
+      col_tensor.Resize(col_shape);
+      if (data_dim == 2U) {
+        lite::x86::math::
+            Im2ColFunctor<lite::x86::math::ColFormat::kCFO, TARGET(kX86), T>
+                im2col;
+        im2col(ctx,
+               in_tensor,
+               param.dilations,
+               param.strides,
+               std::vector<int>{param.paddings[0],
+                                param.paddings[1],
+                                param.paddings[0],
+                                param.paddings[1]},
+               &col_tensor);
+      } else if (data_dim == 3U) {
+        lite::x86::math::Vol2ColFunctor<lite::TargetType::kX86, T> vol2col;
+        vol2col(ctx,
+                in_tensor,
+                param.dilations,
+                param.strides,
+                param.paddings,
+                &col_tensor);
       }
+      return col;
+    };
+    // Multiply the rows [oc_begin, oc_end) of the filter of the group.
+    auto gemm = [&](int task, const T* cols, int oc_begin, int oc_end) {
+      int g = task % param.groups;
+      blas.GEMM(CblasNoTrans,
+                CblasNoTrans,
+                oc_end - oc_begin,
+                out_size,
+                k,
+                T(1.0),
+                filter_data + (g * out_step + oc_begin) * k,
+                cols,
+                T(0.0),
+                out_data + (task * out_step + oc_begin) * out_size);
+    };
+
+    if (!split_channels) {
+      ctx.ParallelFor(tasks, [&](int task, int tid) {
+        T* col = is_expand ? col_data + tid * col_numel : nullptr;
+        gemm(task, lower(task, col), 0, out_step);
+      });
+      return;
+    }
+    int tiles = std::min(ctx.threads(), out_step);
+    for (int task = 0; task < tasks; task++) {
+      const T* cols = lower(task, col_data);
+      ctx.ParallelFor(tiles, [&](int tile, int tid) {
+        gemm(task,
+             cols,
+             out_step * tile / tiles,
+             out_step * (tile + 1) / tiles);
+      });
     }
   }
 
-  virtual ~Conv2dCompute() = default;
+  std::string impl_;
+  lite::Tensor winograd_weights_;
+};
+
+template <typename T>
+constexpr const char* Conv2dCompute<T>::kWinogradWeightsLayout;
+
+// The int8 conv of the quantized models, im2col + gemm_s8. The int32 results
+// are requantized to OutT, float or int8_t, with the bias and the relu or
+// leaky relu fused, by the scales of the output channels, i.e. the filter is
+// quantized per output channel if weight_scale has a scale for each of them.
+template <typename OutT>
+class Conv2dInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::ConvParam;
+
+  void PrepareForRun() override {
+    auto& param = this->Param<param_t>();
+    CHECK_EQ(param.filter->dims().size(), 4UL)
+        << "only the 2-D int8 conv is supported";
+    int oc = param.filter->dims()[0];
+    auto& w_scale = param.weight_scale;
+    CHECK(w_scale.size() == 1 || static_cast<int>(w_scale.size()) == oc)
+        << "the size of weight_scale " << w_scale.size()
+        << " is neither 1 nor the output channels " << oc;
+    // The int8 results are quantized by output_scale.
+    float out_scale =
+        std::is_same<OutT, int8_t>::value ? param.output_scale : 1.f;
+    const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+    scale_.resize(oc);
+    bias_.resize(bias ? oc : 0);
+    for (int c = 0; c < oc; c++) {
+      float ws = w_scale.size() == 1 ? w_scale[0] : w_scale[c];
+      scale_[c] = ws * param.input_scale / out_scale;
+      if (bias) bias_[c] = bias[c] / out_scale;
+    }
+
+    requant_ = lite::x86::math::GemmS8Requant();
+    auto& act = param.activation_param;
+    if (act.has_active) {
+      CHECK(act.active_type == lite_api::ActivationType::kRelu ||
+            act.active_type == lite_api::ActivationType::kLeakyRelu)
+          << "unsupported fused activation of int8 conv: "
+          << static_cast<int>(act.active_type);
+      requant_.has_act = true;
+      requant_.act_alpha =
+          act.active_type == lite_api::ActivationType::kLeakyRelu
+              ? act.Leaky_relu_alpha
+              : 0.f;
+    }
+  }
+
+  void Run() override {
+    auto& ctx = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::ConvParam>();
+    auto x_dims = param.x->dims();
+    auto w_dims = param.filter->dims();
+    auto o_dims = param.output->dims();
+    int groups = param.groups;
+    int out_step = o_dims[1] / groups;
+    int out_size = o_dims[2] * o_dims[3];
+    int k = w_dims.production() / w_dims[0];
+    int in_size = x_dims.production() / (x_dims[0] * groups);
+    int tasks = x_dims[0] * groups;
+
+    std::vector<int64_t> filter_shape_vec(w_dims.Vectorize());
+    lite::DDim col_shape(std::vector<int64_t>{
+        x_dims[1] / groups, w_dims[2], w_dims[3], o_dims[2], o_dims[3]});
+    lite::DDim input_shape(
+        std::vector<int64_t>{x_dims[1] / groups, x_dims[2], x_dims[3]});
+    bool is_expand = IsExpand(
+        filter_shape_vec, param.strides, param.paddings, param.dilations);
+    // As the float conv, the GEMM of an image is split into the tiles of the
+    // output channels if there are not enough images and groups.
+    bool split_channels = tasks < ctx.threads() && out_step > 1;
+    int buffers = split_channels ? 1 : ctx.threads();
+
+    // Every buffer holds the columns, and the columns packed for gemm_s8.
+    int64_t col_numel = is_expand ? col_shape.production() : 0;
+    int64_t buffer_size =
+        col_numel + lite::x86::math::gemm_s8_packed_b_size(k, out_size);
+    auto* buffer_data = reinterpret_cast<int8_t*>(
+        WorkSpace::Global_X86().Alloc(buffer_size * buffers));
+
+    const int8_t* in_data = param.x->data<int8_t>();
+    const int8_t* filter_data = param.filter->data<int8_t>();
+    OutT* out_data = param.output->template mutable_data<OutT>();
+    // Lower the image and group `task` into the packed columns in `buffer`.
+    auto lower = [&](int task, int8_t* buffer) -> const int8_t* {
+      const int8_t* cols = in_data + static_cast<int64_t>(task) * in_size;
+      if (is_expand) {
+        lite::Tensor in_tensor, col_tensor;
+        in_tensor.ShareExternalMemory(
+            const_cast<int8_t*>(cols), in_size, TARGET(kX86));
+        in_tensor.Resize(input_shape);
+        col_tensor.ShareExternalMemory(buffer, col_numel, TARGET(kX86));
+        col_tensor.Resize(col_shape);
+        lite::x86::math::Im2ColFunctor<lite::x86::math::ColFormat::kCFO,
+                                       TARGET(kX86),
+                                       int8_t>
+            im2col;
+        im2col(ctx,
+               in_tensor,
+               param.dilations,
+               param.strides,
+               std::vector<int>{param.paddings[0],
+                                param.paddings[1],
+                                param.paddings[0],
+                                param.paddings[1]},
+               &col_tensor);
+        cols = buffer;
+      }
+      int8_t* packed = buffer + col_numel;
+      lite::x86::math::gemm_s8_pack_b(cols, k, out_size, out_size, packed);
+      return packed;
+    };
+    // Multiply the rows [oc_begin, oc_end) of the filter of the group.
+    auto gemm = [&](int task, const int8_t* packed, int oc_begin, int oc_end) {
+      int oc = task % groups * out_step + oc_begin;
+      auto requant = requant_;
+      requant.scale = scale_.data() + oc;
+      requant.bias = bias_.empty() ? nullptr : bias_.data() + oc;
+      lite::x86::math::gemm_s8<OutT>(
+          oc_end - oc_begin,
+          out_size,
+          k,
+          filter_data + static_cast<int64_t>(oc) * k,
+          k,
+          packed,
+          out_data +
+              (static_cast<int64_t>(task) * out_step + oc_begin) * out_size,
+          out_size,
+          requant);
+    };
+
+    if (!split_channels) {
+      ctx.ParallelFor(tasks, [&](int task, int tid) {
+        gemm(task, lower(task, buffer_data + tid * buffer_size), 0, out_step);
+      });
+      return;
+    }
+    int tiles = std::min(ctx.threads(), out_step);
+    for (int task = 0; task < tasks; task++) {
+      const int8_t* packed = lower(task, buffer_data);
+      ctx.ParallelFor(tiles, [&](int tile, int tid) {
+        gemm(task,
+             packed,
+             out_step * tile / tiles,
+             out_step * (tile + 1) / tiles);
+      });
+    }
+  }
+
+  virtual ~Conv2dInt8Compute() = default;
+
+ private:
+  // The requantization scales and bias of the output channels.
+  std::vector<float> scale_;
+  std::vector<float> bias_;
+  lite::x86::math::GemmS8Requant requant_;
 };
 
 }  // namespace x86
@@ -14,6 +14,9 @@
 
 #include "lite/kernels/x86/conv_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <vector>
 #include "lite/core/op_registry.h"
 
@@ -43,7 +46,7 @@ TEST(conv2d_x86, run_test) {
   x.Resize(lite::DDim(x_shape));
   std::vector<int64_t> filter_shape{1, 3, 3, 3};
   filter.Resize(lite::DDim(filter_shape));
-  std::vector<int64_t> b_shape{1, 3, 1, 1};
+  std::vector<int64_t> b_shape{1};
   b.Resize(lite::DDim(b_shape));
   std::vector<int64_t> out_shape{batch_size, 1, 1, 1};
   out.Resize(lite::DDim(out_shape));
@@ -75,12 +78,268 @@ TEST(conv2d_x86, run_test) {
   param.groups = 1;
   param.dilations = {1, 1};
 
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv2d.SetContext(std::move(ctx));
   conv2d.SetParam(param);
-  conv2d.Run();
+  conv2d.Launch();
 
-  LOG(INFO) << "output: ";
   for (int i = 0; i < out.dims().production(); i++) {
-    LOG(INFO) << out_data[i] << " ";
+    EXPECT_NEAR(out_data[i], 27.f, 1e-5);
+  }
+}
+
+// The reference conv without dilation.
+static void conv_basic(const lite::Tensor& x,
+                       const lite::Tensor& filter,
+                       const lite::Tensor& bias,
+                       const operators::ConvParam& param,
+                       lite::Tensor* out) {
+  auto x_dims = x.dims();
+  auto w_dims = filter.dims();
+  auto o_dims = out->dims();
+  int group = param.groups;
+  int ic_step = x_dims[1] / group;
+  int oc_step = o_dims[1] / group;
+  auto* out_data = out->mutable_data<float>();
+  for (int n = 0; n < o_dims[0]; ++n) {
+    for (int oc = 0; oc < o_dims[1]; ++oc) {
+      int g = oc / oc_step;
+      for (int oh = 0; oh < o_dims[2]; ++oh) {
+        for (int ow = 0; ow < o_dims[3]; ++ow) {
+          float sum = bias.data<float>()[oc];
+          for (int ic = 0; ic < ic_step; ++ic) {
+            for (int i = 0; i < w_dims[2]; ++i) {
+              for (int j = 0; j < w_dims[3]; ++j) {
+                int ih = oh * param.strides[0] - param.paddings[0] + i;
+                int iw = ow * param.strides[1] - param.paddings[1] + j;
+                if (ih < 0 || ih >= x_dims[2] || iw < 0 || iw >= x_dims[3]) {
+                  continue;
+                }
+                int x_idx =
+                    ((n * x_dims[1] + g * ic_step + ic) * x_dims[2] + ih) *
+                        x_dims[3] +
+                    iw;
+                int w_idx = ((oc * ic_step + ic) * w_dims[2] + i) * w_dims[3] +
+                            j;
+                sum += x.data<float>()[x_idx] * filter.data<float>()[w_idx];
+              }
+            }
+          }
+          out_data[((n * o_dims[1] + oc) * o_dims[2] + oh) * o_dims[3] + ow] =
+              sum > 0.f ? sum : 0.f;
+        }
+      }
+    }
+  }
+}
+
+TEST(conv2d_x86, impls) {
+  // {batch, ic, h, w, oc, groups, kernel, stride, pad}
+  std::vector<std::vector<int>> cases{{1, 32, 13, 11, 32, 1, 3, 1, 1},
+                                      {2, 4, 9, 10, 6, 1, 3, 1, 0},
+                                      {1, 8, 20, 19, 8, 8, 3, 1, 1},
+                                      {2, 8, 20, 19, 8, 8, 3, 2, 1},
+                                      {1, 4, 17, 23, 4, 4, 5, 1, 2},
+                                      {1, 16, 7, 7, 8, 1, 1, 1, 0},
+                                      {1, 8, 9, 9, 8, 2, 3, 2, 1},
+                                      {4, 6, 8, 8, 6, 1, 3, 1, 1}};
+  for (auto& c : cases) {
+    int n = c[0], ic = c[1], h = c[2], w = c[3], oc = c[4], groups = c[5];
+    int k = c[6], stride = c[7], pad = c[8];
+    int oh = (h + 2 * pad - k) / stride + 1;
+    int ow = (w + 2 * pad - k) / stride + 1;
+    lite::Tensor x, filter, bias, out, out_ref;
+    x.Resize({n, ic, h, w});
+    filter.Resize({oc, ic / groups, k, k});
+    bias.Resize({oc});
+    out.Resize({n, oc, oh, ow});
+    out_ref.Resize({n, oc, oh, ow});
+    auto* x_data = x.mutable_data<float>();
+    auto* filter_data = filter.mutable_data<float>();
+    auto* bias_data = bias.mutable_data<float>();
+    for (int i = 0; i < x.numel(); i++) x_data[i] = (i % 17) * 0.1f - 0.8f;
+    for (int i = 0; i < filter.numel(); i++) {
+      filter_data[i] = (i % 13) * 0.05f - 0.3f;
+    }
+    for (int i = 0; i < oc; i++) bias_data[i] = i * 0.01f;
+
+    operators::ConvParam param;
+    param.x = &x;
+    param.filter = &filter;
+    param.bias = &bias;
+    param.output = &out;
+    param.strides = {stride, stride};
+    param.paddings = {pad, pad};
+    param.groups = groups;
+    param.dilations = {1, 1};
+    param.activation_param.has_active = true;
+    param.activation_param.active_type = lite_api::ActivationType::kRelu;
+    conv_basic(x, filter, bias, param, &out_ref);
+
+    for (int threads : {1, 4}) {
+      Conv2dCompute<float> conv2d;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>().SetThreadPool(
+          std::make_shared<ThreadPool>(threads));
+      conv2d.SetContext(std::move(ctx));
+      conv2d.SetParam(param);
+      for (auto& impl : conv2d.ImplCandidates()) {
+        conv2d.set_impl_name(impl);
+        conv2d.Launch();
+        for (int i = 0; i < out.numel(); i++) {
+          ASSERT_NEAR(out.data<float>()[i], out_ref.data<float>()[i], 1e-4)
+              << impl << " case " << &c - &cases[0] << " threads " << threads
+              << " at " << i;
+        }
+      }
+    }
+  }
+}
+
+TEST(conv2d_x86, packed_weights) {
+  int n = 1, ic = 16, h = 10, w = 9, oc = 24;
+  lite::Tensor x, filter, out, out_ref;
+  x.Resize({n, ic, h, w});
+  filter.Resize({oc, ic, 3, 3});
+  out.Resize({n, oc, h, w});
+  out_ref.Resize({n, oc, h, w});
+  auto* x_data = x.mutable_data<float>();
+  auto* filter_data = filter.mutable_data<float>();
+  for (int i = 0; i < x.numel(); i++) x_data[i] = (i % 17) * 0.1f - 0.8f;
+  for (int i = 0; i < filter.numel(); i++) {
+    filter_data[i] = (i % 13) * 0.05f - 0.3f;
+  }
+
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.output = &out_ref;
+  param.strides = {1, 1};
+  param.paddings = {1, 1};
+  param.groups = 1;
+  param.dilations = {1, 1};
+
+  Conv2dCompute<float> conv2d;
+  conv2d.SetContext(std::unique_ptr<KernelContext>(new KernelContext));
+  conv2d.SetParam(param);
+  conv2d.set_impl_name("winograd");
+  conv2d.Launch();
+  std::string arg, layout;
+  lite::Tensor packed;
+  ASSERT_TRUE(conv2d.PackWeights(&arg, &layout, &packed));
+  EXPECT_EQ(arg, "Filter");
+
+  // The filter released, only the dims are kept.
+  lite::Tensor released;
+  released.Resize(filter.dims());
+  param.filter = &released;
+  param.output = &out;
+  Conv2dCompute<float> loaded;
+  loaded.SetContext(std::unique_ptr<KernelContext>(new KernelContext));
+  loaded.SetParam(param);
+  loaded.SetPackedWeights(layout, &packed);
+  loaded.Launch();
+  for (int i = 0; i < out.numel(); i++) {
+    ASSERT_NEAR(out.data<float>()[i], out_ref.data<float>()[i], 1e-5);
+  }
+
+  // The gemm-like conv reads the filter.
+  param.filter = &filter;
+  conv2d.SetParam(param);
+  conv2d.set_impl_name("gemm_like");
+  EXPECT_FALSE(conv2d.PackWeights(&arg, &layout, &packed));
+}
+
+// The int8 conv by the scales of the output channels, compared with the
+// reference conv of the dequantized input and filter.
+TEST(conv2d_x86, int8) {
+  // {batch, ic, h, w, oc, groups, kernel, stride, pad}
+  std::vector<std::vector<int>> cases{{1, 32, 13, 11, 32, 1, 3, 1, 1},
+                                      {2, 4, 9, 10, 6, 1, 3, 1, 0},
+                                      {2, 8, 20, 19, 8, 8, 3, 2, 1},
+                                      {1, 16, 7, 7, 20, 1, 1, 1, 0},
+                                      {1, 8, 9, 9, 8, 2, 3, 2, 1}};
+  for (auto& c : cases) {
+    int n = c[0], ic = c[1], h = c[2], w = c[3], oc = c[4], groups = c[5];
+    int k = c[6], stride = c[7], pad = c[8];
+    int oh = (h + 2 * pad - k) / stride + 1;
+    int ow = (w + 2 * pad - k) / stride + 1;
+    lite::Tensor x, filter, x_fp32, filter_fp32, bias, out_ref;
+    lite::Tensor out_fp32, out_int8;
+    x.Resize({n, ic, h, w});
+    filter.Resize({oc, ic / groups, k, k});
+    x_fp32.Resize(x.dims());
+    filter_fp32.Resize(filter.dims());
+    bias.Resize({oc});
+    out_ref.Resize({n, oc, oh, ow});
+    out_fp32.Resize(out_ref.dims());
+    out_int8.Resize(out_ref.dims());
+    float input_scale = 0.01f;
+    std::vector<float> weight_scale(oc);
+    for (int i = 0; i < oc; i++) {
+      weight_scale[i] = 0.002f * (i % 5 + 1);
+      bias.mutable_data<float>()[i] = i * 0.05f - 0.2f;
+    }
+    for (int i = 0; i < x.numel(); i++) {
+      x.mutable_data<int8_t>()[i] = (i * 7) % 255 - 127;
+      x_fp32.mutable_data<float>()[i] = x.data<int8_t>()[i] * input_scale;
+    }
+    int filter_size = filter.numel() / oc;
+    for (int i = 0; i < filter.numel(); i++) {
+      filter.mutable_data<int8_t>()[i] = (i * 13) % 255 - 127;
+      filter_fp32.mutable_data<float>()[i] =
+          filter.data<int8_t>()[i] * weight_scale[i / filter_size];
+    }
+
+    operators::ConvParam param;
+    param.x = &x_fp32;
+    param.filter = &filter_fp32;
+    param.bias = &bias;
+    param.strides = {stride, stride};
+    param.paddings = {pad, pad};
+    param.groups = groups;
+    param.dilations = {1, 1};
+    param.activation_param.has_active = true;
+    param.activation_param.active_type = lite_api::ActivationType::kRelu;
+    conv_basic(x_fp32, filter_fp32, bias, param, &out_ref);
+
+    param.x = &x;
+    param.filter = &filter;
+    param.enable_int8 = true;
+    param.input_scale = input_scale;
+    param.weight_scale = weight_scale;
+    param.output_scale = 0.05f;
+    for (int threads : {1, 4}) {
+      Conv2dInt8Compute<float> conv_fp32;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>().SetThreadPool(
+          std::make_shared<ThreadPool>(threads));
+      param.output = &out_fp32;
+      conv_fp32.SetContext(std::move(ctx));
+      conv_fp32.SetParam(param);
+      conv_fp32.Launch();
+
+      Conv2dInt8Compute<int8_t> conv_int8;
+      ctx.reset(new KernelContext);
+      ctx->As<X86Context>().SetThreadPool(
+          std::make_shared<ThreadPool>(threads));
+      param.output = &out_int8;
+      conv_int8.SetContext(std::move(ctx));
+      conv_int8.SetParam(param);
+      conv_int8.Launch();
+
+      for (int i = 0; i < out_ref.numel(); i++) {
+        float ref = out_ref.data<float>()[i];
+        ASSERT_NEAR(out_fp32.data<float>()[i], ref, 1e-3)
+            << "case " << &c - &cases[0] << " threads " << threads << " at "
+            << i;
+        float q = std::min(127.f, std::round(ref / param.output_scale));
+        ASSERT_NEAR(out_int8.data<int8_t>()[i], q, 1)
+            << "case " << &c - &cases[0] << " threads " << threads << " at "
+            << i;
+      }
+    }
   }
 }
 
@@ -90,3 +349,5 @@ TEST(conv2d_x86, run_test) {
 }  // namespace paddle
 
 USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, fp32_out);
@@ -35,3 +35,111 @@ REGISTER_LITE_KERNEL(elementwise_add,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_mul,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::ElementwiseMulCompute<float>,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_div,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::ElementwiseDivCompute<float>,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_max,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::ElementwiseMaxCompute<float>,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+using FusionElementwiseSubActivationX86 =
+    paddle::lite::kernels::x86::FusionElementwiseActivationCompute<
+        float,
+        paddle::lite::x86::math::ElementwiseType::kSub>;
+REGISTER_LITE_KERNEL(fusion_elementwise_sub_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     FusionElementwiseSubActivationX86,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+using FusionElementwiseAddActivationX86 =
+    paddle::lite::kernels::x86::FusionElementwiseActivationCompute<
+        float,
+        paddle::lite::x86::math::ElementwiseType::kAdd>;
+REGISTER_LITE_KERNEL(fusion_elementwise_add_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     FusionElementwiseAddActivationX86,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+using FusionElementwiseMulActivationX86 =
+    paddle::lite::kernels::x86::FusionElementwiseActivationCompute<
+        float,
+        paddle::lite::x86::math::ElementwiseType::kMul>;
+REGISTER_LITE_KERNEL(fusion_elementwise_mul_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     FusionElementwiseMulActivationX86,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+using FusionElementwiseDivActivationX86 =
+    paddle::lite::kernels::x86::FusionElementwiseActivationCompute<
+        float,
+        paddle::lite::x86::math::ElementwiseType::kDiv>;
+REGISTER_LITE_KERNEL(fusion_elementwise_div_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     FusionElementwiseDivActivationX86,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+using FusionElementwiseMaxActivationX86 =
+    paddle::lite::kernels::x86::FusionElementwiseActivationCompute<
+        float,
+        paddle::lite::x86::math::ElementwiseType::kMax>;
+REGISTER_LITE_KERNEL(fusion_elementwise_max_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     FusionElementwiseMaxActivationX86,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
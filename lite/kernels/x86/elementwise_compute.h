@@ -13,62 +13,80 @@
 // limitations under the License.
 #pragma once
 
+#include <string>
+#include "lite/backends/x86/math/elementwise.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
-#include "lite/fluid/eigen.h"
-#include "lite/kernels/x86/elementwise_op_function.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace x86 {
 
-template <typename T>
-struct SubFunctor {
-  inline HOSTDEVICE T operator()(T a, T b) const { return a - b; }
-};
-
-template <typename T>
-struct AddFunctor {
-  inline HOSTDEVICE T operator()(T a, T b) const { return a + b; }
-};
-
-template <typename T>
-class ElementwiseSubCompute
-    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+template <typename T, lite::x86::math::ElementwiseType type>
+class ElementwiseCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::ElementwiseParam;
 
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
     auto& context = ctx_->As<X86Context>();
-
-    param.Out->template mutable_data<T>();
-    paddle::lite::kernels::x86::ElementwiseComputeEx<SubFunctor<T>,
-                                                     lite::TargetType::kX86,
-                                                     T>(
-        context, param.X, param.Y, param.axis, SubFunctor<T>(), param.Out);
+    lite::x86::math::Elementwise<T>(context,
+                                    type,
+                                    lite::x86::math::ElementwiseActType::kNone,
+                                    *param.X,
+                                    *param.Y,
+                                    param.axis,
+                                    param.Out);
   }
 
-  virtual ~ElementwiseSubCompute() = default;
+  virtual ~ElementwiseCompute() = default;
 };
 
 template <typename T>
-class ElementwiseAddCompute
+using ElementwiseAddCompute =
+    ElementwiseCompute<T, lite::x86::math::ElementwiseType::kAdd>;
+template <typename T>
+using ElementwiseSubCompute =
+    ElementwiseCompute<T, lite::x86::math::ElementwiseType::kSub>;
+template <typename T>
+using ElementwiseMulCompute =
+    ElementwiseCompute<T, lite::x86::math::ElementwiseType::kMul>;
+template <typename T>
+using ElementwiseDivCompute =
+    ElementwiseCompute<T, lite::x86::math::ElementwiseType::kDiv>;
+template <typename T>
+using ElementwiseMaxCompute =
+    ElementwiseCompute<T, lite::x86::math::ElementwiseType::kMax>;
+
+// The elementwise op followed by the activation in one pass over the data.
+template <typename T, lite::x86::math::ElementwiseType type>
+class FusionElementwiseActivationCompute
     : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
-  using param_t = operators::ElementwiseParam;
+  using param_t = operators::FusionElementwiseActivationParam;
+
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<param_t>();
+    if (param.act_type == "relu") {
+      act_ = lite::x86::math::ElementwiseActType::kRelu;
+    } else {
+      LOG(FATAL) << "unsupported Activation type: " << param.act_type;
+    }
+  }
+
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
     auto& context = ctx_->As<X86Context>();
-    param.Out->template mutable_data<T>();
-    paddle::lite::kernels::x86::ElementwiseComputeEx<AddFunctor<T>,
-                                                     lite::TargetType::kX86,
-                                                     T>(
-        context, param.X, param.Y, param.axis, AddFunctor<T>(), param.Out);
+    lite::x86::math::Elementwise<T>(
+        context, type, act_, *param.X, *param.Y, param.axis, param.Out);
   }
 
-  virtual ~ElementwiseAddCompute() = default;
+  virtual ~FusionElementwiseActivationCompute() = default;
+
+ private:
+  lite::x86::math::ElementwiseActType act_{
+      lite::x86::math::ElementwiseActType::kNone};
 };
 
 }  // namespace x86
@@ -14,11 +14,14 @@
 
 #include "lite/kernels/x86/elementwise_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <utility>
 #include <vector>
 #include "lite/core/op_registry.h"
+#include "lite/operators/elementwise_ops.h"
 
 namespace paddle {
 namespace lite {
@@ -80,6 +83,169 @@ TEST(elementwise_add_x86, run_test) {
   }
 }
 
+TEST(elementwise_add_x86, broadcast_threads) {
+  // {x dims, y dims, axis}, the outputs are large enough to be split.
+  std::vector<std::vector<int64_t>> x_shapes{
+      {4, 64, 32, 32}, {4, 64, 32, 32}, {4, 64, 32, 32}, {4, 64, 32, 32}};
+  std::vector<std::vector<int64_t>> y_shapes{
+      {4, 64, 32, 32}, {64}, {32, 32}, {4, 64, 1, 1}};
+  std::vector<int> axes{-1, 1, 2, 0};
+  for (size_t c = 0; c < x_shapes.size(); c++) {
+    lite::Tensor x, y, out;
+    x.Resize(lite::DDim(x_shapes[c]));
+    y.Resize(lite::DDim(y_shapes[c]));
+    out.Resize(lite::DDim(x_shapes[c]));
+    auto* x_data = x.mutable_data<float>();
+    auto* y_data = y.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) x_data[i] = i % 7;
+    for (int64_t i = 0; i < y.numel(); i++) y_data[i] = i;
+
+    ElementwiseAddCompute<float> elementwise_add;
+    operators::ElementwiseParam param;
+    param.X = &x;
+    param.Y = &y;
+    param.Out = &out;
+    param.axis = axes[c];
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>().SetThreadPool(std::make_shared<ThreadPool>(4));
+    elementwise_add.SetParam(param);
+    elementwise_add.SetContext(std::move(ctx));
+    elementwise_add.Run();
+
+    // The index of y is the index of x in the dims of y.
+    int axis = axes[c] == -1 ? 0 : axes[c];
+    auto& x_dims = x_shapes[c];
+    auto& y_dims = y_shapes[c];
+    for (int64_t i = 0; i < x.numel(); i++) {
+      int64_t rest = i;
+      int64_t y_idx = 0;
+      int64_t y_stride = 1;
+      for (int d = x_dims.size() - 1; d >= 0; d--) {
+        int64_t coord = rest % x_dims[d];
+        rest /= x_dims[d];
+        int yd = d - axis;
+        if (yd >= 0 && yd < static_cast<int>(y_dims.size())) {
+          if (y_dims[yd] != 1) y_idx += coord * y_stride;
+          y_stride *= y_dims[yd];
+        }
+      }
+      ASSERT_NEAR(out.data<float>()[i], x_data[i] + y_data[y_idx], 1e-5)
+          << "case " << c << " at " << i;
+    }
+  }
+}
+
+TEST(elementwise_x86, plan) {
+  // The dims broadcast the same way are collapsed.
+  lite::x86::math::ElementwisePlan plan(
+      DDim(std::vector<int64_t>({2, 3, 4, 5})),
+      DDim(std::vector<int64_t>({3, 1})),
+      1);
+  EXPECT_EQ(plan.out_dims, DDim(std::vector<int64_t>({2, 3, 4, 5})));
+  EXPECT_EQ(plan.dims, std::vector<int64_t>({2, 3, 20}));
+  EXPECT_EQ(plan.x_strides, std::vector<int64_t>({60, 20, 1}));
+  EXPECT_EQ(plan.y_strides, std::vector<int64_t>({0, 1, 0}));
+}
+
+// out = act(x op y) with the dims aligned to the trailing dims.
+void ElementwiseRef(const lite::Tensor& x,
+                    const lite::Tensor& y,
+                    const std::function<float(float, float)>& fn,
+                    lite::Tensor* out) {
+  int rank = out->dims().size();
+  auto align = [&](const DDim& dims) {
+    std::vector<int64_t> aligned(rank - dims.size(), 1);
+    for (size_t i = 0; i < dims.size(); i++) aligned.push_back(dims[i]);
+    return aligned;
+  };
+  auto x_dims = align(x.dims());
+  auto y_dims = align(y.dims());
+  auto* out_data = out->mutable_data<float>();
+  for (int64_t i = 0; i < out->numel(); i++) {
+    int64_t rest = i;
+    int64_t x_idx = 0, y_idx = 0, x_stride = 1, y_stride = 1;
+    for (int d = rank - 1; d >= 0; d--) {
+      int64_t coord = rest % out->dims()[d];
+      rest /= out->dims()[d];
+      if (x_dims[d] != 1) x_idx += coord * x_stride;
+      if (y_dims[d] != 1) y_idx += coord * y_stride;
+      x_stride *= x_dims[d];
+      y_stride *= y_dims[d];
+    }
+    out_data[i] = fn(x.data<float>()[x_idx], y.data<float>()[y_idx]);
+  }
+}
+
+TEST(elementwise_x86, broadcast) {
+  // {x dims, y dims, out dims}, either side is broadcast.
+  std::vector<std::vector<std::vector<int64_t>>> shapes{
+      {{4, 64, 33}, {33}, {4, 64, 33}},
+      {{2, 1, 4, 21}, {2, 3, 1, 21}, {2, 3, 4, 21}},
+      {{21}, {2, 3, 21}, {2, 3, 21}},
+      {{3, 1}, {1, 37}, {3, 37}},
+      {{5, 7}, {1}, {5, 7}},
+  };
+  for (size_t c = 0; c < shapes.size(); c++) {
+    lite::Tensor x, y, out, ref;
+    x.Resize(DDim(shapes[c][0]));
+    y.Resize(DDim(shapes[c][1]));
+    auto* x_data = x.mutable_data<float>();
+    auto* y_data = y.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) x_data[i] = i % 11 - 5;
+    for (int64_t i = 0; i < y.numel(); i++) y_data[i] = i % 7 + 1;
+
+    DDim out_dims;
+    ASSERT_TRUE(
+        operators::ElementwiseOutDims(x.dims(), y.dims(), -1, &out_dims));
+    ASSERT_EQ(out_dims, DDim(shapes[c][2]));
+    out.Resize(out_dims);
+    ref.Resize(out_dims);
+
+    auto check = [&](KernelBase* kernel,
+                     const std::function<float(float, float)>& fn) {
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>().SetThreadPool(std::make_shared<ThreadPool>(2));
+      kernel->SetContext(std::move(ctx));
+      kernel->Launch();
+      ElementwiseRef(x, y, fn, &ref);
+      for (int64_t i = 0; i < out.numel(); i++) {
+        ASSERT_NEAR(out.data<float>()[i], ref.data<float>()[i], 1e-5)
+            << "case " << c << " at " << i;
+      }
+    };
+
+    operators::ElementwiseParam param;
+    param.X = &x;
+    param.Y = &y;
+    param.Out = &out;
+    param.axis = -1;
+    ElementwiseSubCompute<float> sub;
+    sub.SetParam(param);
+    check(&sub, [](float a, float b) { return a - b; });
+    ElementwiseMulCompute<float> mul;
+    mul.SetParam(param);
+    check(&mul, [](float a, float b) { return a * b; });
+    ElementwiseDivCompute<float> div;
+    div.SetParam(param);
+    check(&div, [](float a, float b) { return a / b; });
+    ElementwiseMaxCompute<float> max;
+    max.SetParam(param);
+    check(&max, [](float a, float b) { return std::max(a, b); });
+
+    operators::FusionElementwiseActivationParam act_param;
+    act_param.X = &x;
+    act_param.Y = &y;
+    act_param.Out = &out;
+    act_param.axis = -1;
+    act_param.act_type = "relu";
+    FusionElementwiseActivationCompute<float,
+                                       lite::x86::math::ElementwiseType::kAdd>
+        add_relu;
+    add_relu.SetParam(act_param);
+    check(&add_relu, [](float a, float b) { return std::max(a + b, 0.f); });
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
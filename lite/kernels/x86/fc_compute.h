@@ -13,91 +13,155 @@
 // limitations under the License.
 #pragma once
 
-#include <Eigen/Core>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_s8.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/type_system.h"
 #include "lite/operators/fc_op.h"
-#include "paddle/fluid/framework/eigen.h"
-#include "paddle/fluid/framework/operator.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace x86 {
 
+// out = x * w + bias, the GEMM runs by BLAS, and the bias is added to the
+// rows by the jit kernel for the CPU.
 template <typename T>
-void fc_compute_eigen(const T* x,
-                      int x_h,
-                      int x_w,  //
-                      const T* w,
-                      int w_h,
-                      int w_w,     //
-                      const T* b,  //
-                      T* out) {
-  using matrix_t =
-      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
-
-  Eigen::Map<const matrix_t> X(x, x_h, x_w);
-  Eigen::Map<const matrix_t> W(w, w_h, w_w);
-  Eigen::Map<matrix_t> Out(out, x_h, w_w);
-
-  Out = X * W;
-
-  if (b) {
-    Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>> B(b, w_w);
-    Out = Out.array().rowwise() + B.transpose().array();
-  }
-}
+class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FcParam;
 
-template <typename T>
-void fc_compute_naive(const T* x,
-                      int x_h,
-                      int x_w,  //
-                      const T* w,
-                      int w_h,
-                      int w_w,     //
-                      const T* b,  //
-                      T* out) {
-  CHECK_EQ(x_w, w_h);
-  // out shape: (x_h, w_w)
-  memset(out, 0, x_h * w_w * sizeof(T));
-  for (int i = 0; i < x_h; i++) {
-    for (int j = 0; j < w_w; j++) {
-      T tmp = static_cast<T>(0);
-      for (int k = 0; k < x_w; k++) {
-        tmp += x[i * x_w + k] * w[k * w_w + j];
-      }
-      out[i * w_w + j] = tmp + b[j];
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto& ctx = ctx_->As<X86Context>();
+    auto in_dims = param.input->dims();
+    CHECK_GE(in_dims.size(), 2UL);
+    CHECK_EQ(param.output->dims().size(), 2UL);
+
+    int m = in_dims.Slice(0, param.in_num_col_dims).production();
+    int k = in_dims.Slice(param.in_num_col_dims, in_dims.size()).production();
+    int n = param.w->dims()[1];
+    CHECK_EQ(k, param.w->dims()[0]);
+    T* out = param.output->mutable_data<T>();
+
+    auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(ctx);
+    blas.MatMul(m, n, k, param.input->data<T>(), param.w->data<T>(), out);
+    if (!param.bias) return;
+    const T* bias = param.bias->data<T>();
+    auto add_bias =
+        jit::KernelFuncs<jit::VAddTuple<T>, lite::fluid::CPUPlace>::Cache().At(
+            n);
+    for (int i = 0; i < m; i++) {
+      add_bias(bias, out + i * n, out + i * n, n);
     }
   }
-}
 
-template <typename T>
-class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+  virtual ~FcCompute() = default;
+};
+
+// The int8 fc of the quantized models, the int8 w is packed once for
+// gemm_s8, and the int32 results are requantized to OutT, float or int8_t,
+// with the bias fused, by the scales of the columns of w.
+template <typename OutT>
+class FcInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
  public:
   using param_t = operators::FcParam;
 
+  void PrepareForRun() override {
+    auto& param = this->Param<param_t>();
+    int k = param.w->dims()[0];
+    int n = param.w->dims()[1];
+    auto& w_scale = param.weight_scale;
+    CHECK(w_scale.size() == 1 || static_cast<int>(w_scale.size()) == n)
+        << "the size of weight_scale " << w_scale.size()
+        << " is neither 1 nor the columns of w " << n;
+    // The int8 results are quantized by output_scale.
+    float out_scale =
+        std::is_same<OutT, int8_t>::value ? param.output_scale : 1.f;
+    const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+    scale_.resize(n);
+    bias_.resize(bias ? n : 0);
+    for (int i = 0; i < n; i++) {
+      float ws = w_scale.size() == 1 ? w_scale[0] : w_scale[i];
+      scale_[i] = ws * param.input_scale / out_scale;
+      if (bias) bias_[i] = bias[i] / out_scale;
+    }
+
+    packed_w_.Resize({lite::x86::math::gemm_s8_packed_b_size(k, n)});
+    lite::x86::math::gemm_s8_pack_b(
+        param.w->data<int8_t>(), k, n, n, packed_w_.mutable_data<int8_t>());
+  }
+
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
-    CHECK_GE(param.input->dims().size(), 2UL);
+    auto& ctx = ctx_->As<X86Context>();
+    auto in_dims = param.input->dims();
+    CHECK_GE(in_dims.size(), 2UL);
     CHECK_EQ(param.output->dims().size(), 2UL);
 
-    fc_compute_eigen(
-        param.input->data<T>(),  // x
-        param.input->dims().Slice(0, param.in_num_col_dims).production(),
-        param.input->dims()
-            .Slice(param.in_num_col_dims, param.input->dims().size())
-            .production(),
-        param.w->data<T>(),     // w
-        param.w->dims()[0],     // w_h
-        param.w->dims()[1],     // w_w
-        param.bias->data<T>(),  // b
-        param.output->mutable_data<T>());
+    int m = in_dims.Slice(0, param.in_num_col_dims).production();
+    int k = in_dims.Slice(param.in_num_col_dims, in_dims.size()).production();
+    int n = param.w->dims()[1];
+    CHECK_EQ(k, param.w->dims()[0]);
+    const int8_t* in = param.input->data<int8_t>();
+    const int8_t* packed_w = packed_w_.data<int8_t>();
+    OutT* out = param.output->template mutable_data<OutT>();
+
+    // The rows are split to the threads if there are enough of them, e.g.
+    // for a batch, otherwise the columns, by 16, i.e. the tiles of gemm_s8.
+    int threads = ctx.threads();
+    bool split_rows = m >= threads * 4;
+    int units = split_rows ? m : (n + 15) / 16;
+    int tiles = std::min(threads, units);
+    ctx.ParallelFor(tiles, [&](int tile, int tid) {
+      int begin = static_cast<int64_t>(units) * tile / tiles;
+      int end = static_cast<int64_t>(units) * (tile + 1) / tiles;
+      lite::x86::math::GemmS8Requant requant;
+      requant.per_row = false;
+      requant.scale = scale_.data();
+      requant.bias = bias_.empty() ? nullptr : bias_.data();
+      if (split_rows) {
+        lite::x86::math::gemm_s8<OutT>(end - begin,
+                                       n,
+                                       k,
+                                       in + static_cast<int64_t>(begin) * k,
+                                       k,
+                                       packed_w,
+                                       out + static_cast<int64_t>(begin) * n,
+                                       n,
+                                       requant);
+        return;
+      }
+      int n0 = begin * 16;
+      int n1 = std::min(n, end * 16);
+      requant.scale += n0;
+      if (requant.bias) requant.bias += n0;
+      lite::x86::math::gemm_s8<OutT>(
+          m,
+          n1 - n0,
+          k,
+          in,
+          k,
+          packed_w + lite::x86::math::gemm_s8_packed_b_size(k, n0),
+          out + n0,
+          n,
+          requant);
+    });
   }
 
-  virtual ~FcCompute() = default;
+  virtual ~FcInt8Compute() = default;
+
+ private:
+  // The requantization scales and bias of the columns.
+  std::vector<float> scale_;
+  std::vector<float> bias_;
+  lite::Tensor packed_w_;
 };
 
 }  // namespace x86
@@ -13,6 +13,10 @@
 // limitations under the License.
 #include "lite/kernels/x86/fc_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
 #include <vector>
 #include "lite/core/op_registry.h"
 
@@ -43,7 +47,7 @@ TEST(fc_x86, run_test) {
   w.Resize(lite::DDim(w_shape));
   std::vector<int64_t> b_shape{1, 4};
   b.Resize(lite::DDim(b_shape));
-  std::vector<int64_t> out_shape{1, 4};
+  std::vector<int64_t> out_shape{batch_size, 4};
   out.Resize(lite::DDim(out_shape));
 
   auto x_data = x.mutable_data<float>();
@@ -61,11 +65,6 @@ TEST(fc_x86, run_test) {
     b_data[i] = static_cast<float>(i);
   }
 
-  /* lite::x86::math::fc_compute_eigen(x_data, batch_size, 3,  //
-                                     w_data, 3, 4,           //
-                                     b_data, ref_data); */
-
-  // FcCompute fc;
   FcCompute<float> fc;
   operators::FcParam param;
 
@@ -76,20 +75,89 @@ TEST(fc_x86, run_test) {
   param.output = &out;
   param.in_mat_dims = x.dims();
 
-  // std::unique_ptr<KernelContext> ctx(new KernelContext);
-  // ctx->As<X86Context>();
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
   fc.SetParam(param);
-  // fc.SetContext(std::move(ctx));
+  fc.SetContext(std::move(ctx));
   fc.Run();
 
-  VLOG(3) << "output vs ref";
-  for (int i = 0; i < out.dims().production(); i++) {
-    VLOG(3) << out_data[i];
+  // x = [[0, 1, 2], [3, 4, 5]], w = [[0, 1, 2, 3], [4, 5, 6, 7],
+  // [8, 9, 10, 11]], b = [0, 1, 2, 3]
+  std::vector<float> ref_data{20, 24, 28, 32, 56, 69, 82, 95};
+  for (int i = 0; i < out.dims().production(); ++i) {
+    EXPECT_NEAR(out_data[i], ref_data[i], 1e-5);
+  }
+}
+
+// The int8 fc by the scales of the columns of w, with the fp32 and int8
+// outputs.
+TEST(fc_x86, int8_run_test) {
+  // With 4 threads the 5 rows are too few to split, so the columns are split
+  // by the tiles of 16, the last one partial.
+  constexpr int m = 5, k = 37, n = 53;
+  lite::Tensor x, w, b, out_fp32, out_int8;
+  x.Resize({m, k});
+  w.Resize({k, n});
+  b.Resize({1, n});
+  out_fp32.Resize({m, n});
+  out_int8.Resize({m, n});
+  auto* x_data = x.mutable_data<int8_t>();
+  auto* w_data = w.mutable_data<int8_t>();
+  auto* b_data = b.mutable_data<float>();
+  for (int i = 0; i < m * k; i++) x_data[i] = (i * 7) % 255 - 127;
+  for (int i = 0; i < k * n; i++) w_data[i] = (i * 13) % 255 - 127;
+  std::vector<float> w_scale(n);
+  for (int i = 0; i < n; i++) {
+    b_data[i] = 0.1f * i - 1.f;
+    w_scale[i] = 0.001f * (i + 1);
   }
 
-  /* for (int i = 0; i < out.dims().production(); ++i) {
-     EXPECT_NEAR(out_data[i], ref_data[i], 1e-5);
-   }*/
+  operators::FcParam param;
+  param.in_num_col_dims = 1;
+  param.input = &x;
+  param.w = &w;
+  param.bias = &b;
+  param.in_mat_dims = x.dims();
+  param.enable_int8 = true;
+  param.input_scale = 0.02f;
+  param.weight_scale = w_scale;
+  param.output_scale = 0.05f;
+
+  for (int threads : {1, 4}) {
+    FcInt8Compute<float> fc_fp32;
+    param.output = &out_fp32;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>().SetThreadPool(std::make_shared<ThreadPool>(threads));
+    fc_fp32.SetParam(param);
+    fc_fp32.SetContext(std::move(ctx));
+    fc_fp32.PrepareForRun();
+    fc_fp32.Run();
+
+    FcInt8Compute<int8_t> fc_int8;
+    param.output = &out_int8;
+    ctx.reset(new KernelContext);
+    ctx->As<X86Context>().SetThreadPool(std::make_shared<ThreadPool>(threads));
+    fc_int8.SetParam(param);
+    fc_int8.SetContext(std::move(ctx));
+    fc_int8.PrepareForRun();
+    fc_int8.Run();
+
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        int32_t acc = 0;
+        for (int l = 0; l < k; l++) {
+          acc += x_data[i * k + l] * w_data[l * n + j];
+        }
+        float ref = acc * w_scale[j] * param.input_scale + b_data[j];
+        EXPECT_NEAR(out_fp32.data<float>()[i * n + j], ref, 1e-4)
+            << "threads " << threads << " at " << i << ", " << j;
+        float q = std::round(ref / param.output_scale);
+        q = std::min(127.f, std::max(-127.f, q));
+        EXPECT_NEAR(out_int8.data<int8_t>()[i * n + j], q, 1)
+            << "threads " << threads << " at " << i << ", " << j;
+      }
+    }
+  }
 }
 
 }  // namespace x86
@@ -98,3 +166,5 @@ TEST(fc_x86, run_test) {
 }  // namespace paddle
 
 USE_LITE_KERNEL(fc, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(fc, kX86, kInt8, kNCHW, int8out);
+USE_LITE_KERNEL(fc, kX86, kInt8, kNCHW, fp32out);
@@ -0,0 +1,76 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <algorithm>
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// Looks up the embeddings of every sequence of the ids and sums them in a
+// single pass, without the intermediate of lookup_table.
+template <typename T>
+class FusedEmbeddingSeqPoolCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedEmbeddingSeqPoolParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<operators::FusedEmbeddingSeqPoolParam>();
+    auto* table = param.W;
+    auto* ids = param.Ids;
+    auto* out = param.Out;
+    CHECK_EQ(param.combiner, "sum");
+    auto lod = ids->lod();
+    CHECK_EQ(lod.size(), 1UL);
+    auto& offset = lod[0];
+
+    int64_t table_height = table->dims()[0];
+    int64_t table_width = table->dims()[1];
+    int64_t idx_width = ids->numel() / ids->dims()[0];
+    int64_t out_width = table_width * idx_width;
+    out->Resize({static_cast<int64_t>(offset.size()) - 1, out_width});
+
+    const T* table_data = table->data<T>();
+    const int64_t* ids_data = ids->data<int64_t>();
+    T* out_data = out->mutable_data<T>();
+    jit::emb_seq_pool_attr_t attr(
+        table_height, table_width, 0, idx_width, out_width, jit::kSum);
+    for (size_t i = 0; i + 1 < offset.size(); ++i) {
+      T* out_row = out_data + i * out_width;
+      attr.index_height = offset[i + 1] - offset[i];
+      if (attr.index_height == 0) {
+        std::fill(out_row, out_row + out_width, static_cast<T>(0));
+        continue;
+      }
+      auto emb_seqpool = jit::KernelFuncs<jit::EmbSeqPoolTuple<T>,
+                                          lite::fluid::CPUPlace>::Cache()
+                             .At(attr);
+      emb_seqpool(
+          table_data, ids_data + offset[i] * idx_width, out_row, &attr);
+    }
+  }
+
+  virtual ~FusedEmbeddingSeqPoolCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,85 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(fused_embedding_seq_pool_x86, retrive_op) {
+  auto kernel =
+      KernelRegistry::Global().Create<TARGET(kX86), PRECISION(kFloat)>(
+          "fused_embedding_seq_pool");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(fused_embedding_seq_pool_x86, run_test) {
+  const int64_t table_height = 10, table_width = 6;
+  lite::Tensor table, ids, out;
+  table.Resize({table_height, table_width});
+  auto* table_data = table.mutable_data<float>();
+  for (int64_t i = 0; i < table.numel(); i++) {
+    table_data[i] = 0.1f * i;
+  }
+
+  // Three sequences of two ids per row, the second one is empty.
+  lite::LoD lod{{0, 3, 3, 5}};
+  std::vector<int64_t> ids_value{1, 2, 0, 9, 4, 4, 7, 3, 5, 6};
+  ids.set_lod(lod);
+  ids.Resize({5, 2});
+  auto* ids_data = ids.mutable_data<int64_t>();
+  std::copy(ids_value.begin(), ids_value.end(), ids_data);
+
+  FusedEmbeddingSeqPoolCompute<float> kernel;
+  operators::FusedEmbeddingSeqPoolParam param;
+  param.W = &table;
+  param.Ids = &ids;
+  param.Out = &out;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel.SetContext(std::move(ctx));
+  kernel.SetParam(param);
+  kernel.Run();
+
+  ASSERT_EQ(out.dims()[0], 3);
+  ASSERT_EQ(out.dims()[1], 2 * table_width);
+  for (size_t seq = 0; seq + 1 < lod[0].size(); seq++) {
+    for (int64_t w = 0; w < 2; w++) {
+      for (int64_t j = 0; j < table_width; j++) {
+        float ref = 0.f;
+        for (uint64_t h = lod[0][seq]; h < lod[0][seq + 1]; h++) {
+          ref += table_data[ids_value[h * 2 + w] * table_width + j];
+        }
+        EXPECT_NEAR(out.data<float>()[(seq * 2 + w) * table_width + j],
+                    ref,
+                    1e-5);
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_embedding_seq_pool, kX86, kFloat, kNCHW, def);
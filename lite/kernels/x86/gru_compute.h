@@ -13,8 +13,10 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <vector>
+#include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/detail/gru_cpu_kernel.h"
 #include "lite/backends/x86/math/detail/gru_kernel.h"
@@ -182,29 +184,33 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       blas.GEMM_FREE(packed_state);
     } else {
 #endif
-      for (size_t n = 0; n < seq_len; n++) {
-        int64_t bstart = static_cast<int64_t>(batch_starts[n]);
-        int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
-        int64_t cur_batch_size = bend - bstart;
+      if (!origin_mode) {
+        RunByJit(param, gru_value.prev_out_value, frame_size);
+      } else {
+        for (size_t n = 0; n < seq_len; n++) {
+          int64_t bstart = static_cast<int64_t>(batch_starts[n]);
+          int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
+          int64_t cur_batch_size = bend - bstart;
 
-        Tensor gate_t = batch_gate->Slice<T>(bstart, bend);
-        Tensor reset_hidden_prev_t =
-            batch_reset_hidden_prev->Slice<T>(bstart, bend);
-        Tensor hidden_t = batch_hidden->Slice<T>(bstart, bend);
-        gru_value.output_value = hidden_t.mutable_data<T>();
-        gru_value.gate_value = gate_t.mutable_data<T>();
-        gru_value.reset_output_value = reset_hidden_prev_t.mutable_data<T>();
+          Tensor gate_t = batch_gate->Slice<T>(bstart, bend);
+          Tensor reset_hidden_prev_t =
+              batch_reset_hidden_prev->Slice<T>(bstart, bend);
+          Tensor hidden_t = batch_hidden->Slice<T>(bstart, bend);
+          gru_value.output_value = hidden_t.mutable_data<T>();
+          gru_value.gate_value = gate_t.mutable_data<T>();
+          gru_value.reset_output_value = reset_hidden_prev_t.mutable_data<T>();
 
-        lite::x86::math::GRUUnitFunctor<TARGET(kX86), T>::compute(
-            context,
-            gru_value,
-            frame_size,
-            cur_batch_size,
-            active_node,
-            active_gate,
-            origin_mode);
+          lite::x86::math::GRUUnitFunctor<TARGET(kX86), T>::compute(
+              context,
+              gru_value,
+              frame_size,
+              cur_batch_size,
+              active_node,
+              active_gate,
+              origin_mode);
 
-        gru_value.prev_out_value = gru_value.output_value;
+          gru_value.prev_out_value = gru_value.output_value;
+        }
       }
 #ifdef PADDLE_WITH_MKLML
     }
@@ -213,6 +219,94 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     batch_hidden->set_lod(batch_gate->lod());
     to_seq(context, *batch_hidden, hidden);
   }
+
+ private:
+  // Run the steps by the jit GRU kernels for the CPU, which fuse the gate
+  // activations, they compute h = u * c + (1 - u) * h_prev of the non-origin
+  // mode. `h0` is the reordered initial hidden state, or null.
+  void RunByJit(const operators::GRUParam& param, const T* h0, int d) {
+    auto& context = ctx_->As<X86Context>();
+    auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
+    const T* gate_weight = param.weight->data<T>();
+    const T* state_weight = gate_weight + 2 * d * d;
+    T* gate_data = param.batch_gate->mutable_data<T>();
+    T* reset_data = param.batch_reset_hidden_prev->mutable_data<T>();
+    T* hidden_data = param.batch_hidden->mutable_data<T>();
+
+    jit::gru_attr_t attr(d,
+                         jit::to_kerneltype(param.gate_activation),
+                         jit::to_kerneltype(param.activation));
+    auto gru_h1 =
+        jit::KernelFuncs<jit::GRUH1Tuple<T>, lite::fluid::CPUPlace>::Cache()
+            .At(attr);
+    auto gru_part1 = jit::KernelFuncs<jit::GRUHtPart1Tuple<T>,
+                                      lite::fluid::CPUPlace>::Cache()
+                         .At(attr);
+    auto gru_part2 = jit::KernelFuncs<jit::GRUHtPart2Tuple<T>,
+                                      lite::fluid::CPUPlace>::Cache()
+                         .At(attr);
+
+    auto batch_starts = param.batch_gate->lod()[0];
+    const T* prev = h0;
+    for (size_t n = 0; n + 1 < batch_starts.size(); n++) {
+      int64_t bstart = static_cast<int64_t>(batch_starts[n]);
+      int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
+      int batch_size = static_cast<int>(bend - bstart);
+      T* gate = gate_data + bstart * d * 3;
+      T* reset = reset_data + bstart * d;
+      T* hidden = hidden_data + bstart * d;
+      jit::gru_t step;
+      if (!prev) {
+        // The reset hidden state of a zero initial state is zero.
+        std::fill(reset, reset + batch_size * d, static_cast<T>(0));
+        for (int i = 0; i < batch_size; i++) {
+          step.gates = gate + i * d * 3;
+          step.ht = hidden + i * d;
+          gru_h1(&step, &attr);
+        }
+      } else {
+        blas.GEMM(false,
+                  false,
+                  batch_size,
+                  d * 2,
+                  d,
+                  static_cast<T>(1),
+                  prev,
+                  d,
+                  gate_weight,
+                  d * 2,
+                  static_cast<T>(1),
+                  gate,
+                  d * 3);
+        for (int i = 0; i < batch_size; i++) {
+          step.gates = gate + i * d * 3;
+          step.ht_1 = prev + i * d;
+          step.ht = reset + i * d;
+          gru_part1(&step, &attr);
+        }
+        blas.GEMM(false,
+                  false,
+                  batch_size,
+                  d,
+                  d,
+                  static_cast<T>(1),
+                  reset,
+                  d,
+                  state_weight,
+                  d,
+                  static_cast<T>(1),
+                  gate + d * 2,
+                  d * 3);
+        for (int i = 0; i < batch_size; i++) {
+          step.gates = gate + i * d * 3;
+          step.ht_1 = prev + i * d;
+          step.ht = hidden + i * d;
+          gru_part2(&step, &attr);
+        }
+      }
+      prev = hidden;
+    }
+  }
 };
 
 }  // namespace x86
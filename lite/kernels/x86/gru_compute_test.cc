@@ -14,6 +14,8 @@
 
 #include "lite/kernels/x86/gru_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -147,6 +149,108 @@ TEST(gru_x86, run_test) {
   }
 }
 
+// The reference GRU of the non-origin mode on every sequence,
+// h = u * c + (1 - u) * h_prev.
+static void gru_basic(const lite::Tensor& input,
+                      const lite::Tensor* h0,
+                      const lite::Tensor& weight,
+                      const lite::Tensor& bias,
+                      int d,
+                      std::vector<float>* out) {
+  auto sigmoid = [](float x) { return 1.f / (1.f + std::exp(-x)); };
+  const float* w = weight.data<float>();
+  const float* state_w = w + 2 * d * d;
+  auto lod = input.lod()[0];
+  out->resize(input.dims()[0] * d);
+  for (size_t seq = 0; seq + 1 < lod.size(); seq++) {
+    std::vector<float> h(d, 0.f);
+    if (h0) {
+      std::copy(h0->data<float>() + seq * d,
+                h0->data<float>() + (seq + 1) * d,
+                h.begin());
+    }
+    for (uint64_t t = lod[seq]; t < lod[seq + 1]; t++) {
+      const float* x = input.data<float>() + t * d * 3;
+      std::vector<float> u(d), r(d), rh(d), c(d);
+      for (int j = 0; j < d; j++) {
+        float gu = x[j] + bias.data<float>()[j];
+        float gr = x[d + j] + bias.data<float>()[d + j];
+        for (int k = 0; k < d; k++) {
+          gu += h[k] * w[k * d * 2 + j];
+          gr += h[k] * w[k * d * 2 + d + j];
+        }
+        u[j] = sigmoid(gu);
+        r[j] = sigmoid(gr);
+        rh[j] = r[j] * h[j];
+      }
+      for (int j = 0; j < d; j++) {
+        float gc = x[d * 2 + j] + bias.data<float>()[d * 2 + j];
+        for (int k = 0; k < d; k++) {
+          gc += rh[k] * state_w[k * d + j];
+        }
+        c[j] = std::tanh(gc);
+      }
+      for (int j = 0; j < d; j++) {
+        h[j] = u[j] * c[j] + (1.f - u[j]) * h[j];
+        (*out)[t * d + j] = h[j];
+      }
+    }
+  }
+}
+
+TEST(gru_x86, jit_non_origin_mode) {
+  const int d = 7;
+  lite::Tensor input, h0, weight, bias;
+  lite::Tensor batch_gate, batch_reset_hidden_prev, batch_hidden, hidden;
+  input.Resize({9, d * 3});
+  input.set_lod({{0, 2, 6, 9}});
+  h0.Resize({3, d});
+  weight.Resize({d, d * 3});
+  bias.Resize({1, d * 3});
+  batch_gate.Resize({9, d * 3});
+  batch_reset_hidden_prev.Resize({9, d});
+  batch_hidden.Resize({9, d});
+  hidden.Resize({9, d});
+  for (auto* t : {&input, &h0, &weight, &bias}) {
+    auto* data = t->mutable_data<float>();
+    for (int64_t i = 0; i < t->numel(); i++) {
+      data[i] = ((i * 7 + t->numel()) % 19) * 0.1f - 0.9f;
+    }
+  }
+
+  operators::GRUParam param;
+  param.input = &input;
+  param.h0 = &h0;
+  param.weight = &weight;
+  param.bias = &bias;
+  param.batch_gate = &batch_gate;
+  param.batch_reset_hidden_prev = &batch_reset_hidden_prev;
+  param.batch_hidden = &batch_hidden;
+  param.hidden = &hidden;
+  param.gate_activation = "sigmoid";
+  param.activation = "tanh";
+  param.is_reverse = false;
+  param.origin_mode = false;
+
+  // With and without the initial hidden state.
+  for (auto* init : {&h0, static_cast<lite::Tensor*>(nullptr)}) {
+    param.h0 = init;
+    GRUCompute<float> gru;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    gru.SetContext(std::move(ctx));
+    gru.SetParam(param);
+    gru.Run();
+
+    std::vector<float> ref;
+    gru_basic(input, init, weight, bias, d, &ref);
+    ASSERT_EQ(hidden.numel(), static_cast<int64_t>(ref.size()));
+    for (int64_t i = 0; i < hidden.numel(); i++) {
+      EXPECT_NEAR(hidden.data<float>()[i], ref[i], 1e-5) << "at " << i;
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
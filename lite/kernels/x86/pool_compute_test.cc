@@ -15,6 +15,7 @@
 #include "lite/kernels/x86/pool_compute.h"
 #include <gtest/gtest.h>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include "lite/core/op_registry.h"
 
@@ -46,7 +47,6 @@ TEST(pool2d_x86, run_test) {
   out.Resize(lite::DDim(out_shape));
 
   auto x_data = x.mutable_data<float>();
-  auto out_data = out.mutable_data<float>();
 
   for (int64_t i = 0; i < x.dims().production(); i++) {
     x_data[i] = static_cast<float>(i);
@@ -62,12 +62,47 @@ TEST(pool2d_x86, run_test) {
   param.ksize = {2, 2};
   param.pooling_type = "max";
 
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  pool2d.SetContext(std::move(ctx));
   pool2d.SetParam(param);
   pool2d.Run();
 
-  LOG(INFO) << "output: ";
+  std::vector<float> ref{5, 7, 13, 15, 21, 23, 29, 31, 37, 39, 45, 47};
   for (int i = 0; i < out.dims().production(); i++) {
-    LOG(INFO) << out_data[i];
+    EXPECT_NEAR(out.data<float>()[i], ref[i], 1e-5);
+  }
+}
+
+TEST(pool2d_x86, threads) {
+  lite::Tensor x, out, out_ref;
+  x.Resize({2, 5, 9, 9});
+  out.Resize({2, 5, 4, 4});
+  out_ref.Resize({2, 5, 4, 4});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = (i % 23) * 0.1f;
+  }
+
+  operators::PoolParam param;
+  param.x = &x;
+  param.strides = {2, 2};
+  param.paddings = {0, 0};
+  param.ksize = {3, 3};
+  param.pooling_type = "avg";
+
+  for (int threads : {1, 4}) {
+    PoolCompute<float> pool2d;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>().SetThreadPool(
+        std::make_shared<ThreadPool>(threads));
+    pool2d.SetContext(std::move(ctx));
+    param.output = threads == 1 ? &out_ref : &out;
+    pool2d.SetParam(param);
+    pool2d.Run();
+  }
+  for (int64_t i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out.data<float>()[i], out_ref.data<float>()[i], 1e-5);
   }
 }
 
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 #include "lite/core/op_registry.h"
@@ -69,9 +71,71 @@ TEST(relu_x86, run_test) {
   }
 }
 
+TEST(activation_x86, sigmoid_tanh) {
+  lite::Tensor x, out;
+  x.Resize({2, 37});
+  out.Resize({2, 37});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = (i % 23) * 0.5f - 5.f;
+  }
+  operators::ActivationParam param;
+  param.X = &x;
+  param.Out = &out;
+
+  SigmoidCompute<float> sigmoid;
+  sigmoid.SetParam(param);
+  sigmoid.Run();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    EXPECT_NEAR(out.data<float>()[i], 1.f / (1.f + std::exp(-x_data[i])), 1e-5);
+  }
+
+  TanhCompute<float> tanh;
+  tanh.SetParam(param);
+  tanh.Run();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    EXPECT_NEAR(out.data<float>()[i], std::tanh(x_data[i]), 1e-5);
+  }
+}
+
+TEST(activation_x86, blocks) {
+  // The sizes of the full blocks, the tails and both.
+  for (int64_t n : {1, 37, kActivateBlock, 3 * kActivateBlock + 5}) {
+    lite::Tensor x, out;
+    x.Resize({n});
+    out.Resize({n});
+    auto* x_data = x.mutable_data<float>();
+    for (int64_t i = 0; i < n; i++) {
+      x_data[i] = (i % 23) * 0.5f - 5.f;
+    }
+    operators::ActivationParam param;
+    param.X = &x;
+    param.Out = &out;
+
+    SigmoidCompute<float> sigmoid;
+    sigmoid.SetParam(param);
+    sigmoid.Run();
+    for (int64_t i = 0; i < n; i++) {
+      ASSERT_NEAR(
+          out.data<float>()[i], 1.f / (1.f + std::exp(-x_data[i])), 1e-5);
+    }
+
+    // In place.
+    param.Out = &x;
+    ReluCompute<float> relu;
+    relu.SetParam(param);
+    relu.Run();
+    for (int64_t i = 0; i < n; i++) {
+      ASSERT_EQ(x_data[i], std::max((i % 23) * 0.5f - 5.f, 0.f));
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(relu, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(sigmoid, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(tanh, kX86, kFloat, kNCHW, def);
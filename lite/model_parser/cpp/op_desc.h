@@ -91,6 +91,11 @@ class OpDesc : public OpDescAPI {
     return attrs_.count(name);
   }
 
+  void DeleteAttr(const std::string& name) {
+    attrs_.erase(name);
+    attr_types_.erase(name);
+  }
+
   AttrType GetAttrType(const std::string& name) const override {
     auto it = attr_types_.find(name);
     CHECK(it != attr_types_.end());
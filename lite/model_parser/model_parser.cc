@@ -595,15 +595,6 @@ void SaveModelNaive(const std::string &model_dir,
 }
 #endif
 
-template <typename T>
-void SetTensorDataNaive(T *out, size_t size, const std::vector<T> &src) {
-  CHECK(out);
-  CHECK(size == src.size());
-  for (size_t i = 0; i < size; ++i) {
-    out[i] = src[i];
-  }
-}
-
 void GetParamInfoNaive(const naive_buffer::ParamDesc &desc,
                        lite::Scope *scope,
                        const std::string &name) {
@@ -626,33 +617,46 @@ void GetParamInfoNaive(const naive_buffer::ParamDesc &desc,
   tensor->Resize(lite::DDim(desc.Dim()));
 
   // Load data
+  PrecisionType precision;
   switch (desc.GetDataType()) {
-#define SET_TENSOR(data_type__, T, precision)                            \
-  case VarDescAPI::VarDataType::data_type__:                             \
-    SetTensorDataNaive<T>(                                               \
-        tensor->mutable_data<T>(), tensor->data_size(), desc.Data<T>()); \
-    tensor->set_precision(precision);                                    \
+#define SET_PRECISION(data_type__, precision__) \
+  case VarDescAPI::VarDataType::data_type__:    \
+    precision = precision__;                    \
     break
 
-    // SET_TENSOR(BOOL, bool, PRECISION(kBool));
-    SET_TENSOR(FP32, float, PRECISION(kFloat));
-    SET_TENSOR(INT8, int8_t, PRECISION(kInt8));
-    SET_TENSOR(INT16, int16_t, PRECISION(kInt16));
-    SET_TENSOR(INT32, int32_t, PRECISION(kInt32));
-    SET_TENSOR(INT64, int64_t, PRECISION(kInt64));
-#undef SET_TENSOR
+    // SET_PRECISION(BOOL, PRECISION(kBool));
+    SET_PRECISION(FP32, PRECISION(kFloat));
+    SET_PRECISION(INT8, PRECISION(kInt8));
+    SET_PRECISION(INT16, PRECISION(kInt16));
+    SET_PRECISION(INT32, PRECISION(kInt32));
+    SET_PRECISION(INT64, PRECISION(kInt64));
+#undef SET_PRECISION
     default:
       LOG(FATAL) << "unknown type";
   }
+  size_t size = tensor->dims().production() * PrecisionTypeLength(precision);
+  CHECK_EQ(desc.RawDataSize(), size) << "Data size mismatch of " << name;
+  auto *data = const_cast<void *>(desc.RawData());
+  auto mapping = desc.DataMapping();
+  const size_t alignment = naive_buffer::BytesBuilder::kAlignment;
+  if (mapping && reinterpret_cast<uintptr_t>(data) % alignment == 0) {
+    // Use the data in the mapped file directly, the tensor keeps the file
+    // mapped.
+    tensor->ShareExternalMemory(data, size, TARGET(kHost), mapping);
+  } else if (size > 0) {
+    memcpy(tensor->mutable_data(size), data, size);
+  }
+  tensor->set_precision(precision);
   tensor->set_persistable(true);
 }
 
 void LoadParamNaive(const std::string &path,
                     lite::Scope *scope,
-                    const std::string &name) {
+                    const std::string &name,
+                    bool use_mmap) {
   // Load param
   naive_buffer::BinaryTable table;
-  table.LoadFromFile(path);
+  table.LoadFromFile(path, use_mmap);
   naive_buffer::proto::ParamDesc pt_desc(&table);
   pt_desc.Load();
   naive_buffer::ParamDesc desc(&pt_desc);
@@ -662,12 +666,13 @@ void LoadParamNaive(const std::string &path,
 void LoadCombinedParamsNaive(const std::string &path,
                              lite::Scope *scope,
                              const cpp::ProgramDesc &cpp_prog,
-                             bool params_from_memory) {
+                             bool params_from_memory,
+                             bool use_mmap) {
   naive_buffer::BinaryTable table;
   if (params_from_memory) {
     table.LoadFromMemory(path.c_str(), path.length());
   } else {
-    table.LoadFromFile(path);
+    table.LoadFromFile(path, use_mmap);
   }
   naive_buffer::proto::CombinedParamsDesc pt_desc(&table);
   pt_desc.Load();
@@ -695,7 +700,8 @@ void LoadCombinedParamsNaive(const std::string &path,
 void LoadModelNaive(const std::string &model_dir,
                     Scope *scope,
                     cpp::ProgramDesc *cpp_prog,
-                    bool combined) {
+                    bool combined,
+                    bool use_mmap) {
   CHECK(cpp_prog);
   CHECK(scope);
   cpp_prog->ClearBlocks();
@@ -715,7 +721,8 @@ void LoadModelNaive(const std::string &model_dir,
   // NOTE: Only main block be used now.
   if (combined) {
     const std::string combined_params_path = model_dir + "/param.nb";
-    LoadCombinedParamsNaive(combined_params_path, scope, *cpp_prog, false);
+    LoadCombinedParamsNaive(
+        combined_params_path, scope, *cpp_prog, false, use_mmap);
   } else {
     auto &prog = *cpp_prog;
     auto &main_block_desc = *prog.GetBlock<cpp::BlockDesc>(0);
@@ -729,7 +736,7 @@ void LoadModelNaive(const std::string &model_dir,
 
       switch (var.GetType()) {
         case VarDescAPI::Type::LOD_TENSOR:
-          LoadParamNaive(file_path, scope, var.Name());
+          LoadParamNaive(file_path, scope, var.Name(), use_mmap);
           break;
         default:
           CHECK(false) << "unknown weight type";
@@ -781,7 +788,8 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
   // NOTE: Only main block be used now.
   // only combined Params are supported in Loading Model from memory
   std::string combined_params_path = param_buffer;
-  LoadCombinedParamsNaive(combined_params_path, scope, *cpp_prog, true);
+  LoadCombinedParamsNaive(
+      combined_params_path, scope, *cpp_prog, true, false);
 
 #ifdef LITE_WITH_NPU
   LOG(FATAL) << "load from memory is not supported by NPU";
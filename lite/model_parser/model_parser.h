@@ -90,14 +90,18 @@ void SaveModelNaive(const std::string& model_dir,
                     bool combined = true);
 #endif
 
+// With `use_mmap`, the param files are mapped into memory, and the weights
+// refer to the mapped files instead of being copied out.
 void LoadParamNaive(const std::string& path,
                     lite::Scope* scope,
-                    const std::string& name);
+                    const std::string& name,
+                    bool use_mmap = false);
 
 void LoadModelNaive(const std::string& model_dir,
                     lite::Scope* scope,
                     cpp::ProgramDesc* prog,
-                    bool combined = true);
+                    bool combined = true,
+                    bool use_mmap = false);
 
 void LoadModelNaiveFromMemory(const std::string& model_buffer,
                               const std::string& param_buffer,
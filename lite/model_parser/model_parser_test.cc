@@ -16,6 +16,7 @@
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include "lite/core/scope.h"
+#include "lite/model_parser/naive_buffer/naive_buffer.h"
 
 DEFINE_string(model_dir, "", "");
 
@@ -112,6 +113,25 @@ TEST(ModelParser, LoadParamNaive) {
   }
 }
 
+TEST(ModelParser, LoadParamNaiveMmap) {
+  Scope scope;
+  LoadParamNaive("./fc_0.w", &scope, "xxx", true);
+  auto& tensor = scope.Var("xxx")->Get<lite::Tensor>();
+  std::vector<int64_t> bg_dim({1, 2, 5});
+  size_t size = 10;
+
+  ASSERT_EQ(bg_dim, tensor.dims().Vectorize());
+  ASSERT_EQ(tensor.data_size(), size);
+  auto* data = tensor.data<float>();
+  // The data refers to the mapped file, which is aligned.
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(data) %
+                naive_buffer::BytesBuilder::kAlignment,
+            0);
+  for (int i = 0; i < size; ++i) {
+    EXPECT_NEAR(i / static_cast<float>(size), data[i], 1e-6);
+  }
+}
+
 TEST(ModelParser, SaveModelNaive) {
   CHECK(!FLAGS_model_dir.empty());
   cpp::ProgramDesc prog;
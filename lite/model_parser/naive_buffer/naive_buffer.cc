@@ -13,7 +13,11 @@
 // limitations under the License.
 
 #include "lite/model_parser/naive_buffer/naive_buffer.h"
+#include <fcntl.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace paddle {
 namespace lite {
@@ -44,7 +48,29 @@ void BinaryTable::SaveToFile(const std::string &filename) const {
   fclose(fp);
 }
 
-void BinaryTable::LoadFromFile(const std::string &filename) {
+void BinaryTable::LoadFromFile(const std::string &filename, bool use_mmap) {
+  if (use_mmap) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    CHECK_GE(fd, 0) << "Unable to open file: " << filename;
+    struct stat file_stat;
+    CHECK_EQ(fstat(fd, &file_stat), 0) << "Unable to stat file: " << filename;
+    size_t file_size = file_stat.st_size;
+    CHECK_GT(file_size, 0UL) << "Empty file: " << filename;
+    LOG(INFO) << "file size " << file_size;
+    // The private mapping is writable, so the kernels modifying the weights
+    // in place get their own copies of the pages rather than a crash.
+    void *addr = mmap(
+        nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    CHECK(addr != MAP_FAILED) << "Unable to map file: " << filename;
+    mapped_bytes_.reset(static_cast<byte_t *>(addr),
+                        [file_size](byte_t *x) { munmap(x, file_size); });
+    mapped_size_ = file_size;
+    // Set readonly.
+    is_mutable_mode_ = false;
+    return;
+  }
+
   // get file size
   FILE *fp = fopen(filename.c_str(), "rb");
   CHECK(fp) << "Unable to open file: " << filename;
@@ -74,6 +100,54 @@ void BinaryTable::LoadFromMemory(const char *buffer, size_t buffer_size) {
   is_mutable_mode_ = false;
 }
 
+constexpr size_t BytesBuilder::kAlignment;
+constexpr uint64_t BytesBuilder::kAlignedFlag;
+
+void BytesBuilder::set(const void *data, size_t size) {
+  auto *bytes = static_cast<const byte_t *>(data);
+  data_.assign(bytes, bytes + size);
+  loaded_data_ = nullptr;
+  loaded_size_ = 0;
+}
+
+void BytesBuilder::Save() {
+  // memory format: [size | kAlignedFlag][padding size][padding][bytes]
+  uint64_t size = data_.size();
+  uint64_t head = size | kAlignedFlag;
+  size_t offset = table()->offset() + 2 * sizeof(uint64_t);
+  uint64_t padding = (kAlignment - offset % kAlignment) % kAlignment;
+  table()->Require(2 * sizeof(uint64_t) + padding + size);
+
+  memcpy(table()->cursor(), &head, sizeof(uint64_t));
+  table()->Consume(sizeof(uint64_t));
+  memcpy(table()->cursor(), &padding, sizeof(uint64_t));
+  table()->Consume(sizeof(uint64_t));
+  memset(table()->cursor(), 0, padding);
+  table()->Consume(padding);
+  if (size > 0) {
+    memcpy(table()->cursor(), data_.data(), size);
+  }
+  table()->Consume(size);
+}
+
+void BytesBuilder::Load() {
+  uint64_t head{};
+  memcpy(&head, table()->cursor(), sizeof(uint64_t));
+  table()->Consume(sizeof(uint64_t));
+  if (head & kAlignedFlag) {
+    uint64_t padding{};
+    memcpy(&padding, table()->cursor(), sizeof(uint64_t));
+    table()->Consume(sizeof(uint64_t));
+    table()->Consume(padding);
+  }
+
+  // Refer to the bytes in the table.
+  data_.clear();
+  loaded_data_ = table()->cursor();
+  loaded_size_ = head & ~kAlignedFlag;
+  table()->Consume(loaded_size_);
+}
+
 void StringBuilder::Save() {
   // memory format: [size][string data]
   uint64_t mem_size = sizeof(uint64_t) + data_.size();
@@ -43,6 +43,10 @@ using byte_t = uint8_t;
 struct BinaryTable {
  private:
   std::vector<byte_t> bytes_;
+  // The file mapped by `LoadFromFile`, the bytes are read from it instead of
+  // `bytes_` if it is set.
+  std::shared_ptr<byte_t> mapped_bytes_;
+  size_t mapped_size_{};
   size_t cursor_{};
   bool is_mutable_mode_{true};  // true for mutable, false for readonly.
 
@@ -54,15 +58,27 @@ struct BinaryTable {
   void Consume(size_t bytes);
 
   /// The current position of cursor for save or load.
-  byte_t* cursor() { return &bytes_[cursor_]; }
-  const byte_t* data() const { return bytes_.data(); }
-  size_t size() const { return bytes_.size(); }
-  size_t free_size() const { return bytes_.size() - cursor_; }
+  byte_t* cursor() {
+    return (mapped_bytes_ ? mapped_bytes_.get() : bytes_.data()) + cursor_;
+  }
+  size_t offset() const { return cursor_; }
+  const byte_t* data() const {
+    return mapped_bytes_ ? mapped_bytes_.get() : bytes_.data();
+  }
+  size_t size() const { return mapped_bytes_ ? mapped_size_ : bytes_.size(); }
+  size_t free_size() const { return size() - cursor_; }
+
+  /// The mapped file if the table is loaded with `use_mmap`, the loaded bytes
+  /// can refer to it as long as they hold it.
+  const std::shared_ptr<byte_t>& mapped_bytes() const { return mapped_bytes_; }
 
   /// Serialize the table to a binary buffer.
   void SaveToFile(const std::string& filename) const;
 
-  void LoadFromFile(const std::string& filename);
+  /// Load the table from a file. With `use_mmap`, the file is mapped as
+  /// copy-on-write instead of read, so the pages are shared by the processes
+  /// loading the same file, and are only read from disk when touched.
+  void LoadFromFile(const std::string& filename, bool use_mmap = false);
   void LoadFromMemory(const char* buffer, size_t buffer_size);
 };
 
@@ -173,6 +189,44 @@ class StringBuilder : public FieldBuilder {
   Type type() const override { return Type::_string; }
 };
 
+/*
+ * Builder of a byte array, such as the data of a tensor. Unlike the
+ * ListBuilder<CharBuilder>, which creates a builder for each byte, it holds the
+ * bytes as a whole, and the loaded bytes refer to the table without a copy, so
+ * they are only valid in the lifetime of the table.
+ *
+ * The memory format is [size | kAlignedFlag][padding size][padding][bytes],
+ * the padding makes the bytes start at an offset of the table aligned to
+ * kAlignment, so that they can be used in place when the table is mapped from
+ * a file. The format [size][bytes] of ListBuilder<CharBuilder> saved by the
+ * older versions is also supported in loading.
+ */
+class BytesBuilder : public FieldBuilder {
+  std::vector<byte_t> data_;
+  const byte_t* loaded_data_{};
+  size_t loaded_size_{};
+
+ public:
+  static constexpr size_t kAlignment = 64;
+  static constexpr uint64_t kAlignedFlag = 1ULL << 63;
+
+  explicit BytesBuilder(BinaryTable* table) : FieldBuilder(table) {}
+
+  /// Set data.
+  void set(const void* data, size_t size);
+
+  const byte_t* data() const {
+    return loaded_data_ ? loaded_data_ : data_.data();
+  }
+  size_t size() const { return loaded_data_ ? loaded_size_ : data_.size(); }
+
+  void Save() override;
+
+  void Load() override;
+
+  Type type() const override { return Type::_list; }
+};
+
 /*
  * This is a data structure. A composion of multiple fields.
  *
@@ -173,6 +173,57 @@ TEST(ListBuilder, basic) {
   }
 }
 
+TEST(BytesBuilder, mmap) {
+  BinaryTable table;
+  StringBuilder name(&table);
+  BytesBuilder bytes(&table);
+  std::vector<float> data(100);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = i * 0.5f;
+  }
+  name.set("odd-length-name");
+  name.Save();
+  bytes.set(data.data(), data.size() * sizeof(float));
+  bytes.Save();
+  table.SaveToFile("3.bf");
+
+  for (bool use_mmap : {false, true}) {
+    BinaryTable table1;
+    table1.LoadFromFile("3.bf", use_mmap);
+    ASSERT_EQ(table1.size(), table.size());
+    ASSERT_EQ(table1.mapped_bytes() != nullptr, use_mmap);
+    StringBuilder name1(&table1);
+    BytesBuilder bytes1(&table1);
+    name1.Load();
+    bytes1.Load();
+    ASSERT_EQ(name1.data(), "odd-length-name");
+    ASSERT_EQ(bytes1.size(), data.size() * sizeof(float));
+    // The bytes refer to the table, and start at an aligned offset.
+    ASSERT_EQ((bytes1.data() - table1.data()) % BytesBuilder::kAlignment, 0);
+    ASSERT_EQ(memcmp(bytes1.data(), data.data(), bytes1.size()), 0);
+  }
+}
+
+TEST(BytesBuilder, load_list_of_chars) {
+  // The data saved by the older versions as ListBuilder<CharBuilder>.
+  BinaryTable table;
+  ListBuilder<CharBuilder> li(&table);
+  const std::string str = "hello world";
+  for (char c : str) {
+    li.New()->set(c);
+  }
+  li.Save();
+  table.SaveToFile("4.bf");
+
+  BinaryTable table1;
+  table1.LoadFromFile("4.bf");
+  BytesBuilder bytes(&table1);
+  bytes.Load();
+  ASSERT_EQ(std::string(reinterpret_cast<const char*>(bytes.data()),
+                        bytes.size()),
+            str);
+}
+
 }  // namespace naive_buffer
 }  // namespace lite
 }  // namespace paddle
@@ -143,20 +143,17 @@ void ParamDesc::SetDim(const std::vector<int64_t>& dim) {
   VectorToRepeated<int64_t, Int64Builder>(dim, out_builder);
 }
 
-#define GET_DATA_IMPL(T, type__)                                            \
-  template <>                                                               \
-  std::vector<T> ParamDesc::Data() const {                                  \
-    CHECK(GetDataType() == VarDescAPI::VarDataType::type__)                 \
-        << "Data Type mismatch";                                            \
-    std::vector<T> res;                                                     \
-    auto& data_builder = desc_->GetField<ListBuilder<CharBuilder>>("data"); \
-    auto data = RepeatedToVector<char, CharBuilder>(data_builder);          \
-    size_t size = data.size() / sizeof(T);                                  \
-    auto* data_ptr = reinterpret_cast<T*>(&data[0]);                        \
-    for (size_t i = 0; i < size; ++i) {                                     \
-      res.push_back(data_ptr[i]);                                           \
-    }                                                                       \
-    return res;                                                             \
+#define GET_DATA_IMPL(T, type__)                                       \
+  template <>                                                          \
+  std::vector<T> ParamDesc::Data() const {                             \
+    CHECK(GetDataType() == VarDescAPI::VarDataType::type__)            \
+        << "Data Type mismatch";                                       \
+    auto& data_builder = desc_->GetField<BytesBuilder>("data");        \
+    std::vector<T> res(data_builder.size() / sizeof(T));               \
+    if (!res.empty()) {                                                \
+      memcpy(res.data(), data_builder.data(), res.size() * sizeof(T)); \
+    }                                                                  \
+    return res;                                                        \
   }
 GET_DATA_IMPL(uint8_t, UINT8);
 GET_DATA_IMPL(int8_t, INT8);
@@ -168,18 +165,12 @@ GET_DATA_IMPL(double, FP64);
 #undef GET_DATA_IMPL
 
 // NOTE: Must set data type first
-#define SET_DATA_COMMON_IMPL(T, type__, size__, data_ptr__)     \
-  CHECK(GetDataType() == VarDescAPI::VarDataType::type__)       \
-      << "Data Type mismatch, call SetDataType first.";         \
-  auto* data_builder =                                          \
-      desc_->GetMutableField<ListBuilder<CharBuilder>>("data"); \
-  CHECK(data_builder);                                          \
-  data_builder->Clear();                                        \
-  size_t size = size__ * sizeof(T);                             \
-  auto* data_ptr = reinterpret_cast<const char*>(data_ptr__);   \
-  for (size_t i = 0; i < size; ++i) {                           \
-    data_builder->New()->set(data_ptr[i]);                      \
-  }
+#define SET_DATA_COMMON_IMPL(T, type__, size__, data_ptr__)          \
+  CHECK(GetDataType() == VarDescAPI::VarDataType::type__)            \
+      << "Data Type mismatch, call SetDataType first.";              \
+  auto* data_builder = desc_->GetMutableField<BytesBuilder>("data"); \
+  CHECK(data_builder);                                               \
+  data_builder->set(data_ptr__, size__ * sizeof(T));
 
 #define SET_DATA_IMPL(T, type__)                                \
   template <>                                                   \
@@ -203,6 +194,18 @@ SET_DATA_IMPL(double, FP64);
 #undef SET_DATA_IMPL
 #undef SET_DATA_COMMON_IMPL
 
+const void* ParamDesc::RawData() const {
+  return desc_->GetField<BytesBuilder>("data").data();
+}
+
+size_t ParamDesc::RawDataSize() const {
+  return desc_->GetField<BytesBuilder>("data").size();
+}
+
+std::shared_ptr<void> ParamDesc::DataMapping() const {
+  return desc_->table()->mapped_bytes();
+}
+
 uint32_t ParamDesc::Version(const std::string& name) const {
   auto& builder = desc_->GetField<UInt32Builder>(name);
   return builder.data();
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 #include "lite/model_parser/desc_apis.h"
@@ -77,6 +78,14 @@ class ParamDesc {
   template <typename T>
   void SetData(const T *data, size_t size);
 
+  // The bytes of the data, which refer to the table without a copy.
+  const void *RawData() const;
+
+  size_t RawDataSize() const;
+
+  // The mapped file holding the data if the table is mapped, otherwise null.
+  std::shared_ptr<void> DataMapping() const;
+
  private:
   uint32_t Version(const std::string &name) const;
   void SetVersion(const std::string &name, uint32_t version);
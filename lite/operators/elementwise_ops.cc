@@ -13,12 +13,55 @@
 // limitations under the License.
 
 #include "lite/operators/elementwise_ops.h"
+#include <algorithm>
 #include "lite/core/op_registry.h"
 
 namespace paddle {
 namespace lite {
 namespace operators {
 
+bool ElementwiseAlignDims(const DDim& x_dims,
+                          const DDim& y_dims,
+                          int axis,
+                          std::vector<int64_t>* x_aligned,
+                          std::vector<int64_t>* y_aligned) {
+  bool swap = x_dims.size() < y_dims.size();
+  std::vector<int64_t> big = (swap ? y_dims : x_dims).Vectorize();
+  std::vector<int64_t> small = (swap ? x_dims : y_dims).Vectorize();
+  int rank = big.size();
+  if (axis == -1) axis = rank - small.size();
+  // The trailing dims of size 1 past the larger dims are dropped, as in
+  // fluid.
+  while (!small.empty() && axis + static_cast<int>(small.size()) > rank &&
+         small.back() == 1) {
+    small.pop_back();
+  }
+  if (axis < 0 || axis + static_cast<int>(small.size()) > rank) return false;
+  std::vector<int64_t> aligned(rank, 1);
+  std::copy(small.begin(), small.end(), aligned.begin() + axis);
+  for (int i = 0; i < rank; i++) {
+    if (big[i] != aligned[i] && big[i] != 1 && aligned[i] != 1) return false;
+  }
+  *x_aligned = swap ? aligned : big;
+  *y_aligned = swap ? big : aligned;
+  return true;
+}
+
+bool ElementwiseOutDims(const DDim& x_dims,
+                        const DDim& y_dims,
+                        int axis,
+                        DDim* out_dims) {
+  std::vector<int64_t> x_aligned, y_aligned;
+  if (!ElementwiseAlignDims(x_dims, y_dims, axis, &x_aligned, &y_aligned)) {
+    return false;
+  }
+  for (size_t i = 0; i < x_aligned.size(); i++) {
+    if (x_aligned[i] == 1) x_aligned[i] = y_aligned[i];
+  }
+  *out_dims = DDim(x_aligned);
+  return true;
+}
+
 bool ElementwiseOp::CheckShape() const {
   CHECK_OR_FALSE(param_.X);
   CHECK_OR_FALSE(param_.Y);
@@ -27,8 +70,10 @@ bool ElementwiseOp::CheckShape() const {
 }
 
 bool ElementwiseOp::InferShape() const {
-  CHECK_OR_FALSE(param_.X->dims().size() >= param_.Y->dims().size());
-  param_.Out->Resize(param_.X->dims());
+  DDim out_dims;
+  CHECK_OR_FALSE(ElementwiseOutDims(
+      param_.X->dims(), param_.Y->dims(), param_.axis, &out_dims));
+  param_.Out->Resize(out_dims);
   auto out_lod = param_.Out->mutable_lod();
   *out_lod = param_.X->lod();
   return true;
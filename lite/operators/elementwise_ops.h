@@ -21,6 +21,25 @@ namespace paddle {
 namespace lite {
 namespace operators {
 
+// Align the dims of the inputs of an elementwise op to the same rank. Y is
+// aligned with X from `axis`, or with the trailing dims of X when axis is -1,
+// and the other way round when Y has more dims, the other dims are 1. Return
+// false if the dims do not match, the dims of size 1 on either side are
+// broadcast to the other side.
+bool ElementwiseAlignDims(const DDim& x_dims,
+                          const DDim& y_dims,
+                          int axis,
+                          std::vector<int64_t>* x_aligned,
+                          std::vector<int64_t>* y_aligned);
+
+// The dims of the output of an elementwise op, see ElementwiseAlignDims.
+// NOTE: only the x86 kernels broadcast X, the kernels of the other targets
+// check that the output keeps the dims of X.
+bool ElementwiseOutDims(const DDim& x_dims,
+                        const DDim& y_dims,
+                        int axis,
+                        DDim* out_dims);
+
 class ElementwiseOp : public OpLite {
  public:
   explicit ElementwiseOp(const std::string& op_type) : OpLite(op_type) {}
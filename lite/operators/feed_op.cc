@@ -29,7 +29,16 @@ class FeedOp : public OpLite {
     return true;
   }
 
-  bool InferShape() const override { return true; }
+  // The output takes the dims of the fed tensor if it is set, so the shapes
+  // can be inferred before the run, e.g. by memory_optimize_pass.
+  bool InferShape() const override {
+    if (static_cast<size_t>(param_.col) < param_.feed_list->size()) {
+      auto& feed = param_.feed_list->at(param_.col);
+      param_.out->Resize(feed.dims());
+      param_.out->set_lod(feed.lod());
+    }
+    return true;
+  }
 
   void AttachKernel(KernelBase* kernel) override { kernel->SetParam(param_); }
 
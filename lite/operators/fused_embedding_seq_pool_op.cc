@@ -0,0 +1,61 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_embedding_seq_pool_op.h"
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedEmbeddingSeqPoolOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.W);
+  CHECK_OR_FALSE(param_.Ids);
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_EQ_OR_FALSE(param_.W->dims().size(), 2UL);
+  CHECK_EQ_OR_FALSE(param_.Ids->lod().size(), 1UL);
+  CHECK_EQ_OR_FALSE(param_.combiner, "sum");
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::InferShape() const {
+  auto ids_dims = param_.Ids->dims();
+  // The ids of a row are looked up and concatenated, as the table width
+  // times the last dim of the ids.
+  int64_t out_width = param_.W->dims()[1] * ids_dims[ids_dims.size() - 1];
+  int64_t seq_num = static_cast<int64_t>(param_.Ids->lod()[0].size()) - 1;
+  param_.Out->Resize(std::vector<int64_t>{seq_num, out_width});
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::AttachImpl(const cpp::OpDesc &opdesc,
+                                         lite::Scope *scope) {
+  param_.W = scope->FindVar(opdesc.Input("W").front())->GetMutable<Tensor>();
+  param_.Ids =
+      scope->FindVar(opdesc.Input("Ids").front())->GetMutable<Tensor>();
+  param_.Out =
+      scope->FindVar(opdesc.Output("Out").front())->GetMutable<Tensor>();
+  if (opdesc.HasAttr("combiner")) {
+    param_.combiner = opdesc.GetAttr<std::string>("combiner");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_embedding_seq_pool,
+                 paddle::lite::operators::FusedEmbeddingSeqPoolOp);
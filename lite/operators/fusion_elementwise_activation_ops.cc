@@ -28,8 +28,10 @@ bool FusionElementwiseActivationOp::CheckShape() const {
 }
 
 bool FusionElementwiseActivationOp::InferShape() const {
-  CHECK_OR_FALSE(param_.X->dims().size() >= param_.Y->dims().size());
-  param_.Out->Resize(param_.X->dims());
+  DDim out_dims;
+  CHECK_OR_FALSE(ElementwiseOutDims(
+      param_.X->dims(), param_.Y->dims(), param_.axis, &out_dims));
+  param_.Out->Resize(out_dims);
   return true;
 }
 
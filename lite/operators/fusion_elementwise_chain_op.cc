@@ -0,0 +1,80 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fusion_elementwise_chain_op.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/elementwise_ops.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool ElementwiseChainDims(const FusionElementwiseChainParam& param,
+                          std::vector<DDim>* dims) {
+  dims->clear();
+  for (auto* x : param.X) dims->push_back(x->dims());
+  for (size_t i = 0; i + 3 < param.codes.size(); i += 4) {
+    int a = param.codes[i + 1];
+    int b = param.codes[i + 2];
+    int reg = dims->size();
+    if (a < 0 || a >= reg || b >= reg) return false;
+    if (b < 0) {
+      dims->push_back(dims->at(a));
+      continue;
+    }
+    DDim out_dims;
+    if (!ElementwiseOutDims(
+            dims->at(a), dims->at(b), param.codes[i + 3], &out_dims)) {
+      return false;
+    }
+    dims->push_back(out_dims);
+  }
+  return true;
+}
+
+bool FusionElementwiseChainOp::CheckShape() const {
+  CHECK_OR_FALSE(!param_.X.empty());
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_OR_FALSE(!param_.codes.empty());
+  CHECK_OR_FALSE(param_.codes.size() % 4 == 0);
+  CHECK_OR_FALSE(param_.attrs.size() == param_.codes.size() / 2);
+  return true;
+}
+
+bool FusionElementwiseChainOp::InferShape() const {
+  std::vector<DDim> dims;
+  CHECK_OR_FALSE(ElementwiseChainDims(param_, &dims));
+  param_.Out->Resize(dims.back());
+  *param_.Out->mutable_lod() = param_.X.front()->lod();
+  return true;
+}
+
+bool FusionElementwiseChainOp::AttachImpl(const cpp::OpDesc& opdesc,
+                                          lite::Scope* scope) {
+  param_.X.clear();
+  for (auto& name : opdesc.Input("X")) {
+    param_.X.push_back(GetVar<lite::Tensor>(scope, name));
+  }
+  param_.Out = GetMutableVar<lite::Tensor>(scope, opdesc.Output("Out").front());
+  param_.codes = opdesc.GetAttr<std::vector<int>>("codes");
+  param_.attrs = opdesc.GetAttr<std::vector<float>>("attrs");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fusion_elementwise_chain,
+                 paddle::lite::operators::FusionElementwiseChainOp);
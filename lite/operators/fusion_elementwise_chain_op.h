@@ -0,0 +1,62 @@
+// Copyright (c) 2019 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <string>
+#include <vector>
+#include "lite/core/op_lite.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+// The dims of the registers of the instructions of a chain, the inputs first.
+// Return false if the dims of an instruction do not match.
+bool ElementwiseChainDims(const FusionElementwiseChainParam& param,
+                          std::vector<DDim>* dims);
+
+/*
+ * fusion_elementwise_chain evaluates a chain of elementwise ops, e.g.
+ * scale -> elementwise_add -> relu6, in one pass over the data, see
+ * ElementwiseChainFusePass.
+ *
+ * The inputs X are the registers 0 to n - 1, the i-th instruction writes the
+ * register n + i, and the last one is Out. An instruction is the codes
+ * {code, a, b, axis}, where a and b are the registers it reads, b is -1 for
+ * the unary ones and axis is the one of the elementwise ops, and the attrs
+ * {alpha, beta}, e.g. the scale and the bias of scale.
+ */
+class FusionElementwiseChainOp : public OpLite {
+ public:
+  explicit FusionElementwiseChainOp(const std::string& type) : OpLite(type) {}
+
+  bool CheckShape() const override;
+
+  bool InferShape() const override;
+
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override;
+
+  void AttachKernel(KernelBase* kernel) override { kernel->SetParam(param_); }
+
+  std::string DebugString() const override {
+    return "fusion_elementwise_chain_op";
+  }
+
+ private:
+  mutable operators::FusionElementwiseChainParam param_;
+};
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
@@ -33,6 +33,10 @@ class InterpolateOp : public OpLite {
 
   bool InferShape() const override;
 
+  bool InferShapeDependsOnData() const override {
+    return param_.OutSize != nullptr;
+  }
+
   bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
 
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
@@ -28,6 +28,9 @@
 
 namespace paddle {
 namespace lite {
+
+class RuntimeProgram;
+
 namespace operators {
 
 using param_t = Any;
@@ -347,6 +350,35 @@ struct FusionElementwiseActivationGradParam : public ElementwiseGradParam {
   std::string act_type;
 };
 
+// The instructions of fusion_elementwise_chain.
+enum class ElementwiseChainCode : int {
+  kAdd = 0,
+  kSub,
+  kMul,
+  kDiv,
+  kMax,
+  kScale,
+  kRelu,
+  kRelu6,
+  kLeakyRelu,
+  kSigmoid,
+  kTanh,
+  kSwish,
+  kExp,
+  kLog,
+  kSquare,
+  kHardSigmoid,
+};
+
+struct FusionElementwiseChainParam {
+  std::vector<const lite::Tensor*> X;
+  lite::Tensor* Out{};
+  // Every instruction is the 4 codes {code, a, b, axis} and the 2 attrs
+  // {alpha, beta}, see FusionElementwiseChainOp.
+  std::vector<int> codes;
+  std::vector<float> attrs;
+};
+
 /// ----------------------- mean operators ----------------------
 struct MeanParam {
   const lite::Tensor* X{};
@@ -403,6 +435,15 @@ struct FakeDequantizeMaxAbsParam {
   float max_range;
 };
 
+struct FakeChannelWiseDequantizeMaxAbsParam {
+  const lite::Tensor* x{};
+  // The scales of the output channels of the weights, and the scale of the
+  // input if it is quantized too.
+  std::vector<const lite::Tensor*> scale_tensors{};
+  lite::Tensor* out{};
+  std::vector<int> quant_bits;
+};
+
 /// ----------------------- sgd operators ----------------------
 struct SGDParam {
   int dtype{static_cast<int>(VarDescAPI::VarDataType::FP32)};
@@ -634,6 +675,9 @@ struct WhileParam {
   Scope* scope{};
   Tensor* cond{};
   cpp::BlockDesc* sub_block{};
+  // The runtime program of the sub-block, set to the kernel when the runtime
+  // program of the block running the op is created.
+  RuntimeProgram* program{};
   std::vector<Tensor*> x{};
   std::vector<Tensor*> outs{};
 };
@@ -686,6 +730,15 @@ struct SequencePoolParam {
 #endif
 };
 
+// The fused lookup_table and sequence_pool, the embeddings of the ids of
+// every sequence are pooled by `combiner`.
+struct FusedEmbeddingSeqPoolParam {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  lite::Tensor* Out{nullptr};
+  std::string combiner{"sum"};
+};
+
 struct SequenceExpandParam {
   const lite::Tensor* X{};
   const lite::Tensor* Y{};